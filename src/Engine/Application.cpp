@@ -30,6 +30,8 @@
 #include <Scene/Systems/MovingSystem.h>
 #include <Scene/Systems/CameraSystem.h>
 #include <Scene/Systems/LightCameraSystem.h>
+#include <Scene/Systems/ShadowAtlasSystem.h>
+#include <Scene/Systems/CullingSystem.h>
 #include <UI/Systems/UISystem.h>
 #include <Render/Systems/RenderSystem.h>
 #include <Render/Systems/DepthPassSystem.h>
@@ -88,6 +90,8 @@ namespace Engine
 
         scene->AddSystem(MakeUnique<Scene::Systems::CameraSystem>(mRenderContext));
         scene->AddSystem(MakeUnique<Scene::Systems::LightCameraSystem>(mRenderContext));
+        scene->AddSystem(MakeUnique<Scene::Systems::ShadowAtlasSystem>());
+        scene->AddSystem(MakeUnique<Scene::Systems::CullingSystem>());
 
         scene->AddSystem(MakeUnique<Render::Systems::DepthPassSystem>(renderer));
         scene->AddSystem(MakeUnique<Render::Systems::ForwardPassSystem>(renderer));
@@ -129,7 +133,7 @@ namespace Engine
                 {    
                     CoInitialize(nullptr);
                     Scene::Loader::SceneLoader loader;
-                    auto scene = loader.LoadScene(mSceneLoadingInfo->scenePath);
+                    auto scene = loader.LoadScene(mSceneLoadingInfo->scenePath, {}, mSceneLoadingInfo->vertexFormat);
 
                     loader.AddCubeMapToScene(scene.get(), "Resources\\Scenes\\cubemaps\\snowcube1024.dds");
 
@@ -1,9 +1,38 @@
 #pragma once
 
+#include <Types.h>
+
 namespace Engine::EngineConfig
 {
     constexpr int SwapChainBufferCount = 3;
     constexpr int ShadowWidth = 4096;
     constexpr int ShadowHeight = 4096;
+    // Directional light shadows are split into cascades, rendered to square tiles of the shadow atlas.
+    constexpr Size ShadowCascadesCount = 4;
+    constexpr int ShadowCascadeResolution = ShadowWidth / 4;
+    // Blends logarithmic (1) and uniform (0) cascade splits.
+    constexpr float32 ShadowCascadeSplitLambda = 0.8f;
+    // Spot and point lights share the rest of the atlas, their tiles follow how much of the screen they light.
+    constexpr int ShadowMinTileSize = 128;
+    constexpr int ShadowMaxTileSize = ShadowWidth / 4;
+    // Local lights reach as far as their attenuated intensity stays above this.
+    constexpr float32 LightRangeCutoff = 0.01f;
+    // Local lights are binned into a froxel grid over the main view, slices are spaced exponentially in depth.
+    constexpr uint32 LightClustersWidth = 16;
+    constexpr uint32 LightClustersHeight = 9;
+    constexpr uint32 LightClustersDepth = 24;
+    // Caps the light indices uploaded every frame, lights past it in a cluster are dropped.
+    constexpr uint32 MaxLightsPerCluster = 128;
+    constexpr Size UnusedImagesCacheBudget = 512ull * 1024 * 1024;
+    // Store mesh positions in their own vertex buffer so depth-only passes fetch nothing else.
+    constexpr bool SplitPositionStream = true;
+    // Meshes are drawn with their coarsest LOD whose simplification error projects to at most this many pixels.
+    constexpr float32 LodErrorThreshold = 1.0f;
+    // Scene resources are streamed to the GPU with at most this many bytes submitted per frame.
+    constexpr Size StreamingBudgetPerFrame = 32ull * 1024 * 1024;
+    constexpr Size StreamingBatchesInFlight = SwapChainBufferCount;
+    // Passes split their draws over command lists of at least this many draws, recorded in parallel.
+    constexpr Size MinDrawsPerCommandList = 256;
+    constexpr Size MaxCommandListsPerPass = 8;
 
 } // namespace Engine::EngineConfig
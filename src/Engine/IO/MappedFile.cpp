@@ -0,0 +1,76 @@
+#include "MappedFile.h"
+
+#include <StringUtils.h>
+
+#include <Windows.h>
+
+namespace Engine
+{
+    MappedFile::MappedFile() : mFile(INVALID_HANDLE_VALUE), mMapping(nullptr), mData(nullptr), mSize(0)
+    {
+    }
+
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+    bool MappedFile::Open(const String& path)
+    {
+        Close();
+
+        mFile = CreateFileW(StringToWString(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (mFile == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        LARGE_INTEGER fileSize = {};
+        if (!GetFileSizeEx(mFile, &fileSize) || fileSize.QuadPart == 0)
+        {
+            Close();
+            return false;
+        }
+
+        mMapping = CreateFileMappingW(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mMapping == nullptr)
+        {
+            Close();
+            return false;
+        }
+
+        mData = static_cast<const Byte*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+        if (mData == nullptr)
+        {
+            Close();
+            return false;
+        }
+
+        mSize = static_cast<Size>(fileSize.QuadPart);
+
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (mData != nullptr)
+        {
+            UnmapViewOfFile(mData);
+            mData = nullptr;
+        }
+
+        if (mMapping != nullptr)
+        {
+            CloseHandle(mMapping);
+            mMapping = nullptr;
+        }
+
+        if (mFile != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(mFile);
+            mFile = INVALID_HANDLE_VALUE;
+        }
+
+        mSize = 0;
+    }
+} // namespace Engine
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <Types.h>
+
+#include <span>
+
+namespace Engine
+{
+    class MappedFile
+    {
+    public:
+        MappedFile();
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool Open(const String& path);
+        void Close();
+
+        bool IsOpen() const { return mData != nullptr; }
+        std::span<const Byte> GetData() const { return { mData, mSize }; }
+
+    private:
+        void* mFile;
+        void* mMapping;
+        const Byte* mData;
+        Size mSize;
+    };
+} // namespace Engine
@@ -20,4 +20,12 @@ namespace Engine::Memory
         mBuffer = std::move(data);
     }
 
+    void Buffer::SetData(Size elementsCount, Size elementSize, std::span<const Byte> data)
+    {
+        mElementsCount = elementsCount;
+        mElementSize = elementSize;
+
+        mBuffer.assign(data.begin(), data.end());
+    }
+
 } // namespace Engine::Memory
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <Memory/Resource.h>
 
 #include <vector>
+#include <span>
 
 namespace Engine::Memory
 {
@@ -20,17 +21,19 @@ namespace Engine::Memory
             mElementSize = sizeof(T);
             Size size = mElementSize * mElementsCount;
 
-            mBuffer.reserve(size);
+            mBuffer.resize(size);
 
             memcpy(mBuffer.data(), data.data(), size);
         }
 
         void SetData(Size elementsCount, Size elementSize, const std::vector<Byte> &data);
+        void SetData(Size elementsCount, Size elementSize, std::span<const Byte> data);
 
         Size GetElementsCount() const { return mElementsCount; }
         Size GetElementSize() const { return mElementSize; }
 
         const void *GetData() const { return mBuffer.data(); }
+        Size GetDataSize() const { return mBuffer.size(); }
 
     protected:
         Size mElementsCount;
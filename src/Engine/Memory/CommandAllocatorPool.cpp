@@ -15,6 +15,8 @@ namespace Engine::Memory
 
     ComPtr<ID3D12CommandAllocator> CommandAllocatorPool::GetNextAllocator(D3D12_COMMAND_LIST_TYPE type)
     {
+        std::lock_guard<std::mutex> lock(mMutex);
+
         ComPtr<ID3D12CommandAllocator> allocator;
 
         auto &queue = mFreeAllocators[type];
@@ -34,6 +36,8 @@ namespace Engine::Memory
 
     void CommandAllocatorPool::Reset()
     {
+        std::lock_guard<std::mutex> lock(mMutex);
+
         for (auto &allocatorsQueue : mAllocatorsInUse)
         {
             auto &freeAllocatorsQueue = mFreeAllocators[allocatorsQueue.first];
@@ -4,10 +4,12 @@
 
 #include <d3d12.h>
 #include <map>
+#include <mutex>
 #include <queue>
 
 namespace Engine::Memory
 {
+    // Command lists are recorded on several threads, every call is guarded.
     class CommandAllocatorPool
     {
     public:
@@ -30,5 +32,6 @@ namespace Engine::Memory
         AllocatorsQueueMap mFreeAllocators;
 
         ComPtr<ID3D12Device> mDevice;
+        std::mutex mMutex;
     };
 } // namespace Engine::Memory
\ No newline at end of file
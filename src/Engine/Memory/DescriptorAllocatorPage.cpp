@@ -27,6 +27,8 @@ namespace Engine::Memory
 
 	DescriptorAllocation DescriptorAllocatorPage::Allocate(uint32 count)
 	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
 		if (mFreeSize < count)
 		{
 			return DescriptorAllocation();
@@ -60,6 +62,8 @@ namespace Engine::Memory
 
 	void DescriptorAllocatorPage::Free(DescriptorAllocation &&descriptorHandle)
 	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
 		auto offset = CalculateOffset(descriptorHandle.GetDescriptor());
 		auto count = descriptorHandle.GetNumDescsriptors();
 
@@ -68,6 +72,8 @@ namespace Engine::Memory
 
 	void DescriptorAllocatorPage::ReleaseStaleDescriptors(uint64 frameNumber)
 	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
 		while (!mStaleDescriptors.empty() && mStaleDescriptors.front().FrameNumber <= frameNumber)
 		{
 			auto &staleDescriptor = mStaleDescriptors.front();
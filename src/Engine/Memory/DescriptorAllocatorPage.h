@@ -6,6 +6,7 @@
 #include <d3d12.h>
 
 #include <map>
+#include <mutex>
 #include <queue>
 
 namespace Engine::Memory
@@ -76,5 +77,8 @@ namespace Engine::Memory
         FreeBlockByOffsetMap mFreeBlockByOffsetMap;
         FreeBlockBySizeMap mFreeBlockBySizeMap;
         Size mFreeSize;
+
+        // Views are created while command lists are recorded on several threads.
+        std::mutex mMutex;
     };
 } // namespace Engine::Memory
\ No newline at end of file
@@ -34,11 +34,13 @@ namespace Engine::Memory
         }
 
         mStaleDescriptorsTableBitMask |= (1 << rootParameterIndex);
+        mStagedDescriptorsTableBitMask |= (1 << rootParameterIndex);
     }
 
     void DynamicDescriptorHeap::ParseRootSignature(const Render::RootSignature *rootSignature)
     {
         mStaleDescriptorsTableBitMask = 0;
+        mStagedDescriptorsTableBitMask = 0;
 
         mDescriptorsTableBitMask = rootSignature->GetDescriptorsBitMask(mDescriptorHeapType);
         auto bitMask = mDescriptorsTableBitMask;
@@ -59,21 +61,35 @@ namespace Engine::Memory
         }
     }
 
-    void DynamicDescriptorHeap::CommitStagedDescriptors(ComPtr<ID3D12Device> device, ComPtr<ID3D12GraphicsCommandList> commandList)
+    uint32 DynamicDescriptorHeap::CommitStagedDescriptors(ComPtr<ID3D12Device> device, ComPtr<ID3D12GraphicsCommandList> commandList)
     {
+        if (mStaleDescriptorsTableBitMask == 0)
+        {
+            return 0;
+        }
+
         if (mCurrentDescriptorHeap == nullptr || mNumFreeHandles < ComputeStaleDescriptorCount())
         {
+            // Tables committed before point into the old heap, all the staged ones are copied to the new heap.
+            // They fit as the handles cache holding them is as large as a heap.
+            mStaleDescriptorsTableBitMask |= (mStagedDescriptorsTableBitMask & mDescriptorsTableBitMask);
+
             mCurrentDescriptorHeap = GetDescriptorHeap(device);
             mCurrentCpuHandle = mCurrentDescriptorHeap->GetCPUDescriptorHandleForHeapStart();
             mCurrentGpuHandle = mCurrentDescriptorHeap->GetGPUDescriptorHandleForHeapStart();
             mNumFreeHandles = mDescriptorsPerHeap;
+            mBoundCommandList = nullptr;
+        }
 
-                        //commandList->SetDescriptorHeaps(1, heaps);
+        // Changing descriptor heaps may stall the GPU, the heap is only set when it or the command list changes.
+        if (mBoundCommandList != commandList.Get())
+        {
+            ID3D12DescriptorHeap *heaps[] = {mCurrentDescriptorHeap.Get()};
+            commandList->SetDescriptorHeaps(1, heaps);
+            mBoundCommandList = commandList.Get();
         }
 
-        /// TODO: this solution not optimize but for now it's ok
-        ID3D12DescriptorHeap *heaps[] = {mCurrentDescriptorHeap.Get()};
-        commandList->SetDescriptorHeaps(1, heaps);
+        uint32 tablesCount = 0;
 
         DWORD index;
         while (_BitScanForward(&index, mStaleDescriptorsTableBitMask))
@@ -96,18 +112,23 @@ namespace Engine::Memory
             mNumFreeHandles -= numDescriptors;
 
             mStaleDescriptorsTableBitMask ^= (1 << index);
+            ++tablesCount;
         }
+
+        return tablesCount;
     }
 
     void DynamicDescriptorHeap::Reset()
     {
         mFreeDescriptorHeaps = mDescriptorHeapPool;
         mCurrentDescriptorHeap.Reset();
+        mBoundCommandList = nullptr;
 
         mCurrentCpuHandle = CD3DX12_CPU_DESCRIPTOR_HANDLE(D3D12_DEFAULT);
         mCurrentGpuHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(D3D12_DEFAULT);
 
         mStaleDescriptorsTableBitMask = 0;
+        mStagedDescriptorsTableBitMask = 0;
         mDescriptorsTableBitMask = 0;
 
         mNumFreeHandles = 0;
@@ -18,7 +18,8 @@ namespace Engine::Memory
 
         void ParseRootSignature(const Render::RootSignature *rootSignature);
 
-        void CommitStagedDescriptors(ComPtr<ID3D12Device> device, ComPtr<ID3D12GraphicsCommandList> commandList);
+        // Returns the number of descriptor tables set on the command list.
+        uint32 CommitStagedDescriptors(ComPtr<ID3D12Device> device, ComPtr<ID3D12GraphicsCommandList> commandList);
 
         void Reset();
 
@@ -54,12 +55,16 @@ namespace Engine::Memory
         uint32 mDescriptorsPerHeap;
 
         uint32 mStaleDescriptorsTableBitMask;
+        // Tables staged since the root signature was parsed, copied again when the heap changes.
+        uint32 mStagedDescriptorsTableBitMask = 0;
         uint32 mDescriptorsTableBitMask;
 
         std::queue<ComPtr<ID3D12DescriptorHeap>> mDescriptorHeapPool;
         std::queue<ComPtr<ID3D12DescriptorHeap>> mFreeDescriptorHeaps;
 
         ComPtr<ID3D12DescriptorHeap> mCurrentDescriptorHeap;
+        // Command list the current heap is set on.
+        ID3D12GraphicsCommandList *mBoundCommandList = nullptr;
         CD3DX12_CPU_DESCRIPTOR_HANDLE mCurrentCpuHandle;
         CD3DX12_GPU_DESCRIPTOR_HANDLE mCurrentGpuHandle;
         uint32 mNumFreeHandles;
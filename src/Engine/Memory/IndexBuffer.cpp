@@ -5,7 +5,7 @@
 namespace Engine::Memory
 {
     IndexBuffer::IndexBuffer(const std::wstring &name)
-        : Buffer(name), mIndexBufferView{0}
+        : Buffer(name), mIndexFormat(DXGI_FORMAT_UNKNOWN), mIndexBufferView{0}
     {
     }
 
@@ -13,19 +13,42 @@ namespace Engine::Memory
     {
     }
 
+    void IndexBuffer::SetData(const std::vector<uint16> &indices)
+    {
+        Buffer::SetData(indices);
+        SetIndexFormat(sizeof(uint16));
+    }
+
+    void IndexBuffer::SetData(const std::vector<uint32> &indices)
+    {
+        Buffer::SetData(indices);
+        SetIndexFormat(sizeof(uint32));
+    }
+
+    void IndexBuffer::SetData(Size indicesCount, Size indexSize, std::span<const Byte> data)
+    {
+        Buffer::SetData(indicesCount, indexSize, data);
+        SetIndexFormat(indexSize);
+    }
+
+    void IndexBuffer::SetIndexFormat(Size indexSize)
+    {
+        assert((indexSize == 2 || indexSize == 4) && "Indices must be 16, or 32-bit integers.");
+
+        mIndexFormat = indexSize == 2 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+        mIndexBufferView = {};
+    }
+
     D3D12_INDEX_BUFFER_VIEW IndexBuffer::GetIndexBufferView()
     {
         if (!mIndexBufferView.BufferLocation)
         {
-            assert(mElementSize == 2 || mElementSize == 4 && "Indices must be 16, or 32-bit integers.");
-            auto indexFormat = mElementSize == 2 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
-
             auto size = mElementsCount * mElementSize;
 
             D3D12_INDEX_BUFFER_VIEW indexBufferView = {};
             indexBufferView.BufferLocation = mResource->GetGPUVirtualAddress();
             indexBufferView.SizeInBytes = static_cast<uint32>(size);
-            indexBufferView.Format = indexFormat;
+            indexBufferView.Format = mIndexFormat;
 
             mIndexBufferView = indexBufferView;
         }
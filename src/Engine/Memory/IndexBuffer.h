@@ -11,9 +11,19 @@ namespace Engine::Memory
         IndexBuffer(const std::wstring &name = L"");
         virtual ~IndexBuffer();
 
+        void SetData(const std::vector<uint16> &indices);
+        void SetData(const std::vector<uint32> &indices);
+        void SetData(Size indicesCount, Size indexSize, std::span<const Byte> data);
+
+        DXGI_FORMAT GetIndexFormat() const { return mIndexFormat; }
+
         D3D12_INDEX_BUFFER_VIEW GetIndexBufferView();
 
     private:
+        void SetIndexFormat(Size indexSize);
+
+    private:
+        DXGI_FORMAT mIndexFormat;
         D3D12_INDEX_BUFFER_VIEW mIndexBufferView;
     };
 
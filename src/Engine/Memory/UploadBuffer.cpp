@@ -36,12 +36,18 @@ namespace Engine::Memory
     UploadBuffer::Allocation UploadBuffer::Allocate(Size sizeInBytes, Size alignment)
     {
         Size alignedSize = (sizeInBytes + (alignment - 1)) & ~(alignment - 1);
-        Size alignedOffset = (mOffset + (alignment - 1)) & ~(alignment - 1);
+        Size offset = mOffset.load(std::memory_order_relaxed);
+        Size alignedOffset;
 
-        if (alignedOffset + alignedSize > mSize)
+        do
         {
-            throw std::bad_alloc();
-        }
+            alignedOffset = (offset + (alignment - 1)) & ~(alignment - 1);
+
+            if (alignedOffset + alignedSize > mSize)
+            {
+                throw std::bad_alloc();
+            }
+        } while (!mOffset.compare_exchange_weak(offset, alignedOffset + alignedSize, std::memory_order_relaxed));
 
         Allocation allocation;
         allocation.CPU = mMappedData + alignedOffset;
@@ -49,8 +55,6 @@ namespace Engine::Memory
         allocation.bufferSize = alignedSize;
         allocation.offset = alignedOffset;
 
-        mOffset = alignedOffset + alignedSize;
-
         return allocation;
     }
 
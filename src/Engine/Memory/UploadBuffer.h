@@ -3,6 +3,7 @@
 #include <Types.h>
 #include <d3d12.h>
 
+#include <atomic>
 #include <vector>
 
 namespace Engine::Memory
@@ -34,6 +35,7 @@ namespace Engine::Memory
         UploadBuffer(ID3D12Device *device, Size size);
         ~UploadBuffer();
 
+        // Safe to call from several threads, command lists of a frame are recorded in parallel.
         Allocation Allocate(Size sizeInBytes, Size alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
 
         void Reset()
@@ -42,13 +44,14 @@ namespace Engine::Memory
         }
 
         ID3D12Resource *GetD3D12Resource() const { return mBuffer.Get(); }
+        Size GetSize() const { return mSize; }
 
     private:
         ComPtr<ID3D12Resource> mBuffer;
         Byte *mMappedData;
         D3D12_GPU_VIRTUAL_ADDRESS mGpuAddress;
         Size mSize;
-        Size mOffset;
+        std::atomic<Size> mOffset;
     };
 
 } // namespace Engine::Memory
\ No newline at end of file
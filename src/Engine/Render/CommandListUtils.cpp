@@ -17,6 +17,7 @@
 #include <Scene/Image.h>
 #include <Scene/Texture.h>
 #include <Scene/Material.h>
+#include <Scene/Mesh.h>
 #include <Scene/PunctualLight.h>
 #include <Scene/Camera.h>
 #include <Scene/Texture.h>
@@ -29,17 +30,40 @@
 
 namespace Engine::Render::CommandListUtils
 {
-    void UploadVertexBuffer(SharedPtr<RenderContext> renderContext, ComPtr<ID3D12GraphicsCommandList> commandList, SharedPtr<ResourceStateTracker> stateTracker, Memory::VertexBuffer &vertexBuffer, SharedPtr<Memory::UploadBuffer> uploadBuffer)
+    namespace
     {
-        UploadBuffer(renderContext, commandList, stateTracker, vertexBuffer, uploadBuffer);
-    }
+        Size AlignUploadSize(Size size)
+        {
+            return (size + (D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1)) & ~static_cast<Size>(D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1);
+        }
 
-    void UploadIndexBuffer(SharedPtr<RenderContext> renderContext, ComPtr<ID3D12GraphicsCommandList> commandList, SharedPtr<ResourceStateTracker> stateTracker, Memory::IndexBuffer &indexBuffer, SharedPtr<Memory::UploadBuffer> uploadBuffer)
-    {
-        UploadBuffer(renderContext, commandList, stateTracker, indexBuffer, uploadBuffer);
+        D3D12_RESOURCE_DESC GetTextureDescription(const Scene::Texture &texture)
+        {
+            auto &metadata = texture.GetImage()->GetImage()->GetMetadata();
+
+            DXGI_FORMAT format = metadata.format;
+            if (texture.IsSRGB())
+            {
+                format = DirectX::MakeSRGB(format);
+            }
+
+            D3D12_RESOURCE_DESC desc = {};
+            desc.Width = static_cast<uint32>(metadata.width);
+            desc.Height = static_cast<uint32>(metadata.height);
+            desc.MipLevels = static_cast<uint16>(metadata.mipLevels);
+            desc.DepthOrArraySize = (metadata.dimension == DirectX::TEX_DIMENSION_TEXTURE3D)
+                ? static_cast<uint16>(metadata.depth)
+                : static_cast<uint16>(metadata.arraySize);
+            desc.Format = format;
+            desc.Flags = D3D12_RESOURCE_FLAG_NONE;
+            desc.SampleDesc.Count = 1;
+            desc.Dimension = static_cast<D3D12_RESOURCE_DIMENSION>(metadata.dimension);
+
+            return desc;
+        }
     }
 
-    void UploadBuffer(SharedPtr<RenderContext> renderContext, ComPtr<ID3D12GraphicsCommandList> commandList, SharedPtr<ResourceStateTracker> stateTracker, Memory::Buffer &buffer, SharedPtr<Memory::UploadBuffer> uploadBuffer, D3D12_RESOURCE_FLAGS flags)
+    ComPtr<ID3D12Resource> UploadBuffer(SharedPtr<RenderContext> renderContext, ComPtr<ID3D12GraphicsCommandList> commandList, SharedPtr<ResourceStateTracker> stateTracker, const Memory::Buffer &buffer, SharedPtr<Memory::UploadBuffer> uploadBuffer, D3D12_RESOURCE_FLAGS flags)
     {
         auto device = renderContext->Device();
         auto resourceTracker = stateTracker;
@@ -68,46 +92,22 @@ namespace Engine::Render::CommandListUtils
 
         UpdateSubresources(commandList.Get(), destinationResource.Get(), uploadBuffer->GetD3D12Resource(), allocation.offset, 0, 1, &subresource);
 
-        
-        buffer.SetD3D12Resource(destinationResource);
+        return destinationResource;
     }
 
-    void UploadTexture(SharedPtr<RenderContext> renderContext, ComPtr<ID3D12GraphicsCommandList> commandList, SharedPtr<ResourceStateTracker> stateTracker, Scene::Texture *texture, SharedPtr<Memory::UploadBuffer> uploadBuffer)
+    ComPtr<ID3D12Resource> UploadTexture(SharedPtr<RenderContext> renderContext, ComPtr<ID3D12GraphicsCommandList> commandList, SharedPtr<ResourceStateTracker> stateTracker, const Scene::Texture &texture, SharedPtr<Memory::UploadBuffer> uploadBuffer)
     {
-        if (texture->GetD3D12Resource() != nullptr)
-        {
-            return;
-        }
-
         auto device = renderContext->Device();
         auto resourceTracker = stateTracker;
 
-        std::filesystem::path filename = texture->GetName();
-
-        auto image = texture->GetImage();
+        auto image = texture.GetImage();
         auto &metadata = image->GetImage()->GetMetadata();
         const DirectX::Image *images = image->GetImage()->GetImages();
         Size imageCount = image->GetImage()->GetImageCount();
 
         ComPtr<ID3D12Resource> textureResource;
 
-        DXGI_FORMAT format = metadata.format;
-        if (texture->IsSRGB())
-        {
-            format = DirectX::MakeSRGB(format);
-        }
-
-        D3D12_RESOURCE_DESC desc = {};
-        desc.Width = static_cast<uint32>(metadata.width);
-        desc.Height = static_cast<uint32>(metadata.height);
-        desc.MipLevels = static_cast<uint16>(metadata.mipLevels);
-        desc.DepthOrArraySize = (metadata.dimension == DirectX::TEX_DIMENSION_TEXTURE3D)
-            ? static_cast<uint16>(metadata.depth)
-            : static_cast<uint16>(metadata.arraySize);
-        desc.Format = format;
-        desc.Flags = D3D12_RESOURCE_FLAG_NONE;
-        desc.SampleDesc.Count = 1;
-        desc.Dimension = static_cast<D3D12_RESOURCE_DIMENSION>(metadata.dimension);
+        D3D12_RESOURCE_DESC desc = GetTextureDescription(texture);
         CD3DX12_HEAP_PROPERTIES props{D3D12_HEAP_TYPE_DEFAULT};
         ThrowIfFailed(device->CreateCommittedResource(
             &props,
@@ -144,51 +144,31 @@ namespace Engine::Render::CommandListUtils
             static_cast<unsigned int>(subresources.size()),
             subresources.data());
 
-        texture->SetD3D12Resource(textureResource);
+        return textureResource;
     }
 
-    bool UploadMaterialTextures(SharedPtr<RenderContext> renderContext, ComPtr<ID3D12GraphicsCommandList> commandList, SharedPtr<ResourceStateTracker> stateTracker, SharedPtr<Scene::Material> material, SharedPtr<Memory::UploadBuffer> uploadBuffer)
+    Size GetUploadSize(SharedPtr<RenderContext> renderContext, const Memory::Buffer &buffer)
     {
-        bool anythingToLoad = false;
-        if (material->HasBaseColorTexture() && !material->GetBaseColorTexture()->GetD3D12Resource())
-        {
-            anythingToLoad = true;
-            UploadTexture(renderContext, commandList, stateTracker, material->GetBaseColorTexture().get(), uploadBuffer);
-        }
-
-        if (material->HasMetallicRoughnessTexture() && !material->GetMetallicRoughnessTexture()->GetD3D12Resource())
-        {
-            anythingToLoad = true;
-            UploadTexture(renderContext, commandList, stateTracker, material->GetMetallicRoughnessTexture().get(), uploadBuffer);
-        }
-
-        if (material->HasNormalTexture() && !material->GetNormalTexture()->GetD3D12Resource())
-        {
-            anythingToLoad = true;
-            UploadTexture(renderContext, commandList, stateTracker, material->GetNormalTexture().get(), uploadBuffer);
-        }
+        return AlignUploadSize(buffer.GetElementsCount() * buffer.GetElementSize());
+    }
 
-        if (material->HasEmissiveTexture() && !material->GetEmissiveTexture()->GetD3D12Resource())
-        {
-            anythingToLoad = true;
-            UploadTexture(renderContext, commandList, stateTracker, material->GetEmissiveTexture().get(), uploadBuffer);
-        }
+    Size GetUploadSize(SharedPtr<RenderContext> renderContext, const Scene::Texture &texture)
+    {
+        D3D12_RESOURCE_DESC desc = GetTextureDescription(texture);
+        const uint32 subresourcesCount = static_cast<uint32>(texture.GetImage()->GetImage()->GetImageCount());
 
-        if (material->HasAmbientOcclusionTexture() && !material->GetAmbientOcclusionTexture()->GetD3D12Resource())
-        {
-            anythingToLoad = true;
-            UploadTexture(renderContext, commandList, stateTracker, material->GetAmbientOcclusionTexture().get(), uploadBuffer);
-        }
+        uint64 requiredSize = 0;
+        renderContext->Device()->GetCopyableFootprints(&desc, 0, subresourcesCount, 0, nullptr, nullptr, nullptr, &requiredSize);
 
-        return anythingToLoad;
+        return AlignUploadSize(requiredSize);
     }
 
-    void BindVertexBuffer(ComPtr<ID3D12GraphicsCommandList> commandList, SharedPtr<ResourceStateTracker> stateTracker, Memory::VertexBuffer &vertexBuffer)
+    void BindVertexBuffer(ComPtr<ID3D12GraphicsCommandList> commandList, SharedPtr<ResourceStateTracker> stateTracker, Memory::VertexBuffer &vertexBuffer, uint32 slot)
     {
         TransitionBarrier(stateTracker, vertexBuffer.GetD3D12Resource(), D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
 
         auto vbv = vertexBuffer.GetVertexBufferView();
-        commandList->IASetVertexBuffers(0, 1, &vbv);
+        commandList->IASetVertexBuffers(slot, 1, &vbv);
     }
 
     void BindIndexBuffer(ComPtr<ID3D12GraphicsCommandList> commandList, SharedPtr<ResourceStateTracker> stateTracker, Memory::IndexBuffer &indexBuffer)
@@ -261,7 +241,7 @@ namespace Engine::Render::CommandListUtils
         return cb;
     }
 
-    MeshUniform GetMeshUniform(const DirectX::XMMATRIX& world)
+    MeshUniform GetMeshUniform(const DirectX::XMMATRIX& world, const Scene::Mesh& mesh)
     {
         DirectX::XMMATRIX tWorld = DirectX::XMMatrixTranspose(world);
         auto d = DirectX::XMMatrixDeterminant(tWorld);
@@ -270,56 +250,67 @@ namespace Engine::Render::CommandListUtils
         MeshUniform cb;
         DirectX::XMStoreFloat4x4(&cb.World, tWorld);
         DirectX::XMStoreFloat4x4(&cb.InverseTranspose, tWorldInverseTranspose);
+        cb.PositionScale = mesh.positionQuantization.scale;
+        cb.PositionOffset = mesh.positionQuantization.offset;
 
         return cb;
     }
 
-    void BindMaterial(SharedPtr<RenderContext> renderContext, ComPtr<ID3D12GraphicsCommandList> commandList, SharedPtr<ResourceStateTracker> stateTracker, SharedPtr<Memory::UploadBuffer> buffer, SharedPtr<Memory::DynamicDescriptorHeap> dynamicDescriptorHeap, SharedPtr<Scene::Material> material)
+    uint32 BindMaterial(RenderContext *renderContext, ID3D12GraphicsCommandList *commandList, ResourceStateTracker *stateTracker, Memory::UploadBuffer *buffer, Memory::DynamicDescriptorHeap *dynamicDescriptorHeap, const Scene::Material &material)
     {
         auto device = renderContext->Device();
         auto descriptorAllocator = renderContext->GetDescriptorAllocator(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
 
-        MaterialUniform uniform = CommandListUtils::GetMaterialUniform(*material.get());
+        MaterialUniform uniform = CommandListUtils::GetMaterialUniform(material);
 
         auto matAllocation = buffer->Allocate(sizeof(MaterialUniform));
         matAllocation.CopyTo(&uniform);
         commandList->SetGraphicsRootConstantBufferView(2, matAllocation.GPU);
 
-        if (material->HasBaseColorTexture())
+        uint32 tablesCount = 0;
+
+        if (material.HasBaseColorTexture())
         {
-            CommandListUtils::TransitionBarrier(stateTracker, material->GetBaseColorTexture()->GetD3D12Resource(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+            stateTracker->TransitionResource(material.GetBaseColorTexture()->GetD3D12Resource().Get(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
 
-            dynamicDescriptorHeap->StageDescriptor(4, 0, 1, material->GetBaseColorTexture()->GetShaderResourceView(device, descriptorAllocator));
+            dynamicDescriptorHeap->StageDescriptor(4, 0, 1, material.GetBaseColorTexture()->GetShaderResourceView(device, descriptorAllocator));
+            ++tablesCount;
         }
 
-        if (material->HasMetallicRoughnessTexture())
+        if (material.HasMetallicRoughnessTexture())
         {
-            CommandListUtils::TransitionBarrier(stateTracker, material->GetMetallicRoughnessTexture()->GetD3D12Resource(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+            stateTracker->TransitionResource(material.GetMetallicRoughnessTexture()->GetD3D12Resource().Get(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
 
-            dynamicDescriptorHeap->StageDescriptor(5, 0, 1, material->GetMetallicRoughnessTexture()->GetShaderResourceView(device, descriptorAllocator));
+            dynamicDescriptorHeap->StageDescriptor(5, 0, 1, material.GetMetallicRoughnessTexture()->GetShaderResourceView(device, descriptorAllocator));
+            ++tablesCount;
         }
 
-        if (material->HasNormalTexture())
+        if (material.HasNormalTexture())
         {
-            CommandListUtils::TransitionBarrier(stateTracker, material->GetNormalTexture()->GetD3D12Resource(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+            stateTracker->TransitionResource(material.GetNormalTexture()->GetD3D12Resource().Get(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
 
-            dynamicDescriptorHeap->StageDescriptor(6, 0, 1, material->GetNormalTexture()->GetShaderResourceView(device, descriptorAllocator));
+            dynamicDescriptorHeap->StageDescriptor(6, 0, 1, material.GetNormalTexture()->GetShaderResourceView(device, descriptorAllocator));
+            ++tablesCount;
         }
 
         
-        if (material->HasEmissiveTexture())
+        if (material.HasEmissiveTexture())
         {
-            CommandListUtils::TransitionBarrier(stateTracker, material->GetEmissiveTexture()->GetD3D12Resource(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+            stateTracker->TransitionResource(material.GetEmissiveTexture()->GetD3D12Resource().Get(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
 
-            dynamicDescriptorHeap->StageDescriptor(7, 0, 1, material->GetEmissiveTexture()->GetShaderResourceView(device, descriptorAllocator));
+            dynamicDescriptorHeap->StageDescriptor(7, 0, 1, material.GetEmissiveTexture()->GetShaderResourceView(device, descriptorAllocator));
+            ++tablesCount;
         }
 
-        if (material->HasAmbientOcclusionTexture())
+        if (material.HasAmbientOcclusionTexture())
         {
-            CommandListUtils::TransitionBarrier(stateTracker, material->GetAmbientOcclusionTexture()->GetD3D12Resource(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+            stateTracker->TransitionResource(material.GetAmbientOcclusionTexture()->GetD3D12Resource().Get(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
 
-            dynamicDescriptorHeap->StageDescriptor(8, 0, 1, material->GetAmbientOcclusionTexture()->GetShaderResourceView(device, descriptorAllocator));
+            dynamicDescriptorHeap->StageDescriptor(8, 0, 1, material.GetAmbientOcclusionTexture()->GetShaderResourceView(device, descriptorAllocator));
+            ++tablesCount;
         }
+
+        return tablesCount;
     }
 
     void TransitionBarrier(ComPtr<ID3D12GraphicsCommandList> commandList, SharedPtr<ResourceStateTracker> stateTracker, ComPtr<ID3D12Resource> resource, D3D12_RESOURCE_STATES targetState, bool forceFlush)
@@ -334,11 +325,7 @@ namespace Engine::Render::CommandListUtils
 
     void TransitionBarrier(SharedPtr<ResourceStateTracker> stateTracker, ComPtr<ID3D12Resource> resource, D3D12_RESOURCE_STATES targetState)
     {
-        CD3DX12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(
-            resource.Get(),
-            D3D12_RESOURCE_STATE_COMMON,
-            targetState);
-        stateTracker->ResourceBarrier(barrier);
+        stateTracker->TransitionResource(resource.Get(), targetState);
     }
 
 } // namespace Engine::CommandListUtils
\ No newline at end of file
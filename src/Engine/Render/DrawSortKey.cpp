@@ -0,0 +1,25 @@
+#include "DrawSortKey.h"
+
+#include <algorithm>
+
+namespace Engine::Render
+{
+    uint32 GetSortId(std::unordered_map<const void *, uint32> &ids, const void *object)
+    {
+        return ids.emplace(object, static_cast<uint32>(ids.size())).first->second;
+    }
+
+    uint64 GetDrawSortKey(bool isDoubleSided, bool isCompact, uint32 material, uint32 mesh, float32 depth)
+    {
+        constexpr uint32 MaterialBits = 20;
+        constexpr uint32 MeshBits = 20;
+        constexpr uint32 DepthBits = 22;
+
+        const uint64 pipelineState = (isDoubleSided ? 2 : 0) | (isCompact ? 1 : 0);
+        const uint64 materialKey = std::min<uint64>(material, (1ull << MaterialBits) - 1);
+        const uint64 meshKey = std::min<uint64>(mesh, (1ull << MeshBits) - 1);
+        const uint64 depthKey = static_cast<uint64>(std::clamp(depth, 0.0f, 1.0f) * static_cast<float32>((1u << DepthBits) - 1));
+
+        return (pipelineState << (MaterialBits + MeshBits + DepthBits)) | (materialKey << (MeshBits + DepthBits)) | (meshKey << DepthBits) | depthKey;
+    }
+} // namespace Engine::Render
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <Types.h>
+
+#include <unordered_map>
+
+namespace Engine::Render
+{
+    // Dense ids of the objects drawn in a frame, in the order they were first seen.
+    uint32 GetSortId(std::unordered_map<const void *, uint32> &ids, const void *object);
+
+    // Pipeline state, material and mesh from the most significant bits, then front to back for early depth rejection.
+    // Ids past their bits share the largest value, depth is clamped to [0, 1].
+    uint64 GetDrawSortKey(bool isDoubleSided, bool isCompact, uint32 material, uint32 mesh, float32 depth);
+} // namespace Engine::Render
@@ -1,42 +1,126 @@
 #include "FrameResourceProvider.h"
 
 #include <DirectXHashes.h>
+#include <Exceptions.h>
 
+#include <Render/CommandQueue.h>
 #include <Render/ResourceStateTracker.h>
+#include <Render/RenderGraph.h>
 #include <Render/Texture.h>
 #include <Render/TextureCreationInfo.h>
 
+#include <d3dx12.h>
+#include <algorithm>
 #include <tuple>
 
 namespace Engine::Render
 {
-    FrameResourceProvider::FrameResourceProvider(ComPtr<ID3D12Device> device, GlobalResourceStateTracker* stateTracker)
-        : mDevice{device}, mStateTracker(stateTracker)
+    FrameResourceProvider::FrameResourceProvider(ComPtr<ID3D12Device> device, SharedPtr<CommandQueue> commandQueue, GlobalResourceStateTracker* stateTracker)
+        : mDevice{device}, mCommandQueue(commandQueue), mStateTracker(stateTracker)
     {
     }
     FrameResourceProvider::~FrameResourceProvider() = default;
 
-    void FrameResourceProvider::CreateResource(const Name &name, const TextureCreationInfo &textureInfo)
+    void FrameResourceProvider::CreateResources(const std::vector<RenderGraphResource> &resources)
     {
-        auto iter = mResources.find(name);
-        size_t hash = std::hash<TextureCreationInfo>{}(textureInfo);
+        uint64 alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
 
-        if (iter != mResources.end())
+        mRequests.resize(resources.size());
+        for (Size i = 0; i < resources.size(); ++i)
         {
-            if (iter->second.hash != hash)
+            auto allocationInfo = mDevice->GetResourceAllocationInfo(0, 1, &resources[i].creationInfo.description);
+
+            mRequests[i].size = allocationInfo.SizeInBytes;
+            mRequests[i].alignment = allocationInfo.Alignment;
+            mRequests[i].firstUse = resources[i].firstUse;
+            mRequests[i].lastUse = resources[i].lastUse;
+
+            alignment = std::max<uint64>(alignment, allocationInfo.Alignment);
+        }
+
+        PackAliasedResources(mRequests, mLayout);
+
+        const bool isHeapTooSmall = mLayout.heapSize > mHeapCapacity || alignment > mHeapAlignment;
+
+        // Textures of the frames still in flight live on until the GPU is done with them, one wait covers every release of this frame.
+        bool isReleasing = isHeapTooSmall && mHeap;
+        for (const auto &[name, data] : mResources)
+        {
+            auto usedResource = std::find_if(resources.begin(), resources.end(), [&name](const RenderGraphResource &resource)
+            {
+                return resource.name == name;
+            });
+
+            isReleasing |= usedResource == resources.end() ||
+                data.hash != std::hash<TextureCreationInfo>{}(usedResource->creationInfo) ||
+                data.heapOffset != mLayout.offsets[usedResource - resources.begin()];
+        }
+
+        if (isReleasing)
+        {
+            mCommandQueue->WaitForIdle();
+        }
+
+        for (auto iter = mResources.begin(); iter != mResources.end();)
+        {
+            auto isUsed = std::any_of(resources.begin(), resources.end(), [&iter](const RenderGraphResource &resource)
+            {
+                return resource.name == iter->first;
+            });
+
+            if (isUsed)
             {
-                iter->second.hash = hash;
-                iter->second.texture = MakeUnique<Texture>(mDevice, name.string(), textureInfo);
-                mStateTracker->TrackResource(iter->second.texture->D3D12Resource(), D3D12_RESOURCE_STATE_COMMON);
+                ++iter;
+            }
+            else
+            {
+                mStateTracker->UntrackResource(iter->second.texture->D3D12Resource());
+                iter = mResources.erase(iter);
             }
         }
-        else
+
+        if (isHeapTooSmall)
+        {
+            for (auto &[name, data] : mResources)
+            {
+                mStateTracker->UntrackResource(data.texture->D3D12Resource());
+            }
+            mResources.clear();
+
+            CD3DX12_HEAP_DESC heapDesc(mLayout.heapSize, D3D12_HEAP_TYPE_DEFAULT, alignment, D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES);
+            mHeap.Reset();
+            ThrowIfFailed(mDevice->CreateHeap(&heapDesc, IID_PPV_ARGS(&mHeap)));
+            mHeap->SetName(L"Frame Resources Heap");
+
+            mHeapCapacity = mLayout.heapSize;
+            mHeapAlignment = alignment;
+        }
+
+        for (Size i = 0; i < resources.size(); ++i)
         {
+            const auto &resource = resources[i];
+            size_t hash = std::hash<TextureCreationInfo>{}(resource.creationInfo);
+            uint64 heapOffset = mLayout.offsets[i];
+
+            auto iter = mResources.find(resource.name);
+            if (iter != mResources.end())
+            {
+                iter->second.isAliased = mLayout.isAliased[i];
+                if (iter->second.hash == hash && iter->second.heapOffset == heapOffset)
+                {
+                    continue;
+                }
+
+                mStateTracker->UntrackResource(iter->second.texture->D3D12Resource());
+            }
+
             FrameResourceProvider::ResourceData data = {};
             data.hash = hash;
-            data.texture = MakeUnique<Texture>(mDevice, name.string(), textureInfo);
+            data.heapOffset = heapOffset;
+            data.isAliased = mLayout.isAliased[i];
+            data.texture = MakeUnique<Texture>(mDevice, resource.name.string(), resource.creationInfo, mHeap.Get(), heapOffset);
             mStateTracker->TrackResource(data.texture->D3D12Resource(), D3D12_RESOURCE_STATE_COMMON);
-            mResources.emplace(name, std::move(data));
+            mResources.insert_or_assign(resource.name, std::move(data));
         }
     }
 
@@ -44,4 +128,9 @@ namespace Engine::Render
     {
         return  mResources.at(name).texture.get();
     }
+
+    bool FrameResourceProvider::IsAliased(const Name &name) const
+    {
+        return mResources.at(name).isAliased;
+    }
 } // namespace Engine::Render
@@ -4,25 +4,45 @@
 #include <Name.h>
 
 #include <Render/RenderForwards.h>
+#include <Render/ResourceAliasing.h>
 
 #include <d3d12.h>
 #include <unordered_map>
+#include <vector>
 
 namespace Engine::Render
 {
     class FrameResourceProvider
     {
     public:
-        FrameResourceProvider(ComPtr<ID3D12Device> device, GlobalResourceStateTracker* stateTracker);
+        FrameResourceProvider(ComPtr<ID3D12Device> device, SharedPtr<CommandQueue> commandQueue, GlobalResourceStateTracker* stateTracker);
         ~FrameResourceProvider();
 
-        void CreateResource(const Name& name, const TextureCreationInfo& textureInfo);
+        // Places the resources of the frame into one heap, resources whose passes don't overlap share memory.
+        // A resource is only recreated when its description or its place in the heap changes.
+        // Frames in flight may still use what gets released, so releasing waits for the queue to go idle first.
+        void CreateResources(const std::vector<RenderGraphResource>& resources);
 
         Texture* GetTexture(const Name& name) const;
+
+        // Aliased resources need an aliasing barrier before their first pass in every frame.
+        bool IsAliased(const Name& name) const;
+
+        uint64 GetHeapSize() const { return mLayout.heapSize; }
+        uint64 GetNaiveSize() const { return mLayout.naiveSize; }
+
     private:
         ComPtr<ID3D12Device> mDevice;
+        SharedPtr<CommandQueue> mCommandQueue;
         GlobalResourceStateTracker* mStateTracker;
 
+        ComPtr<ID3D12Heap> mHeap;
+        uint64 mHeapCapacity = 0;
+        uint64 mHeapAlignment = 0;
+
+        std::vector<AliasedResourceRequest> mRequests;
+        AliasedResourcesLayout mLayout;
+
         struct ResourceData;
 
         std::unordered_map<Name, ResourceData> mResources;
@@ -30,6 +50,8 @@ namespace Engine::Render
         struct ResourceData
         {
             size_t hash;
+            uint64 heapOffset;
+            bool isAliased;
             UniquePtr<Texture> texture;
         };
     };
@@ -8,10 +8,13 @@
 #include <Render/RootSignatureProvider.h>
 #include <Render/FrameTransientContext.h>
 #include <Render/PipelineStateProvider.h>
+#include <Render/ResourceStateTracker.h>
 
 #include <Memory/DescriptorAllocator.h>
 #include <Memory/DescriptorAllocation.h>
 #include <Memory/DynamicDescriptorHeap.h>
+#include <Memory/VertexBuffer.h>
+#include <Memory/IndexBuffer.h>
 
 #include <d3dx12.h>
 
@@ -40,8 +43,13 @@ namespace Engine::Render
             height = mRenderContext->GetSwapChain()->GetHeight();
         }
 
-        auto screenViewport = CD3DX12_VIEWPORT(0.0f, 0.0f, static_cast<float32>(width), static_cast<float32>(height));
-        auto scissorRect = CD3DX12_RECT(0, 0, width, height);
+        SetViewPort(0, 0, width, height);
+    }
+
+    void PassCommandRecorder::SetViewPort(uint32 x, uint32 y, uint32 width, uint32 height)
+    {
+        auto screenViewport = CD3DX12_VIEWPORT(static_cast<float32>(x), static_cast<float32>(y), static_cast<float32>(width), static_cast<float32>(height));
+        auto scissorRect = CD3DX12_RECT(x, y, x + width, y + height);
 
         mCommandList->RSSetViewports(1, &screenViewport);
         mCommandList->RSSetScissorRects(1, &scissorRect);
@@ -49,15 +57,13 @@ namespace Engine::Render
 
     void PassCommandRecorder::SetRenderTargets(std::vector<Name> renderTargets, const Name& depthStencil)
     {
-        SharedPtr<ResourceStateTracker> stateTrackerSharedPtr(mResourceStateTracker, [](ResourceStateTracker const*){}); //temporary solution
-
         D3D12_CPU_DESCRIPTOR_HANDLE dsDescriptor {0};
 
         if (depthStencil.isValid())
         {
             Render::Texture* dsTexture = mFrameResourceProvider->GetTexture(depthStencil);
             
-            CommandListUtils::TransitionBarrier(stateTrackerSharedPtr, dsTexture->D3D12Resource(), D3D12_RESOURCE_STATE_DEPTH_WRITE);
+            mResourceStateTracker->TransitionResource(dsTexture->D3D12Resource(), D3D12_RESOURCE_STATE_DEPTH_WRITE);
 
             dsDescriptor = dsTexture->GetDSDescriptor(mRenderContext->GetDescriptorAllocator(D3D12_DESCRIPTOR_HEAP_TYPE_DSV).get());
         }
@@ -69,7 +75,7 @@ namespace Engine::Render
         {
             Render::Texture* rtTexture = mFrameResourceProvider->GetTexture(renderTargetName);
 
-            CommandListUtils::TransitionBarrier(stateTrackerSharedPtr, rtTexture->D3D12Resource(), D3D12_RESOURCE_STATE_RENDER_TARGET);
+            mResourceStateTracker->TransitionResource(rtTexture->D3D12Resource(), D3D12_RESOURCE_STATE_RENDER_TARGET);
 
             auto rtDescriptor = rtTexture->GetRTDescriptor(mRenderContext->GetDescriptorAllocator(D3D12_DESCRIPTOR_HEAP_TYPE_RTV).get());
 
@@ -81,11 +87,8 @@ namespace Engine::Render
 
     void PassCommandRecorder::SetBackBufferAsRenderTarget()
     {
-        SharedPtr<ResourceStateTracker> stateTrackerSharedPtr(mResourceStateTracker, [](ResourceStateTracker const*){}); //temporary solution
-
         auto backBufferTexture = mRenderContext->GetSwapChain()->GetCurrentBackBufferTexture();
-        auto backBuffer = backBufferTexture->D3D12ResourceCom();
-        CommandListUtils::TransitionBarrier(stateTrackerSharedPtr, backBuffer.Get(), D3D12_RESOURCE_STATE_RENDER_TARGET);
+        mResourceStateTracker->TransitionResource(backBufferTexture->D3D12Resource(), D3D12_RESOURCE_STATE_RENDER_TARGET);
 
         auto rtv = backBufferTexture->GetRTDescriptor(mRenderContext->GetDescriptorAllocator(D3D12_DESCRIPTOR_HEAP_TYPE_RTV).get());
 
@@ -116,7 +119,7 @@ namespace Engine::Render
     
     void PassCommandRecorder::SetRootSignature(const Name& rootSignature)
     {
-        if (mLastRootSignature == rootSignature)
+        if (!mStateCache.SetRootSignature(rootSignature))
         {
             return;
         }
@@ -125,18 +128,96 @@ namespace Engine::Render
         mCommandList->SetGraphicsRootSignature(rs->GetD3D12RootSignature().Get());
 
         mFrameTransientContext->dynamicDescriptorHeap->ParseRootSignature(rs);
-        mLastRootSignature = rootSignature;
     }
 
     void PassCommandRecorder::SetPipelineState(const Name& pso)
     {
-        if (mLastPSO == pso)
+        if (!mStateCache.SetPipelineState(pso))
         {
             return;
         }
 
         mCommandList->SetPipelineState(mRenderContext->GetPipelineStateProvider()->GetPipelineState(pso).Get());
-        mLastPSO = pso;
+    }
+
+    void PassCommandRecorder::SetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY primitiveTopology)
+    {
+        if (!mStateCache.SetPrimitiveTopology(primitiveTopology))
+        {
+            return;
+        }
+
+        mCommandList->IASetPrimitiveTopology(primitiveTopology);
+    }
+
+    void PassCommandRecorder::SetGraphicsRootConstantBufferView(uint32 rootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS address)
+    {
+        if (!mStateCache.SetRootConstantBufferView(rootParameterIndex, address))
+        {
+            return;
+        }
+
+        mCommandList->SetGraphicsRootConstantBufferView(rootParameterIndex, address);
+    }
+
+    void PassCommandRecorder::SetGraphicsRootShaderResourceView(uint32 rootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS address)
+    {
+        if (!mStateCache.SetRootShaderResourceView(rootParameterIndex, address))
+        {
+            return;
+        }
+
+        mCommandList->SetGraphicsRootShaderResourceView(rootParameterIndex, address);
+    }
+
+    void PassCommandRecorder::SetVertexBuffer(Memory::VertexBuffer& vertexBuffer, uint32 slot)
+    {
+        auto vertexBufferView = vertexBuffer.GetVertexBufferView();
+        if (!mStateCache.SetVertexBuffer(slot, vertexBufferView.BufferLocation))
+        {
+            return;
+        }
+
+        mResourceStateTracker->TransitionResource(vertexBuffer.GetD3D12Resource().Get(), D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
+
+        mCommandList->IASetVertexBuffers(slot, 1, &vertexBufferView);
+    }
+
+    void PassCommandRecorder::SetIndexBuffer(Memory::IndexBuffer& indexBuffer)
+    {
+        auto indexBufferView = indexBuffer.GetIndexBufferView();
+        if (!mStateCache.SetIndexBuffer(indexBufferView.BufferLocation))
+        {
+            return;
+        }
+
+        mResourceStateTracker->TransitionResource(indexBuffer.GetD3D12Resource().Get(), D3D12_RESOURCE_STATE_INDEX_BUFFER);
+
+        mCommandList->IASetIndexBuffer(&indexBufferView);
+    }
+
+    void PassCommandRecorder::SetMaterial(const SharedPtr<Scene::Material>& material)
+    {
+        // Skipping keeps the textures of the material staged, the dynamic descriptor heap copies them again if it moves to a new heap.
+        if (!mStateCache.SetMaterial(material.get()))
+        {
+            return;
+        }
+
+        const uint32 tablesCount = CommandListUtils::BindMaterial(
+            mRenderContext,
+            mCommandList.Get(),
+            mResourceStateTracker,
+            mFrameTransientContext->uploadBuffer.get(),
+            mFrameTransientContext->dynamicDescriptorHeap.get(),
+            *material);
+
+        mStateCache.SetMaterialTablesCount(tablesCount);
+    }
+
+    void PassCommandRecorder::CommitStagedDescriptors()
+    {
+        mStateCache.AddDescriptorTables(mFrameTransientContext->dynamicDescriptorHeap->CommitStagedDescriptors(mRenderContext->Device(), mCommandList));
     }
 
 } // namespace Engine::Render
\ No newline at end of file
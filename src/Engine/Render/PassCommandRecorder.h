@@ -4,6 +4,9 @@
 #include <Name.h>
 
 #include <Render/RenderForwards.h>
+#include <Render/PassStateCache.h>
+#include <Memory/MemoryForwards.h>
+#include <Scene/SceneForwards.h>
 
 #include <d3d12.h>
 #include <vector>
@@ -24,6 +27,7 @@ namespace Engine::Render
         ComPtr<ID3D12GraphicsCommandList> GetD3D12CommandList() const { return mCommandList; }
 
         void SetViewPort(uint32 width = 0, uint32 height = 0);
+        void SetViewPort(uint32 x, uint32 y, uint32 width, uint32 height);
 
         void SetRenderTargets(std::vector<Name> renderTargets, const Name& depthStencil);
         void SetBackBufferAsRenderTarget();
@@ -35,6 +39,18 @@ namespace Engine::Render
 
         void SetPipelineState(const Name& pso);
 
+        // Bindings below skip the commands that would set what is already bound on the command list.
+        void SetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY primitiveTopology);
+        void SetGraphicsRootConstantBufferView(uint32 rootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS address);
+        void SetGraphicsRootShaderResourceView(uint32 rootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS address);
+        void SetVertexBuffer(Memory::VertexBuffer& vertexBuffer, uint32 slot = 0);
+        void SetIndexBuffer(Memory::IndexBuffer& indexBuffer);
+        void SetMaterial(const SharedPtr<Scene::Material>& material);
+
+        void CommitStagedDescriptors();
+
+        const PassCommandStatistics& GetStatistics() const { return mStateCache.GetStatistics(); }
+
     private:
         ComPtr<ID3D12GraphicsCommandList> mCommandList;
         ResourceStateTracker *mResourceStateTracker;
@@ -42,8 +58,7 @@ namespace Engine::Render
         const FrameResourceProvider *mFrameResourceProvider;
         FrameTransientContext* mFrameTransientContext;
 
-        Name mLastRootSignature;
-        Name mLastPSO;
+        PassStateCache mStateCache;
     };
 
 } // namespace Engine::Render
@@ -21,5 +21,9 @@ namespace Engine::Render
         FrameTransientContext  * frameContext;
 
         const Timer * timer;
+
+        // Part of the pass recorded into this command list, out of RenderPassBase::GetCommandListsCount.
+        uint32 commandListIndex;
+        uint32 commandListsCount;
     };
 } // namespace Engine::Render
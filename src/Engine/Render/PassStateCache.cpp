@@ -0,0 +1,138 @@
+#include "PassStateCache.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace Engine::Render
+{
+    PassCommandStatistics &PassCommandStatistics::operator+=(const PassCommandStatistics &other)
+    {
+        pipelineStates += other.pipelineStates;
+        descriptorTables += other.descriptorTables;
+        rootConstantBufferViews += other.rootConstantBufferViews;
+        rootShaderResourceViews += other.rootShaderResourceViews;
+        inputBuffers += other.inputBuffers;
+
+        skippedPipelineStates += other.skippedPipelineStates;
+        skippedDescriptorTables += other.skippedDescriptorTables;
+        skippedRootConstantBufferViews += other.skippedRootConstantBufferViews;
+        skippedRootShaderResourceViews += other.skippedRootShaderResourceViews;
+        skippedInputBuffers += other.skippedInputBuffers;
+
+        return *this;
+    }
+
+    bool PassStateCache::SetRootSignature(const Name &rootSignature)
+    {
+        if (mLastRootSignature == rootSignature)
+        {
+            return false;
+        }
+
+        mLastRootSignature = rootSignature;
+
+        std::fill(std::begin(mLastRootConstantBufferViews), std::end(mLastRootConstantBufferViews), 0);
+        std::fill(std::begin(mLastRootShaderResourceViews), std::end(mLastRootShaderResourceViews), 0);
+        mLastMaterial = nullptr;
+
+        return true;
+    }
+
+    bool PassStateCache::SetPipelineState(const Name &pso)
+    {
+        if (mLastPSO == pso)
+        {
+            ++mStatistics.skippedPipelineStates;
+            return false;
+        }
+
+        mLastPSO = pso;
+        ++mStatistics.pipelineStates;
+        return true;
+    }
+
+    bool PassStateCache::SetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY primitiveTopology)
+    {
+        if (mLastPrimitiveTopology == primitiveTopology)
+        {
+            return false;
+        }
+
+        mLastPrimitiveTopology = primitiveTopology;
+        return true;
+    }
+
+    bool PassStateCache::SetRootConstantBufferView(uint32 rootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS address)
+    {
+        if (mLastRootConstantBufferViews[rootParameterIndex] == address)
+        {
+            ++mStatistics.skippedRootConstantBufferViews;
+            return false;
+        }
+
+        // Overwrites the uniform of the bound material, the next one has to be bound again even if it is the same.
+        if (rootParameterIndex == MaterialRootParameterIndex)
+        {
+            mLastMaterial = nullptr;
+        }
+
+        mLastRootConstantBufferViews[rootParameterIndex] = address;
+        ++mStatistics.rootConstantBufferViews;
+        return true;
+    }
+
+    bool PassStateCache::SetRootShaderResourceView(uint32 rootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS address)
+    {
+        if (mLastRootShaderResourceViews[rootParameterIndex] == address)
+        {
+            ++mStatistics.skippedRootShaderResourceViews;
+            return false;
+        }
+
+        mLastRootShaderResourceViews[rootParameterIndex] = address;
+        ++mStatistics.rootShaderResourceViews;
+        return true;
+    }
+
+    bool PassStateCache::SetVertexBuffer(uint32 slot, D3D12_GPU_VIRTUAL_ADDRESS address)
+    {
+        if (mLastVertexBuffers[slot] == address)
+        {
+            ++mStatistics.skippedInputBuffers;
+            return false;
+        }
+
+        mLastVertexBuffers[slot] = address;
+        ++mStatistics.inputBuffers;
+        return true;
+    }
+
+    bool PassStateCache::SetIndexBuffer(D3D12_GPU_VIRTUAL_ADDRESS address)
+    {
+        if (mLastIndexBuffer == address)
+        {
+            ++mStatistics.skippedInputBuffers;
+            return false;
+        }
+
+        mLastIndexBuffer = address;
+        ++mStatistics.inputBuffers;
+        return true;
+    }
+
+    bool PassStateCache::SetMaterial(const Scene::Material *material)
+    {
+        if (mLastMaterial == material)
+        {
+            ++mStatistics.skippedRootConstantBufferViews;
+            mStatistics.skippedDescriptorTables += mLastMaterialTablesCount;
+            return false;
+        }
+
+        // The uniform is a new upload allocation, so no later address can match the one recorded before.
+        mLastMaterial = material;
+        mLastRootConstantBufferViews[MaterialRootParameterIndex] = 0;
+        ++mStatistics.rootConstantBufferViews;
+        return true;
+    }
+} // namespace Engine::Render
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Types.h>
+#include <Name.h>
+
+#include <Scene/SceneForwards.h>
+
+#include <d3d12.h>
+
+namespace Engine::Render
+{
+    // State changes recorded on a command list, and the ones dropped because they set what was already bound.
+    struct PassCommandStatistics
+    {
+        uint32 pipelineStates = 0;
+        uint32 descriptorTables = 0;
+        uint32 rootConstantBufferViews = 0;
+        uint32 rootShaderResourceViews = 0;
+        uint32 inputBuffers = 0;
+
+        uint32 skippedPipelineStates = 0;
+        uint32 skippedDescriptorTables = 0;
+        uint32 skippedRootConstantBufferViews = 0;
+        uint32 skippedRootShaderResourceViews = 0;
+        uint32 skippedInputBuffers = 0;
+
+        PassCommandStatistics &operator+=(const PassCommandStatistics &other);
+    };
+
+    // What is bound on a command list, so PassCommandRecorder can skip the commands that would set it again.
+    // Every setter returns true when the command has to be recorded and counts it in the statistics.
+    class PassStateCache
+    {
+    public:
+        // Root parameter of the material uniform, its textures go to the tables after it.
+        static constexpr uint32 MaterialRootParameterIndex = 2;
+
+        // Root arguments don't survive a root signature change, the other state does.
+        bool SetRootSignature(const Name &rootSignature);
+        bool SetPipelineState(const Name &pso);
+        bool SetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY primitiveTopology);
+        bool SetRootConstantBufferView(uint32 rootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS address);
+        bool SetRootShaderResourceView(uint32 rootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS address);
+        bool SetVertexBuffer(uint32 slot, D3D12_GPU_VIRTUAL_ADDRESS address);
+        bool SetIndexBuffer(D3D12_GPU_VIRTUAL_ADDRESS address);
+
+        // A recorded material binds its uniform and stages tablesCount tables, a skipped one counts them as skipped.
+        bool SetMaterial(const Scene::Material *material);
+        void SetMaterialTablesCount(uint32 tablesCount) { mLastMaterialTablesCount = tablesCount; }
+
+        void AddDescriptorTables(uint32 tablesCount) { mStatistics.descriptorTables += tablesCount; }
+
+        const PassCommandStatistics &GetStatistics() const { return mStatistics; }
+
+    private:
+        Name mLastRootSignature;
+        Name mLastPSO;
+
+        D3D12_PRIMITIVE_TOPOLOGY mLastPrimitiveTopology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+        D3D12_GPU_VIRTUAL_ADDRESS mLastRootConstantBufferViews[D3D12_MAX_ROOT_COST] = {};
+        D3D12_GPU_VIRTUAL_ADDRESS mLastRootShaderResourceViews[D3D12_MAX_ROOT_COST] = {};
+        D3D12_GPU_VIRTUAL_ADDRESS mLastVertexBuffers[D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT] = {};
+        D3D12_GPU_VIRTUAL_ADDRESS mLastIndexBuffer = 0;
+        const Scene::Material *mLastMaterial = nullptr;
+        uint32 mLastMaterialTablesCount = 0;
+
+        PassCommandStatistics mStatistics;
+    };
+} // namespace Engine::Render
@@ -41,13 +41,7 @@ namespace Engine::Render::Passes
 
     void CubePass::PrepareResources(Render::ResourcePlanner* planner)
     {
-        float clear[4] = {0};
-        Render::TextureCreationInfo rtTexture = {
-            .description = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R16G16B16A16_FLOAT, 0, 0, 1, 1, 1, 0, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET),
-            .clearValue = CD3DX12_CLEAR_VALUE(DXGI_FORMAT_R16G16B16A16_FLOAT, clear)
-        };
-        planner->NewRenderTarget(ResourceNames::CubeOutput, rtTexture);
-
+        planner->WriteRenderTarget(ResourceNames::ForwardOutput);
         planner->ReadDeptStencil(ResourceNames::ForwardDepth);
     }
 
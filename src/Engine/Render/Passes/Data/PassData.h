@@ -5,6 +5,7 @@
 #include <Scene/PunctualLight.h>
 #include <Scene/Camera.h>
 #include <Scene/CubeMap.h>
+#include <Scene/MeshletCulling.h>
 
 #include <DirectXMath.h>
 #include <DirectXCollision.h>
@@ -15,12 +16,19 @@ namespace Engine::Render::Passes
     {
         Scene::Mesh mesh;
         dx::XMMATRIX worldTransform;
+        // Visible index ranges in the pass draw ranges.
+        uint32 firstDrawRange = 0;
+        uint32 drawRangesCount = 0;
+        // Orders the draws of a pass to change as little state as possible between them.
+        uint64 sortKey = 0;
     };
 
     struct LightData
     {
         Scene::PunctualLight light;
         dx::XMMATRIX worldTransform;
+        // First of the pass shadow transforms of the light, one per shadow view, negative without shadows.
+        int32 firstShadowTransform = -1;
     };
 
     struct CameraData
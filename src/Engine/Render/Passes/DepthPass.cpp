@@ -72,7 +72,7 @@ namespace Engine::Render::Passes
 
         PipelineStateProxy pipelineState = {
             .rootSignatureName = RootSignatureNames::Depth,
-            .inputLayout = Scene::Vertex::GetInputLayout(),
+            .inputLayout = Scene::Vertex::GetInputLayout(Scene::VertexFormat::Full, EngineConfig::SplitPositionStream),
             .primitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE,
             .vertexShaderName = Shaders::DepthVS,
             .pixelShaderName = Shaders::DepthPS,
@@ -82,6 +82,22 @@ namespace Engine::Render::Passes
             .depthStencil = CD3DX12_DEPTH_STENCIL_DESC{D3D12_DEFAULT}
         };
         pipelineStateProvider->CreatePipelineState(PSONames::Depth, pipelineState);
+
+        PipelineStateProxy compactPipelineState = pipelineState;
+        compactPipelineState.inputLayout = Scene::Vertex::GetInputLayout(Scene::VertexFormat::Compact, EngineConfig::SplitPositionStream);
+        compactPipelineState.shaderDefines = {{"COMPACT_VERTEX", "1"}};
+        pipelineStateProvider->CreatePipelineState(PSONames::DepthCompact, compactPipelineState);
+
+        // Opaque meshes with a split position stream fetch only positions and need no pixel shader.
+        PipelineStateProxy positionPipelineState = pipelineState;
+        positionPipelineState.inputLayout = Scene::Vertex::GetPositionInputLayout(Scene::VertexFormat::Full);
+        positionPipelineState.pixelShaderName = {};
+        positionPipelineState.shaderDefines = {{"POSITION_ONLY", "1"}};
+        pipelineStateProvider->CreatePipelineState(PSONames::DepthPositionOnly, positionPipelineState);
+
+        positionPipelineState.inputLayout = Scene::Vertex::GetPositionInputLayout(Scene::VertexFormat::Compact);
+        positionPipelineState.shaderDefines = {{"POSITION_ONLY", "1"}, {"COMPACT_VERTEX", "1"}};
+        pipelineStateProvider->CreatePipelineState(PSONames::DepthPositionOnlyCompact, positionPipelineState);
     }
 
     void DepthPass::Render(Render::PassContext& passContext)
@@ -92,35 +108,38 @@ namespace Engine::Render::Passes
 
         auto commandRecorder = passContext.commandRecorder;
 
-        commandRecorder->SetViewPort(EngineConfig::ShadowWidth, EngineConfig::ShadowHeight);
-
         commandRecorder->SetRenderTargets({}, ResourceNames::ShadowDepth);
 
         commandRecorder->ClearDepthStencil(ResourceNames::ShadowDepth);
 
         commandRecorder->SetRootSignature(RootSignatureNames::Depth);
 
-        auto& camera = PassData().camera;
-        auto cb = CommandListUtils::GetFrameUniform(camera.viewProjection, camera.eyePosition, 0);
+        for (auto &view : PassData().views)
+        {
+            commandRecorder->SetViewPort(view.tile.x, view.tile.y, view.tile.z, view.tile.z);
 
-        auto cbAllocation = passContext.frameContext->uploadBuffer->Allocate(sizeof(FrameUniform));
-        cbAllocation.CopyTo(&cb);
+            auto cb = CommandListUtils::GetFrameUniform(view.camera.viewProjection, view.camera.eyePosition, 0);
 
-        commandList->SetGraphicsRootConstantBufferView(1, cbAllocation.GPU);
+            auto cbAllocation = passContext.frameContext->uploadBuffer->Allocate(sizeof(FrameUniform));
+            cbAllocation.CopyTo(&cb);
 
-        auto& meshes = PassData().meshes;
-        for (auto &mesh : meshes)
-        {
-            Draw(commandList, mesh.mesh, mesh.worldTransform, passContext);
+            commandList->SetGraphicsRootConstantBufferView(1, cbAllocation.GPU);
+
+            auto meshes = std::span(PassData().meshes).subspan(view.firstMesh, view.meshesCount);
+            for (auto &mesh : meshes)
+            {
+                auto drawRanges = std::span(PassData().drawRanges).subspan(mesh.firstDrawRange, mesh.drawRangesCount);
+                Draw(commandList, mesh.mesh, mesh.worldTransform, drawRanges, passContext);
+            }
         }
     }
 
-    void DepthPass::Draw(ComPtr<ID3D12GraphicsCommandList> commandList, const Scene::Mesh &mesh, const dx::XMMATRIX &world, Render::PassContext &passContext)
+    void DepthPass::Draw(ComPtr<ID3D12GraphicsCommandList> commandList, const Scene::Mesh &mesh, const dx::XMMATRIX &world, std::span<const Scene::MeshletCulling::DrawRange> drawRanges, Render::PassContext &passContext)
     {
         auto renderContext = passContext.renderContext;
         auto commandRecorder = passContext.commandRecorder;
 
-        auto cb = CommandListUtils::GetMeshUniform(world);
+        auto cb = CommandListUtils::GetMeshUniform(world, mesh);
         auto cbAllocation = passContext.frameContext->uploadBuffer->Allocate(sizeof(MeshUniform));
         cbAllocation.CopyTo(&cb);
 
@@ -129,7 +148,26 @@ namespace Engine::Render::Passes
         auto dynamicDescriptorHeap = passContext.frameContext->dynamicDescriptorHeap;
         auto resourceStateTracker = passContext.resourceStateTracker;
 
-        commandRecorder->SetPipelineState(PSONames::Depth);
+        bool isCompact = mesh.vertexFormat == Scene::VertexFormat::Compact;
+        bool isPositionOnly = mesh.positionBuffer && mesh.material->GetProperties().alphaMode == Scene::AlphaMode::Opaque;
+
+        if (isPositionOnly)
+        {
+            commandRecorder->SetPipelineState(isCompact ? PSONames::DepthPositionOnlyCompact : PSONames::DepthPositionOnly);
+
+            commandList->IASetPrimitiveTopology(mesh.primitiveTopology);
+
+            CommandListUtils::BindVertexBuffer(commandList, resourceStateTracker, *mesh.positionBuffer);
+            CommandListUtils::BindIndexBuffer(commandList, resourceStateTracker, *mesh.indexBuffer);
+
+            for (const auto &range : drawRanges)
+            {
+                commandList->DrawIndexedInstanced(range.indexCount, 1, range.indexOffset, 0, 0);
+            }
+            return;
+        }
+
+        commandRecorder->SetPipelineState(isCompact ? PSONames::DepthCompact : PSONames::Depth);
 
         commandList->IASetPrimitiveTopology(mesh.primitiveTopology);
 
@@ -151,11 +189,22 @@ namespace Engine::Render::Passes
             dynamicDescriptorHeap->StageDescriptor(3, 0, 1, mesh.material->GetBaseColorTexture()->GetShaderResourceView(device, descriptorAllocator));
         }
 
-        CommandListUtils::BindVertexBuffer(commandList, resourceStateTracker, *mesh.vertexBuffer);
+        if (mesh.positionBuffer)
+        {
+            CommandListUtils::BindVertexBuffer(commandList, resourceStateTracker, *mesh.positionBuffer, 0);
+            CommandListUtils::BindVertexBuffer(commandList, resourceStateTracker, *mesh.vertexBuffer, 1);
+        }
+        else
+        {
+            CommandListUtils::BindVertexBuffer(commandList, resourceStateTracker, *mesh.vertexBuffer);
+        }
         CommandListUtils::BindIndexBuffer(commandList, resourceStateTracker, *mesh.indexBuffer);
 
         dynamicDescriptorHeap->CommitStagedDescriptors(renderContext->Device(), commandList);
 
-        commandList->DrawIndexedInstanced(static_cast<uint32>(mesh.indexBuffer->GetElementsCount()), 1, 0, 0, 0);
+        for (const auto &range : drawRanges)
+        {
+            commandList->DrawIndexedInstanced(range.indexCount, 1, range.indexOffset, 0, 0);
+        }
     }
 } // namespace Engine::Render::Passes
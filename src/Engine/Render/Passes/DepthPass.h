@@ -6,14 +6,27 @@
 
 #include <DirectXMath.h>
 #include <d3d12.h>
+#include <span>
 #include <vector>
 
 namespace Engine::Render::Passes
 {
-    struct DepthPassData
+    struct ShadowViewData
     {
         CameraData camera;
+        // Tile of the shadow atlas, offset and size in texels.
+        dx::XMUINT3 tile;
+        // Meshes of the view in the pass meshes.
+        uint32 firstMesh = 0;
+        uint32 meshesCount = 0;
+    };
+
+    struct DepthPassData
+    {
+        // Cascades of the directional light, then every view of the spot and point lights.
+        std::vector<ShadowViewData> views;
         std::vector<MeshData> meshes;
+        std::vector<Scene::MeshletCulling::DrawRange> drawRanges;
     };
 
     class DepthPass : public RenderPassBaseWithData<DepthPassData>
@@ -31,7 +44,7 @@ namespace Engine::Render::Passes
         void Render(Render::PassContext& passContext) override;
 
     private:
-        void Draw(ComPtr<ID3D12GraphicsCommandList> commandList, const Scene::Mesh& node, const dx::XMMATRIX& world, Render::PassContext& passContext);
+        void Draw(ComPtr<ID3D12GraphicsCommandList> commandList, const Scene::Mesh& node, const dx::XMMATRIX& world, std::span<const Scene::MeshletCulling::DrawRange> drawRanges, Render::PassContext& passContext);
     };
 
 } // namespace Engine
\ No newline at end of file
@@ -5,6 +5,8 @@
 
 #include <Render/Passes/Names.h>
 
+#include <EngineConfig.h>
+
 #include <Scene/SceneObject.h>
 #include <Scene/Mesh.h>
 #include <Scene/Material.h>
@@ -37,6 +39,7 @@
 #include <Memory/DynamicDescriptorHeap.h>
 
 #include <DirectXTex.h>
+#include <algorithm>
 #include <DirectXMath.h>
 #include <d3d12.h>
 
@@ -61,7 +64,10 @@ namespace Engine::Render::Passes
             .AddSRVDescriptorTableParameter(2, 0, D3D12_SHADER_VISIBILITY_PIXEL)
             .AddSRVDescriptorTableParameter(3, 0, D3D12_SHADER_VISIBILITY_PIXEL)
             .AddSRVDescriptorTableParameter(4, 0, D3D12_SHADER_VISIBILITY_PIXEL)
-            .AddSRVDescriptorTableParameter(5, 0, D3D12_SHADER_VISIBILITY_PIXEL);
+            .AddSRVDescriptorTableParameter(5, 0, D3D12_SHADER_VISIBILITY_PIXEL)
+            .AddSRVParameter(1, 1, D3D12_SHADER_VISIBILITY_PIXEL)
+            .AddSRVParameter(2, 1, D3D12_SHADER_VISIBILITY_PIXEL)
+            .AddSRVParameter(3, 1, D3D12_SHADER_VISIBILITY_PIXEL);
 
         rootSignatureProvider->BuildRootSignature(RootSignatureNames::Forward, builder);
     }
@@ -74,7 +80,7 @@ namespace Engine::Render::Passes
 
         Render::PipelineStateProxy pipelineStateCullModeBack = {
             .rootSignatureName = RootSignatureNames::Forward,
-            .inputLayout = Scene::Vertex::GetInputLayout(),
+            .inputLayout = Scene::Vertex::GetInputLayout(Scene::VertexFormat::Full, EngineConfig::SplitPositionStream),
             .primitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE,
             .vertexShaderName = Shaders::ForwardVS,
             .pixelShaderName = Shaders::ForwardPS,
@@ -90,6 +96,14 @@ namespace Engine::Render::Passes
 
         pipelineStateProvider->CreatePipelineState(PSONames::ForwardCullBack, pipelineStateCullModeBack);
         pipelineStateProvider->CreatePipelineState(PSONames::ForwardCullNone, pipelineStateCullModeNone);
+
+        pipelineStateCullModeBack.inputLayout = Scene::Vertex::GetInputLayout(Scene::VertexFormat::Compact, EngineConfig::SplitPositionStream);
+        pipelineStateCullModeBack.shaderDefines = {{"COMPACT_VERTEX", "1"}};
+        pipelineStateCullModeNone.inputLayout = pipelineStateCullModeBack.inputLayout;
+        pipelineStateCullModeNone.shaderDefines = pipelineStateCullModeBack.shaderDefines;
+
+        pipelineStateProvider->CreatePipelineState(PSONames::ForwardCullBackCompact, pipelineStateCullModeBack);
+        pipelineStateProvider->CreatePipelineState(PSONames::ForwardCullNoneCompact, pipelineStateCullModeNone);
     }
 
     void ForwardPass::PrepareResources(Render::ResourcePlanner* planner)
@@ -110,65 +124,56 @@ namespace Engine::Render::Passes
             .clearValue = CD3DX12_CLEAR_VALUE(DXGI_FORMAT_R16G16B16A16_FLOAT, clear)
         };
         planner->NewRenderTarget(ResourceNames::ForwardOutput, rtTexture);
+
+        planner->ReadTexture(ResourceNames::ShadowDepth);
     }
 
-    void ForwardPass::Draw(ComPtr<ID3D12GraphicsCommandList> commandList, const Scene::Mesh &mesh, const dx::XMMATRIX &world, Render::PassContext &passContext)
+    void ForwardPass::Draw(ComPtr<ID3D12GraphicsCommandList> commandList, const Scene::Mesh &mesh, const dx::XMMATRIX &world, std::span<const Scene::MeshletCulling::DrawRange> drawRanges, Render::PassContext &passContext)
     {
-        auto renderContext = passContext.renderContext;
         auto commandRecorder = passContext.commandRecorder;
 
-        auto cb = CommandListUtils::GetMeshUniform(world);
+        auto cb = CommandListUtils::GetMeshUniform(world, mesh);
         auto cbAllocation = passContext.frameContext->uploadBuffer->Allocate(sizeof(MeshUniform));
         cbAllocation.CopyTo(&cb);
 
-        commandList->SetGraphicsRootConstantBufferView(0, cbAllocation.GPU);
-
-        auto dynamicDescriptorHeap = passContext.frameContext->dynamicDescriptorHeap;
-        auto resourceStateTracker = passContext.resourceStateTracker;
+        commandRecorder->SetGraphicsRootConstantBufferView(0, cbAllocation.GPU);
 
+        bool isCompact = mesh.vertexFormat == Scene::VertexFormat::Compact;
         if (mesh.material->GetProperties().doubleSided)
         {
-            commandRecorder->SetPipelineState(PSONames::ForwardCullNone);
+            commandRecorder->SetPipelineState(isCompact ? PSONames::ForwardCullNoneCompact : PSONames::ForwardCullNone);
         }
         else
         {
-            commandRecorder->SetPipelineState(PSONames::ForwardCullBack);
+            commandRecorder->SetPipelineState(isCompact ? PSONames::ForwardCullBackCompact : PSONames::ForwardCullBack);
         }
 
-        commandList->IASetPrimitiveTopology(mesh.primitiveTopology);
+        commandRecorder->SetPrimitiveTopology(mesh.primitiveTopology);
 
-        CommandListUtils::BindMaterial(
-            renderContext,
-            commandList,
-            resourceStateTracker,
-            passContext.frameContext->uploadBuffer,
-            dynamicDescriptorHeap,
-            mesh.material);
-        CommandListUtils::BindVertexBuffer(commandList, resourceStateTracker, *mesh.vertexBuffer);
-        CommandListUtils::BindIndexBuffer(commandList, resourceStateTracker, *mesh.indexBuffer);
+        commandRecorder->SetMaterial(mesh.material);
+        if (mesh.positionBuffer)
+        {
+            commandRecorder->SetVertexBuffer(*mesh.positionBuffer, 0);
+            commandRecorder->SetVertexBuffer(*mesh.vertexBuffer, 1);
+        }
+        else
+        {
+            commandRecorder->SetVertexBuffer(*mesh.vertexBuffer);
+        }
+        commandRecorder->SetIndexBuffer(*mesh.indexBuffer);
 
-        dynamicDescriptorHeap->CommitStagedDescriptors(renderContext->Device(), commandList);
+        commandRecorder->CommitStagedDescriptors();
 
-        commandList->DrawIndexedInstanced(static_cast<uint32>(mesh.indexBuffer->GetElementsCount()), 1, 0, 0, 0);
+        for (const auto &range : drawRanges)
+        {
+            commandList->DrawIndexedInstanced(range.indexCount, 1, range.indexOffset, 0, 0);
+        }
     }
 
-    void ForwardPass::Render(Render::PassContext &passContext)
+    void ForwardPass::PrepareRender(Render::PassContext &passContext)
     {
         auto renderContext = passContext.renderContext;
 
-        auto commandList = passContext.commandList;
-
-        auto commandRecorder = passContext.commandRecorder;
-
-        commandRecorder->SetViewPort();
-
-        commandRecorder->SetRenderTargets({ResourceNames::ForwardOutput}, ResourceNames::ForwardDepth);
-
-        commandRecorder->ClearRenderTargets({ResourceNames::ForwardOutput});
-        commandRecorder->ClearDepthStencil(ResourceNames::ForwardDepth);
-
-        commandRecorder->SetRootSignature(RootSignatureNames::Forward);
-
         auto& lightsData = PassData().lights;
         std::vector<LightUniform> lights;
         lights.reserve(lightsData.size());
@@ -176,28 +181,62 @@ namespace Engine::Render::Passes
         for (auto& lightData : lightsData)
         {
             LightUniform light = CommandListUtils::GetLightUniform(lightData.light, lightData.worldTransform);
+            light.FirstShadowTransform = lightData.firstShadowTransform;
             lights.emplace_back(light);
         }
 
         auto& camera = PassData().camera;
         auto cb = CommandListUtils::GetFrameUniform(camera.viewProjection, camera.eyePosition, static_cast<uint32>(lights.size()));
-        cb.ShadowTransform = PassData().shadowTransform;
+
+        const auto& cascadeTransforms = PassData().cascadeTransforms;
+        const auto& cascadeSplits = PassData().cascadeSplits;
+        float32 splits[MAX_SHADOW_CASCADES] = {};
+
+        cb.CascadesCount = static_cast<int>(std::min<Size>(cascadeTransforms.size(), MAX_SHADOW_CASCADES));
+        for (int i = 0; i < cb.CascadesCount; ++i)
+        {
+            cb.CascadeTransforms[i] = cascadeTransforms[i];
+            splits[i] = cascadeSplits[i];
+        }
+        cb.CascadeSplits = float4(splits[0], splits[1], splits[2], splits[3]);
+
+        const float32 width = static_cast<float32>(renderContext->GetSwapChain()->GetWidth());
+        const float32 height = static_cast<float32>(renderContext->GetSwapChain()->GetHeight());
+        cb.ClusterTileScale = float2(EngineConfig::LightClustersWidth / width, EngineConfig::LightClustersHeight / height);
+        cb.ClusterDepthScale = PassData().clusterDepthScale;
+        cb.ClusterDepthBias = PassData().clusterDepthBias;
+        cb.ClusterGridX = EngineConfig::LightClustersWidth;
+        cb.ClusterGridY = EngineConfig::LightClustersHeight;
+        cb.ClusterGridZ = EngineConfig::LightClustersDepth;
+        cb.GlobalLightsCount = static_cast<int>(PassData().globalLightsCount);
 
         auto cbAllocation = passContext.frameContext->uploadBuffer->Allocate(sizeof(FrameUniform));
         cbAllocation.CopyTo(&cb);
+        mFrameUniformAddress = cbAllocation.GPU;
 
-        commandList->SetGraphicsRootConstantBufferView(1, cbAllocation.GPU);
+        // Root views only need 16 byte alignment, the upload buffer aligns to powers of two.
+        auto lightsAllocation = passContext.frameContext->uploadBuffer->Allocate(std::max<Size>(lights.size(), 1) * sizeof(LightUniform), 16);
+        lightsAllocation.CopyTo(lights);
+        mLightsAddress = lightsAllocation.GPU;
 
-        auto lightsAllocation = passContext.frameContext->uploadBuffer->Allocate(lights.size() * sizeof(LightUniform), sizeof(LightUniform));
+        // The buffer is bound even without shadow casting lights.
+        const auto& shadowTransforms = PassData().shadowTransforms;
+        auto shadowTransformsAllocation = passContext.frameContext->uploadBuffer->Allocate(std::max<Size>(shadowTransforms.size(), 1) * sizeof(float4x4), sizeof(float4x4));
+        shadowTransformsAllocation.CopyTo(shadowTransforms);
+        mShadowTransformsAddress = shadowTransformsAllocation.GPU;
 
-        lightsAllocation.CopyTo(lights);
+        const auto& clusters = PassData().clusters;
+        auto clustersAllocation = passContext.frameContext->uploadBuffer->Allocate(std::max<Size>(clusters.size(), 1) * sizeof(dx::XMUINT2), 16);
+        clustersAllocation.CopyTo(clusters);
+        mClustersAddress = clustersAllocation.GPU;
 
-        commandList->SetGraphicsRootShaderResourceView(3, lightsAllocation.GPU);
+        const auto& clusterLightIndices = PassData().clusterLightIndices;
+        auto clusterLightIndicesAllocation = passContext.frameContext->uploadBuffer->Allocate(std::max<Size>(clusterLightIndices.size(), 1) * sizeof(uint32), 16);
+        clusterLightIndicesAllocation.CopyTo(clusterLightIndices);
+        mClusterLightIndicesAddress = clusterLightIndicesAllocation.GPU;
 
         auto* depth = passContext.frameResourceProvider->GetTexture(ResourceNames::ShadowDepth);
 
-        CommandListUtils::TransitionBarrier(passContext.resourceStateTracker, depth->D3D12ResourceCom(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-
         D3D12_SHADER_RESOURCE_VIEW_DESC desc = {};
         desc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
         desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
@@ -205,14 +244,55 @@ namespace Engine::Render::Passes
         desc.TextureCube.MipLevels = depth->D3D12Resource()->GetDesc().MipLevels;
         desc.TextureCube.ResourceMinLODClamp = 0.0f;
         desc.Format = DXGI_FORMAT_R32_FLOAT;
-        auto srv = depth->GetSRDescriptor(renderContext->GetDescriptorAllocator(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV).get(), &desc);
+        mShadowDepthSRV = depth->GetSRDescriptor(renderContext->GetDescriptorAllocator(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV).get(), &desc);
+    }
+
+    uint32 ForwardPass::GetCommandListsCount() const
+    {
+        const Size count = PassData().meshes.size() / EngineConfig::MinDrawsPerCommandList;
+        return static_cast<uint32>(std::clamp<Size>(count, 1, EngineConfig::MaxCommandListsPerPass));
+    }
 
-        passContext.frameContext->dynamicDescriptorHeap->StageDescriptor(9, 0, 1, srv);
+    void ForwardPass::Render(Render::PassContext &passContext)
+    {
+        auto commandList = passContext.commandList;
+
+        auto commandRecorder = passContext.commandRecorder;
+
+        commandRecorder->SetViewPort();
+
+        commandRecorder->SetRenderTargets({ResourceNames::ForwardOutput}, ResourceNames::ForwardDepth);
+
+        // Command lists of the pass run in order, the first one clears for all of them.
+        if (passContext.commandListIndex == 0)
+        {
+            commandRecorder->ClearRenderTargets({ResourceNames::ForwardOutput});
+            commandRecorder->ClearDepthStencil(ResourceNames::ForwardDepth);
+        }
+
+        commandRecorder->SetRootSignature(RootSignatureNames::Forward);
+
+        commandRecorder->SetGraphicsRootConstantBufferView(1, mFrameUniformAddress);
+        commandRecorder->SetGraphicsRootShaderResourceView(3, mLightsAddress);
+        commandRecorder->SetGraphicsRootShaderResourceView(10, mShadowTransformsAddress);
+        commandRecorder->SetGraphicsRootShaderResourceView(11, mClustersAddress);
+        commandRecorder->SetGraphicsRootShaderResourceView(12, mClusterLightIndicesAddress);
+
+        auto* depth = passContext.frameResourceProvider->GetTexture(ResourceNames::ShadowDepth);
+
+        CommandListUtils::TransitionBarrier(passContext.resourceStateTracker, depth->D3D12ResourceCom(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+
+        passContext.frameContext->dynamicDescriptorHeap->StageDescriptor(9, 0, 1, mShadowDepthSRV);
 
         auto& meshes = PassData().meshes;
-        for (auto &mesh : meshes)
+        const Size firstMesh = meshes.size() * passContext.commandListIndex / passContext.commandListsCount;
+        const Size lastMesh = meshes.size() * (passContext.commandListIndex + 1) / passContext.commandListsCount;
+
+        for (Size i = firstMesh; i < lastMesh; ++i)
         {
-            Draw(commandList, mesh.mesh, mesh.worldTransform, passContext);
+            auto &mesh = meshes[i];
+            auto drawRanges = std::span(PassData().drawRanges).subspan(mesh.firstDrawRange, mesh.drawRangesCount);
+            Draw(commandList, mesh.mesh, mesh.worldTransform, drawRanges, passContext);
         }
     }
 
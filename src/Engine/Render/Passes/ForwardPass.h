@@ -6,6 +6,7 @@
 
 #include <DirectXMath.h>
 #include <d3d12.h>
+#include <span>
 #include <vector>
 
 namespace Engine::Render::Passes
@@ -14,8 +15,19 @@ namespace Engine::Render::Passes
     {
         CameraData camera;
         std::vector<MeshData> meshes;
+        std::vector<Scene::MeshletCulling::DrawRange> drawRanges;
         std::vector<LightData> lights;
-        dx::XMFLOAT4X4 shadowTransform;
+        std::vector<dx::XMFLOAT4X4> cascadeTransforms;
+        std::vector<float32> cascadeSplits;
+        // World to shadow atlas texture space of every spot light and point light cube face.
+        std::vector<dx::XMFLOAT4X4> shadowTransforms;
+        // Lights before this reach every pixel, the rest are listed by the clusters they touch.
+        uint32 globalLightsCount = 0;
+        // Offset into the cluster light indices and lights count of every cluster.
+        std::vector<dx::XMUINT2> clusters;
+        std::vector<uint32> clusterLightIndices;
+        float32 clusterDepthScale = 0.0f;
+        float32 clusterDepthBias = 0.0f;
     };
 
     class ForwardPass : public RenderPassBaseWithData<ForwardPassData>
@@ -30,11 +42,24 @@ namespace Engine::Render::Passes
 
         void CreatePipelineStates(Render::PipelineStateProvider* pipelineStateProvider) override;
 
+        void PrepareRender(Render::PassContext& passContext) override;
+
+        uint32 GetCommandListsCount() const override;
+
         void Render(Render::PassContext& passContext) override;
 
     private:
 
-        void Draw(ComPtr<ID3D12GraphicsCommandList> commandList, const Scene::Mesh& node, const dx::XMMATRIX& world, Render::PassContext& passContext);
+        void Draw(ComPtr<ID3D12GraphicsCommandList> commandList, const Scene::Mesh& node, const dx::XMMATRIX& world, std::span<const Scene::MeshletCulling::DrawRange> drawRanges, Render::PassContext& passContext);
+
+    private:
+        // Frame data uploaded once and bound by every command list of the pass.
+        D3D12_GPU_VIRTUAL_ADDRESS mFrameUniformAddress = 0;
+        D3D12_GPU_VIRTUAL_ADDRESS mLightsAddress = 0;
+        D3D12_GPU_VIRTUAL_ADDRESS mShadowTransformsAddress = 0;
+        D3D12_GPU_VIRTUAL_ADDRESS mClustersAddress = 0;
+        D3D12_GPU_VIRTUAL_ADDRESS mClusterLightIndicesAddress = 0;
+        D3D12_CPU_DESCRIPTOR_HANDLE mShadowDepthSRV = {};
     };
 
 } // namespace Engine
\ No newline at end of file
@@ -24,7 +24,6 @@ namespace Engine::Render::Passes
     namespace ResourceNames
     {
         inline Name ForwardOutput {"ForwardOutput"};
-        inline Name CubeOutput {"CubeOutput"};
         inline Name ForwardDepth {"ForwardDepth"};
         inline Name ShadowDepth {"Depth::Shadow"};
     }
@@ -33,11 +32,16 @@ namespace Engine::Render::Passes
     {
         inline Name ForwardCullBack {"Forward::PSO::CullModeBack"};
         inline Name ForwardCullNone {"Forward::PSO::CullModeNone"};
+        inline Name ForwardCullBackCompact {"Forward::PSO::CullModeBack::CompactVertex"};
+        inline Name ForwardCullNoneCompact {"Forward::PSO::CullModeNone::CompactVertex"};
 
         inline Name ToneMapping {"ToneMapping::PSO"};
 
         inline Name Cube {"Cube::PSO"};
         inline Name Depth {"Depth::PSO"};
+        inline Name DepthCompact {"Depth::PSO::CompactVertex"};
+        inline Name DepthPositionOnly {"Depth::PSO::PositionOnly"};
+        inline Name DepthPositionOnlyCompact {"Depth::PSO::PositionOnly::CompactVertex"};
     }
 
     namespace RootSignatureNames
@@ -35,6 +35,9 @@ namespace Engine::Render::Passes
     void ToneMappingPass::PrepareResources(Render::ResourcePlanner* planner)
     {
         planner->ReadRenderTarget(ResourceNames::ForwardOutput);
+        planner->ReadTexture(ResourceNames::ShadowDepth);
+
+        planner->WriteBackBuffer();
     }
 
     void ToneMappingPass::CreateRootSignatures(Render::RootSignatureProvider* rootSignatureProvider)
@@ -69,6 +72,27 @@ namespace Engine::Render::Passes
         pipelineStateProvider->CreatePipelineState(PSONames::ToneMapping, pipelineState);
     }
 
+    void ToneMappingPass::PrepareRender(Render::PassContext& passContext)
+    {
+        auto renderContext = passContext.renderContext;
+
+        auto* depth = passContext.frameResourceProvider->GetTexture(ResourceNames::ShadowDepth);
+
+        D3D12_SHADER_RESOURCE_VIEW_DESC desc = {};
+        desc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        desc.TextureCube.MostDetailedMip = 0;
+        desc.TextureCube.MipLevels = depth->D3D12Resource()->GetDesc().MipLevels;
+        desc.TextureCube.ResourceMinLODClamp = 0.0f;
+        desc.Format = DXGI_FORMAT_R32_FLOAT;
+        auto srv = depth->GetSRDescriptor(renderContext->GetDescriptorAllocator(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV).get(), &desc);
+
+        // ImGui isn't thread safe, the pass may record on another thread.
+        ImGui::Begin("ShadowMap");
+        ImGui::Image(renderContext->GetUIContext()->GetTextureId(srv), {512, 512});
+        ImGui::End();
+    }
+
     void ToneMappingPass::Render(Render::PassContext& passContext)
     {
         auto renderContext = passContext.renderContext;
@@ -114,19 +138,5 @@ namespace Engine::Render::Passes
         auto* depth = passContext.frameResourceProvider->GetTexture(ResourceNames::ShadowDepth);
 
         CommandListUtils::TransitionBarrier(passContext.resourceStateTracker, depth->D3D12ResourceCom(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-
-        D3D12_SHADER_RESOURCE_VIEW_DESC desc = {};
-        desc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-        desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-        desc.TextureCube.MostDetailedMip = 0;
-        desc.TextureCube.MipLevels = depth->D3D12Resource()->GetDesc().MipLevels;
-        desc.TextureCube.ResourceMinLODClamp = 0.0f;
-        desc.Format = DXGI_FORMAT_R32_FLOAT;
-        auto srv = depth->GetSRDescriptor(renderContext->GetDescriptorAllocator(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV).get(), &desc);
-
-        ImGui::Begin("ShadowMap");
-        ImGui::Image(passContext.renderContext->GetUIContext()->GetTextureId(srv), {512, 512});
-        ImGui::End();
-
     }
 } // namespace Engine::Render::Passes
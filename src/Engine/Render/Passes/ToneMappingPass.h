@@ -16,6 +16,8 @@ namespace Engine::Render::Passes
 
         void CreatePipelineStates(Render::PipelineStateProvider* pipelineStateProvider) override;
 
+        void PrepareRender(Render::PassContext& passContext) override;
+
         void Render(Render::PassContext& passContext) override;
     }; 
 } // namespace Engine::Render::Passes
@@ -51,8 +51,17 @@ namespace Engine::Render
         stateStream.dsvFormat = pipelineStateProxy.dsvFormat;
         stateStream.inputLayout = {pipelineStateProxy.inputLayout.data(), static_cast<uint32>(pipelineStateProxy.inputLayout.size())};
         stateStream.primitiveTopologyType = pipelineStateProxy.primitiveTopologyType;
-        stateStream.PS = CD3DX12_SHADER_BYTECODE(mShaderProvider->GetShader({pipelineStateProxy.pixelShaderName, "mainPS", "ps_5_1"}).Get());
-        stateStream.VS = CD3DX12_SHADER_BYTECODE(mShaderProvider->GetShader({pipelineStateProxy.vertexShaderName, "mainVS", "vs_5_1"}).Get());
+
+        ShaderCreationInfo pixelShader = {pipelineStateProxy.pixelShaderName, "mainPS", "ps_5_1"};
+        pixelShader.defines = pipelineStateProxy.shaderDefines;
+        ShaderCreationInfo vertexShader = {pipelineStateProxy.vertexShaderName, "mainVS", "vs_5_1"};
+        vertexShader.defines = pipelineStateProxy.shaderDefines;
+
+        if (!pipelineStateProxy.pixelShaderName.empty())
+        {
+            stateStream.PS = CD3DX12_SHADER_BYTECODE(mShaderProvider->GetShader(pixelShader).Get());
+        }
+        stateStream.VS = CD3DX12_SHADER_BYTECODE(mShaderProvider->GetShader(vertexShader).Get());
         stateStream.rasterizer = CD3DX12_RASTERIZER_DESC(pipelineStateProxy.rasterizer);
         stateStream.rootSignature = mRootSignatureProvider->GetRootSignature(pipelineStateProxy.rootSignatureName)->GetD3D12RootSignature().Get();
         stateStream.rtvFormats = rtFormats;
@@ -62,6 +71,6 @@ namespace Engine::Render
 
     ComPtr<ID3D12PipelineState> PipelineStateProvider::GetPipelineState(const Name& name)
     {
-        return mPipelineStates[name];
+        return mPipelineStates.at(name);
     }
 } // namespace Engine::Render
\ No newline at end of file
@@ -25,6 +25,7 @@ namespace Engine::Render
         std::vector<DXGI_FORMAT> rtvFormats;
         D3D12_RASTERIZER_DESC rasterizer;
         D3D12_DEPTH_STENCIL_DESC depthStencil;
+        std::vector<D3D_SHADER_MACRO> shaderDefines;
 
         auto operator<=>(const PipelineStateProxy& other) const = default;
     };
@@ -80,7 +81,8 @@ namespace std
                 key.dsvFormat,
                 std::hash_combine(key.rtvFormats.begin(), key.rtvFormats.end()),
                 key.rasterizer,
-                key.depthStencil
+                key.depthStencil,
+                std::hash_combine(key.shaderDefines.begin(), key.shaderDefines.end())
                );
         }
     };
@@ -22,10 +22,14 @@ namespace Engine::Render
     class Texture;
     class FrameTransientContext;
     class RenderPassBase;
+    class RenderGraph;
     template <class TPassData> class RenderPassBaseWithData;
     class Renderer;
+    class ResourceStreamer;
+    class StreamingUploader;
 
     struct PipelineStateProxy;
+    struct RenderGraphResource;
     struct PipelineStateStream;
     struct ShaderCreationInfo;
     struct TextureCreationInfo;
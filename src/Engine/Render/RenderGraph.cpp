@@ -0,0 +1,398 @@
+#include "RenderGraph.h"
+
+#include <Render/ResourcePlanner.h>
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+
+namespace Engine::Render
+{
+    namespace
+    {
+        void AddEdge(std::vector<uint32> &edges, uint32 pass)
+        {
+            if (std::find(edges.begin(), edges.end(), pass) == edges.end())
+            {
+                edges.push_back(pass);
+            }
+        }
+
+        bool IsReadOnlyState(D3D12_RESOURCE_STATES state)
+        {
+            const auto writeStates =
+                D3D12_RESOURCE_STATE_RENDER_TARGET |
+                D3D12_RESOURCE_STATE_UNORDERED_ACCESS |
+                D3D12_RESOURCE_STATE_DEPTH_WRITE |
+                D3D12_RESOURCE_STATE_STREAM_OUT |
+                D3D12_RESOURCE_STATE_COPY_DEST |
+                D3D12_RESOURCE_STATE_RESOLVE_DEST;
+
+            return (state & writeStates) == 0;
+        }
+    }
+
+    RenderGraph::RenderGraph() = default;
+    RenderGraph::~RenderGraph() = default;
+
+    void RenderGraph::Reset()
+    {
+        mPasses.clear();
+        mResources.clear();
+        mResourceIndices.clear();
+        mExecutionOrder.clear();
+        mBarriers.clear();
+    }
+
+    uint32 RenderGraph::AddPass(const ResourcePlanner &planner)
+    {
+        PassNode node = {};
+        node.writesBackBuffer = planner.WritesBackBuffer();
+
+        for (const auto &access : planner.GetResourceAccesses())
+        {
+            const uint32 resource = GetResourceIndex(access.name);
+
+            // A resource used several ways by one pass is a single access.
+            auto iter = std::find_if(node.accesses.begin(), node.accesses.end(), [resource](const PassAccess &passAccess)
+            {
+                return passAccess.resource == resource;
+            });
+
+            if (iter != node.accesses.end())
+            {
+                iter->state |= access.state;
+                iter->isWrite |= access.isWrite;
+            }
+            else
+            {
+                node.accesses.push_back({resource, access.state, access.isWrite});
+            }
+        }
+
+        for (const auto &plannedResource : planner.GetPlannedResources())
+        {
+            auto &resource = mResources[GetResourceIndex(plannedResource.name)];
+            if (!resource.hasCreationInfo)
+            {
+                resource.creationInfo = plannedResource.creationInfo;
+                resource.hasCreationInfo = true;
+            }
+        }
+
+        mPasses.push_back(std::move(node));
+        return static_cast<uint32>(mPasses.size() - 1);
+    }
+
+    bool RenderGraph::Compile()
+    {
+        bool isValid = BuildDependencies();
+        if (isValid)
+        {
+            CullPasses();
+            isValid = SortPasses();
+        }
+
+        if (!isValid)
+        {
+            mExecutionOrder.clear();
+            for (uint32 pass = 0; pass < mPasses.size(); ++pass)
+            {
+                mPasses[pass].isCulled = false;
+                mExecutionOrder.push_back(pass);
+            }
+        }
+
+        ComputeLifetimes();
+        ComputeBarriers(isValid);
+
+        return isValid;
+    }
+
+    std::span<const RenderGraphBarrier> RenderGraph::GetBarriers(uint32 pass) const
+    {
+        const auto &node = mPasses[pass];
+        return std::span<const RenderGraphBarrier>(mBarriers.data() + node.firstBarrier, node.barriersCount);
+    }
+
+    uint32 RenderGraph::GetResourceIndex(const Name &name)
+    {
+        auto [iter, isInserted] = mResourceIndices.emplace(name, static_cast<uint32>(mResources.size()));
+        if (isInserted)
+        {
+            RenderGraphResource resource = {};
+            resource.name = name;
+            mResources.push_back(resource);
+        }
+
+        return iter->second;
+    }
+
+    bool RenderGraph::BuildDependencies()
+    {
+        std::vector<std::vector<uint32>> resourcePasses(mResources.size());
+        for (uint32 pass = 0; pass < mPasses.size(); ++pass)
+        {
+            for (const auto &access : mPasses[pass].accesses)
+            {
+                resourcePasses[access.resource].push_back(pass);
+            }
+        }
+
+        const auto getAccess = [this](uint32 pass, uint32 resource) -> const PassAccess &
+        {
+            const auto &accesses = mPasses[pass].accesses;
+            return *std::find_if(accesses.begin(), accesses.end(), [resource](const PassAccess &access)
+            {
+                return access.resource == resource;
+            });
+        };
+
+        std::vector<uint32> readers;
+        for (uint32 resource = 0; resource < mResources.size(); ++resource)
+        {
+            const auto &passes = resourcePasses[resource];
+
+            auto firstWriter = std::find_if(passes.begin(), passes.end(), [&](uint32 pass)
+            {
+                return getAccess(pass, resource).isWrite;
+            });
+
+            if (firstWriter == passes.end() || !mResources[resource].hasCreationInfo)
+            {
+                return false;
+            }
+
+            // Reads registered before the first write see what it wrote.
+            uint32 lastWriter = *firstWriter;
+            readers.clear();
+
+            for (auto pass : passes)
+            {
+                auto &node = mPasses[pass];
+                if (!getAccess(pass, resource).isWrite)
+                {
+                    AddEdge(node.dependencies, lastWriter);
+                    AddEdge(node.producers, lastWriter);
+                    readers.push_back(pass);
+                    continue;
+                }
+
+                if (pass == *firstWriter)
+                {
+                    continue;
+                }
+
+                // A later write draws on top of the previous one and waits for everything that read it.
+                AddEdge(node.dependencies, lastWriter);
+                AddEdge(node.producers, lastWriter);
+                for (auto reader : readers)
+                {
+                    AddEdge(node.dependencies, reader);
+                }
+
+                lastWriter = pass;
+                readers.clear();
+            }
+        }
+
+        return true;
+    }
+
+    void RenderGraph::CullPasses()
+    {
+        std::vector<uint32> passesToVisit;
+        for (uint32 pass = 0; pass < mPasses.size(); ++pass)
+        {
+            mPasses[pass].isCulled = !mPasses[pass].writesBackBuffer;
+            if (!mPasses[pass].isCulled)
+            {
+                passesToVisit.push_back(pass);
+            }
+        }
+
+        while (!passesToVisit.empty())
+        {
+            const uint32 pass = passesToVisit.back();
+            passesToVisit.pop_back();
+
+            for (auto producer : mPasses[pass].producers)
+            {
+                if (mPasses[producer].isCulled)
+                {
+                    mPasses[producer].isCulled = false;
+                    passesToVisit.push_back(producer);
+                }
+            }
+        }
+    }
+
+    bool RenderGraph::SortPasses()
+    {
+        std::vector<uint32> dependenciesLeft(mPasses.size(), 0);
+        std::vector<std::vector<uint32>> dependents(mPasses.size());
+        for (uint32 pass = 0; pass < mPasses.size(); ++pass)
+        {
+            if (mPasses[pass].isCulled)
+            {
+                continue;
+            }
+
+            for (auto dependency : mPasses[pass].dependencies)
+            {
+                if (!mPasses[dependency].isCulled && dependency != pass)
+                {
+                    ++dependenciesLeft[pass];
+                    dependents[dependency].push_back(pass);
+                }
+            }
+        }
+
+        // Passes free to run are taken in registration order.
+        std::priority_queue<uint32, std::vector<uint32>, std::greater<uint32>> readyPasses;
+        uint32 livePassesCount = 0;
+        for (uint32 pass = 0; pass < mPasses.size(); ++pass)
+        {
+            if (!mPasses[pass].isCulled)
+            {
+                ++livePassesCount;
+                if (dependenciesLeft[pass] == 0)
+                {
+                    readyPasses.push(pass);
+                }
+            }
+        }
+
+        mExecutionOrder.clear();
+        while (!readyPasses.empty())
+        {
+            const uint32 pass = readyPasses.top();
+            readyPasses.pop();
+            mExecutionOrder.push_back(pass);
+
+            for (auto dependent : dependents[pass])
+            {
+                if (--dependenciesLeft[dependent] == 0)
+                {
+                    readyPasses.push(dependent);
+                }
+            }
+        }
+
+        return mExecutionOrder.size() == livePassesCount;
+    }
+
+    void RenderGraph::ComputeLifetimes()
+    {
+        for (auto &resource : mResources)
+        {
+            resource.firstUse = RenderGraphResource::InvalidUse;
+            resource.lastUse = RenderGraphResource::InvalidUse;
+        }
+
+        for (uint32 position = 0; position < mExecutionOrder.size(); ++position)
+        {
+            for (const auto &access : mPasses[mExecutionOrder[position]].accesses)
+            {
+                auto &resource = mResources[access.resource];
+                if (!resource.IsUsed())
+                {
+                    resource.firstUse = position;
+                }
+                resource.lastUse = position;
+                resource.initialState = access.state;
+            }
+        }
+    }
+
+    void RenderGraph::ComputeBarriers(bool isValid)
+    {
+        mBarriers.clear();
+        for (auto &pass : mPasses)
+        {
+            pass.firstBarrier = 0;
+            pass.barriersCount = 0;
+        }
+
+        if (!isValid)
+        {
+            return;
+        }
+
+        struct ResourceUse
+        {
+            uint32 position;
+            D3D12_RESOURCE_STATES state;
+            bool isReadOnly;
+        };
+
+        std::vector<std::vector<ResourceUse>> resourceUses(mResources.size());
+        for (uint32 position = 0; position < mExecutionOrder.size(); ++position)
+        {
+            for (const auto &access : mPasses[mExecutionOrder[position]].accesses)
+            {
+                resourceUses[access.resource].push_back({position, access.state, !access.isWrite && IsReadOnlyState(access.state)});
+            }
+        }
+
+        // Barriers of every pass boundary, boundary i comes right before the pass at position i.
+        std::vector<std::vector<RenderGraphBarrier>> boundaries(mExecutionOrder.size());
+        for (uint32 resource = 0; resource < mResources.size(); ++resource)
+        {
+            auto &uses = resourceUses[resource];
+            if (uses.empty())
+            {
+                continue;
+            }
+
+            // Reads following each other share one state, the resource isn't transitioned between them.
+            for (Size first = 0; first < uses.size();)
+            {
+                Size last = first;
+                D3D12_RESOURCE_STATES state = uses[first].state;
+                while (uses[first].isReadOnly && last + 1 < uses.size() && uses[last + 1].isReadOnly)
+                {
+                    state |= uses[++last].state;
+                }
+
+                for (Size i = first; i <= last; ++i)
+                {
+                    uses[i].state = state;
+                }
+                first = last + 1;
+            }
+
+            mResources[resource].initialState = uses.back().state;
+
+            // The transition of a resource idle since its last use is split, it begins right after that use and ends right before the next one.
+            // Heap memory of a resource may belong to another one until its first use, so its first transition is never split.
+            D3D12_RESOURCE_STATES state = mResources[resource].initialState;
+            uint32 idleSince = uses.front().position;
+            for (const auto &use : uses)
+            {
+                if (use.state != state)
+                {
+                    if (use.position > idleSince)
+                    {
+                        boundaries[idleSince].push_back({resource, state, use.state, D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY});
+                        boundaries[use.position].push_back({resource, state, use.state, D3D12_RESOURCE_BARRIER_FLAG_END_ONLY});
+                    }
+                    else
+                    {
+                        boundaries[use.position].push_back({resource, state, use.state, D3D12_RESOURCE_BARRIER_FLAG_NONE});
+                    }
+                    state = use.state;
+                }
+                idleSince = use.position + 1;
+            }
+        }
+
+        for (uint32 position = 0; position < mExecutionOrder.size(); ++position)
+        {
+            auto &node = mPasses[mExecutionOrder[position]];
+            node.firstBarrier = static_cast<uint32>(mBarriers.size());
+            node.barriersCount = static_cast<uint32>(boundaries[position].size());
+            mBarriers.insert(mBarriers.end(), boundaries[position].begin(), boundaries[position].end());
+        }
+    }
+} // namespace Engine::Render
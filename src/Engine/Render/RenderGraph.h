@@ -0,0 +1,107 @@
+#pragma once
+
+#include <Types.h>
+#include <Name.h>
+
+#include <Render/RenderForwards.h>
+#include <Render/TextureCreationInfo.h>
+
+#include <d3d12.h>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace Engine::Render
+{
+    struct RenderGraphBarrier
+    {
+        uint32 resource;
+        D3D12_RESOURCE_STATES stateBefore;
+        D3D12_RESOURCE_STATES stateAfter;
+        // Begin and end halves of a split barrier go before different passes.
+        D3D12_RESOURCE_BARRIER_FLAGS flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+    };
+
+    struct RenderGraphResource
+    {
+        static constexpr uint32 InvalidUse = ~0u;
+
+        Name name;
+        TextureCreationInfo creationInfo = {};
+        bool hasCreationInfo = false;
+
+        // Positions in the execution order of the first and the last pass using the resource.
+        uint32 firstUse = InvalidUse;
+        uint32 lastUse = InvalidUse;
+
+        // The resource leaves the frame in the state of its last access and is expected back in it on the next frame.
+        D3D12_RESOURCE_STATES initialState = D3D12_RESOURCE_STATE_COMMON;
+
+        bool IsUsed() const { return firstUse != InvalidUse; }
+    };
+
+    // Schedules the passes of a frame from the resources they declare through ResourcePlanner.
+    // A read sees the last write registered before it, or the first write when none was. Writes to a resource keep their registration order.
+    // Compiling touches no D3D12 objects, resources are known by name only.
+    class RenderGraph
+    {
+    public:
+        RenderGraph();
+        ~RenderGraph();
+
+        void Reset();
+
+        // Passes are known by their registration index.
+        uint32 AddPass(const ResourcePlanner &planner);
+
+        // Returns false when the passes depend on each other in a cycle or use a resource no pass creates,
+        // every pass then runs in registration order and transitions its resources itself.
+        bool Compile();
+
+        const std::vector<uint32> &GetExecutionOrder() const { return mExecutionOrder; }
+        bool IsCulled(uint32 pass) const { return mPasses[pass].isCulled; }
+        uint32 GetPassesCount() const { return static_cast<uint32>(mPasses.size()); }
+
+        const std::vector<RenderGraphResource> &GetResources() const { return mResources; }
+        // Transitions to record in one batch before the pass, resources are indices into GetResources.
+        std::span<const RenderGraphBarrier> GetBarriers(uint32 pass) const;
+
+    private:
+        struct PassAccess
+        {
+            uint32 resource;
+            D3D12_RESOURCE_STATES state;
+            bool isWrite;
+        };
+
+        struct PassNode
+        {
+            std::vector<PassAccess> accesses;
+            bool writesBackBuffer = false;
+
+            // Passes that have to run before this one, producers also make what this pass reads or draws on top of.
+            std::vector<uint32> dependencies;
+            std::vector<uint32> producers;
+
+            bool isCulled = false;
+            uint32 firstBarrier = 0;
+            uint32 barriersCount = 0;
+        };
+
+        uint32 GetResourceIndex(const Name &name);
+
+        bool BuildDependencies();
+        void CullPasses();
+        bool SortPasses();
+        void ComputeLifetimes();
+        void ComputeBarriers(bool isValid);
+
+    private:
+        std::vector<PassNode> mPasses;
+        std::vector<RenderGraphResource> mResources;
+        std::unordered_map<Name, uint32> mResourceIndices;
+
+        std::vector<uint32> mExecutionOrder;
+        std::vector<RenderGraphBarrier> mBarriers;
+    };
+} // namespace Engine::Render
@@ -18,6 +18,12 @@ namespace Engine::Render
 
         virtual void CreatePipelineStates(Render::PipelineStateProvider *pipelineStateProvider) {}
 
+        // Runs on the render thread before the command lists of the pass are recorded, data they share is uploaded here.
+        virtual void PrepareRender(Render::PassContext &passContext) {}
+
+        // Passes with many draws split them over several command lists, recorded in parallel with each other and with other passes.
+        virtual uint32 GetCommandListsCount() const { return 1; }
+
         virtual void Render(Render::PassContext &passContext) {}
 
         const std::string &GetName() const { return mPassName; }
@@ -1,12 +1,16 @@
 #include "Renderer.h"
 
 #include <StringUtils.h>
+#include <ThreadPool.h>
 
 #include <Scene/CubeMap.h>
 #include <Scene/Texture.h>
 #include <Scene/SceneObject.h>
 #include <Scene/Components/MeshComponent.h>
 #include <Scene/Components/CubeMapComponent.h>
+#include <Scene/Components/CameraComponent.h>
+#include <Scene/Components/AABBComponent.h>
+#include <Scene/Material.h>
 
 
 #include <Render/CommandQueue.h>
@@ -16,10 +20,13 @@
 #include <Render/TextureCreationInfo.h>
 #include <Render/FrameResourceProvider.h>
 #include <Render/ResourcePlanner.h>
+#include <Render/RenderGraph.h>
 #include <Render/PassContext.h>
 #include <Render/RenderContext.h>
 #include <Render/RenderPassBase.h>
 #include <Render/PassCommandRecorder.h>
+#include <Render/ResourceStreamer.h>
+#include <Render/StreamingUploader.h>
 
 #include <Memory/UploadBuffer.h>
 #include <Memory/IndexBuffer.h>
@@ -27,7 +34,10 @@
 #include <Memory/DynamicDescriptorHeap.h>
 
 #include <entt/entt.hpp>
+#include <imgui/imgui.h>
 #include <d3d12.h>
+#include <d3dx12.h>
+#include <algorithm>
 
 namespace Engine::Render
 {
@@ -38,16 +48,34 @@ namespace Engine::Render
 
     Renderer::~Renderer() = default;
 
-    void Renderer::Initialize()
+    void Renderer::Initialize(Scene::SceneObject* scene)
     {
-        auto cbvSrvUavDescriptorSize = mRenderContext->Device()->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-        for (Size i = 0; i < std::size(mFrameContexts); ++i)
+        for (Size i = 0; i < std::size(mUploadBuffers); ++i)
         {
-            mFrameContexts[i].uploadBuffer = MakeShared<Memory::UploadBuffer>(mRenderContext->Device().Get(), 500 * 1024 * 1024);
-            mFrameContexts[i].dynamicDescriptorHeap = MakeShared<Memory::DynamicDescriptorHeap>(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, cbvSrvUavDescriptorSize);
+            mUploadBuffers[i] = MakeShared<Memory::UploadBuffer>(mRenderContext->Device().Get(), 64 * 1024 * 1024);
         }
 
-        mFrameResourceProvider = MakeUnique<FrameResourceProvider>(mRenderContext->Device(), mRenderContext->GetGlobalResourceStateTracker().get());
+        mRenderGraph = MakeUnique<RenderGraph>();
+        mFrameResourceProvider = MakeUnique<FrameResourceProvider>(mRenderContext->Device(), mRenderContext->GetGraphicsCommandQueue(), mRenderContext->GetGlobalResourceStateTracker().get());
+
+        mStreamingUploader = MakeUnique<StreamingUploader>(mRenderContext, EngineConfig::StreamingBudgetPerFrame);
+        mResourceStreamer = MakeUnique<ResourceStreamer>(EngineConfig::StreamingBudgetPerFrame, EngineConfig::StreamingBatchesInFlight);
+
+        auto &registry = scene->GetRegistry();
+        registry.on_construct<Scene::Components::MeshComponent>().connect<&Renderer::MarkForUpload>(this);
+        registry.on_update<Scene::Components::MeshComponent>().connect<&Renderer::MarkForUpload>(this);
+        registry.on_construct<Scene::Components::CubeMapComponent>().connect<&Renderer::MarkForUpload>(this);
+        registry.on_update<Scene::Components::CubeMapComponent>().connect<&Renderer::MarkForUpload>(this);
+
+        for (auto entity : registry.view<Scene::Components::MeshComponent>())
+        {
+            mEntitiesToUpload.push_back(entity);
+        }
+
+        for (auto entity : registry.view<Scene::Components::CubeMapComponent>())
+        {
+            mEntitiesToUpload.push_back(entity);
+        }
     }
 
     void Renderer::Deinitialize()
@@ -62,9 +90,12 @@ namespace Engine::Render
     void Renderer::Render(Scene::SceneObject* scene, const Timer& timer)
     {
         auto currentBackbufferIndex = mRenderContext->GetCurrentBackBufferIndex();
-        mFrameContexts[currentBackbufferIndex].Reset();
+        for (auto& frameContext : mFrameContexts[currentBackbufferIndex])
+        {
+            frameContext.Reset();
+        }
 
-        UploadResources(scene, mRenderContext, mFrameContexts[currentBackbufferIndex].uploadBuffer);
+        StreamResources(scene);
 
         PrepareFrame();
 
@@ -73,24 +104,49 @@ namespace Engine::Render
 
     void Renderer::PrepareFrame()
     {
+        mRenderGraph->Reset();
+
         for (auto& pass : mRenderPasses)
         {
             ResourcePlanner planner;
 
             pass->PrepareResources(&planner);
 
-            for (auto resource : planner.GetPlannedResources())
+            mRenderGraph->AddPass(planner);
+        }
+
+        [[maybe_unused]] bool isCompiled = mRenderGraph->Compile();
+        assert(isCompiled && "Render passes depend on each other in a cycle or use a resource no pass creates.");
+
+        std::vector<RenderGraphResource> resources;
+        for (auto resource : mRenderGraph->GetResources())
+        {
+            if (!resource.IsUsed() || !resource.hasCreationInfo)
             {
-                auto& creationInfo = resource.creationInfo;
-                if (creationInfo.description.Width == 0 && creationInfo.description.Height == 0)
-                {
-                    creationInfo.description.Width = mRenderContext->GetSwapChain()->GetWidth();
-                    creationInfo.description.Height = mRenderContext->GetSwapChain()->GetHeight();
-                }
-
-                mFrameResourceProvider->CreateResource(resource.name, resource.creationInfo);
+                continue;
             }
 
+            auto& creationInfo = resource.creationInfo;
+            if (creationInfo.description.Width == 0 && creationInfo.description.Height == 0)
+            {
+                creationInfo.description.Width = mRenderContext->GetSwapChain()->GetWidth();
+                creationInfo.description.Height = mRenderContext->GetSwapChain()->GetHeight();
+            }
+
+            resources.push_back(resource);
+        }
+
+        mFrameResourceProvider->CreateResources(resources);
+
+        ImGui::Begin("Frame Resources");
+        ImGui::Text("Heap: %.2f MB", static_cast<float32>(mFrameResourceProvider->GetHeapSize()) / (1024.0f * 1024.0f));
+        ImGui::Text("Without aliasing: %.2f MB", static_cast<float32>(mFrameResourceProvider->GetNaiveSize()) / (1024.0f * 1024.0f));
+        ImGui::End();
+
+        for (auto passIndex : mRenderGraph->GetExecutionOrder())
+        {
+            auto pass = mRenderPasses[passIndex];
+
             pass->CreateRootSignatures(mRenderContext->GetRootSignatureProvider());
             pass->CreatePipelineStates(mRenderContext->GetPipelineStateProvider());
         }
@@ -98,147 +154,291 @@ namespace Engine::Render
 
     void Renderer::RenderPasses(Scene::SceneObject* scene, const Timer& timer)
     {
-        for (auto& pass : mRenderPasses)
+        const auto& executionOrder = mRenderGraph->GetExecutionOrder();
+
+        std::vector<PassCommandList> passCommandLists;
+        for (uint32 position = 0; position < executionOrder.size(); ++position)
         {
-            RenderPass(pass, scene, timer);
+            const uint32 count = mRenderPasses[executionOrder[position]]->GetCommandListsCount();
+            for (uint32 index = 0; index < count; ++index)
+            {
+                passCommandLists.push_back({position, index, count});
+            }
+        }
+
+        ReserveFrameContexts(std::max<Size>(passCommandLists.size(), 1));
+        auto& frameContexts = mFrameContexts[mRenderContext->GetCurrentBackBufferIndex()];
+
+        for (auto passIndex : executionOrder)
+        {
+            PassContext passContext = {};
+
+            passContext.frameContext = &frameContexts[0];
+            passContext.renderContext = mRenderContext;
+            passContext.frameResourceProvider = mFrameResourceProvider.get();
+            passContext.timer = &timer;
+
+            mRenderPasses[passIndex]->PrepareRender(passContext);
+        }
+
+        // Each command list records with its own context and state tracker, nothing touches the global states until all of them are done.
+        ThreadPool::Instance().ParallelFor(passCommandLists.size(), [&](Size i)
+        {
+            auto& passCommandList = passCommandLists[i];
+            auto pass = mRenderPasses[executionOrder[passCommandList.position]];
+
+            auto name = pass->GetName();
+            if (passCommandList.count > 1)
+            {
+                name += " " + std::to_string(passCommandList.index);
+            }
+
+            passCommandList.commandList = mRenderContext->CreateGraphicsCommandList();
+            passCommandList.commandList->SetName(StringToWString(name + " CL").c_str());
+
+            RecordPass(pass, passCommandList, &frameContexts[i], timer);
+        });
+
+        // The barriers before a command list are recorded as one batch at the end of the list before it,
+        // the first batch goes into a list of its own with the states resources enter the frame in.
+        auto frameBeginCommandList = mRenderContext->CreateGraphicsCommandList();
+        frameBeginCommandList->SetName(L"Frame Begin CL");
+
+        std::vector<ComPtr<ID3D12GraphicsCommandList>> commandLists = {frameBeginCommandList};
+        std::vector<D3D12_RESOURCE_BARRIER> barriers;
+        bool hasFrameBeginBarriers = false;
+        PassCommandStatistics statistics;
+
+        AddInitialStateBarriers(barriers);
+
+        // Command lists are merged in submission order, so the barriers don't depend on which thread finished first.
+        for (Size i = 0; i < passCommandLists.size(); ++i)
+        {
+            auto& passCommandList = passCommandLists[i];
+
+            // Transitions a command list made itself are resolved against the states the graph barriers and the lists before it leave.
+            if (passCommandList.index == 0)
+            {
+                AddGraphBarriers(executionOrder[passCommandList.position], passCommandList.position, barriers);
+            }
+            passCommandList.resourceStateTracker->ResolvePendingBarriers(barriers);
+            passCommandList.resourceStateTracker->CommitFinalResourceStates();
+
+            statistics += passCommandList.statistics;
+
+            if (!barriers.empty())
+            {
+                commandLists.back()->ResourceBarrier(static_cast<uint32>(barriers.size()), barriers.data());
+                hasFrameBeginBarriers |= i == 0;
+                barriers.clear();
+            }
+
+            commandLists.back()->Close();
+            commandLists.push_back(passCommandList.commandList);
+        }
+
+        commandLists.back()->Close();
+
+        // Skipped commands are the ones recording every binding for every draw would issue on top.
+        ImGui::Begin("State Changes");
+        ImGui::Text("Pipeline states: %u (%u unfiltered)", statistics.pipelineStates, statistics.pipelineStates + statistics.skippedPipelineStates);
+        ImGui::Text("Descriptor tables: %u (%u unfiltered)", statistics.descriptorTables, statistics.descriptorTables + statistics.skippedDescriptorTables);
+        ImGui::Text("Root CBVs: %u (%u unfiltered)", statistics.rootConstantBufferViews, statistics.rootConstantBufferViews + statistics.skippedRootConstantBufferViews);
+        ImGui::Text("Root SRVs: %u (%u unfiltered)", statistics.rootShaderResourceViews, statistics.rootShaderResourceViews + statistics.skippedRootShaderResourceViews);
+        ImGui::Text("Vertex and index buffers: %u (%u unfiltered)", statistics.inputBuffers, statistics.inputBuffers + statistics.skippedInputBuffers);
+        ImGui::End();
+
+        std::vector<ID3D12CommandList*> d3d12CommandLists;
+        for (Size i = hasFrameBeginBarriers ? 0 : 1; i < commandLists.size(); ++i)
+        {
+            d3d12CommandLists.push_back(commandLists[i].Get());
+        }
+
+        if (!d3d12CommandLists.empty())
+        {
+            mRenderContext->GetGraphicsCommandQueue()->ExecuteCommandLists(d3d12CommandLists.size(), d3d12CommandLists.data());
         }
 
         mRenderPasses.clear();
     }
 
-    void Renderer::RenderPass(RenderPassBase* pass, Scene::SceneObject* scene, const Timer& timer)
+    void Renderer::ReserveFrameContexts(Size count)
     {
         auto currentBackbufferIndex = mRenderContext->GetCurrentBackBufferIndex();
+        auto cbvSrvUavDescriptorSize = mRenderContext->Device()->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+        auto& frameContexts = mFrameContexts[currentBackbufferIndex];
+        while (frameContexts.size() < count)
+        {
+            FrameTransientContext frameContext;
+            frameContext.uploadBuffer = mUploadBuffers[currentBackbufferIndex];
+            frameContext.dynamicDescriptorHeap = MakeShared<Memory::DynamicDescriptorHeap>(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, cbvSrvUavDescriptorSize);
+
+            frameContexts.push_back(frameContext);
+        }
+    }
+
+    void Renderer::AddInitialStateBarriers(std::vector<D3D12_RESOURCE_BARRIER>& barriers)
+    {
+        // Graph barriers expect resources in the state they left the previous frame in, this only differs
+        // for new resources and when the passes change.
+        auto globalStateTracker = mRenderContext->GetGlobalResourceStateTracker();
+
+        for (const auto& resource : mRenderGraph->GetResources())
+        {
+            if (!resource.IsUsed() || !resource.hasCreationInfo)
+            {
+                continue;
+            }
+
+            auto d3d12Resource = mFrameResourceProvider->GetTexture(resource.name)->D3D12Resource();
+            auto state = globalStateTracker->GetLastState(d3d12Resource);
+            if (state != resource.initialState)
+            {
+                barriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(d3d12Resource, state, resource.initialState));
+                globalStateTracker->TrackResource(d3d12Resource, resource.initialState);
+            }
+        }
+    }
+
+    void Renderer::AddGraphBarriers(uint32 passIndex, uint32 position, std::vector<D3D12_RESOURCE_BARRIER>& barriers)
+    {
+        auto globalStateTracker = mRenderContext->GetGlobalResourceStateTracker();
+
+        // Resources sharing heap memory take it over at their first pass.
+        for (const auto& resource : mRenderGraph->GetResources())
+        {
+            if (resource.firstUse == position && resource.hasCreationInfo && mFrameResourceProvider->IsAliased(resource.name))
+            {
+                barriers.push_back(CD3DX12_RESOURCE_BARRIER::Aliasing(nullptr, mFrameResourceProvider->GetTexture(resource.name)->D3D12Resource()));
+            }
+        }
+
+        for (const auto& barrier : mRenderGraph->GetBarriers(passIndex))
+        {
+            auto d3d12Resource = mFrameResourceProvider->GetTexture(mRenderGraph->GetResources()[barrier.resource].name)->D3D12Resource();
+            barriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(d3d12Resource, barrier.stateBefore, barrier.stateAfter, D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES, barrier.flags));
+
+            // No pass uses the resource while a split barrier is in flight, its state changes when the barrier ends.
+            if (barrier.flags != D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY)
+            {
+                assert(globalStateTracker->GetLastState(d3d12Resource) == barrier.stateBefore);
+                globalStateTracker->TrackResource(d3d12Resource, barrier.stateAfter);
+            }
+        }
+    }
+
+    void Renderer::RecordPass(RenderPassBase* pass, PassCommandList& passCommandList, FrameTransientContext* frameContext, const Timer& timer)
+    {
+        auto commandList = passCommandList.commandList;
 
-        auto commandList = mRenderContext->CreateGraphicsCommandList();
-        commandList->SetName(StringToWString(pass->GetName() + " CL").c_str());
-        
         mRenderContext->GetEventTracker().StartGPUEvent(pass->GetName(), commandList);
 
         PassContext passContext = {};
 
-        passContext.frameContext = &mFrameContexts[currentBackbufferIndex];
+        passContext.frameContext = frameContext;
         passContext.commandList = commandList;
         passContext.renderContext = mRenderContext;
         passContext.frameResourceProvider = mFrameResourceProvider.get();
         passContext.timer = &timer;
         passContext.resourceStateTracker = MakeShared<ResourceStateTracker>(mRenderContext->GetGlobalResourceStateTracker());
+        passContext.commandListIndex = passCommandList.index;
+        passContext.commandListsCount = passCommandList.count;
 
         passContext.commandRecorder = MakeShared<PassCommandRecorder>(
             commandList,
             passContext.resourceStateTracker.get(),
             mRenderContext.get(),
             mFrameResourceProvider.get(),
-            &mFrameContexts[currentBackbufferIndex]);
+            frameContext);
 
         pass->Render(passContext);
 
         passContext.resourceStateTracker->FlushBarriers(commandList);
 
         mRenderContext->GetEventTracker().EndGPUEvent(commandList);
-        
-        commandList->Close();
 
-        auto prePassCommandList = mRenderContext->CreateGraphicsCommandList();
-        prePassCommandList->SetName(StringToWString(pass->GetName() + " PrePass CL").c_str());
-        mRenderContext->GetEventTracker().StartGPUEvent("PrePass: " + pass->GetName(), prePassCommandList);
-
-        auto barriers = passContext.resourceStateTracker->FlushPendingBarriers(prePassCommandList);
-        passContext.resourceStateTracker->CommitFinalResourceStates();
-        passContext.resourceStateTracker->FlushBarriers(prePassCommandList);
-
-        mRenderContext->GetEventTracker().EndGPUEvent(prePassCommandList);
-        prePassCommandList->Close();
-
-        std::vector<ID3D12CommandList*> commandLists;
-
-        if (barriers > 0)
-        {
-            commandLists.push_back(prePassCommandList.Get());
-        }
-        
-        commandLists.push_back(commandList.Get());
-        
-        mRenderContext->GetGraphicsCommandQueue()->ExecuteCommandLists(commandLists.size(), commandLists.data());
+        passCommandList.resourceStateTracker = passContext.resourceStateTracker;
+        passCommandList.statistics = passContext.commandRecorder->GetStatistics();
     }
 
 
-    /// TODO: find better solution for uploading scene resources to GPU memory
-    /// Let's stay this logic here for now.
-    void Renderer::UploadResources(Scene::SceneObject *scene, SharedPtr<RenderContext> renderContext, SharedPtr<Memory::UploadBuffer> uploadBuffer)
+    void Renderer::MarkForUpload(entt::registry &registry, entt::entity entity)
     {
-        const auto &meshView = scene->GetRegistry().view<Scene::Components::MeshComponent>();
-        const auto &cubeMapView = scene->GetRegistry().view<Scene::Components::CubeMapComponent>();
-
-        auto stateTracker = MakeShared<ResourceStateTracker>(renderContext->GetGlobalResourceStateTracker());
-
-        auto commandList = renderContext->CreateCopyCommandList();
-
-        commandList->SetName(L"Uploading resources List");
+        mEntitiesToUpload.push_back(entity);
+    }
 
-        uploadBuffer->Reset();
-        bool anythingToLoad = false;
+    void Renderer::EnqueueResources(Scene::SceneObject *scene)
+    {
+        auto &registry = scene->GetRegistry();
 
-        for (auto &&[entity, meshComponent] : meshView.each())
+        for (auto entity : mEntitiesToUpload)
         {
-            auto mesh = meshComponent.mesh;
-            if (!mesh.vertexBuffer->GetD3D12Resource())
-            {
-                anythingToLoad = true;
-                CommandListUtils::UploadVertexBuffer(renderContext, commandList, stateTracker, *mesh.vertexBuffer, uploadBuffer);
-            }
-            if (!mesh.indexBuffer->GetD3D12Resource())
+            if (!registry.valid(entity))
             {
-                anythingToLoad = true;
-                CommandListUtils::UploadIndexBuffer(renderContext, commandList, stateTracker, *mesh.indexBuffer, uploadBuffer);
+                continue;
             }
-            anythingToLoad = CommandListUtils::UploadMaterialTextures(renderContext, commandList, stateTracker, mesh.material, uploadBuffer) || anythingToLoad;
-        }
 
-        for (auto &&[entity, cubeComponent] : cubeMapView.each())
-        {
-            if (!cubeComponent.cubeMap.vertexBuffer->GetD3D12Resource())
-            {
-                anythingToLoad = true;
-                CommandListUtils::UploadVertexBuffer(renderContext, commandList, stateTracker, *cubeComponent.cubeMap.vertexBuffer, uploadBuffer);
-            }
-            if (!cubeComponent.cubeMap.indexBuffer->GetD3D12Resource())
+            if (auto meshComponent = registry.try_get<Scene::Components::MeshComponent>(entity))
             {
-                anythingToLoad = true;
-                CommandListUtils::UploadIndexBuffer(renderContext, commandList, stateTracker, *cubeComponent.cubeMap.indexBuffer, uploadBuffer);
+                EnqueueMesh(registry, entity, meshComponent->mesh);
             }
-            if (!cubeComponent.cubeMap.texture->GetD3D12Resource())
+
+            if (auto cubeComponent = registry.try_get<Scene::Components::CubeMapComponent>(entity))
             {
-                anythingToLoad = true;
-                CommandListUtils::UploadTexture(renderContext, commandList, stateTracker, cubeComponent.cubeMap.texture.get(), uploadBuffer);
+                EnqueueCubeMap(cubeComponent->cubeMap);
             }
         }
 
-        std::vector<ID3D12CommandList *> commandLists;
-
-        auto barriersCommandList = renderContext->CreateCopyCommandList();
+        mEntitiesToUpload.clear();
+    }
 
-        auto barriers = stateTracker->FlushPendingBarriers(barriersCommandList);
-        stateTracker->CommitFinalResourceStates();
+    void Renderer::EnqueueMesh(entt::registry &registry, entt::entity entity, const Scene::Mesh &mesh)
+    {
+        dx::XMFLOAT3 location = {0.0f, 0.0f, 0.0f};
+        if (auto aabbComponent = registry.try_get<Scene::Components::AABBComponent>(entity))
+        {
+            location = aabbComponent->boundingBox.Center;
+        }
 
-        barriersCommandList->Close();
-        commandList->Close();
+        auto enqueue = [&](auto resource)
+        {
+            if (resource && !resource->GetD3D12Resource())
+            {
+                mResourceStreamer->Enqueue(mStreamingUploader->CreateRequest(resource), location);
+            }
+        };
+
+        enqueue(SharedPtr<Memory::Buffer>(mesh.vertexBuffer));
+        enqueue(SharedPtr<Memory::Buffer>(mesh.positionBuffer));
+        enqueue(SharedPtr<Memory::Buffer>(mesh.indexBuffer));
+        enqueue(mesh.material->GetBaseColorTexture());
+        enqueue(mesh.material->GetMetallicRoughnessTexture());
+        enqueue(mesh.material->GetNormalTexture());
+        enqueue(mesh.material->GetEmissiveTexture());
+        enqueue(mesh.material->GetAmbientOcclusionTexture());
+    }
 
-        if (barriers > 0)
+    void Renderer::EnqueueCubeMap(const Scene::CubeMap &cubeMap)
+    {
+        if (!ResourceStreamer::IsResident(cubeMap))
         {
-            commandLists.push_back(barriersCommandList.Get());
+            mResourceStreamer->Enqueue(mStreamingUploader->CreateRequest(SharedPtr<Memory::Buffer>(cubeMap.vertexBuffer)));
+            mResourceStreamer->Enqueue(mStreamingUploader->CreateRequest(SharedPtr<Memory::Buffer>(cubeMap.indexBuffer)));
+            mResourceStreamer->Enqueue(mStreamingUploader->CreateRequest(cubeMap.texture));
         }
+    }
 
-        if (anythingToLoad)
+    void Renderer::StreamResources(Scene::SceneObject *scene)
+    {
+        if (mEntitiesToUpload.empty() && mResourceStreamer->IsIdle())
         {
-            commandLists.push_back(commandList.Get());
+            return;
         }
 
-        if (commandLists.size() > 0)
-        {
-            uint64 fenceValue = renderContext->GetCopyCommandQueue()->ExecuteCommandLists(commandLists.size(), commandLists.data());
+        EnqueueResources(scene);
 
-            renderContext->GetGraphicsCommandQueue()->InsertWaitForQueue(renderContext->GetCopyCommandQueue(), fenceValue);
-        }
+        auto [cameraEntity, camera] = scene->GetMainCamera();
+        mResourceStreamer->Update(*mStreamingUploader, camera.eyePosition);
     }
 }
\ No newline at end of file
@@ -9,8 +9,11 @@
 #include <Scene/SceneForwards.h>
 
 #include <Render/FrameTransientContext.h>
+#include <Render/PassCommandRecorder.h>
 
 
+#include <entt/fwd.hpp>
+#include <d3d12.h>
 #include <vector>
 
 namespace Engine::Render
@@ -22,7 +25,7 @@ namespace Engine::Render
         ~Renderer();
 
     public:
-        void Initialize();
+        void Initialize(Scene::SceneObject* scene);
         void Deinitialize();
 
         void Render(Scene::SceneObject* scene, const Timer& timer);
@@ -32,14 +35,39 @@ namespace Engine::Render
     private:
         void PrepareFrame();
         void RenderPasses(Scene::SceneObject* scene, const Timer& timer);
-        void RenderPass(RenderPassBase* pass, Scene::SceneObject* scene, const Timer& timer);
-        void UploadResources(Scene::SceneObject *scene, SharedPtr<RenderContext> renderContext, SharedPtr<Memory::UploadBuffer> uploadBuffer);
+        void AddInitialStateBarriers(std::vector<D3D12_RESOURCE_BARRIER>& barriers);
+        void AddGraphBarriers(uint32 passIndex, uint32 position, std::vector<D3D12_RESOURCE_BARRIER>& barriers);
+        struct PassCommandList
+        {
+            uint32 position;
+            uint32 index;
+            uint32 count;
+            ComPtr<ID3D12GraphicsCommandList> commandList;
+            SharedPtr<ResourceStateTracker> resourceStateTracker;
+            PassCommandStatistics statistics;
+        };
+
+        void RecordPass(RenderPassBase* pass, PassCommandList& passCommandList, FrameTransientContext* frameContext, const Timer& timer);
+        void ReserveFrameContexts(Size count);
+        void EnqueueResources(Scene::SceneObject *scene);
+        void StreamResources(Scene::SceneObject *scene);
+        void EnqueueMesh(entt::registry &registry, entt::entity entity, const Scene::Mesh &mesh);
+        void EnqueueCubeMap(const Scene::CubeMap &cubeMap);
+        void MarkForUpload(entt::registry &registry, entt::entity entity);
     private:
-        FrameTransientContext mFrameContexts[EngineConfig::SwapChainBufferCount];
+        // Every command list of a frame records with its own context, they share the upload buffer of the frame.
+        std::vector<FrameTransientContext> mFrameContexts[EngineConfig::SwapChainBufferCount];
+        SharedPtr<Memory::UploadBuffer> mUploadBuffers[EngineConfig::SwapChainBufferCount];
 
     private:
         SharedPtr<RenderContext> mRenderContext;
         std::vector<RenderPassBase*> mRenderPasses;
+        UniquePtr<RenderGraph> mRenderGraph;
         UniquePtr<FrameResourceProvider> mFrameResourceProvider;
+
+        UniquePtr<StreamingUploader> mStreamingUploader;
+        UniquePtr<ResourceStreamer> mResourceStreamer;
+        // Entities whose mesh or cube map was added or replaced since the last frame.
+        std::vector<entt::entity> mEntitiesToUpload;
     };
 } // namespace Engine::Render
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "ResourceAliasing.h"
+
+#include <MathUtils.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace Engine::Render
+{
+    namespace
+    {
+        bool AreAliveTogether(const AliasedResourceRequest &a, const AliasedResourceRequest &b)
+        {
+            return a.firstUse <= b.lastUse && b.firstUse <= a.lastUse;
+        }
+    }
+
+    void PackAliasedResources(std::span<const AliasedResourceRequest> requests, AliasedResourcesLayout &layout)
+    {
+        layout.offsets.assign(requests.size(), 0);
+        layout.isAliased.assign(requests.size(), false);
+        layout.heapSize = 0;
+        layout.naiveSize = 0;
+
+        std::vector<uint32> order(requests.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&requests](uint32 a, uint32 b)
+        {
+            return requests[a].size > requests[b].size;
+        });
+
+        struct Range
+        {
+            uint64 begin;
+            uint64 end;
+        };
+
+        std::vector<uint32> placed;
+        std::vector<Range> occupied;
+        for (auto index : order)
+        {
+            const auto &request = requests[index];
+
+            occupied.clear();
+            for (auto other : placed)
+            {
+                if (AreAliveTogether(request, requests[other]))
+                {
+                    occupied.push_back({layout.offsets[other], layout.offsets[other] + requests[other].size});
+                }
+            }
+
+            std::sort(occupied.begin(), occupied.end(), [](const Range &a, const Range &b)
+            {
+                return a.begin < b.begin;
+            });
+
+            // First gap between the memory of the resources alive at the same time that holds the request.
+            uint64 offset = 0;
+            for (const auto &range : occupied)
+            {
+                if (Math::AlignUp(offset, request.alignment) + request.size <= range.begin)
+                {
+                    break;
+                }
+                offset = std::max(offset, range.end);
+            }
+
+            offset = Math::AlignUp(offset, request.alignment);
+            layout.offsets[index] = offset;
+            layout.heapSize = std::max(layout.heapSize, offset + request.size);
+            layout.naiveSize += Math::AlignUp(request.size, request.alignment);
+
+            placed.push_back(index);
+        }
+
+        for (uint32 a = 0; a < requests.size(); ++a)
+        {
+            for (uint32 b = a + 1; b < requests.size(); ++b)
+            {
+                const bool isOverlapped = layout.offsets[a] < layout.offsets[b] + requests[b].size && layout.offsets[b] < layout.offsets[a] + requests[a].size;
+                if (isOverlapped)
+                {
+                    layout.isAliased[a] = true;
+                    layout.isAliased[b] = true;
+                }
+            }
+        }
+    }
+} // namespace Engine::Render
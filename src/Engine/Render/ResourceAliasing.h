@@ -0,0 +1,35 @@
+#pragma once
+
+#include <Types.h>
+
+#include <span>
+#include <vector>
+
+namespace Engine::Render
+{
+    struct AliasedResourceRequest
+    {
+        uint64 size = 0;
+        // Power of two.
+        uint64 alignment = 1;
+
+        // Positions in the execution order of the first and the last pass using the resource, both included.
+        uint32 firstUse = 0;
+        uint32 lastUse = 0;
+    };
+
+    struct AliasedResourcesLayout
+    {
+        std::vector<uint64> offsets;
+        // Set for resources sharing memory with another one, they need an aliasing barrier before their first use.
+        std::vector<bool> isAliased;
+
+        // Peak memory of the shared heap and memory of a separate allocation for every resource.
+        uint64 heapSize = 0;
+        uint64 naiveSize = 0;
+    };
+
+    // Places resources into one heap, resources alive during the same pass never overlap and the others may share memory.
+    // Largest resources go first, each at the lowest offset that is free over its whole lifetime.
+    void PackAliasedResources(std::span<const AliasedResourceRequest> requests, AliasedResourcesLayout &layout);
+} // namespace Engine::Render
@@ -8,20 +8,32 @@ namespace Engine::Render
     void ResourcePlanner::NewRenderTarget(const Name &name, const TextureCreationInfo &textureInfo)
     {
         mResourcesForCreate.push_back({name, textureInfo});
+        mResourceAccesses.push_back({name, D3D12_RESOURCE_STATE_RENDER_TARGET, true});
     }
 
     void ResourcePlanner::NewDepthStencil(const Name &name, const TextureCreationInfo &textureInfo)
     {
         mResourcesForCreate.push_back({name, textureInfo});
+        mResourceAccesses.push_back({name, D3D12_RESOURCE_STATE_DEPTH_WRITE, true});
     }
 
-    void ResourcePlanner::ReadRenderTarget(const Name &name)
+    void ResourcePlanner::WriteRenderTarget(const Name &name)
     {
+        mResourceAccesses.push_back({name, D3D12_RESOURCE_STATE_RENDER_TARGET, true});
+    }
 
+    void ResourcePlanner::ReadRenderTarget(const Name &name)
+    {
+        ReadTexture(name);
     }
 
     void ResourcePlanner::ReadDeptStencil(const Name &name)
     {
+        mResourceAccesses.push_back({name, D3D12_RESOURCE_STATE_DEPTH_WRITE, false});
+    }
 
+    void ResourcePlanner::ReadTexture(const Name &name)
+    {
+        mResourceAccesses.push_back({name, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, false});
     }
 } // namespace Engine::Render
\ No newline at end of file
@@ -19,6 +19,13 @@ namespace Engine::Render
                 Name name;
                 TextureCreationInfo creationInfo;
             };
+
+            struct ResourceAccess
+            {
+                Name name;
+                D3D12_RESOURCE_STATES state;
+                bool isWrite;
+            };
             
         public:
             ResourcePlanner();
@@ -26,15 +33,30 @@ namespace Engine::Render
         
         public:
 
+            // Resources only live through the frame and share memory with the ones used by other passes,
+            // the first pass writing a resource clears it.
             void NewRenderTarget(const Name& name, const TextureCreationInfo& textureInfo);
             void NewDepthStencil(const Name& name, const TextureCreationInfo& textureInfo);
 
+            // Draws on top of a render target another pass created.
+            void WriteRenderTarget(const Name& name);
+
             void ReadRenderTarget(const Name& name);
+            // Depth tested against without writing, the depth stencil view stays writable.
             void ReadDeptStencil(const Name& name);
+            // Sampled in the pixel shader.
+            void ReadTexture(const Name& name);
+
+            // Passes writing to the back buffer are the outputs of the frame, passes nothing reads from are culled.
+            void WriteBackBuffer() { mWritesBackBuffer = true; }
 
             const std::vector<ResourceCreationInfo> GetPlannedResources() const { return mResourcesForCreate; }
+            const std::vector<ResourceAccess> &GetResourceAccesses() const { return mResourceAccesses; }
+            bool WritesBackBuffer() const { return mWritesBackBuffer; }
         
         private:
             std::vector<ResourceCreationInfo> mResourcesForCreate;
+            std::vector<ResourceAccess> mResourceAccesses;
+            bool mWritesBackBuffer = false;
     };
 } // namespace Engine::Render
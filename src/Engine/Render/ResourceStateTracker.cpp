@@ -1,5 +1,7 @@
 #include "ResourceStateTracker.h"
 
+#include <d3dx12.h>
+
 namespace Engine::Render
 {
 
@@ -43,31 +45,31 @@ namespace Engine::Render
     {
         if (barrier.Type == D3D12_RESOURCE_BARRIER_TYPE_TRANSITION)
         {
-            const D3D12_RESOURCE_TRANSITION_BARRIER &transitionBarrier = barrier.Transition;
+            TransitionResource(barrier.Transition.pResource, barrier.Transition.StateAfter);
+        }
+        else
+        {
+            mBarriers.emplace_back(barrier);
+        }
+    }
 
-            auto resource = transitionBarrier.pResource;
-            auto iter = mFinalStates.find(resource);
-            if (iter != mFinalStates.end())
-            {
-                auto finalState = iter->second;
-                if (finalState != transitionBarrier.StateAfter)
-                {
-                    D3D12_RESOURCE_BARRIER newBarrier = barrier;
-                    newBarrier.Transition.StateBefore = finalState;
-                    mBarriers.emplace_back(newBarrier);
-                }
-            }
-            else
+    void ResourceStateTracker::TransitionResource(ID3D12Resource *resource, D3D12_RESOURCE_STATES stateAfter)
+    {
+        auto iter = mFinalStates.find(resource);
+        if (iter != mFinalStates.end())
+        {
+            auto finalState = iter->second;
+            if (finalState != stateAfter)
             {
-                mPendingBarriers.emplace_back(barrier);
+                mBarriers.emplace_back(CD3DX12_RESOURCE_BARRIER::Transition(resource, finalState, stateAfter));
             }
-
-            mFinalStates[transitionBarrier.pResource] = transitionBarrier.StateAfter;
         }
         else
         {
-            mBarriers.emplace_back(barrier);
+            mPendingTransitions.push_back({resource, stateAfter});
         }
+
+        mFinalStates[resource] = stateAfter;
     }
 
     void ResourceStateTracker::FlushBarriers(ComPtr<ID3D12GraphicsCommandList> commandList)
@@ -83,22 +85,7 @@ namespace Engine::Render
     uint32 ResourceStateTracker::FlushPendingBarriers(ComPtr<ID3D12GraphicsCommandList> commandList)
     {
         std::vector<D3D12_RESOURCE_BARRIER> resourceBarriers;
-        resourceBarriers.reserve(mPendingBarriers.size());
-
-        for (auto &barrier : mPendingBarriers)
-        {
-            auto *resource = barrier.Transition.pResource;
-            auto &stateAfter = barrier.Transition.StateAfter;
-
-            auto globalState = mGlobalReourceTracker->GetLastState(resource);
-
-            if (stateAfter != globalState)
-            {
-                D3D12_RESOURCE_BARRIER newBarrier = barrier;
-                newBarrier.Transition.StateBefore = globalState;
-                resourceBarriers.emplace_back(newBarrier);
-            }
-        }
+        ResolvePendingBarriers(resourceBarriers);
 
         uint32 numBarriers = static_cast<uint32>(resourceBarriers.size());
         if (numBarriers > 0)
@@ -106,11 +93,24 @@ namespace Engine::Render
             commandList->ResourceBarrier(numBarriers, resourceBarriers.data());
         }
 
-        mPendingBarriers.clear();
-
         return numBarriers;
     }
 
+    void ResourceStateTracker::ResolvePendingBarriers(std::vector<D3D12_RESOURCE_BARRIER> &barriers)
+    {
+        for (const auto &transition : mPendingTransitions)
+        {
+            auto globalState = mGlobalReourceTracker->GetLastState(transition.resource);
+
+            if (transition.stateAfter != globalState)
+            {
+                barriers.emplace_back(CD3DX12_RESOURCE_BARRIER::Transition(transition.resource, globalState, transition.stateAfter));
+            }
+        }
+
+        mPendingTransitions.clear();
+    }
+
     void ResourceStateTracker::CommitFinalResourceStates()
     {
         for (auto &iter : mFinalStates)
@@ -31,10 +31,17 @@ namespace Engine::Render
 
         void ResourceBarrier(const D3D12_RESOURCE_BARRIER &barrier);
 
+        // The state before is the one the resource was last transitioned to on this tracker,
+        // the first transition of a resource waits for the global state it starts from.
+        void TransitionResource(ID3D12Resource *resource, D3D12_RESOURCE_STATES stateAfter);
+
         void FlushBarriers(ComPtr<ID3D12GraphicsCommandList> commandList);
 
         uint32 FlushPendingBarriers(ComPtr<ID3D12GraphicsCommandList> commandList);
 
+        // Appends the first transitions that change the global state of their resource.
+        void ResolvePendingBarriers(std::vector<D3D12_RESOURCE_BARRIER> &barriers);
+
         void CommitFinalResourceStates();
 
         void TrackResource(ID3D12Resource *resource, D3D12_RESOURCE_STATES state);
@@ -44,8 +51,14 @@ namespace Engine::Render
     private:
         SharedPtr<GlobalResourceStateTracker> mGlobalReourceTracker;
 
+        struct PendingTransition
+        {
+            ID3D12Resource *resource;
+            D3D12_RESOURCE_STATES stateAfter;
+        };
+
         std::vector<D3D12_RESOURCE_BARRIER> mBarriers;
-        std::vector<D3D12_RESOURCE_BARRIER> mPendingBarriers;
+        std::vector<PendingTransition> mPendingTransitions;
         std::unordered_map<ID3D12Resource *, D3D12_RESOURCE_STATES> mFinalStates;
     };
 
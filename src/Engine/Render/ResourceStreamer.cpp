@@ -0,0 +1,183 @@
+#include "ResourceStreamer.h"
+
+#include <Memory/Buffer.h>
+#include <Memory/IndexBuffer.h>
+#include <Memory/VertexBuffer.h>
+
+#include <Scene/Mesh.h>
+#include <Scene/CubeMap.h>
+#include <Scene/Material.h>
+#include <Scene/Texture.h>
+
+#include <algorithm>
+
+namespace Engine::Render
+{
+    namespace
+    {
+        const Memory::Resource *GetResource(const StreamingRequest &request)
+        {
+            if (request.buffer)
+            {
+                return request.buffer.get();
+            }
+
+            return request.texture.get();
+        }
+
+        bool IsTextureResident(const SharedPtr<Scene::Texture> &texture)
+        {
+            return !texture || texture->GetD3D12Resource() != nullptr;
+        }
+    }
+
+    ResourceStreamer::ResourceStreamer(Size frameBudget, Size maxBatchesInFlight)
+        : mFrameBudget(frameBudget), mMaxBatchesInFlight(maxBatchesInFlight)
+    {
+    }
+
+    ResourceStreamer::~ResourceStreamer() = default;
+
+    ResourceStreamer::PendingRequest *ResourceStreamer::Add(const StreamingRequest &request, bool &isNew)
+    {
+        isNew = false;
+
+        auto resource = GetResource(request);
+        if (!resource || resource->GetD3D12Resource() || mInFlight.contains(resource))
+        {
+            return nullptr;
+        }
+
+        auto [it, inserted] = mPending.try_emplace(resource);
+        if (inserted)
+        {
+            it->second.request = request;
+            mPendingBytes += request.sizeInBytes;
+            isNew = true;
+        }
+
+        return &it->second;
+    }
+
+    void ResourceStreamer::Enqueue(const StreamingRequest &request)
+    {
+        bool isNew;
+        if (auto pending = Add(request, isNew))
+        {
+            pending->locations.clear();
+        }
+    }
+
+    void ResourceStreamer::Enqueue(const StreamingRequest &request, const dx::XMFLOAT3 &location)
+    {
+        bool isNew;
+        auto pending = Add(request, isNew);
+
+        // A request without locations is already streamed first.
+        if (pending && (isNew || pending->locations.size() > 0))
+        {
+            pending->locations.push_back(location);
+        }
+    }
+
+    void ResourceStreamer::CompleteBatches(StreamingCopyQueue &copyQueue)
+    {
+        while (!mBatches.empty() && copyQueue.IsFenceCompleted(mBatches.front().fenceValue))
+        {
+            auto &batch = mBatches.front();
+            copyQueue.Complete(batch.fenceValue);
+
+            for (auto resource : batch.keys)
+            {
+                mInFlight.erase(resource);
+            }
+
+            mBatches.pop_front();
+        }
+    }
+
+    void ResourceStreamer::Update(StreamingCopyQueue &copyQueue, const dx::XMVECTOR &eyePosition)
+    {
+        CompleteBatches(copyQueue);
+
+        if (mPending.empty() || mBatches.size() >= mMaxBatchesInFlight)
+        {
+            return;
+        }
+
+        std::vector<PendingRequest *> requests;
+        requests.reserve(mPending.size());
+
+        for (auto &[resource, pending] : mPending)
+        {
+            pending.priority = 0.0f;
+            for (Size i = 0; i < pending.locations.size(); ++i)
+            {
+                auto offset = dx::XMVectorSubtract(dx::XMLoadFloat3(&pending.locations[i]), eyePosition);
+                const float32 distance = dx::XMVectorGetX(dx::XMVector3LengthSq(offset));
+
+                pending.priority = (i == 0 || distance < pending.priority) ? distance : pending.priority;
+            }
+
+            requests.push_back(&pending);
+        }
+
+        std::sort(requests.begin(), requests.end(), [](const PendingRequest *a, const PendingRequest *b) { return a->priority < b->priority; });
+
+        std::vector<StreamingRequest> batchRequests;
+        Size batchSize = 0;
+        for (auto pending : requests)
+        {
+            if (batchRequests.size() > 0 && batchSize + pending->request.sizeInBytes > mFrameBudget)
+            {
+                break;
+            }
+
+            batchSize += pending->request.sizeInBytes;
+            batchRequests.push_back(pending->request);
+        }
+
+        Batch batch;
+        batch.fenceValue = copyQueue.Submit(batchRequests, batchSize);
+        batch.keys.reserve(batchRequests.size());
+
+        for (const auto &request : batchRequests)
+        {
+            auto resource = GetResource(request);
+
+            batch.keys.push_back(resource);
+            mInFlight.insert(resource);
+            mPending.erase(resource);
+        }
+
+        mPendingBytes -= batchSize;
+        mBatches.push_back(std::move(batch));
+    }
+
+    bool ResourceStreamer::IsResident(const Scene::Mesh &mesh)
+    {
+        if (!mesh.vertexBuffer->GetD3D12Resource() || !mesh.indexBuffer->GetD3D12Resource())
+        {
+            return false;
+        }
+
+        if (mesh.positionBuffer && !mesh.positionBuffer->GetD3D12Resource())
+        {
+            return false;
+        }
+
+        const auto &material = *mesh.material;
+        return IsTextureResident(material.GetBaseColorTexture()) &&
+            IsTextureResident(material.GetMetallicRoughnessTexture()) &&
+            IsTextureResident(material.GetNormalTexture()) &&
+            IsTextureResident(material.GetEmissiveTexture()) &&
+            IsTextureResident(material.GetAmbientOcclusionTexture());
+    }
+
+    bool ResourceStreamer::IsResident(const Scene::CubeMap &cubeMap)
+    {
+        return cubeMap.vertexBuffer->GetD3D12Resource() != nullptr &&
+            cubeMap.indexBuffer->GetD3D12Resource() != nullptr &&
+            IsTextureResident(cubeMap.texture);
+    }
+} // namespace Engine::Render
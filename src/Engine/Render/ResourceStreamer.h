@@ -0,0 +1,86 @@
+#pragma once
+
+#include <Types.h>
+#include <Memory/MemoryForwards.h>
+#include <Scene/SceneForwards.h>
+
+#include <DirectXMath.h>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Engine::Render
+{
+    // A buffer or a texture waiting for its GPU copy.
+    struct StreamingRequest
+    {
+        SharedPtr<Memory::Buffer> buffer;
+        SharedPtr<Scene::Texture> texture;
+        // Staging memory taken by the upload, including its placement alignment.
+        Size sizeInBytes = 0;
+    };
+
+    // The copy queue side of the streamer, kept abstract so the scheduling works against a fake queue.
+    class StreamingCopyQueue
+    {
+    public:
+        virtual ~StreamingCopyQueue() = default;
+
+        // Records and submits the uploads of a batch, returns the fence value the batch completes at.
+        virtual uint64 Submit(const std::vector<StreamingRequest> &batch, Size batchSize) = 0;
+        virtual bool IsFenceCompleted(uint64 fenceValue) = 0;
+        // Called once for every submitted batch after its fence completed, publishes the uploaded resources.
+        virtual void Complete(uint64 fenceValue) = 0;
+    };
+
+    // Uploads scene resources progressively: closest to the eye first, at most a byte budget per frame.
+    // A request larger than the budget is submitted alone so it never blocks the queue.
+    class ResourceStreamer
+    {
+    public:
+        ResourceStreamer(Size frameBudget, Size maxBatchesInFlight);
+        ~ResourceStreamer();
+
+    public:
+        // Resources that are already resident or streaming are ignored.
+        void Enqueue(const StreamingRequest &request);
+        void Enqueue(const StreamingRequest &request, const DirectX::XMFLOAT3 &location);
+
+        void Update(StreamingCopyQueue &copyQueue, const DirectX::XMVECTOR &eyePosition);
+
+        bool IsIdle() const { return mPending.empty() && mBatches.empty(); }
+        Size GetPendingCount() const { return mPending.size(); }
+        Size GetPendingBytes() const { return mPendingBytes; }
+
+        static bool IsResident(const Scene::Mesh &mesh);
+        static bool IsResident(const Scene::CubeMap &cubeMap);
+
+    private:
+        struct PendingRequest
+        {
+            StreamingRequest request;
+            // Places the resource is used at, an empty list is streamed first.
+            std::vector<DirectX::XMFLOAT3> locations;
+            float32 priority = 0.0f;
+        };
+
+        struct Batch
+        {
+            uint64 fenceValue = 0;
+            std::vector<const Memory::Resource *> keys;
+        };
+
+        PendingRequest *Add(const StreamingRequest &request, bool &isNew);
+        void CompleteBatches(StreamingCopyQueue &copyQueue);
+
+    private:
+        Size mFrameBudget;
+        Size mMaxBatchesInFlight;
+
+        std::unordered_map<const Memory::Resource *, PendingRequest> mPending;
+        std::unordered_set<const Memory::Resource *> mInFlight;
+        std::deque<Batch> mBatches;
+        Size mPendingBytes = 0;
+    };
+} // namespace Engine::Render
@@ -23,7 +23,7 @@ namespace Engine::Render
 
     RootSignature *RootSignatureProvider::GetRootSignature(const Name &name)
     {
-        return mRootSignatureMap[name].get();
+        return mRootSignatureMap.at(name).get();
     }
 
 } // namespace Engine::Render
\ No newline at end of file
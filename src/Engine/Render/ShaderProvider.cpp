@@ -22,9 +22,13 @@ namespace Engine::Render
         }
         else
         {
+            // D3DCompile expects the defines array to be null terminated.
+            std::vector<D3D_SHADER_MACRO> defines = creationInfo.defines;
+            defines.push_back({nullptr, nullptr});
+
             auto shader = ShaderCompiler::Compile(
                 StringToWString(creationInfo.path),
-                creationInfo.defines.data(),
+                defines.data(),
                 creationInfo.entryPoint,
                 creationInfo.target);
                 
@@ -0,0 +1,141 @@
+#include "StreamingUploader.h"
+
+#include <Memory/Buffer.h>
+#include <Memory/UploadBuffer.h>
+
+#include <Render/CommandQueue.h>
+#include <Render/CommandListUtils.h>
+#include <Render/RenderContext.h>
+#include <Render/ResourceStateTracker.h>
+
+#include <Scene/Texture.h>
+
+namespace Engine::Render
+{
+    StreamingUploader::StreamingUploader(SharedPtr<RenderContext> renderContext, Size stagingBufferSize)
+        : mRenderContext(renderContext), mStagingBufferSize(stagingBufferSize)
+    {
+    }
+
+    StreamingUploader::~StreamingUploader()
+    {
+        if (!mSubmissions.empty())
+        {
+            mRenderContext->GetCopyCommandQueue()->WaitForFenceCPU(mSubmissions.back().fenceValue);
+        }
+    }
+
+    StreamingRequest StreamingUploader::CreateRequest(SharedPtr<Memory::Buffer> buffer) const
+    {
+        StreamingRequest request;
+        request.sizeInBytes = CommandListUtils::GetUploadSize(mRenderContext, *buffer);
+        request.buffer = std::move(buffer);
+
+        return request;
+    }
+
+    StreamingRequest StreamingUploader::CreateRequest(SharedPtr<Scene::Texture> texture) const
+    {
+        StreamingRequest request;
+        request.sizeInBytes = CommandListUtils::GetUploadSize(mRenderContext, *texture);
+        request.texture = std::move(texture);
+
+        return request;
+    }
+
+    uint64 StreamingUploader::Submit(const std::vector<StreamingRequest> &batch, Size batchSize)
+    {
+        Submission submission;
+        submission.requests = batch;
+
+        // A request over the budget gets a staging buffer of its own, released with the batch.
+        if (batchSize > mStagingBufferSize)
+        {
+            submission.stagingBuffer = MakeShared<Memory::UploadBuffer>(mRenderContext->Device().Get(), batchSize);
+        }
+        else if (!mFreeStagingBuffers.empty())
+        {
+            submission.stagingBuffer = mFreeStagingBuffers.back();
+            mFreeStagingBuffers.pop_back();
+        }
+        else
+        {
+            submission.stagingBuffer = MakeShared<Memory::UploadBuffer>(mRenderContext->Device().Get(), mStagingBufferSize);
+        }
+
+        submission.stagingBuffer->Reset();
+
+        auto stateTracker = MakeShared<ResourceStateTracker>(mRenderContext->GetGlobalResourceStateTracker());
+
+        auto commandList = mRenderContext->CreateCopyCommandList();
+        commandList->SetName(L"Streaming resources List");
+
+        submission.resources.reserve(batch.size());
+        for (const auto &request : batch)
+        {
+            if (request.buffer)
+            {
+                submission.resources.push_back(CommandListUtils::UploadBuffer(mRenderContext, commandList, stateTracker, *request.buffer, submission.stagingBuffer));
+            }
+            else
+            {
+                submission.resources.push_back(CommandListUtils::UploadTexture(mRenderContext, commandList, stateTracker, *request.texture, submission.stagingBuffer));
+            }
+        }
+
+        auto barriersCommandList = mRenderContext->CreateCopyCommandList();
+
+        auto barriers = stateTracker->FlushPendingBarriers(barriersCommandList);
+        stateTracker->CommitFinalResourceStates();
+
+        barriersCommandList->Close();
+        commandList->Close();
+
+        std::vector<ID3D12CommandList *> commandLists;
+        if (barriers > 0)
+        {
+            commandLists.push_back(barriersCommandList.Get());
+        }
+        commandLists.push_back(commandList.Get());
+
+        submission.fenceValue = mRenderContext->GetCopyCommandQueue()->ExecuteCommandLists(commandLists.size(), commandLists.data());
+
+        const uint64 fenceValue = submission.fenceValue;
+        mSubmissions.push_back(std::move(submission));
+
+        return fenceValue;
+    }
+
+    bool StreamingUploader::IsFenceCompleted(uint64 fenceValue)
+    {
+        return mRenderContext->GetCopyCommandQueue()->IsFenceCompleted(fenceValue);
+    }
+
+    void StreamingUploader::Complete(uint64 fenceValue)
+    {
+        while (!mSubmissions.empty() && mSubmissions.front().fenceValue <= fenceValue)
+        {
+            auto &submission = mSubmissions.front();
+
+            for (Size i = 0; i < submission.requests.size(); ++i)
+            {
+                const auto &request = submission.requests[i];
+                if (request.buffer)
+                {
+                    request.buffer->SetD3D12Resource(submission.resources[i]);
+                }
+                else
+                {
+                    request.texture->SetD3D12Resource(submission.resources[i]);
+                }
+            }
+
+            if (submission.stagingBuffer->GetSize() == mStagingBufferSize)
+            {
+                mFreeStagingBuffers.push_back(submission.stagingBuffer);
+            }
+
+            mSubmissions.pop_front();
+        }
+    }
+} // namespace Engine::Render
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <Types.h>
+#include <Memory/MemoryForwards.h>
+#include <Render/RenderForwards.h>
+#include <Render/ResourceStreamer.h>
+
+#include <d3d12.h>
+#include <deque>
+#include <vector>
+
+namespace Engine::Render
+{
+    // Records streaming batches on the copy queue, staging memory is reused once the batch fence completes.
+    class StreamingUploader : public StreamingCopyQueue
+    {
+    public:
+        StreamingUploader(SharedPtr<RenderContext> renderContext, Size stagingBufferSize);
+        ~StreamingUploader() override;
+
+    public:
+        uint64 Submit(const std::vector<StreamingRequest> &batch, Size batchSize) override;
+        bool IsFenceCompleted(uint64 fenceValue) override;
+        void Complete(uint64 fenceValue) override;
+
+        StreamingRequest CreateRequest(SharedPtr<Memory::Buffer> buffer) const;
+        StreamingRequest CreateRequest(SharedPtr<Scene::Texture> texture) const;
+
+    private:
+        struct Submission
+        {
+            uint64 fenceValue = 0;
+            SharedPtr<Memory::UploadBuffer> stagingBuffer;
+            std::vector<StreamingRequest> requests;
+            std::vector<ComPtr<ID3D12Resource>> resources;
+        };
+
+    private:
+        SharedPtr<RenderContext> mRenderContext;
+        Size mStagingBufferSize;
+
+        std::vector<SharedPtr<Memory::UploadBuffer>> mFreeStagingBuffers;
+        std::deque<Submission> mSubmissions;
+    };
+} // namespace Engine::Render
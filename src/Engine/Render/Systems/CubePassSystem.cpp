@@ -1,6 +1,7 @@
 #include "CubePassSystem.h"
 
 #include <Render/Renderer.h>
+#include <Render/ResourceStreamer.h>
 #include <Render/Passes/CubePass.h>
 #include <Render/Passes/Data/PassData.h>
 
@@ -29,7 +30,7 @@ namespace Engine::Render::Systems
         Render::Passes::CubePassData data = {};
 
         auto view = registry.view<Scene::Components::CubeMapComponent>();
-        if (!view.empty())
+        if (!view.empty() && Render::ResourceStreamer::IsResident(registry.get<Scene::Components::CubeMapComponent>(view.front()).cubeMap))
         {
             auto [cameraEntity, camera] = scene->GetMainCamera();
 
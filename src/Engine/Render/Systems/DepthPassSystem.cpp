@@ -1,18 +1,69 @@
 #include "DepthPassSystem.h"
 
 #include <Render/Renderer.h>
+#include <Render/ResourceStreamer.h>
 #include <Render/Passes/DepthPass.h>
 
 #include <Scene/SceneObject.h>
-#include <Scene/Components/CameraComponent.h>
+#include <Scene/MeshletCulling.h>
 #include <Scene/Components/WorldTransformComponent.h>
-#include <Scene/Components/LightComponent.h>
 #include <Scene/Components/MeshComponent.h>
 #include <Scene/Components/AABBComponent.h>
-#include <Scene/Components/IsDisabledComponent.h>
+#include <Scene/Components/ShadowCascadesComponent.h>
+#include <Scene/Components/ShadowViewsComponent.h>
+
+#include <entt/entt.hpp>
+#include <vector>
 
 namespace Engine::Render::Systems
 {
+    namespace
+    {
+        void AddShadowView(
+            entt::registry &registry,
+            Render::Passes::DepthPassData &data,
+            const Render::Passes::CameraData &camera,
+            const dx::XMUINT3 &tile,
+            const std::vector<entt::entity> &visibleEntities,
+            const Scene::MeshletCulling::View &cullingView)
+        {
+            Render::Passes::ShadowViewData viewData = {};
+            viewData.camera = camera;
+            viewData.tile = tile;
+            viewData.firstMesh = static_cast<uint32>(data.meshes.size());
+
+            for (auto entity : visibleEntities)
+            {
+                const auto &[meshComponent, transformComponent, aabbComponent] = registry.get<
+                    Scene::Components::MeshComponent,
+                    Scene::Components::WorldTransformComponent,
+                    Scene::Components::AABBComponent>(entity);
+
+                if (!Render::ResourceStreamer::IsResident(meshComponent.mesh))
+                {
+                    continue;
+                }
+
+                Render::Passes::MeshData meshData = {};
+                meshData.firstDrawRange = static_cast<uint32>(data.drawRanges.size());
+                const uint32 lod = Scene::MeshletCulling::SelectLod(meshComponent.mesh, transformComponent.transform, aabbComponent.boundingBox, cullingView);
+                meshData.drawRangesCount = Scene::MeshletCulling::Cull(meshComponent.mesh, transformComponent.transform, lod, cullingView, data.drawRanges);
+                if (meshData.drawRangesCount == 0)
+                {
+                    continue;
+                }
+
+                meshData.mesh = meshComponent.mesh;
+                meshData.worldTransform = transformComponent.transform;
+
+                data.meshes.push_back(meshData);
+            }
+
+            viewData.meshesCount = static_cast<uint32>(data.meshes.size()) - viewData.firstMesh;
+            data.views.push_back(viewData);
+        }
+    }
+
     DepthPassSystem::DepthPassSystem(SharedPtr<Render::Renderer> renderer)
         : mRenderer(renderer)
     {
@@ -31,39 +82,39 @@ namespace Engine::Render::Systems
 
         Render::Passes::DepthPassData data = {};
 
-        auto [cameraEntity, camera] = scene->GetMainCamera();
-
-        auto cameras = registry.view<Scene::Components::CameraComponent, Scene::Components::LightComponent>();
-
-        for (auto&& [entity, cameraComponent, lightComponent] : cameras.each())
+        // The shadow atlas keeps cascades of the first enabled directional light only.
+        auto cascadesView = registry.view<Scene::Components::ShadowCascadesComponent>();
+        for (auto&& [entity, cascadesComponent] : cascadesView.each())
         {
-            if (lightComponent.light.GetLightType() == Scene::LightType::DirectionalLight)
+            for (Size i = 0; i < cascadesComponent.cascades.size(); ++i)
             {
-                camera = cameraComponent;
-                cameraEntity = entity;
-                break;
+                const auto &cascade = cascadesComponent.cascades[i];
+                const auto &tile = cascadesComponent.tiles[i];
+
+                Render::Passes::CameraData camera = {};
+                camera.projection = cascade.projection;
+                camera.view = cascade.view;
+                camera.viewProjection = dx::XMMatrixTranspose(cascade.viewProjection);
+                camera.eyePosition = dx::XMVectorZero();
+
+                AddShadowView(registry, data, camera, tile, cascadesComponent.visibleEntities[i], Scene::MeshletCulling::GetView(cascade, tile.z));
             }
         }
 
-        data.camera.projection = camera.projection;
-        data.camera.view = camera.view;
-        data.camera.viewProjection = camera.viewProjection;
-        data.camera.eyePosition = camera.eyePosition;
-
-        const auto &meshsView = registry.view<
-            Scene::Components::MeshComponent, 
-            Scene::Components::WorldTransformComponent, 
-            Scene::Components::AABBComponent>(entt::exclude<Scene::Components::IsDisabledComponent>);
-        data.meshes.reserve(meshsView.size_hint());
-        for (auto &&[entity, meshComponent, transformComponent, aabbComponent] : meshsView.each())
+        auto shadowViewsView = registry.view<Scene::Components::ShadowViewsComponent>();
+        for (auto&& [entity, shadowViews] : shadowViewsView.each())
         {
-            if (camera.frustum.Intersects(aabbComponent.boundingBox))
+            for (Size i = 0; i < shadowViews.views.size(); ++i)
             {
-                Render::Passes::MeshData meshData = {};
-                meshData.mesh = meshComponent.mesh;
-                meshData.worldTransform = transformComponent.transform;
+                const auto &view = shadowViews.views[i];
 
-                data.meshes.push_back(meshData);
+                Render::Passes::CameraData camera = {};
+                camera.projection = view.projection;
+                camera.view = view.view;
+                camera.viewProjection = view.viewProjection;
+                camera.eyePosition = view.eyePosition;
+
+                AddShadowView(registry, data, camera, shadowViews.tiles[i], shadowViews.visibleEntities[i], Scene::MeshletCulling::GetView(view));
             }
         }
 
@@ -1,21 +1,62 @@
 #include "ForwardPassSystem.h"
 
+#include <EngineConfig.h>
+
+#include <Render/DrawSortKey.h>
 #include <Render/Renderer.h>
+#include <Render/ResourceStreamer.h>
 #include <Render/Passes/ForwardPass.h>
 #include <Render/Passes/Data/PassData.h>
 
 #include <Scene/SceneObject.h>
+#include <Scene/Material.h>
+#include <Scene/MeshletCulling.h>
 #include <Scene/Components/CameraComponent.h>
 #include <Scene/Components/WorldTransformComponent.h>
 #include <Scene/Components/LightComponent.h>
 #include <Scene/Components/MeshComponent.h>
 #include <Scene/Components/AABBComponent.h>
-#include <Scene/Components/IsDisabledComponent.h>
+#include <Scene/Components/VisibilityComponent.h>
+#include <Scene/Components/ShadowCascadesComponent.h>
+#include <Scene/Components/ShadowViewsComponent.h>
+
+#include <algorithm>
+#include <cmath>
 
 namespace Engine::Render::Systems
 {
+    namespace
+    {
+        // Maps clip space of a shadow view to its tile of the shadow atlas, transposed for the shaders.
+        dx::XMFLOAT4X4 GetShadowTransform(const dx::XMMATRIX &viewProjection, const dx::XMUINT3 &tile)
+        {
+            const float32 scale = static_cast<float32>(tile.z) / EngineConfig::ShadowWidth;
+            const float32 offsetX = static_cast<float32>(tile.x) / EngineConfig::ShadowWidth;
+            const float32 offsetY = static_cast<float32>(tile.y) / EngineConfig::ShadowHeight;
+            const dx::XMMATRIX T(
+                0.5f * scale, 0.0f, 0.0f, 0.0f,
+                0.0f, -0.5f * scale, 0.0f, 0.0f,
+                0.0f, 0.0f, 1.0f, 0.0f,
+                offsetX + 0.5f * scale, offsetY + 0.5f * scale, 0.0f, 1.0f);
+
+            dx::XMFLOAT4X4 transform;
+            dx::XMStoreFloat4x4(&transform, dx::XMMatrixTranspose(viewProjection * T));
+
+            return transform;
+        }
+
+        // Directional lights and lights without falloff reach every pixel.
+        bool IsGlobalLight(const Render::Passes::LightData &lightData)
+        {
+            return lightData.light.GetLightType() == Scene::LightType::DirectionalLight ||
+                !std::isfinite(lightData.light.GetRange(EngineConfig::LightRangeCutoff));
+        }
+
+    }
+
     ForwardPassSystem::ForwardPassSystem(SharedPtr<Render::Renderer> renderer)
         : mRenderer(renderer)
+        , mLightClusters(EngineConfig::LightClustersWidth, EngineConfig::LightClustersHeight, EngineConfig::LightClustersDepth, EngineConfig::MaxLightsPerCluster)
     {
     }
 
@@ -39,57 +80,120 @@ namespace Engine::Render::Systems
         data.camera.viewProjection = camera.viewProjection;
         data.camera.eyePosition = camera.eyePosition;
 
-        auto shadowCameraComponent = camera;
-        auto cameras = registry.view<Scene::Components::CameraComponent, Scene::Components::LightComponent>();
-
-        for (auto&& [entity, cameraComponent, lightComponent] : cameras.each())
+        // The shadow atlas keeps cascades of the first enabled directional light only.
+        auto cascadesView = registry.view<Scene::Components::ShadowCascadesComponent>();
+        for (auto&& [entity, cascadesComponent] : cascadesView.each())
         {
-            if (lightComponent.light.GetLightType() == Scene::LightType::DirectionalLight)
+            for (Size i = 0; i < cascadesComponent.cascades.size(); ++i)
             {
-                shadowCameraComponent = cameraComponent;
-                break;
+                const auto &cascade = cascadesComponent.cascades[i];
+
+                data.cascadeTransforms.push_back(GetShadowTransform(cascade.viewProjection, cascadesComponent.tiles[i]));
+                data.cascadeSplits.push_back(cascade.splitDepth);
             }
         }
 
-        const dx::XMMATRIX T(
-            0.5f, 0.0f, 0.0f, 0.0f,
-            0.0f, -0.5f, 0.0f, 0.0f,
-            0.0f, 0.0f, 1.0f, 0.0f,
-            0.5f, 0.5f, 0.0f, 1.0f);
-
-        dx::XMStoreFloat4x4(&data.shadowTransform, dx::XMMatrixTranspose(dx::XMMatrixTranspose(shadowCameraComponent.viewProjection) * T));
-
         const auto &lightsView = registry.view<Scene::Components::LightComponent, Scene::Components::WorldTransformComponent>();
         
         data.lights.reserve(lightsView.size_hint());
         for (auto &&[entity, lightComponent, transformComponent] : lightsView.each())
         {
-            if (lightComponent.light.IsEnabled())
+            if (lightComponent.light.IsEnabled() && data.lights.size() < MAX_LIGHTS)
             {
                 Render::Passes::LightData lightData = {};
                 lightData.light = lightComponent.light;
                 lightData.worldTransform = transformComponent.transform;
+
+                const auto *shadowViews = registry.try_get<Scene::Components::ShadowViewsComponent>(entity);
+                if (shadowViews && !shadowViews->views.empty())
+                {
+                    lightData.firstShadowTransform = static_cast<int32>(data.shadowTransforms.size());
+                    for (Size i = 0; i < shadowViews->views.size(); ++i)
+                    {
+                        // View projections of cameras are stored transposed.
+                        const auto viewProjection = dx::XMMatrixTranspose(shadowViews->views[i].viewProjection);
+                        data.shadowTransforms.push_back(GetShadowTransform(viewProjection, shadowViews->tiles[i]));
+                    }
+                }
+
                 data.lights.emplace_back(lightData);
             }
         }
 
-        const auto &meshsView = registry.view<
-            Scene::Components::MeshComponent, 
-            Scene::Components::WorldTransformComponent, 
-            Scene::Components::AABBComponent>(entt::exclude<Scene::Components::IsDisabledComponent>);
-        data.meshes.reserve(meshsView.size_hint());
-        for (auto &&[entity, meshComponent, transformComponent, aabbComponent] : meshsView.each())
+        const auto firstLocalLight = std::stable_partition(data.lights.begin(), data.lights.end(), IsGlobalLight);
+        data.globalLightsCount = static_cast<uint32>(std::distance(data.lights.begin(), firstLocalLight));
+
+        mLightBounds.clear();
+        for (auto it = firstLocalLight; it != data.lights.end(); ++it)
         {
-            if (camera.frustum.Intersects(aabbComponent.boundingBox))
+            dx::BoundingSphere bounds;
+            dx::XMStoreFloat3(&bounds.Center, it->worldTransform.r[3]);
+            bounds.Radius = it->light.GetRange(EngineConfig::LightRangeCutoff);
+            mLightBounds.push_back(bounds);
+        }
+
+        const float32 tanHalfWidth = 1.0f / dx::XMVectorGetX(camera.projection.r[0]);
+        const float32 tanHalfHeight = 1.0f / dx::XMVectorGetY(camera.projection.r[1]);
+        mLightClusters.Build(camera.view, tanHalfWidth, tanHalfHeight, camera.camera.GetNearPlane(), camera.camera.GetFarPlane(), mLightBounds);
+
+        data.clusters = mLightClusters.GetClusters();
+        data.clusterLightIndices = mLightClusters.GetLightIndices();
+        data.clusterDepthScale = mLightClusters.GetDepthSliceScale();
+        data.clusterDepthBias = mLightClusters.GetDepthSliceBias();
+
+        const auto &visibleEntities = registry.get<Scene::Components::VisibilityComponent>(cameraEntity).visibleEntities;
+        data.meshes.reserve(visibleEntities.size());
+
+        const auto cullingView = Scene::MeshletCulling::GetView(camera);
+
+        const float32 nearPlane = camera.camera.GetNearPlane();
+        const float32 farPlane = camera.camera.GetFarPlane();
+
+        mMaterialSortIds.clear();
+        mMeshSortIds.clear();
+
+        for (auto entity : visibleEntities)
+        {
+            const auto &[meshComponent, transformComponent, aabbComponent] = registry.get<
+                Scene::Components::MeshComponent,
+                Scene::Components::WorldTransformComponent,
+                Scene::Components::AABBComponent>(entity);
+
+            if (!Render::ResourceStreamer::IsResident(meshComponent.mesh))
             {
-                Render::Passes::MeshData meshData = {};
-                meshData.mesh = meshComponent.mesh;
-                meshData.worldTransform = transformComponent.transform;
+                continue;
+            }
 
-                data.meshes.push_back(meshData);
+            Render::Passes::MeshData meshData = {};
+            meshData.firstDrawRange = static_cast<uint32>(data.drawRanges.size());
+            const uint32 lod = Scene::MeshletCulling::SelectLod(meshComponent.mesh, transformComponent.transform, aabbComponent.boundingBox, cullingView);
+            meshData.drawRangesCount = Scene::MeshletCulling::Cull(meshComponent.mesh, transformComponent.transform, lod, cullingView, data.drawRanges);
+            if (meshData.drawRangesCount == 0)
+            {
+                continue;
             }
+
+            meshData.mesh = meshComponent.mesh;
+            meshData.worldTransform = transformComponent.transform;
+
+            const auto center = dx::XMVector3Transform(dx::XMLoadFloat3(&aabbComponent.boundingBox.Center), camera.view);
+            const float32 depth = (dx::XMVectorGetZ(center) - nearPlane) / (farPlane - nearPlane);
+            // The same choice of pipeline state as ForwardPass::Draw.
+            meshData.sortKey = Render::GetDrawSortKey(
+                meshComponent.mesh.material->GetProperties().doubleSided,
+                meshComponent.mesh.vertexFormat == Scene::VertexFormat::Compact,
+                Render::GetSortId(mMaterialSortIds, meshComponent.mesh.material.get()),
+                Render::GetSortId(mMeshSortIds, meshComponent.mesh.vertexBuffer.get()),
+                depth);
+
+            data.meshes.push_back(meshData);
         }
 
+        std::stable_sort(data.meshes.begin(), data.meshes.end(), [](const Render::Passes::MeshData &a, const Render::Passes::MeshData &b)
+        {
+            return a.sortKey < b.sortKey;
+        });
+
         mForwardPass->SetPassData(data);
 
         mRenderer->RegisterRenderPass(mForwardPass.get());
@@ -4,8 +4,13 @@
 #include <Scene/SceneForwards.h>
 #include <Render/RenderForwards.h>
 #include <Scene/Systems/System.h>
+#include <Scene/LightClusters.h>
 #include <Timer.h>
 
+#include <DirectXCollision.h>
+#include <unordered_map>
+#include <vector>
+
 namespace Engine::Render::Systems
 {
     class ForwardPassSystem : public Scene::Systems::System
@@ -22,5 +27,13 @@ namespace Engine::Render::Systems
         SharedPtr<Render::Renderer> mRenderer;
 
         UniquePtr<Render::Passes::ForwardPass> mForwardPass;
+
+        Scene::LightClusters mLightClusters;
+        // World space range of every local light, in the order of the pass lights after the global ones.
+        std::vector<dx::BoundingSphere> mLightBounds;
+
+        // Sort key ids of the materials and meshes drawn this frame, in the order they were first seen.
+        std::unordered_map<const void *, uint32> mMaterialSortIds;
+        std::unordered_map<const void *, uint32> mMeshSortIds;
     };
 } // namespace Engine::Scene::Systems
\ No newline at end of file
@@ -15,7 +15,7 @@ namespace Engine::Render::Systems
 
     void RenderSystem::Init(Scene::SceneObject *scene)
     {
-        mRenderer->Initialize();
+        mRenderer->Initialize(scene);
     }
 
     void RenderSystem::Process(Scene::SceneObject *scene, const Timer &timer)
@@ -26,6 +26,20 @@ namespace Engine::Render
         mResource->SetName(StringToWString(name).c_str());
     }
 
+    Texture::Texture(ComPtr<ID3D12Device> device, std::string name, const TextureCreationInfo &creationInfo, ID3D12Heap *heap, uint64 heapOffset) :
+        mDevice{device}
+    {
+        ThrowIfFailed(mDevice->CreatePlacedResource(
+            heap,
+            heapOffset,
+            &creationInfo.description,
+            D3D12_RESOURCE_STATE_COMMON,
+            &creationInfo.clearValue,
+            IID_PPV_ARGS(&mResource)));
+
+        mResource->SetName(StringToWString(name).c_str());
+    }
+
     Texture::Texture(ComPtr<ID3D12Device> device, ComPtr<ID3D12Resource> resource, std::string name) : mDevice{device}, mResource{resource}
     {
         mResource->SetName(StringToWString(name).c_str());
@@ -35,6 +49,8 @@ namespace Engine::Render
 
     D3D12_CPU_DESCRIPTOR_HANDLE Texture::GetRTDescriptor(Memory::DescriptorAllocator *allocator)
     {
+        std::lock_guard<std::mutex> lock(mDescriptorsMutex);
+
         if (mRTDescriptor.IsNull())
         {
             mRTDescriptor = allocator->Allocate();
@@ -46,6 +62,8 @@ namespace Engine::Render
 
     D3D12_CPU_DESCRIPTOR_HANDLE Texture::GetDSDescriptor(Memory::DescriptorAllocator *allocator)
     {
+        std::lock_guard<std::mutex> lock(mDescriptorsMutex);
+
         if (mDSDescriptor.IsNull())
         {
             mDSDescriptor = allocator->Allocate();
@@ -57,6 +75,8 @@ namespace Engine::Render
 
     D3D12_CPU_DESCRIPTOR_HANDLE Texture::GetSRDescriptor(Memory::DescriptorAllocator *allocator, const D3D12_SHADER_RESOURCE_VIEW_DESC *desc)
     {
+        std::lock_guard<std::mutex> lock(mDescriptorsMutex);
+
         size_t hash = 0;
         if (desc)
         {
@@ -77,6 +97,8 @@ namespace Engine::Render
 
     D3D12_CPU_DESCRIPTOR_HANDLE Texture::GetUADescriptor(Memory::DescriptorAllocator *allocator, const D3D12_UNORDERED_ACCESS_VIEW_DESC *desc)
     {
+        std::lock_guard<std::mutex> lock(mDescriptorsMutex);
+
         size_t hash = 0;
         if (desc)
         {
@@ -7,6 +7,7 @@
 #include <Memory/DescriptorAllocation.h>
 
 #include <d3d12.h>
+#include <mutex>
 #include <unordered_map>
 
 namespace Engine::Render
@@ -15,6 +16,7 @@ namespace Engine::Render
     {
     public:
         Texture(ComPtr<ID3D12Device> device, std::string name, const TextureCreationInfo &creationInfo);
+        Texture(ComPtr<ID3D12Device> device, std::string name, const TextureCreationInfo &creationInfo, ID3D12Heap *heap, uint64 heapOffset);
         Texture(ComPtr<ID3D12Device> device, ComPtr<ID3D12Resource> resource, std::string name);
         ~Texture();
 
@@ -35,6 +37,8 @@ namespace Engine::Render
         std::unordered_map<size_t, Memory::DescriptorAllocation> mUADescriptors;
         Memory::DescriptorAllocation mRTDescriptor;
         Memory::DescriptorAllocation mDSDescriptor;
+        // Views are created on first use, possibly by several recording threads at once.
+        std::mutex mDescriptorsMutex;
     };
 
 } // namespace Engine::Render
@@ -11,14 +11,25 @@ Texture2D baseColorTexture : register(t0);
 
 SamplerState gsamPointWrap : register(s0);
 
+#ifdef POSITION_ONLY
+
+float4 mainVS(VertexPositionInput input) : SV_Position
+{
+    float4 posW = mul(float4(LoadPosition(input), 1.0f), ObjectCB.World);
+    return mul(posW, FrameCB.ViewProj);
+}
+
+#else
+
 struct VertexShaderOutput
 {
     float2 TextureCoord : TEXCOORD;
     float4 PositionH : SV_Position;
 };
 
-VertexShaderOutput mainVS(Vertex1P1N1UV1T IN)
+VertexShaderOutput mainVS(VertexInput input)
 {
+    Vertex1P1N1UV1T IN = LoadVertex(input);
     VertexShaderOutput OUT;
 
     OUT.TextureCoord = IN.TextureCoord;
@@ -38,4 +49,6 @@ void mainPS(VertexShaderOutput IN)
     }
 
     clip(baseColor.a - MaterialCB.Cutoff);
-}
\ No newline at end of file
+}
+
+#endif
\ No newline at end of file
@@ -10,6 +10,12 @@ ConstantBuffer<MaterialUniform> MaterialCB : register(b2);
 
 StructuredBuffer<LightUniform> Lights : register(t0, space1);
 
+StructuredBuffer<float4x4> ShadowTransforms : register(t1, space1);
+
+StructuredBuffer<uint2> Clusters : register(t2, space1);
+
+StructuredBuffer<uint> ClusterLightIndices : register(t3, space1);
+
 Texture2D baseColorTexture : register(t0);
 
 Texture2D metallicRoughnessTexture : register(t1);
@@ -28,7 +34,6 @@ SamplerComparisonState gsamShadow : register(s1);
 struct VertexShaderOutput
 {
     float3 PositionW : POSITION0;
-    float4 ShadowPosH : POSITION1;
     float3 NormalW : NORMAL;
     float2 TextureCoord : TEXCOORD;
     float3x3 TBN : TBN;
@@ -40,8 +45,9 @@ struct PixelShaderOutput
     float4 Color : SV_TARGET0;
 };
 
-float ShadowCalculation(float4 fragPosLightSpace)
+float SampleShadow(float4x4 shadowTransform, float3 positionW)
 {
+    float4 fragPosLightSpace = mul(float4(positionW, 1.0f), shadowTransform);
     float3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
 
     float currentDepth = projCoords.z;
@@ -71,8 +77,98 @@ float ShadowCalculation(float4 fragPosLightSpace)
     return percentLit / 9.0f;
 }
 
-VertexShaderOutput mainVS(Vertex1P1N1UV1T IN)
+float ShadowCalculation(float3 positionW, float viewDepth)
+{
+    // Cascades are ordered by depth, the first one that reaches the pixel has the most resolution.
+    int cascade = 0;
+    while (cascade < FrameCB.CascadesCount && viewDepth > FrameCB.CascadeSplits[cascade])
+    {
+        ++cascade;
+    }
+
+    if (cascade == FrameCB.CascadesCount)
+    {
+        return 1.0f;
+    }
+
+    return SampleShadow(FrameCB.CascadeTransforms[cascade], positionW);
+}
+
+float LocalShadowCalculation(LightUniform light, float3 positionW)
+{
+    if (light.FirstShadowTransform < 0)
+    {
+        return 1.0f;
+    }
+
+    // Point lights have a view per cube face, in the order +X, -X, +Y, -Y, +Z, -Z.
+    int face = 0;
+    if (light.LightType == POINT_LIGHT)
+    {
+        float3 direction = positionW - light.PositionWS;
+        float3 absDirection = abs(direction);
+        if (absDirection.x >= absDirection.y && absDirection.x >= absDirection.z)
+        {
+            face = direction.x >= 0.0f ? 0 : 1;
+        }
+        else if (absDirection.y >= absDirection.z)
+        {
+            face = direction.y >= 0.0f ? 2 : 3;
+        }
+        else
+        {
+            face = direction.z >= 0.0f ? 4 : 5;
+        }
+    }
+
+    return SampleShadow(ShadowTransforms[light.FirstShadowTransform + face], positionW);
+}
+
+uint GetClusterIndex(float4 positionH)
 {
+    // Pixel coordinates pick the tile, the w of a perspective position is its view space depth.
+    uint2 tile = min(uint2(positionH.xy * FrameCB.ClusterTileScale), uint2(FrameCB.ClusterGridX - 1, FrameCB.ClusterGridY - 1));
+    uint slice = uint(clamp(log(positionH.w) * FrameCB.ClusterDepthScale + FrameCB.ClusterDepthBias, 0.0f, FrameCB.ClusterGridZ - 1.0f));
+
+    return (slice * FrameCB.ClusterGridY + tile.y) * FrameCB.ClusterGridX + tile.x;
+}
+
+float3 ApplyLight(LightUniform light, float3 positionW, float viewDepth, float3 F0, float3 N, float3 V, float3 albedo, float metallic, float roughness)
+{
+    float3 luminance = 0.0f;
+    if (!light.Enabled)
+    {
+        return luminance;
+    }
+
+    switch( light.LightType )
+    {
+    case DIRECTIONAL_LIGHT:
+        {
+            luminance = ApplyDirectionalLight(light, positionW, F0, N, V, albedo, metallic, roughness);
+            luminance *= ShadowCalculation(positionW, viewDepth);
+        }
+        break;
+    case POINT_LIGHT: 
+        {
+            luminance = ApplyPointLight(light, positionW, F0, N, V, albedo, metallic, roughness);
+            luminance *= LocalShadowCalculation(light, positionW);
+        }
+        break;
+    case SPOT_LIGHT:
+        {
+            luminance = ApplySpotLight(light, positionW, F0, N, V, albedo, metallic, roughness);
+            luminance *= LocalShadowCalculation(light, positionW);
+        }
+        break;
+    }
+
+    return luminance;
+}
+
+VertexShaderOutput mainVS(VertexInput input)
+{
+    Vertex1P1N1UV1T IN = LoadVertex(input);
     VertexShaderOutput OUT;
  
     float4 posW = mul(float4(IN.PositionL, 1.0f), ObjectCB.World);
@@ -87,7 +183,6 @@ VertexShaderOutput mainVS(Vertex1P1N1UV1T IN)
 
     OUT.NormalW = normalW;
     OUT.PositionW = posW.xyz;
-    OUT.ShadowPosH = mul(posW, FrameCB.ShadowTransform);
     OUT.PositionH = mul(posW, FrameCB.ViewProj);
     OUT.TBN = TBN;
     OUT.TextureCoord = IN.TextureCoord;
@@ -148,36 +243,19 @@ PixelShaderOutput mainPS(VertexShaderOutput IN)
 	           
     float3 directLuminance = 0.0f;
 
-    for(int i = 0; i < FrameCB.LightsCount; ++i) 
+    // The w of a perspective position is its view space depth.
+    for(int i = 0; i < FrameCB.GlobalLightsCount; ++i) 
     {
-        LightUniform light = Lights[i];
-
-        if ( !light.Enabled ) continue;
-
-        float3 luminance = 0.0f;
-        switch( light.LightType )
-        {
-        case DIRECTIONAL_LIGHT:
-            {
-                luminance = ApplyDirectionalLight(light, IN.PositionW, F0, N, V, baseColor.rgb, metallic, roughness);
-
-                luminance *= ShadowCalculation(IN.ShadowPosH);
-            }
-            break;
-        case POINT_LIGHT: 
-            {
-                luminance = ApplyPointLight(light, IN.PositionW, F0, N, V, baseColor.rgb, metallic, roughness);
-            }
-            break;
-        case SPOT_LIGHT:
-            {
-                luminance = ApplySpotLight(light, IN.PositionW, F0, N, V, baseColor.rgb, metallic, roughness);
-            }
-            break;
-        }
+        directLuminance += ApplyLight(Lights[i], IN.PositionW, IN.PositionH.w, F0, N, V, baseColor.rgb, metallic, roughness);
+    }
 
-        directLuminance += luminance;
-    }   
+    // Local lights come from the cluster of the pixel only.
+    uint2 cluster = Clusters[GetClusterIndex(IN.PositionH)];
+    for(uint j = 0; j < cluster.y; ++j)
+    {
+        LightUniform light = Lights[FrameCB.GlobalLightsCount + ClusterLightIndices[cluster.x + j]];
+        directLuminance += ApplyLight(light, IN.PositionW, IN.PositionH.w, F0, N, V, baseColor.rgb, metallic, roughness);
+    }
 
     float3 ambient = 0.03 * baseColor.rgb * occlusion.r;
     float3 color = emissiveFactor.rgb + ambient + directLuminance;
@@ -20,7 +20,11 @@ using float4x4 = DirectX::XMFLOAT4X4;
 
 #define aligned_bool CB_ALIGN(4) bool
 
-#define MAX_LIGHTS 16
+// Local lights are binned into clusters, so the cost per pixel only grows with the lights around it.
+#define MAX_LIGHTS 4096
+
+// Cascade splits are packed into a single float4.
+#define MAX_SHADOW_CASCADES 4
 
 // Light types.
 #define DIRECTIONAL_LIGHT 0
@@ -31,6 +35,10 @@ struct MeshUniform
 {
     float4x4 World;
     float4x4 InverseTranspose;
+    float3 PositionScale;
+    float Padding0;
+    float3 PositionOffset;
+    float Padding1;
 };
 
 struct MaterialUniform
@@ -71,14 +79,32 @@ struct LightUniform
     float QuadraticAttenuation;
     float InnerConeAngle;
     float OuterConeAngle;
+
+    // First shadow transform of a spot light or the +X face of a point light, negative without shadows.
+    int FirstShadowTransform;
+    float3 Padding;
 };
 
 struct FrameUniform
 {
     float4x4 ViewProj;
-    float4x4 ShadowTransform;
+    // World to shadow map texture space of every cascade.
+    float4x4 CascadeTransforms[MAX_SHADOW_CASCADES];
+    // View space depth where every cascade ends.
+    float4 CascadeSplits;
     float3 EyePos;
     int LightsCount;
+    int CascadesCount;
+    float3 Padding;
+    // Clusters per pixel of the viewport, the slice of a view space depth is log(depth) * scale + bias.
+    float2 ClusterTileScale;
+    float ClusterDepthScale;
+    float ClusterDepthBias;
+    int ClusterGridX;
+    int ClusterGridY;
+    int ClusterGridZ;
+    // Lights before this reach every pixel, cluster light indices start after them.
+    int GlobalLightsCount;
 };
 
 #endif
\ No newline at end of file
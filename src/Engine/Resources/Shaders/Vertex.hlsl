@@ -9,4 +9,52 @@ struct Vertex1P1N1UV1T
     float4 Tangent : TANGENT;
 };
 
+struct Vertex1P
+{
+    float3 PositionL : POSITION;
+};
+
+struct Vertex1PCompact
+{
+    float4 PositionL : POSITION;
+};
+
+struct Vertex1P1N1UV1TCompact
+{
+    float4 PositionL : POSITION;
+    float2 NormalL : NORMAL;
+    float2 TextureCoord : TEXCOORD;
+    float2 Tangent : TANGENT;
+};
+
+float3 DecodeOctahedron(float2 encoded)
+{
+    float3 direction = float3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+    float fold = saturate(-direction.z);
+    direction.xy += direction.xy >= 0.0f ? -fold : fold;
+    return normalize(direction);
+}
+
+Vertex1P1N1UV1T DecodeVertex(Vertex1P1N1UV1TCompact IN, float3 positionScale, float3 positionOffset)
+{
+    Vertex1P1N1UV1T OUT;
+    OUT.PositionL = IN.PositionL.xyz * positionScale + positionOffset;
+    OUT.NormalL = DecodeOctahedron(IN.NormalL);
+    OUT.TextureCoord = IN.TextureCoord;
+    OUT.Tangent = float4(DecodeOctahedron(IN.Tangent), IN.PositionL.w * 2.0f - 1.0f);
+    return OUT;
+}
+
+#ifdef COMPACT_VERTEX
+#define VertexInput Vertex1P1N1UV1TCompact
+#define VertexPositionInput Vertex1PCompact
+#define LoadVertex(IN) DecodeVertex(IN, ObjectCB.PositionScale, ObjectCB.PositionOffset)
+#define LoadPosition(IN) (IN.PositionL.xyz * ObjectCB.PositionScale + ObjectCB.PositionOffset)
+#else
+#define VertexInput Vertex1P1N1UV1T
+#define VertexPositionInput Vertex1P
+#define LoadVertex(IN) IN
+#define LoadPosition(IN) IN.PositionL
+#endif
+
 #endif
\ No newline at end of file
@@ -0,0 +1,227 @@
+#include "BoundingBoxArray.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace Engine::Scene
+{
+    namespace
+    {
+        // Relative width of the band around the planes where the batched test defers to DirectXCollision.
+        constexpr float32 Tolerance = 1e-4f;
+
+        dx::XMVECTOR LoadBatch(const std::vector<float32> &values, Size first)
+        {
+            return dx::XMLoadFloat4(reinterpret_cast<const dx::XMFLOAT4 *>(values.data() + first));
+        }
+
+        uint32 GetLanesMask(dx::FXMVECTOR lanes)
+        {
+            uint32 values[4];
+            dx::XMStoreInt4(values, lanes);
+
+            return (values[0] & 1) | (values[1] & 2) | (values[2] & 4) | (values[3] & 8);
+        }
+
+        // Distance along one axis from a coordinate to the closest point of every box, zero inside.
+        dx::XMVECTOR GetOutsideDistance(dx::FXMVECTOR center, dx::FXMVECTOR extent, float32 coordinate)
+        {
+            const auto offset = dx::XMVectorAbs(dx::XMVectorSubtract(center, dx::XMVectorReplicate(coordinate)));
+            return dx::XMVectorMax(dx::XMVectorSubtract(offset, extent), dx::XMVectorZero());
+        }
+    }
+
+    CullingFrustum::CullingFrustum(const dx::BoundingFrustum &frustum) : mFrustum(frustum)
+    {
+        dx::XMVECTOR planes[PlanesCount];
+        frustum.GetPlanes(&planes[0], &planes[1], &planes[2], &planes[3], &planes[4], &planes[5]);
+
+        SetPlanes(planes, std::abs(frustum.Origin.x) + std::abs(frustum.Origin.y) + std::abs(frustum.Origin.z) + std::abs(frustum.Far));
+    }
+
+    CullingFrustum::CullingFrustum(const dx::BoundingOrientedBox &box) : mBox(box), mIsBox(true)
+    {
+        const auto center = dx::XMLoadFloat3(&box.Center);
+        const auto rotation = dx::XMMatrixRotationQuaternion(dx::XMLoadFloat4(&box.Orientation));
+        const float32 extents[3] = { box.Extents.x, box.Extents.y, box.Extents.z };
+
+        // Two planes facing outwards along every axis of the box.
+        dx::XMVECTOR planes[PlanesCount];
+        for (uint32 axis = 0; axis < 3; ++axis)
+        {
+            const auto normal = rotation.r[axis];
+            const float32 distance = dx::XMVectorGetX(dx::XMVector3Dot(normal, center));
+
+            planes[2 * axis] = dx::XMVectorSetW(normal, -distance - extents[axis]);
+            planes[2 * axis + 1] = dx::XMVectorSetW(dx::XMVectorNegate(normal), distance - extents[axis]);
+        }
+
+        SetPlanes(planes, std::abs(box.Center.x) + std::abs(box.Center.y) + std::abs(box.Center.z) + extents[0] + extents[1] + extents[2]);
+    }
+
+    dx::ContainmentType CullingFrustum::Contains(const dx::BoundingBox &box) const
+    {
+        return mIsBox ? mBox.Contains(box) : mFrustum.Contains(box);
+    }
+
+    bool CullingFrustum::Intersects(const dx::BoundingBox &box) const
+    {
+        return mIsBox ? mBox.Intersects(box) : mFrustum.Intersects(box);
+    }
+
+    bool CullingFrustum::Intersects(const dx::BoundingSphere &sphere) const
+    {
+        return mIsBox ? mBox.Intersects(sphere) : mFrustum.Intersects(sphere);
+    }
+
+    void CullingFrustum::SetPlanes(const dx::XMVECTOR *planes, float32 toleranceBias)
+    {
+        for (uint32 i = 0; i < PlanesCount; ++i)
+        {
+            auto &plane = mPlanes[i];
+            plane.normalX = dx::XMVectorSplatX(planes[i]);
+            plane.normalY = dx::XMVectorSplatY(planes[i]);
+            plane.normalZ = dx::XMVectorSplatZ(planes[i]);
+            plane.absNormalX = dx::XMVectorAbs(plane.normalX);
+            plane.absNormalY = dx::XMVectorAbs(plane.normalY);
+            plane.absNormalZ = dx::XMVectorAbs(plane.normalZ);
+            plane.distance = dx::XMVectorSplatW(planes[i]);
+        }
+
+        mToleranceBias = dx::XMVectorReplicate(toleranceBias);
+    }
+
+    void BoundingBoxArray::Resize(Size count)
+    {
+        mSize = count;
+
+        const Size capacity = count + BatchSize;
+        mCenterX.resize(capacity, 0.0f);
+        mCenterY.resize(capacity, 0.0f);
+        mCenterZ.resize(capacity, 0.0f);
+        mExtentX.resize(capacity, 0.0f);
+        mExtentY.resize(capacity, 0.0f);
+        mExtentZ.resize(capacity, 0.0f);
+    }
+
+    void BoundingBoxArray::Assign(std::span<const dx::BoundingBox> boxes)
+    {
+        Resize(boxes.size());
+        for (Size i = 0; i < boxes.size(); ++i)
+        {
+            Set(i, boxes[i]);
+        }
+    }
+
+    void BoundingBoxArray::Set(Size index, const dx::BoundingBox &box)
+    {
+        mCenterX[index] = box.Center.x;
+        mCenterY[index] = box.Center.y;
+        mCenterZ[index] = box.Center.z;
+        mExtentX[index] = box.Extents.x;
+        mExtentY[index] = box.Extents.y;
+        mExtentZ[index] = box.Extents.z;
+    }
+
+    dx::BoundingBox BoundingBoxArray::Get(Size index) const
+    {
+        return dx::BoundingBox(
+            dx::XMFLOAT3(mCenterX[index], mCenterY[index], mCenterZ[index]),
+            dx::XMFLOAT3(mExtentX[index], mExtentY[index], mExtentZ[index]));
+    }
+
+    uint32 BoundingBoxArray::CullBatch(const CullingFrustum &frustum, Size first, Size count) const
+    {
+        const auto centerX = LoadBatch(mCenterX, first);
+        const auto centerY = LoadBatch(mCenterY, first);
+        const auto centerZ = LoadBatch(mCenterZ, first);
+        const auto extentX = LoadBatch(mExtentX, first);
+        const auto extentY = LoadBatch(mExtentY, first);
+        const auto extentZ = LoadBatch(mExtentZ, first);
+
+        // Float error of the plane distances grows with the coordinates involved, not with the distances themselves.
+        auto magnitude = dx::XMVectorAdd(dx::XMVectorAbs(centerX), dx::XMVectorAbs(centerY));
+        magnitude = dx::XMVectorAdd(magnitude, dx::XMVectorAbs(centerZ));
+        magnitude = dx::XMVectorAdd(magnitude, dx::XMVectorAdd(extentX, dx::XMVectorAdd(extentY, extentZ)));
+        magnitude = dx::XMVectorAdd(magnitude, frustum.mToleranceBias);
+        const auto tolerance = dx::XMVectorScale(magnitude, Tolerance);
+
+        auto outside = dx::XMVectorFalseInt();
+        auto uncertain = dx::XMVectorFalseInt();
+        auto crossedOnce = dx::XMVectorFalseInt();
+        auto crossedTwice = dx::XMVectorFalseInt();
+        auto centerInside = dx::XMVectorTrueInt();
+
+        for (const auto &plane : frustum.mPlanes)
+        {
+            auto distance = dx::XMVectorMultiplyAdd(centerX, plane.normalX, plane.distance);
+            distance = dx::XMVectorMultiplyAdd(centerY, plane.normalY, distance);
+            distance = dx::XMVectorMultiplyAdd(centerZ, plane.normalZ, distance);
+
+            auto radius = dx::XMVectorMultiply(extentX, plane.absNormalX);
+            radius = dx::XMVectorMultiplyAdd(extentY, plane.absNormalY, radius);
+            radius = dx::XMVectorMultiplyAdd(extentZ, plane.absNormalZ, radius);
+
+            const auto outerRadius = dx::XMVectorAdd(radius, tolerance);
+            const auto innerRadius = dx::XMVectorSubtract(radius, tolerance);
+
+            // Planes face outwards, a box past one of them is rejected.
+            const auto isOutside = dx::XMVectorGreater(distance, outerRadius);
+            const auto isInside = dx::XMVectorLessOrEqual(distance, dx::XMVectorNegate(outerRadius));
+            const auto isCrossing = dx::XMVectorLess(dx::XMVectorAbs(distance), innerRadius);
+
+            outside = dx::XMVectorOrInt(outside, isOutside);
+            uncertain = dx::XMVectorOrInt(uncertain, dx::XMVectorAndCInt(dx::XMVectorTrueInt(), dx::XMVectorOrInt(isOutside, dx::XMVectorOrInt(isInside, isCrossing))));
+            crossedTwice = dx::XMVectorOrInt(crossedTwice, dx::XMVectorAndInt(crossedOnce, isCrossing));
+            crossedOnce = dx::XMVectorOrInt(crossedOnce, isCrossing);
+            centerInside = dx::XMVectorAndInt(centerInside, dx::XMVectorLessOrEqual(distance, dx::XMVectorNegate(tolerance)));
+        }
+
+        // A box inside all planes but one it crosses has a point inside the frustum, so does a box around an inner point.
+        // Boxes crossing several planes may still miss the frustum near its edges and go through the exact test.
+        const uint32 countMask = (1u << count) - 1;
+        const uint32 hidden = GetLanesMask(outside);
+        const uint32 crossing = GetLanesMask(dx::XMVectorOrInt(uncertain, crossedTwice));
+        uint32 visible = ~hidden & (GetLanesMask(centerInside) | ~crossing) & countMask;
+        uint32 undecided = ~(hidden | visible) & countMask;
+
+        while (undecided != 0)
+        {
+            const uint32 lane = std::countr_zero(undecided);
+            undecided &= undecided - 1;
+
+            if (frustum.Intersects(Get(first + lane)))
+            {
+                visible |= 1u << lane;
+            }
+        }
+
+        return visible;
+    }
+
+    uint32 BoundingBoxArray::IntersectBatch(const dx::BoundingSphere &sphere, Size first, Size count) const
+    {
+        const auto distanceX = GetOutsideDistance(LoadBatch(mCenterX, first), LoadBatch(mExtentX, first), sphere.Center.x);
+        const auto distanceY = GetOutsideDistance(LoadBatch(mCenterY, first), LoadBatch(mExtentY, first), sphere.Center.y);
+        const auto distanceZ = GetOutsideDistance(LoadBatch(mCenterZ, first), LoadBatch(mExtentZ, first), sphere.Center.z);
+
+        auto distanceSquared = dx::XMVectorMultiply(distanceX, distanceX);
+        distanceSquared = dx::XMVectorMultiplyAdd(distanceY, distanceY, distanceSquared);
+        distanceSquared = dx::XMVectorMultiplyAdd(distanceZ, distanceZ, distanceSquared);
+
+        const uint32 countMask = (1u << count) - 1;
+        return GetLanesMask(dx::XMVectorLessOrEqual(distanceSquared, dx::XMVectorReplicate(sphere.Radius * sphere.Radius))) & countMask;
+    }
+
+    void BoundingBoxArray::Cull(const CullingFrustum &frustum, std::vector<uint32> &visibilityMask) const
+    {
+        visibilityMask.assign((mSize + 31) / 32, 0);
+
+        for (Size first = 0; first < mSize; first += BatchSize)
+        {
+            const Size count = std::min<Size>(BatchSize, mSize - first);
+            visibilityMask[first / 32] |= CullBatch(frustum, first, count) << (first % 32);
+        }
+    }
+} // namespace Engine::Scene
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <Types.h>
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include <span>
+#include <vector>
+
+namespace Engine::Scene
+{
+    // World space planes of a view volume splatted once, shared by every batch tested against it.
+    // Perspective views are frusta, orthographic views are oriented boxes.
+    class CullingFrustum
+    {
+    public:
+        CullingFrustum(const DirectX::BoundingFrustum &frustum);
+        CullingFrustum(const DirectX::BoundingOrientedBox &box);
+
+        DirectX::ContainmentType Contains(const DirectX::BoundingBox &box) const;
+        bool Intersects(const DirectX::BoundingBox &box) const;
+        bool Intersects(const DirectX::BoundingSphere &sphere) const;
+
+    private:
+        void SetPlanes(const DirectX::XMVECTOR *planes, float32 toleranceBias);
+
+    private:
+        friend class BoundingBoxArray;
+
+        static constexpr uint32 PlanesCount = 6;
+
+        struct Plane
+        {
+            DirectX::XMVECTOR normalX;
+            DirectX::XMVECTOR normalY;
+            DirectX::XMVECTOR normalZ;
+            DirectX::XMVECTOR absNormalX;
+            DirectX::XMVECTOR absNormalY;
+            DirectX::XMVECTOR absNormalZ;
+            DirectX::XMVECTOR distance;
+        };
+
+        DirectX::BoundingFrustum mFrustum;
+        DirectX::BoundingOrientedBox mBox;
+        bool mIsBox = false;
+        Plane mPlanes[PlanesCount];
+        // Magnitude of the frustum placement, scales the band of boxes left to the exact test.
+        DirectX::XMVECTOR mToleranceBias;
+    };
+
+    // Axis aligned boxes stored as separate coordinate arrays, a batch of boxes is tested with one pass over the planes.
+    // Results match DirectXCollision, boxes too close to a plane for the batched test are resolved by it.
+    class BoundingBoxArray
+    {
+    public:
+        static constexpr uint32 BatchSize = 4;
+
+        void Resize(Size count);
+        void Assign(std::span<const DirectX::BoundingBox> boxes);
+        void Set(Size index, const DirectX::BoundingBox &box);
+        DirectX::BoundingBox Get(Size index) const;
+
+        // Bit i is set when box first + i intersects the frustum, count is at most BatchSize.
+        uint32 CullBatch(const CullingFrustum &frustum, Size first, Size count) const;
+
+        // Bit i is set when box first + i intersects the sphere, count is at most BatchSize.
+        uint32 IntersectBatch(const DirectX::BoundingSphere &sphere, Size first, Size count) const;
+
+        // Bit i % 32 of word i / 32 is set when box i intersects the frustum.
+        void Cull(const CullingFrustum &frustum, std::vector<uint32> &visibilityMask) const;
+
+        Size GetSize() const { return mSize; }
+
+    private:
+        Size mSize = 0;
+        // Padded by a batch so any run of BatchSize boxes can be loaded.
+        std::vector<float32> mCenterX;
+        std::vector<float32> mCenterY;
+        std::vector<float32> mCenterZ;
+        std::vector<float32> mExtentX;
+        std::vector<float32> mExtentY;
+        std::vector<float32> mExtentZ;
+    };
+} // namespace Engine::Scene
@@ -0,0 +1,227 @@
+#include "BoundingVolumeHierarchy.h"
+
+#include <algorithm>
+#include <bit>
+#include <cfloat>
+
+namespace Engine::Scene
+{
+    namespace
+    {
+        constexpr uint32 MaxLeafItems = BoundingBoxArray::BatchSize;
+
+        float32 GetAxis(const dx::XMFLOAT3 &vector, uint32 axis)
+        {
+            return axis == 0 ? vector.x : (axis == 1 ? vector.y : vector.z);
+        }
+
+        struct Bounds
+        {
+            dx::XMVECTOR min = dx::XMVectorReplicate(FLT_MAX);
+            dx::XMVECTOR max = dx::XMVectorReplicate(-FLT_MAX);
+
+            void Merge(const dx::BoundingBox &box)
+            {
+                auto center = dx::XMLoadFloat3(&box.Center);
+                auto extents = dx::XMLoadFloat3(&box.Extents);
+
+                min = dx::XMVectorMin(min, dx::XMVectorSubtract(center, extents));
+                max = dx::XMVectorMax(max, dx::XMVectorAdd(center, extents));
+            }
+
+            dx::BoundingBox GetBox() const
+            {
+                dx::BoundingBox box;
+                dx::XMStoreFloat3(&box.Center, dx::XMVectorScale(dx::XMVectorAdd(min, max), 0.5f));
+                dx::XMStoreFloat3(&box.Extents, dx::XMVectorScale(dx::XMVectorSubtract(max, min), 0.5f));
+
+                return box;
+            }
+        };
+    }
+
+    void BoundingVolumeHierarchy::Build(std::span<const dx::BoundingBox> bounds)
+    {
+        mNodes.clear();
+        mItems.resize(bounds.size());
+
+        if (bounds.empty())
+        {
+            mItemBounds.Resize(0);
+            return;
+        }
+
+        std::vector<dx::XMFLOAT3> centers(bounds.size());
+        for (uint32 i = 0; i < bounds.size(); ++i)
+        {
+            mItems[i] = i;
+            centers[i] = bounds[i].Center;
+        }
+
+        mNodes.reserve(2 * (bounds.size() / MaxLeafItems + 1));
+        mNodes.emplace_back();
+        BuildNode(0, bounds, centers, 0, static_cast<uint32>(bounds.size()));
+
+        StoreItemBounds(bounds);
+    }
+
+    void BoundingVolumeHierarchy::BuildNode(uint32 nodeIndex, std::span<const dx::BoundingBox> bounds, const std::vector<dx::XMFLOAT3> &centers, uint32 firstItem, uint32 itemsCount)
+    {
+        Bounds nodeBounds;
+        Bounds centerBounds;
+        for (uint32 i = firstItem; i < firstItem + itemsCount; ++i)
+        {
+            nodeBounds.Merge(bounds[mItems[i]]);
+            centerBounds.Merge(dx::BoundingBox(centers[mItems[i]], dx::XMFLOAT3(0.0f, 0.0f, 0.0f)));
+        }
+
+        auto &node = mNodes[nodeIndex];
+        node.bounds = nodeBounds.GetBox();
+        node.firstItem = firstItem;
+        node.itemsCount = itemsCount;
+
+        if (itemsCount <= MaxLeafItems)
+        {
+            return;
+        }
+
+        // Median split along the widest spread of the centers keeps the tree balanced.
+        dx::XMFLOAT3 spread;
+        dx::XMStoreFloat3(&spread, dx::XMVectorSubtract(centerBounds.max, centerBounds.min));
+        const uint32 axis = spread.x >= spread.y && spread.x >= spread.z ? 0 : (spread.y >= spread.z ? 1 : 2);
+
+        const uint32 leftCount = itemsCount / 2;
+        auto first = mItems.begin() + firstItem;
+        std::nth_element(first, first + leftCount, first + itemsCount, [&centers, axis](uint32 a, uint32 b)
+        {
+            return GetAxis(centers[a], axis) < GetAxis(centers[b], axis);
+        });
+
+        const uint32 firstChild = static_cast<uint32>(mNodes.size());
+        mNodes[nodeIndex].firstChild = firstChild;
+        mNodes.emplace_back();
+        mNodes.emplace_back();
+
+        BuildNode(firstChild, bounds, centers, firstItem, leftCount);
+        BuildNode(firstChild + 1, bounds, centers, firstItem + leftCount, itemsCount - leftCount);
+    }
+
+    void BoundingVolumeHierarchy::StoreItemBounds(std::span<const dx::BoundingBox> bounds)
+    {
+        mItemBounds.Resize(mItems.size());
+        for (Size i = 0; i < mItems.size(); ++i)
+        {
+            mItemBounds.Set(i, bounds[mItems[i]]);
+        }
+    }
+
+    void BoundingVolumeHierarchy::Refit(std::span<const dx::BoundingBox> bounds)
+    {
+        StoreItemBounds(bounds);
+
+        // Children always follow their parent, so a reverse walk sees them first.
+        for (Size i = mNodes.size(); i-- > 0;)
+        {
+            auto &node = mNodes[i];
+
+            Bounds nodeBounds;
+            if (node.firstChild == 0)
+            {
+                for (uint32 item = node.firstItem; item < node.firstItem + node.itemsCount; ++item)
+                {
+                    nodeBounds.Merge(bounds[mItems[item]]);
+                }
+            }
+            else
+            {
+                nodeBounds.Merge(mNodes[node.firstChild].bounds);
+                nodeBounds.Merge(mNodes[node.firstChild + 1].bounds);
+            }
+
+            node.bounds = nodeBounds.GetBox();
+        }
+    }
+
+    void BoundingVolumeHierarchy::Query(const dx::BoundingFrustum &frustum, std::vector<uint32> &items) const
+    {
+        const CullingFrustum cullingFrustum(frustum);
+        Query(std::span(&cullingFrustum, 1), std::span(&items, 1));
+    }
+
+    void BoundingVolumeHierarchy::Query(std::span<const CullingFrustum> frusta, std::span<std::vector<uint32>> items) const
+    {
+        if (mNodes.empty() || frusta.empty())
+        {
+            return;
+        }
+
+        // View masks hold MaxQueryViews bits, longer lists take one walk per chunk.
+        if (frusta.size() > MaxQueryViews)
+        {
+            for (Size first = 0; first < frusta.size(); first += MaxQueryViews)
+            {
+                const Size count = std::min(MaxQueryViews, frusta.size() - first);
+                Query(frusta.subspan(first, count), items.subspan(first, count));
+            }
+            return;
+        }
+
+        struct StackEntry
+        {
+            uint32 node;
+            // Views the node is partially inside of, the others already rejected or accepted it.
+            uint32 views;
+        };
+
+        StackEntry stack[64];
+        Size stackSize = 0;
+        stack[stackSize++] = { 0, static_cast<uint32>((uint64(1) << frusta.size()) - 1) };
+
+        while (stackSize > 0)
+        {
+            const auto entry = stack[--stackSize];
+            const auto &node = mNodes[entry.node];
+
+            uint32 partialViews = 0;
+            for (uint32 views = entry.views; views != 0; views &= views - 1)
+            {
+                const uint32 view = std::countr_zero(views);
+
+                const auto containment = frusta[view].Contains(node.bounds);
+                if (containment == dx::CONTAINS)
+                {
+                    // A contained subtree is visible as a whole.
+                    items[view].insert(items[view].end(), mItems.begin() + node.firstItem, mItems.begin() + node.firstItem + node.itemsCount);
+                }
+                else if (containment == dx::INTERSECTS)
+                {
+                    partialViews |= 1u << view;
+                }
+            }
+
+            if (partialViews == 0)
+            {
+                continue;
+            }
+
+            if (node.firstChild == 0)
+            {
+                for (uint32 views = partialViews; views != 0; views &= views - 1)
+                {
+                    const uint32 view = std::countr_zero(views);
+
+                    uint32 visible = node.itemsCount == 1 ? 1 : mItemBounds.CullBatch(frusta[view], node.firstItem, node.itemsCount);
+                    while (visible != 0)
+                    {
+                        items[view].push_back(mItems[node.firstItem + std::countr_zero(visible)]);
+                        visible &= visible - 1;
+                    }
+                }
+                continue;
+            }
+
+            stack[stackSize++] = { node.firstChild, partialViews };
+            stack[stackSize++] = { node.firstChild + 1, partialViews };
+        }
+    }
+} // namespace Engine::Scene
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <Types.h>
+#include <Scene/BoundingBoxArray.h>
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include <span>
+#include <vector>
+
+namespace Engine::Scene
+{
+    // Binary tree over a list of boxes, queries return indices into that list.
+    // Build once for a set of items and refit when only their bounds change.
+    class BoundingVolumeHierarchy
+    {
+    public:
+        void Build(std::span<const DirectX::BoundingBox> bounds);
+        void Refit(std::span<const DirectX::BoundingBox> bounds);
+
+        static constexpr Size MaxQueryViews = 32;
+
+        // Appends the indices of the items intersecting the frustum.
+        void Query(const DirectX::BoundingFrustum &frustum, std::vector<uint32> &items) const;
+
+        // Walks the tree once per MaxQueryViews frusta, items of every frustum go to the list of the same index.
+        void Query(std::span<const CullingFrustum> frusta, std::span<std::vector<uint32>> items) const;
+
+        Size GetItemsCount() const { return mItems.size(); }
+
+    private:
+        struct Node
+        {
+            DirectX::BoundingBox bounds;
+            // Items of the whole subtree are contiguous in mItems.
+            uint32 firstItem = 0;
+            uint32 itemsCount = 0;
+            // Children are stored next to each other, zero for leaves.
+            uint32 firstChild = 0;
+        };
+
+        void BuildNode(uint32 nodeIndex, std::span<const DirectX::BoundingBox> bounds, const std::vector<DirectX::XMFLOAT3> &centers, uint32 firstItem, uint32 itemsCount);
+        void StoreItemBounds(std::span<const DirectX::BoundingBox> bounds);
+
+    private:
+        std::vector<Node> mNodes;
+        std::vector<uint32> mItems;
+        // Bounds in mItems order, the items of a leaf are culled as one batch.
+        BoundingBoxArray mItemBounds;
+    };
+} // namespace Engine::Scene
@@ -13,6 +13,8 @@ namespace Engine::Scene::Components
         dx::XMMATRIX viewProjection;
         dx::XMVECTOR eyePosition; 
         dx::BoundingFrustum frustum;
+        // Height in pixels of the target the camera renders to.
+        float32 viewportHeight = 0.0f;
     };
 
     struct MainCameraComponent
@@ -13,5 +13,8 @@ namespace Engine::Scene::Components
     struct MovingComponent;
     struct NameComponent;
     struct RelationshipComponent;
+    struct ShadowCascadesComponent;
+    struct ShadowViewsComponent;
+    struct VisibilityComponent;
     struct WorldTransformComponent;
 }
\ No newline at end of file
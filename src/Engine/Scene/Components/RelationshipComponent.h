@@ -18,9 +18,5 @@ namespace Engine::Scene::Components
     {
 
     };
-
-    struct Dirty
-    {
-    };
     
 } // namespace Engine::Scene::Components
\ No newline at end of file
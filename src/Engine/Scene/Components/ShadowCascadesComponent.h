@@ -0,0 +1,19 @@
+#pragma once
+
+#include <Scene/ShadowCascades.h>
+
+#include <DirectXMath.h>
+#include <entt/entt.hpp>
+#include <vector>
+
+namespace Engine::Scene::Components
+{
+    struct ShadowCascadesComponent
+    {
+        std::vector<ShadowCascades::Cascade> cascades;
+        // Shadow map tile every cascade is rendered to, offset and size in texels.
+        std::vector<DirectX::XMUINT3> tiles;
+        // Enabled mesh entities inside every cascade, refreshed every frame.
+        std::vector<std::vector<entt::entity>> visibleEntities;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <Scene/Components/CameraComponent.h>
+
+#include <DirectXMath.h>
+#include <entt/entt.hpp>
+#include <vector>
+
+namespace Engine::Scene::Components
+{
+    struct ShadowViewsComponent
+    {
+        // One view for spot lights, the cube faces +X, -X, +Y, -Y, +Z, -Z for point lights.
+        // Empty when the light got no room in the shadow atlas.
+        std::vector<CameraComponent> views;
+        // Shadow atlas tile every view is rendered to, offset and size in texels.
+        std::vector<DirectX::XMUINT3> tiles;
+        // Enabled mesh entities inside every view, refreshed every frame.
+        std::vector<std::vector<entt::entity>> visibleEntities;
+    };
+}
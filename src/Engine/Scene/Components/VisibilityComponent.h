@@ -0,0 +1,13 @@
+#pragma once
+
+#include <entt/entt.hpp>
+#include <vector>
+
+namespace Engine::Scene::Components
+{
+    struct VisibilityComponent
+    {
+        // Enabled mesh entities whose bounds intersect the camera frustum, refreshed every frame.
+        std::vector<entt::entity> visibleEntities;
+    };
+}
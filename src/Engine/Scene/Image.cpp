@@ -70,7 +70,7 @@ namespace Engine::Scene
         return image;
     }
 
-    SharedPtr<Image> Image::LoadImageFromData(const std::vector<Byte> &imageData, String extension, String name, bool generateMips)
+    SharedPtr<Image> Image::LoadImageFromData(std::span<const Byte> imageData, String extension, String name, bool generateMips)
     {
         UniquePtr<DirectX::ScratchImage> scratch = MakeUnique<DirectX::ScratchImage>();
         HRESULT hr;
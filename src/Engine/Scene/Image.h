@@ -4,6 +4,7 @@
 
 #include <d3d12.h>
 #include <vector>
+#include <span>
 #include <DirectXTex.h>
 
 #define GENERATE_MIPS true
@@ -14,7 +15,7 @@ namespace Engine::Scene
     {
     public:
         static SharedPtr<Image> LoadImageFromFile(String path, bool generateMips = GENERATE_MIPS);
-        static SharedPtr<Image> LoadImageFromData(const std::vector<Byte> &data, String extension, String name, bool generateMips = GENERATE_MIPS);
+        static SharedPtr<Image> LoadImageFromData(std::span<const Byte> data, String extension, String name, bool generateMips = GENERATE_MIPS);
 
         Image() = default;
         ~Image() = default;
@@ -25,6 +26,8 @@ namespace Engine::Scene
         void SetName(const String &name) { mName = name; }
         const String &GetName() const { return mName; }
 
+        Size GetSizeInBytes() const { return mImage ? mImage->GetPixelsSize() : 0; }
+
     private:
         UniquePtr<DirectX::ScratchImage> mImage;
         String mName;
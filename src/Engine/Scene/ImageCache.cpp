@@ -0,0 +1,171 @@
+#include "ImageCache.h"
+
+#include <IO/MappedFile.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+namespace Engine::Scene
+{
+    namespace
+    {
+        // MurmurHash64A
+        uint64 HashContent(std::span<const Byte> data)
+        {
+            constexpr uint64 m = 0xc6a4a7935bd1e995ull;
+            constexpr int r = 47;
+
+            const Size size = data.size();
+            uint64 h = 0x8445d61a4e774912ull ^ (size * m);
+
+            const Byte *bytes = data.data();
+            const Size blocksCount = size / sizeof(uint64);
+            for (Size i = 0; i < blocksCount; ++i)
+            {
+                uint64 k;
+                memcpy(&k, bytes + i * sizeof(uint64), sizeof(uint64));
+
+                k *= m;
+                k ^= k >> r;
+                k *= m;
+
+                h ^= k;
+                h *= m;
+            }
+
+            const Byte *tail = bytes + blocksCount * sizeof(uint64);
+            const Size tailSize = size & 7;
+            if (tailSize > 0)
+            {
+                for (Size i = tailSize; i > 0; --i)
+                {
+                    h ^= static_cast<uint64>(tail[i - 1]) << (8 * (i - 1));
+                }
+                h *= m;
+            }
+
+            h ^= h >> r;
+            h *= m;
+            h ^= h >> r;
+
+            return h;
+        }
+    }
+
+    ImageCache &ImageCache::Instance()
+    {
+        static ImageCache instance;
+        return instance;
+    }
+
+    ImageCache::ImageCache() : mUseCounter(0)
+    {
+    }
+
+    ImageCache::~ImageCache() = default;
+
+    SharedPtr<Image> ImageCache::LoadImageFromFile(const String &path, bool generateMips)
+    {
+        MappedFile file;
+        if (!file.Open(path))
+        {
+            throw std::bad_alloc();
+        }
+
+        String extension = std::filesystem::path(path).extension().string();
+        if (!extension.empty() && extension[0] == '.')
+        {
+            extension.erase(0, 1);
+        }
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return static_cast<char>(std::tolower(c)); });
+
+        return LoadImageFromData(file.GetData(), extension, path, generateMips);
+    }
+
+    SharedPtr<Image> ImageCache::LoadImageFromData(std::span<const Byte> data, const String &extension, const String &name, bool generateMips)
+    {
+        ImageKey key = {HashContent(data), data.size(), generateMips};
+
+        std::promise<SharedPtr<Image>> promise;
+        std::shared_future<SharedPtr<Image>> image;
+        bool isDecoder = false;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+
+            auto iter = mImages.find(key);
+            if (iter != mImages.end())
+            {
+                iter->second.lastUse = ++mUseCounter;
+                image = iter->second.image;
+            }
+            else
+            {
+                image = promise.get_future().share();
+                mImages.emplace(key, ImageEntry{image, ++mUseCounter});
+                isDecoder = true;
+            }
+        }
+
+        // Only one thread decodes a given image; the others wait for its result.
+        if (isDecoder)
+        {
+            try
+            {
+                promise.set_value(Image::LoadImageFromData(data, extension, name, generateMips));
+            }
+            catch (...)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    mImages.erase(key);
+                }
+                promise.set_exception(std::current_exception());
+            }
+        }
+
+        return image.get();
+    }
+
+    void ImageCache::Trim(Size unusedBytesBudget)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        std::vector<std::tuple<uint64, Size, ImageKey>> unusedImages;
+        Size unusedBytes = 0;
+
+        for (const auto &[key, entry] : mImages)
+        {
+            if (entry.image.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            {
+                continue;
+            }
+
+            const auto &image = entry.image.get();
+            if (image.use_count() == 1)
+            {
+                Size size = image->GetSizeInBytes();
+                unusedImages.emplace_back(entry.lastUse, size, key);
+                unusedBytes += size;
+            }
+        }
+
+        std::sort(unusedImages.begin(), unusedImages.end(), [](const auto &left, const auto &right)
+        {
+            return std::get<0>(left) < std::get<0>(right);
+        });
+
+        for (const auto &[lastUse, size, key] : unusedImages)
+        {
+            if (unusedBytes <= unusedBytesBudget)
+            {
+                break;
+            }
+
+            mImages.erase(key);
+            unusedBytes -= size;
+        }
+    }
+} // namespace Engine::Scene
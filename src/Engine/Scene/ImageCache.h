@@ -0,0 +1,60 @@
+#pragma once
+
+#include <Types.h>
+#include <Hash.h>
+#include <Scene/Image.h>
+
+#include <future>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+
+namespace Engine::Scene
+{
+    class ImageCache
+    {
+    public:
+        static ImageCache &Instance();
+
+    private:
+        ImageCache();
+        ~ImageCache();
+
+    public:
+        SharedPtr<Image> LoadImageFromFile(const String &path, bool generateMips = GENERATE_MIPS);
+        SharedPtr<Image> LoadImageFromData(std::span<const Byte> data, const String &extension, const String &name, bool generateMips = GENERATE_MIPS);
+
+        // Evicts least recently used images that nobody references anymore
+        // until the remaining unreferenced images fit into the budget.
+        void Trim(Size unusedBytesBudget);
+
+    private:
+        struct ImageKey
+        {
+            uint64 contentHash;
+            uint64 contentSize;
+            bool generateMips;
+
+            bool operator==(const ImageKey &other) const = default;
+        };
+
+        struct ImageKeyHash
+        {
+            size_t operator()(const ImageKey &key) const
+            {
+                return std::hash_combine(key.contentHash, key.contentSize, key.generateMips);
+            }
+        };
+
+        struct ImageEntry
+        {
+            std::shared_future<SharedPtr<Image>> image;
+            uint64 lastUse;
+        };
+
+    private:
+        std::unordered_map<ImageKey, ImageEntry, ImageKeyHash> mImages;
+        std::mutex mMutex;
+        uint64 mUseCounter;
+    };
+} // namespace Engine::Scene
@@ -0,0 +1,204 @@
+#include "LightClusters.h"
+
+#include <ThreadPool.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace Engine::Scene
+{
+    namespace
+    {
+        // Tiles covered by the coordinates [minimum, maximum] of a view space interval between two depths.
+        // Returns false when the interval is outside of the view.
+        bool GetTileRange(float32 minimum, float32 maximum, float32 nearDepth, float32 farDepth, float32 tanHalfSize, uint32 tilesCount, uint32 &first, uint32 &last)
+        {
+            const float32 minimumNdc = minimum / ((minimum >= 0.0f ? farDepth : nearDepth) * tanHalfSize);
+            const float32 maximumNdc = maximum / ((maximum >= 0.0f ? nearDepth : farDepth) * tanHalfSize);
+            if (minimumNdc > 1.0f || maximumNdc < -1.0f)
+            {
+                return false;
+            }
+
+            const float32 tiles = static_cast<float32>(tilesCount);
+            first = static_cast<uint32>(std::clamp(std::floor((minimumNdc + 1.0f) * 0.5f * tiles), 0.0f, tiles - 1.0f));
+            last = static_cast<uint32>(std::clamp(std::floor((maximumNdc + 1.0f) * 0.5f * tiles), 0.0f, tiles - 1.0f));
+
+            return true;
+        }
+    }
+
+    LightClusters::LightClusters(uint32 width, uint32 height, uint32 depth, uint32 maxLightsPerCluster)
+        : mWidth(width)
+        , mHeight(height)
+        , mDepth(depth)
+        , mMaxLightsPerCluster(maxLightsPerCluster)
+    {
+        mSliceDepths.resize(depth + 1);
+        mClusterBounds.Resize(width * height * depth);
+        mClusterLights.resize(width * height * depth);
+        mClusters.resize(width * height * depth);
+    }
+
+    void LightClusters::Build(
+        const dx::XMMATRIX &view,
+        float32 tanHalfWidth,
+        float32 tanHalfHeight,
+        float32 nearPlane,
+        float32 farPlane,
+        std::span<const dx::BoundingSphere> lights)
+    {
+        if (tanHalfWidth != mTanHalfWidth || tanHalfHeight != mTanHalfHeight || nearPlane != mNearPlane || farPlane != mFarPlane)
+        {
+            UpdateClusterBounds(tanHalfWidth, tanHalfHeight, nearPlane, farPlane);
+        }
+
+        mViewLights.resize(lights.size());
+        for (Size i = 0; i < lights.size(); ++i)
+        {
+            auto &light = mViewLights[i];
+            lights[i].Transform(light.sphere, view);
+
+            const float32 nearDepth = light.sphere.Center.z - light.sphere.Radius;
+            const float32 farDepth = light.sphere.Center.z + light.sphere.Radius;
+            light.isVisible = farDepth >= mNearPlane && nearDepth <= mFarPlane;
+            if (!light.isVisible)
+            {
+                continue;
+            }
+
+            const float32 lastSlice = static_cast<float32>(mDepth - 1);
+            const auto getSlice = [this, lastSlice](float32 depth)
+            {
+                const float32 slice = depth > mNearPlane ? std::floor(std::log(depth) * mDepthSliceScale + mDepthSliceBias) : 0.0f;
+                return static_cast<uint32>(std::clamp(slice, 0.0f, lastSlice));
+            };
+
+            light.firstSlice = getSlice(nearDepth);
+            light.lastSlice = getSlice(farDepth);
+        }
+
+        ThreadPool::Instance().ParallelFor(mDepth, [this](Size slice)
+        {
+            BinSlice(static_cast<uint32>(slice));
+        });
+
+        mLightIndices.clear();
+        for (Size i = 0; i < mClusterLights.size(); ++i)
+        {
+            const auto &clusterLights = mClusterLights[i];
+            mClusters[i] = dx::XMUINT2(static_cast<uint32>(mLightIndices.size()), static_cast<uint32>(clusterLights.size()));
+            mLightIndices.insert(mLightIndices.end(), clusterLights.begin(), clusterLights.end());
+        }
+    }
+
+    void LightClusters::UpdateClusterBounds(float32 tanHalfWidth, float32 tanHalfHeight, float32 nearPlane, float32 farPlane)
+    {
+        mTanHalfWidth = tanHalfWidth;
+        mTanHalfHeight = tanHalfHeight;
+        mNearPlane = nearPlane;
+        mFarPlane = farPlane;
+
+        const float32 depthRatio = std::log(farPlane / nearPlane);
+        mDepthSliceScale = static_cast<float32>(mDepth) / depthRatio;
+        mDepthSliceBias = -std::log(nearPlane) * mDepthSliceScale;
+
+        for (uint32 z = 0; z <= mDepth; ++z)
+        {
+            mSliceDepths[z] = nearPlane * std::exp(depthRatio * static_cast<float32>(z) / static_cast<float32>(mDepth));
+        }
+        mSliceDepths[mDepth] = farPlane;
+
+        for (uint32 z = 0; z < mDepth; ++z)
+        {
+            const float32 nearDepth = mSliceDepths[z];
+            const float32 farDepth = mSliceDepths[z + 1];
+
+            for (uint32 y = 0; y < mHeight; ++y)
+            {
+                // Rows run top to bottom, view space y points up.
+                const float32 top = (1.0f - 2.0f * static_cast<float32>(y) / static_cast<float32>(mHeight)) * tanHalfHeight;
+                const float32 bottom = (1.0f - 2.0f * static_cast<float32>(y + 1) / static_cast<float32>(mHeight)) * tanHalfHeight;
+
+                for (uint32 x = 0; x < mWidth; ++x)
+                {
+                    const float32 left = (-1.0f + 2.0f * static_cast<float32>(x) / static_cast<float32>(mWidth)) * tanHalfWidth;
+                    const float32 right = (-1.0f + 2.0f * static_cast<float32>(x + 1) / static_cast<float32>(mWidth)) * tanHalfWidth;
+
+                    // Side planes go through the eye, the extreme points lie on the near or the far plane.
+                    const dx::XMFLOAT3 minimum(
+                        std::min(left * nearDepth, left * farDepth),
+                        std::min(bottom * nearDepth, bottom * farDepth),
+                        nearDepth);
+                    const dx::XMFLOAT3 maximum(
+                        std::max(right * nearDepth, right * farDepth),
+                        std::max(top * nearDepth, top * farDepth),
+                        farDepth);
+
+                    const dx::BoundingBox bounds(
+                        dx::XMFLOAT3(0.5f * (minimum.x + maximum.x), 0.5f * (minimum.y + maximum.y), 0.5f * (minimum.z + maximum.z)),
+                        dx::XMFLOAT3(0.5f * (maximum.x - minimum.x), 0.5f * (maximum.y - minimum.y), 0.5f * (maximum.z - minimum.z)));
+                    mClusterBounds.Set(GetClusterIndex(x, y, z), bounds);
+                }
+            }
+        }
+    }
+
+    void LightClusters::BinSlice(uint32 slice)
+    {
+        const uint32 firstCluster = GetClusterIndex(0, 0, slice);
+        for (uint32 i = 0; i < mWidth * mHeight; ++i)
+        {
+            mClusterLights[firstCluster + i].clear();
+        }
+
+        const float32 sliceNear = mSliceDepths[slice];
+        const float32 sliceFar = mSliceDepths[slice + 1];
+
+        for (uint32 lightIndex = 0; lightIndex < mViewLights.size(); ++lightIndex)
+        {
+            const auto &light = mViewLights[lightIndex];
+            if (!light.isVisible || slice < light.firstSlice || slice > light.lastSlice)
+            {
+                continue;
+            }
+
+            const auto &center = light.sphere.Center;
+            const float32 radius = light.sphere.Radius;
+
+            // Tiles of the light bounds over the depths it shares with the slice, refined by the exact cluster bounds.
+            const float32 nearDepth = std::max(sliceNear, center.z - radius);
+            const float32 farDepth = std::min(sliceFar, center.z + radius);
+
+            uint32 firstX, lastX, firstY, lastY;
+            if (!GetTileRange(center.x - radius, center.x + radius, nearDepth, farDepth, mTanHalfWidth, mWidth, firstX, lastX) ||
+                !GetTileRange(-center.y - radius, -center.y + radius, nearDepth, farDepth, mTanHalfHeight, mHeight, firstY, lastY))
+            {
+                continue;
+            }
+
+            for (uint32 y = firstY; y <= lastY; ++y)
+            {
+                const uint32 rowCluster = GetClusterIndex(0, y, slice);
+                for (uint32 x = firstX; x <= lastX; x += BoundingBoxArray::BatchSize)
+                {
+                    const uint32 count = std::min(BoundingBoxArray::BatchSize, lastX - x + 1);
+                    uint32 mask = mClusterBounds.IntersectBatch(light.sphere, rowCluster + x, count);
+
+                    while (mask != 0)
+                    {
+                        const uint32 lane = std::countr_zero(mask);
+                        mask &= mask - 1;
+
+                        auto &clusterLights = mClusterLights[rowCluster + x + lane];
+                        if (clusterLights.size() < mMaxLightsPerCluster)
+                        {
+                            clusterLights.push_back(lightIndex);
+                        }
+                    }
+                }
+            }
+        }
+    }
+} // namespace Engine::Scene
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <Types.h>
+#include <Scene/BoundingBoxArray.h>
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include <span>
+#include <vector>
+
+namespace Engine::Scene
+{
+    // Froxel grid over a perspective view, every light sphere is binned into the clusters it touches.
+    // Slices are spaced exponentially in depth so clusters stay close to cubes along the whole view.
+    class LightClusters
+    {
+    public:
+        LightClusters(uint32 width, uint32 height, uint32 depth, uint32 maxLightsPerCluster);
+
+        // Lights are world space spheres, clusters list indices into them in increasing order.
+        // Slices are binned in parallel on the thread pool.
+        void Build(
+            const DirectX::XMMATRIX &view,
+            float32 tanHalfWidth,
+            float32 tanHalfHeight,
+            float32 nearPlane,
+            float32 farPlane,
+            std::span<const DirectX::BoundingSphere> lights);
+
+        // Offset into the light indices and lights count of every cluster.
+        const std::vector<DirectX::XMUINT2> &GetClusters() const { return mClusters; }
+        const std::vector<uint32> &GetLightIndices() const { return mLightIndices; }
+
+        // x runs left to right and y top to bottom over the viewport, z away from the eye.
+        uint32 GetClusterIndex(uint32 x, uint32 y, uint32 z) const { return (z * mHeight + y) * mWidth + x; }
+        // View space bounds of a cluster.
+        DirectX::BoundingBox GetClusterBounds(uint32 index) const { return mClusterBounds.Get(index); }
+
+        // The slice of a view space depth is log(depth) * scale + bias.
+        float32 GetDepthSliceScale() const { return mDepthSliceScale; }
+        float32 GetDepthSliceBias() const { return mDepthSliceBias; }
+
+        uint32 GetWidth() const { return mWidth; }
+        uint32 GetHeight() const { return mHeight; }
+        uint32 GetDepth() const { return mDepth; }
+
+    private:
+        void UpdateClusterBounds(float32 tanHalfWidth, float32 tanHalfHeight, float32 nearPlane, float32 farPlane);
+        void BinSlice(uint32 slice);
+
+    private:
+        struct ViewLight
+        {
+            DirectX::BoundingSphere sphere;
+            uint32 firstSlice = 0;
+            uint32 lastSlice = 0;
+            bool isVisible = false;
+        };
+
+        uint32 mWidth;
+        uint32 mHeight;
+        uint32 mDepth;
+        uint32 mMaxLightsPerCluster;
+
+        // Projection the cluster bounds were built for.
+        float32 mTanHalfWidth = 0.0f;
+        float32 mTanHalfHeight = 0.0f;
+        float32 mNearPlane = 0.0f;
+        float32 mFarPlane = 0.0f;
+
+        float32 mDepthSliceScale = 0.0f;
+        float32 mDepthSliceBias = 0.0f;
+        std::vector<float32> mSliceDepths;
+        BoundingBoxArray mClusterBounds;
+
+        std::vector<ViewLight> mViewLights;
+        // Lights of every cluster before compaction, every slice fills only its own clusters.
+        std::vector<std::vector<uint32>> mClusterLights;
+
+        std::vector<DirectX::XMUINT2> mClusters;
+        std::vector<uint32> mLightIndices;
+    };
+} // namespace Engine::Scene
@@ -0,0 +1,1026 @@
+#include "MeshOptimizer.h"
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+
+namespace Engine::Scene::Loader
+{
+    namespace
+    {
+        constexpr uint32 InvalidIndex = ~0u;
+
+        // Tom Forsyth, "Linear-Speed Vertex Cache Optimisation".
+        constexpr float32 CacheDecayPower = 1.5f;
+        constexpr float32 LastTriangleScore = 0.75f;
+        constexpr float32 ValenceBoostScale = 2.0f;
+        constexpr float32 ValenceBoostPower = 0.5f;
+
+        float32 GetVertexScore(int32 cachePosition, uint32 liveTrianglesCount)
+        {
+            if (liveTrianglesCount == 0)
+            {
+                return -1.0f;
+            }
+
+            float32 score = 0.0f;
+            if (cachePosition >= 0)
+            {
+                if (cachePosition < 3)
+                {
+                    score = LastTriangleScore;
+                }
+                else
+                {
+                    const float32 scaler = 1.0f / (MeshOptimizer::LruCacheSize - 3);
+                    score = std::pow(1.0f - (cachePosition - 3) * scaler, CacheDecayPower);
+                }
+            }
+
+            score += ValenceBoostScale * std::pow(static_cast<float32>(liveTrianglesCount), -ValenceBoostPower);
+            return score;
+        }
+
+        // FIFO cache simulation: a vertex is cached while fewer than cacheSize misses happened since it was loaded.
+        class FifoCache
+        {
+        public:
+            FifoCache(Size verticesCount, Size cacheSize)
+                : mTimestamps(verticesCount, 0), mTime(static_cast<uint32>(cacheSize) + 1), mCacheSize(static_cast<uint32>(cacheSize))
+            {
+            }
+
+            bool Access(uint32 index)
+            {
+                if (mTime - mTimestamps[index] > mCacheSize)
+                {
+                    mTimestamps[index] = mTime++;
+                    return false;
+                }
+                return true;
+            }
+
+        private:
+            std::vector<uint32> mTimestamps;
+            uint32 mTime;
+            uint32 mCacheSize;
+        };
+
+        struct VertexHash
+        {
+            size_t operator()(const Vertex *vertex) const
+            {
+                return std::hash<std::string_view>()(std::string_view(reinterpret_cast<const char *>(vertex), sizeof(Vertex)));
+            }
+        };
+
+        struct VertexEqual
+        {
+            bool operator()(const Vertex *left, const Vertex *right) const
+            {
+                return memcmp(left, right, sizeof(Vertex)) == 0;
+            }
+        };
+
+        struct TriangleCluster
+        {
+            Size begin;
+            Size end;
+            float32 sortKey;
+        };
+
+        // Returns false for degenerate triangles.
+        bool GetTriangleNormal(const std::vector<Vertex> &vertices, const uint32 *triangle, DirectX::XMVECTOR &normal)
+        {
+            using namespace DirectX;
+
+            auto p0 = XMLoadFloat3(&vertices[triangle[0]].Vertex);
+            auto p1 = XMLoadFloat3(&vertices[triangle[1]].Vertex);
+            auto p2 = XMLoadFloat3(&vertices[triangle[2]].Vertex);
+
+            // Clockwise front faces of the left-handed scene, the normal points towards the viewer.
+            auto cross = XMVector3Cross(XMVectorSubtract(p1, p0), XMVectorSubtract(p2, p0));
+            const float32 length = XMVectorGetX(XMVector3Length(cross));
+            if (length <= 0.0f)
+            {
+                return false;
+            }
+
+            normal = XMVectorScale(cross, 1.0f / length);
+            return true;
+        }
+
+        void SetMeshletBounds(Meshlet &meshlet, const std::vector<DirectX::XMFLOAT3> &positions, const std::vector<Vertex> &vertices, std::span<const uint32> indices)
+        {
+            using namespace DirectX;
+
+            meshlet.verticesCount = static_cast<uint32>(positions.size());
+
+            BoundingSphere sphere;
+            BoundingSphere::CreateFromPoints(sphere, positions.size(), positions.data(), sizeof(XMFLOAT3));
+            meshlet.center = sphere.Center;
+            meshlet.radius = sphere.Radius;
+
+            auto triangles = indices.subspan(meshlet.indexOffset, meshlet.indexCount);
+
+            auto axis = XMVectorZero();
+            for (Size i = 0; i < triangles.size(); i += 3)
+            {
+                XMVECTOR normal;
+                if (GetTriangleNormal(vertices, &triangles[i], normal))
+                {
+                    axis = XMVectorAdd(axis, normal);
+                }
+            }
+
+            const float32 axisLength = XMVectorGetX(XMVector3Length(axis));
+            if (axisLength <= 0.0f)
+            {
+                return;
+            }
+            axis = XMVectorScale(axis, 1.0f / axisLength);
+
+            float32 minDot = 1.0f;
+            for (Size i = 0; i < triangles.size(); i += 3)
+            {
+                XMVECTOR normal;
+                if (GetTriangleNormal(vertices, &triangles[i], normal))
+                {
+                    const float32 dot = XMVectorGetX(XMVector3Dot(axis, normal));
+                    minDot = dot < minDot ? dot : minDot;
+                }
+            }
+
+            XMStoreFloat3(&meshlet.coneAxis, axis);
+
+            // Cones of 90 degrees or wider can always be seen from the front.
+            if (minDot > 0.0f)
+            {
+                meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+            }
+        }
+
+        enum class VertexKind : uint8
+        {
+            Manifold,
+            Border,
+            Locked
+        };
+
+        // Border edges are kept in place by planes perpendicular to their triangles.
+        constexpr float64 BorderWeight = 10.0;
+
+        // Garland and Heckbert, "Surface Simplification Using Quadric Error Metrics".
+        struct Quadric
+        {
+            float64 a00 = 0.0, a11 = 0.0, a22 = 0.0;
+            float64 a01 = 0.0, a02 = 0.0, a12 = 0.0;
+            float64 b0 = 0.0, b1 = 0.0, b2 = 0.0;
+            float64 c = 0.0;
+            float64 weight = 0.0;
+
+            void AddPlane(const DirectX::XMFLOAT3 &normal, float64 distance, float64 planeWeight)
+            {
+                const float64 x = normal.x;
+                const float64 y = normal.y;
+                const float64 z = normal.z;
+
+                a00 += planeWeight * x * x;
+                a11 += planeWeight * y * y;
+                a22 += planeWeight * z * z;
+                a01 += planeWeight * x * y;
+                a02 += planeWeight * x * z;
+                a12 += planeWeight * y * z;
+                b0 += planeWeight * x * distance;
+                b1 += planeWeight * y * distance;
+                b2 += planeWeight * z * distance;
+                c += planeWeight * distance * distance;
+                weight += planeWeight;
+            }
+
+            void Add(const Quadric &other)
+            {
+                a00 += other.a00;
+                a11 += other.a11;
+                a22 += other.a22;
+                a01 += other.a01;
+                a02 += other.a02;
+                a12 += other.a12;
+                b0 += other.b0;
+                b1 += other.b1;
+                b2 += other.b2;
+                c += other.c;
+                weight += other.weight;
+            }
+
+            // Weighted mean of the squared distances to the accumulated planes.
+            float64 GetError(const DirectX::XMFLOAT3 &position) const
+            {
+                const float64 x = position.x;
+                const float64 y = position.y;
+                const float64 z = position.z;
+
+                const float64 error =
+                    a00 * x * x + a11 * y * y + a22 * z * z +
+                    2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+                    2.0 * (b0 * x + b1 * y + b2 * z) + c;
+
+                return weight > 0.0 ? std::abs(error) / weight : 0.0;
+            }
+        };
+
+        struct Collapse
+        {
+            uint32 source;
+            uint32 target;
+            float64 error;
+        };
+
+        uint64 GetEdgeKey(uint32 from, uint32 to)
+        {
+            return (static_cast<uint64>(from) << 32) | to;
+        }
+
+        // Counts directed edges and marks border, seam and non-manifold vertices.
+        void ClassifyVertices(
+            const std::vector<Vertex> &vertices,
+            const std::vector<uint32> &indices,
+            std::vector<VertexKind> &kinds,
+            std::unordered_map<uint64, uint32> &edges)
+        {
+            kinds.assign(vertices.size(), VertexKind::Manifold);
+            edges.clear();
+
+            for (Size i = 0; i < indices.size(); i += 3)
+            {
+                for (Size k = 0; k < 3; ++k)
+                {
+                    ++edges[GetEdgeKey(indices[i + k], indices[i + (k + 1) % 3])];
+                }
+            }
+
+            std::vector<uint32> borderEdgesCount(vertices.size(), 0);
+            for (const auto &[key, count] : edges)
+            {
+                const uint32 from = static_cast<uint32>(key >> 32);
+                const uint32 to = static_cast<uint32>(key & 0xffffffff);
+
+                if (count > 1)
+                {
+                    kinds[from] = VertexKind::Locked;
+                    kinds[to] = VertexKind::Locked;
+                }
+                else if (!edges.contains(GetEdgeKey(to, from)))
+                {
+                    ++borderEdgesCount[from];
+                    ++borderEdgesCount[to];
+                }
+            }
+
+            for (Size i = 0; i < vertices.size(); ++i)
+            {
+                if (borderEdgesCount[i] > 0 && kinds[i] != VertexKind::Locked)
+                {
+                    kinds[i] = borderEdgesCount[i] == 2 ? VertexKind::Border : VertexKind::Locked;
+                }
+            }
+
+            // Vertices sharing a position sit on an attribute seam, moving one of them would tear the surface.
+            std::vector<uint32> referenced(indices.begin(), indices.end());
+            std::sort(referenced.begin(), referenced.end());
+            referenced.erase(std::unique(referenced.begin(), referenced.end()), referenced.end());
+
+            auto comparePositions = [&vertices](uint32 left, uint32 right)
+            {
+                return memcmp(&vertices[left].Vertex, &vertices[right].Vertex, sizeof(DirectX::XMFLOAT3));
+            };
+            std::sort(referenced.begin(), referenced.end(), [&comparePositions](uint32 left, uint32 right)
+            {
+                return comparePositions(left, right) < 0;
+            });
+
+            for (Size begin = 0; begin < referenced.size();)
+            {
+                Size end = begin + 1;
+                while (end < referenced.size() && comparePositions(referenced[begin], referenced[end]) == 0)
+                {
+                    ++end;
+                }
+
+                if (end - begin > 1)
+                {
+                    for (Size i = begin; i < end; ++i)
+                    {
+                        kinds[referenced[i]] = VertexKind::Locked;
+                    }
+                }
+                begin = end;
+            }
+        }
+
+        bool CanCollapse(uint32 source, uint32 target, const std::vector<VertexKind> &kinds, const std::unordered_map<uint64, uint32> &edges)
+        {
+            switch (kinds[source])
+            {
+            case VertexKind::Manifold:
+                return kinds[target] != VertexKind::Locked;
+            case VertexKind::Border:
+                return kinds[target] == VertexKind::Border &&
+                    edges.contains(GetEdgeKey(source, target)) != edges.contains(GetEdgeKey(target, source));
+            default:
+                return false;
+            }
+        }
+
+        // Rejects collapses that turn a remaining triangle around the source over.
+        bool IsFlipped(
+            const std::vector<Vertex> &vertices,
+            const std::vector<uint32> &indices,
+            std::span<const uint32> triangles,
+            uint32 source,
+            uint32 target)
+        {
+            using namespace DirectX;
+
+            auto getNormal = [](const XMVECTOR *positions)
+            {
+                return XMVector3Cross(XMVectorSubtract(positions[1], positions[0]), XMVectorSubtract(positions[2], positions[0]));
+            };
+
+            // Degenerate triangles have no facing of their own, they are compared with the whole ring.
+            XMVECTOR ringNormal = XMVectorZero();
+            for (auto triangle : triangles)
+            {
+                XMVECTOR positions[3];
+                for (Size k = 0; k < 3; ++k)
+                {
+                    positions[k] = XMLoadFloat3(&vertices[indices[triangle * 3 + k]].Vertex);
+                }
+                ringNormal = XMVectorAdd(ringNormal, getNormal(positions));
+            }
+
+            const XMVECTOR targetPosition = XMLoadFloat3(&vertices[target].Vertex);
+            for (auto triangle : triangles)
+            {
+                const uint32 *corners = &indices[triangle * 3];
+                if (corners[0] == target || corners[1] == target || corners[2] == target)
+                {
+                    continue;
+                }
+
+                XMVECTOR positions[3];
+                XMVECTOR collapsed[3];
+                for (Size k = 0; k < 3; ++k)
+                {
+                    positions[k] = XMLoadFloat3(&vertices[corners[k]].Vertex);
+                    collapsed[k] = corners[k] == source ? targetPosition : positions[k];
+                }
+
+                XMVECTOR normal = getNormal(positions);
+                if (XMVectorGetX(XMVector3LengthSq(normal)) <= 0.0f)
+                {
+                    normal = ringNormal;
+                }
+                const XMVECTOR collapsedNormal = getNormal(collapsed);
+
+                // Allow at most about 75 degrees of rotation. Collapsing to a line is rejected too, degenerate
+                // triangles along a border would hide it from the next pass and let it move without error.
+                const float32 dot = XMVectorGetX(XMVector3Dot(normal, collapsedNormal));
+                const float32 lengths = XMVectorGetX(XMVector3Length(normal)) * XMVectorGetX(XMVector3Length(collapsedNormal));
+                if (lengths <= 0.0f || dot < 0.25f * lengths)
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+    }
+
+    void MeshOptimizer::Optimize(std::vector<Vertex> &vertices, std::vector<uint32> &indices)
+    {
+        RemoveDuplicateVertices(vertices, indices);
+        OptimizeVertexCache(indices, vertices.size());
+        OptimizeOverdraw(vertices, indices);
+        OptimizeVertexFetch(vertices, indices);
+    }
+
+    void MeshOptimizer::RemoveDuplicateVertices(std::vector<Vertex> &vertices, std::vector<uint32> &indices)
+    {
+        // Vertex is tightly packed floats, so bitwise comparison is enough.
+        std::unordered_map<const Vertex *, uint32, VertexHash, VertexEqual> uniqueVertices;
+        uniqueVertices.reserve(vertices.size());
+
+        std::vector<uint32> remap(vertices.size());
+        std::vector<Vertex> result;
+        result.reserve(vertices.size());
+
+        for (Size i = 0; i < vertices.size(); ++i)
+        {
+            auto [iter, isInserted] = uniqueVertices.try_emplace(&vertices[i], static_cast<uint32>(result.size()));
+            if (isInserted)
+            {
+                result.push_back(vertices[i]);
+            }
+            remap[i] = iter->second;
+        }
+
+        if (result.size() == vertices.size())
+        {
+            return;
+        }
+
+        for (auto &index : indices)
+        {
+            index = remap[index];
+        }
+        vertices = std::move(result);
+    }
+
+    void MeshOptimizer::OptimizeVertexCache(std::vector<uint32> &indices, Size verticesCount)
+    {
+        const Size trianglesCount = indices.size() / 3;
+        if (trianglesCount == 0)
+        {
+            return;
+        }
+
+        std::vector<uint32> liveTrianglesCount(verticesCount, 0);
+        for (auto index : indices)
+        {
+            ++liveTrianglesCount[index];
+        }
+
+        std::vector<uint32> adjacencyOffsets(verticesCount + 1, 0);
+        for (Size i = 0; i < verticesCount; ++i)
+        {
+            adjacencyOffsets[i + 1] = adjacencyOffsets[i] + liveTrianglesCount[i];
+        }
+
+        std::vector<uint32> adjacency(trianglesCount * 3);
+        {
+            std::vector<uint32> fillOffsets(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (Size i = 0; i < trianglesCount * 3; ++i)
+            {
+                adjacency[fillOffsets[indices[i]]++] = static_cast<uint32>(i / 3);
+            }
+        }
+
+        std::vector<int32> cachePositions(verticesCount, -1);
+        std::vector<float32> vertexScores(verticesCount);
+        for (Size i = 0; i < verticesCount; ++i)
+        {
+            vertexScores[i] = GetVertexScore(-1, liveTrianglesCount[i]);
+        }
+
+        auto getTriangleScore = [&indices, &vertexScores](uint32 triangle)
+        {
+            const uint32 *triangleIndices = &indices[triangle * 3];
+            return vertexScores[triangleIndices[0]] + vertexScores[triangleIndices[1]] + vertexScores[triangleIndices[2]];
+        };
+
+        uint32 bestTriangle = 0;
+        float32 bestScore = getTriangleScore(0);
+        for (uint32 i = 1; i < trianglesCount; ++i)
+        {
+            float32 score = getTriangleScore(i);
+            if (score > bestScore)
+            {
+                bestScore = score;
+                bestTriangle = i;
+            }
+        }
+
+        std::vector<bool> isTriangleEmitted(trianglesCount, false);
+        std::vector<uint32> cache;
+        std::vector<uint32> newCache;
+        cache.reserve(LruCacheSize + 3);
+        newCache.reserve(LruCacheSize + 3);
+
+        std::vector<uint32> result;
+        result.reserve(indices.size());
+
+        Size nextTriangle = 0;
+        for (Size emitted = 0; emitted < trianglesCount; ++emitted)
+        {
+            if (bestTriangle == InvalidIndex)
+            {
+                // Nothing adjacent to the cache is left, continue with the next unemitted triangle.
+                while (isTriangleEmitted[nextTriangle])
+                {
+                    ++nextTriangle;
+                }
+                bestTriangle = static_cast<uint32>(nextTriangle);
+            }
+
+            const uint32 *triangleIndices = &indices[bestTriangle * 3];
+            isTriangleEmitted[bestTriangle] = true;
+
+            newCache.clear();
+            for (Size i = 0; i < 3; ++i)
+            {
+                uint32 index = triangleIndices[i];
+                result.push_back(index);
+
+                if (std::find(newCache.begin(), newCache.end(), index) == newCache.end())
+                {
+                    newCache.push_back(index);
+                }
+
+                uint32 *begin = adjacency.data() + adjacencyOffsets[index];
+                uint32 *end = begin + liveTrianglesCount[index];
+                std::swap(*std::find(begin, end, bestTriangle), *(end - 1));
+                --liveTrianglesCount[index];
+            }
+
+            for (auto index : cache)
+            {
+                if (std::find(triangleIndices, triangleIndices + 3, index) == triangleIndices + 3)
+                {
+                    newCache.push_back(index);
+                }
+            }
+
+            for (Size i = 0; i < newCache.size(); ++i)
+            {
+                uint32 index = newCache[i];
+                cachePositions[index] = i < LruCacheSize ? static_cast<int32>(i) : -1;
+                vertexScores[index] = GetVertexScore(cachePositions[index], liveTrianglesCount[index]);
+            }
+
+            if (newCache.size() > LruCacheSize)
+            {
+                newCache.resize(LruCacheSize);
+            }
+            std::swap(cache, newCache);
+
+            bestTriangle = InvalidIndex;
+            bestScore = -1.0f;
+            for (auto index : cache)
+            {
+                const uint32 begin = adjacencyOffsets[index];
+                const uint32 end = begin + liveTrianglesCount[index];
+                for (uint32 i = begin; i < end; ++i)
+                {
+                    float32 score = getTriangleScore(adjacency[i]);
+                    if (score > bestScore)
+                    {
+                        bestScore = score;
+                        bestTriangle = adjacency[i];
+                    }
+                }
+            }
+        }
+
+        indices = std::move(result);
+    }
+
+    void MeshOptimizer::OptimizeOverdraw(const std::vector<Vertex> &vertices, std::vector<uint32> &indices)
+    {
+        using namespace DirectX;
+
+        const Size trianglesCount = indices.size() / 3;
+        if (trianglesCount == 0)
+        {
+            return;
+        }
+
+        // Triangles that miss the cache on every vertex start a new cluster,
+        // so reordering whole clusters barely affects the vertex cache efficiency.
+        std::vector<TriangleCluster> clusters;
+        {
+            FifoCache cache(vertices.size(), FifoCacheSize);
+            for (Size i = 0; i < trianglesCount; ++i)
+            {
+                uint32 missesCount = 0;
+                for (Size j = 0; j < 3; ++j)
+                {
+                    missesCount += cache.Access(indices[i * 3 + j]) ? 0 : 1;
+                }
+
+                if (i == 0 || missesCount == 3)
+                {
+                    if (!clusters.empty())
+                    {
+                        clusters.back().end = i;
+                    }
+                    clusters.push_back({i, trianglesCount, 0.0f});
+                }
+            }
+        }
+
+        if (clusters.size() < 2)
+        {
+            return;
+        }
+
+        // Sander et al., "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw":
+        // clusters facing away from the mesh center are likely to occlude the rest, so draw them first.
+        std::vector<XMFLOAT3> centroids(clusters.size());
+        std::vector<XMFLOAT3> normals(clusters.size());
+
+        XMVECTOR meshCentroid = XMVectorZero();
+        float32 meshArea = 0.0f;
+
+        for (Size i = 0; i < clusters.size(); ++i)
+        {
+            XMVECTOR centroid = XMVectorZero();
+            XMVECTOR normal = XMVectorZero();
+            float32 area = 0.0f;
+
+            for (Size triangle = clusters[i].begin; triangle < clusters[i].end; ++triangle)
+            {
+                XMVECTOR p0 = XMLoadFloat3(&vertices[indices[triangle * 3 + 0]].Vertex);
+                XMVECTOR p1 = XMLoadFloat3(&vertices[indices[triangle * 3 + 1]].Vertex);
+                XMVECTOR p2 = XMLoadFloat3(&vertices[indices[triangle * 3 + 2]].Vertex);
+
+                XMVECTOR triangleNormal = XMVector3Cross(XMVectorSubtract(p1, p0), XMVectorSubtract(p2, p0));
+                float32 triangleArea = XMVectorGetX(XMVector3Length(triangleNormal));
+
+                centroid = XMVectorAdd(centroid, XMVectorScale(XMVectorAdd(XMVectorAdd(p0, p1), p2), triangleArea / 3.0f));
+                normal = XMVectorAdd(normal, triangleNormal);
+                area += triangleArea;
+            }
+
+            meshCentroid = XMVectorAdd(meshCentroid, centroid);
+            meshArea += area;
+
+            XMStoreFloat3(&centroids[i], area > 0.0f ? XMVectorScale(centroid, 1.0f / area) : centroid);
+            XMStoreFloat3(&normals[i], XMVector3Normalize(normal));
+        }
+
+        if (meshArea > 0.0f)
+        {
+            meshCentroid = XMVectorScale(meshCentroid, 1.0f / meshArea);
+        }
+
+        for (Size i = 0; i < clusters.size(); ++i)
+        {
+            XMVECTOR offset = XMVectorSubtract(XMLoadFloat3(&centroids[i]), meshCentroid);
+            clusters[i].sortKey = XMVectorGetX(XMVector3Dot(offset, XMLoadFloat3(&normals[i])));
+        }
+
+        std::stable_sort(clusters.begin(), clusters.end(), [](const TriangleCluster &left, const TriangleCluster &right)
+        {
+            return left.sortKey > right.sortKey;
+        });
+
+        std::vector<uint32> result;
+        result.reserve(indices.size());
+        for (const auto &cluster : clusters)
+        {
+            result.insert(result.end(), indices.begin() + cluster.begin * 3, indices.begin() + cluster.end * 3);
+        }
+
+        indices = std::move(result);
+    }
+
+    void MeshOptimizer::OptimizeVertexFetch(std::vector<Vertex> &vertices, std::vector<uint32> &indices)
+    {
+        std::vector<uint32> remap(vertices.size(), InvalidIndex);
+        std::vector<Vertex> result;
+        result.reserve(vertices.size());
+
+        for (auto &index : indices)
+        {
+            if (remap[index] == InvalidIndex)
+            {
+                remap[index] = static_cast<uint32>(result.size());
+                result.push_back(vertices[index]);
+            }
+            index = remap[index];
+        }
+
+        vertices = std::move(result);
+    }
+
+    std::vector<Meshlet> MeshOptimizer::BuildMeshlets(const std::vector<Vertex> &vertices, std::span<const uint32> indices)
+    {
+        std::vector<Meshlet> meshlets;
+        std::vector<uint32> meshletIndices(vertices.size(), InvalidIndex);
+        std::vector<DirectX::XMFLOAT3> positions;
+        positions.reserve(MaxMeshletVertices);
+
+        Meshlet meshlet;
+        for (Size i = 0; i + 2 < indices.size(); i += 3)
+        {
+            Size newVerticesCount = 0;
+            for (Size k = 0; k < 3; ++k)
+            {
+                newVerticesCount += meshletIndices[indices[i + k]] != meshlets.size() ? 1 : 0;
+            }
+
+            if (positions.size() + newVerticesCount > MaxMeshletVertices || meshlet.indexCount == MaxMeshletTriangles * 3)
+            {
+                SetMeshletBounds(meshlet, positions, vertices, indices);
+                meshlets.push_back(meshlet);
+
+                meshlet = {};
+                meshlet.indexOffset = static_cast<uint32>(i);
+                positions.clear();
+            }
+
+            const uint32 meshletIndex = static_cast<uint32>(meshlets.size());
+            for (Size k = 0; k < 3; ++k)
+            {
+                const uint32 index = indices[i + k];
+                if (meshletIndices[index] != meshletIndex)
+                {
+                    meshletIndices[index] = meshletIndex;
+                    positions.push_back(vertices[index].Vertex);
+                }
+            }
+            meshlet.indexCount += 3;
+        }
+
+        if (meshlet.indexCount > 0)
+        {
+            SetMeshletBounds(meshlet, positions, vertices, indices);
+            meshlets.push_back(meshlet);
+        }
+
+        return meshlets;
+    }
+
+    std::vector<uint32> MeshOptimizer::Simplify(
+        const std::vector<Vertex> &vertices,
+        std::span<const uint32> indices,
+        Size targetIndicesCount,
+        float32 targetError,
+        float32 &resultError)
+    {
+        using namespace DirectX;
+
+        std::vector<uint32> result(indices.begin(), indices.end());
+
+        std::vector<VertexKind> kinds;
+        std::unordered_map<uint64, uint32> edges;
+        ClassifyVertices(vertices, result, kinds, edges);
+
+        std::vector<Quadric> quadrics(vertices.size());
+        for (Size i = 0; i < result.size(); i += 3)
+        {
+            XMVECTOR positions[3];
+            for (Size k = 0; k < 3; ++k)
+            {
+                positions[k] = XMLoadFloat3(&vertices[result[i + k]].Vertex);
+            }
+
+            XMVECTOR normal;
+            if (!GetTriangleNormal(vertices, &result[i], normal))
+            {
+                continue;
+            }
+
+            const float32 area = 0.5f * XMVectorGetX(XMVector3Length(
+                XMVector3Cross(XMVectorSubtract(positions[1], positions[0]), XMVectorSubtract(positions[2], positions[0]))));
+
+            XMFLOAT3 plane;
+            XMStoreFloat3(&plane, normal);
+            const float32 distance = -XMVectorGetX(XMVector3Dot(normal, positions[0]));
+            for (Size k = 0; k < 3; ++k)
+            {
+                quadrics[result[i + k]].AddPlane(plane, distance, area);
+            }
+
+            for (Size k = 0; k < 3; ++k)
+            {
+                const uint32 from = result[i + k];
+                const uint32 to = result[i + (k + 1) % 3];
+                if (edges.contains(GetEdgeKey(to, from)))
+                {
+                    continue;
+                }
+
+                const XMVECTOR edge = XMVectorSubtract(positions[(k + 1) % 3], positions[k]);
+                XMFLOAT3 borderPlane;
+                XMStoreFloat3(&borderPlane, XMVector3Normalize(XMVector3Cross(edge, normal)));
+                const float32 borderDistance = -XMVectorGetX(XMVector3Dot(XMLoadFloat3(&borderPlane), positions[k]));
+                const float64 borderWeight = BorderWeight * XMVectorGetX(XMVector3LengthSq(edge));
+
+                quadrics[from].AddPlane(borderPlane, borderDistance, borderWeight);
+                quadrics[to].AddPlane(borderPlane, borderDistance, borderWeight);
+            }
+        }
+
+        const float64 maxError = static_cast<float64>(targetError) * targetError;
+        float64 collapsedError = 0.0;
+
+        std::vector<Collapse> collapses;
+        std::vector<uint32> remap(vertices.size());
+        std::vector<bool> isTouched(vertices.size());
+        std::vector<uint32> adjacencyOffsets(vertices.size() + 1);
+        std::vector<uint32> adjacency;
+
+        // Every pass collapses an independent set of the cheapest edges, then the topology is rebuilt.
+        while (result.size() > targetIndicesCount)
+        {
+            collapses.clear();
+            for (Size i = 0; i < result.size(); i += 3)
+            {
+                for (Size k = 0; k < 3; ++k)
+                {
+                    const uint32 from = result[i + k];
+                    const uint32 to = result[i + (k + 1) % 3];
+
+                    if (CanCollapse(from, to, kinds, edges))
+                    {
+                        collapses.push_back({from, to, quadrics[from].GetError(vertices[to].Vertex)});
+                    }
+                    if (CanCollapse(to, from, kinds, edges))
+                    {
+                        collapses.push_back({to, from, quadrics[to].GetError(vertices[from].Vertex)});
+                    }
+                }
+            }
+
+            std::sort(collapses.begin(), collapses.end(), [](const Collapse &left, const Collapse &right)
+            {
+                return left.error < right.error;
+            });
+
+            std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+            for (auto index : result)
+            {
+                ++adjacencyOffsets[index + 1];
+            }
+            for (Size i = 0; i < vertices.size(); ++i)
+            {
+                adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+            }
+            adjacency.resize(result.size());
+            {
+                std::vector<uint32> writeOffsets(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+                for (Size i = 0; i < result.size(); ++i)
+                {
+                    adjacency[writeOffsets[result[i]]++] = static_cast<uint32>(i / 3);
+                }
+            }
+
+            for (uint32 i = 0; i < remap.size(); ++i)
+            {
+                remap[i] = i;
+            }
+            std::fill(isTouched.begin(), isTouched.end(), false);
+
+            Size trianglesCount = result.size() / 3;
+            Size collapsesCount = 0;
+            for (const auto &collapse : collapses)
+            {
+                if (collapse.error > maxError || trianglesCount * 3 <= targetIndicesCount)
+                {
+                    break;
+                }
+
+                if (isTouched[collapse.source] || isTouched[collapse.target])
+                {
+                    continue;
+                }
+
+                auto triangles = std::span<const uint32>(adjacency).subspan(
+                    adjacencyOffsets[collapse.source],
+                    adjacencyOffsets[collapse.source + 1] - adjacencyOffsets[collapse.source]);
+
+                if (IsFlipped(vertices, result, triangles, collapse.source, collapse.target))
+                {
+                    continue;
+                }
+
+                // The whole ring is frozen for the rest of the pass, so flip checks stay valid and remaps do not chain.
+                for (auto triangle : triangles)
+                {
+                    const uint32 *corners = &result[triangle * 3];
+                    if (corners[0] == collapse.target || corners[1] == collapse.target || corners[2] == collapse.target)
+                    {
+                        --trianglesCount;
+                    }
+
+                    for (Size k = 0; k < 3; ++k)
+                    {
+                        isTouched[corners[k]] = true;
+                    }
+                }
+
+                remap[collapse.source] = collapse.target;
+                quadrics[collapse.target].Add(quadrics[collapse.source]);
+                collapsedError = collapse.error > collapsedError ? collapse.error : collapsedError;
+                ++collapsesCount;
+            }
+
+            if (collapsesCount == 0)
+            {
+                break;
+            }
+
+            Size writeOffset = 0;
+            for (Size i = 0; i < result.size(); i += 3)
+            {
+                const uint32 a = remap[result[i + 0]];
+                const uint32 b = remap[result[i + 1]];
+                const uint32 c = remap[result[i + 2]];
+
+                if (a != b && b != c && a != c)
+                {
+                    result[writeOffset++] = a;
+                    result[writeOffset++] = b;
+                    result[writeOffset++] = c;
+                }
+            }
+            result.resize(writeOffset);
+
+            ClassifyVertices(vertices, result, kinds, edges);
+        }
+
+        resultError = static_cast<float32>(std::sqrt(collapsedError));
+        return result;
+    }
+
+    std::vector<MeshLod> MeshOptimizer::BuildLods(const std::vector<Vertex> &vertices, std::vector<uint32> &indices, std::vector<Meshlet> &meshlets)
+    {
+        std::vector<MeshLod> lods;
+        if (indices.empty())
+        {
+            return lods;
+        }
+
+        DirectX::BoundingSphere bounds;
+        DirectX::BoundingSphere::CreateFromPoints(bounds, vertices.size(), &vertices[0].Vertex, sizeof(Vertex));
+        const float32 maxError = MaxLodError * bounds.Radius;
+
+        MeshLod lod;
+        lod.indexCount = static_cast<uint32>(indices.size());
+        while (true)
+        {
+            auto lodMeshlets = BuildMeshlets(vertices, std::span(indices).subspan(lod.indexOffset, lod.indexCount));
+            for (auto &meshlet : lodMeshlets)
+            {
+                meshlet.indexOffset += lod.indexOffset;
+            }
+
+            lod.meshletOffset = static_cast<uint32>(meshlets.size());
+            lod.meshletsCount = static_cast<uint32>(lodMeshlets.size());
+            meshlets.insert(meshlets.end(), lodMeshlets.begin(), lodMeshlets.end());
+            lods.push_back(lod);
+
+            if (lods.size() == MaxLodsCount || lod.error >= maxError)
+            {
+                break;
+            }
+
+            float32 error = 0.0f;
+            auto simplified = Simplify(vertices, std::span(indices).subspan(lod.indexOffset, lod.indexCount), lod.indexCount / 6 * 3, maxError - lod.error, error);
+
+            // Stop once locked vertices or the error budget keep the simplification from making progress.
+            if (simplified.empty() || simplified.size() * 4 > static_cast<Size>(lod.indexCount) * 3)
+            {
+                break;
+            }
+
+            OptimizeVertexCache(simplified, vertices.size());
+
+            lod.indexOffset = static_cast<uint32>(indices.size());
+            lod.indexCount = static_cast<uint32>(simplified.size());
+            lod.error += error;
+            indices.insert(indices.end(), simplified.begin(), simplified.end());
+        }
+
+        return lods;
+    }
+
+    VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(std::span<const uint32> indices, Size verticesCount, Size cacheSize)
+    {
+        VertexCacheStatistics statistics;
+        statistics.trianglesCount = indices.size() / 3;
+
+        FifoCache cache(verticesCount, cacheSize);
+        std::vector<bool> isReferenced(verticesCount, false);
+
+        Size missesCount = 0;
+        for (auto index : indices)
+        {
+            missesCount += cache.Access(index) ? 0 : 1;
+
+            if (!isReferenced[index])
+            {
+                isReferenced[index] = true;
+                ++statistics.verticesCount;
+            }
+        }
+
+        if (statistics.trianglesCount > 0)
+        {
+            statistics.acmr = static_cast<float32>(missesCount) / statistics.trianglesCount;
+        }
+        if (statistics.verticesCount > 0)
+        {
+            statistics.atvr = static_cast<float32>(missesCount) / statistics.verticesCount;
+        }
+
+        return statistics;
+    }
+} // namespace Engine::Scene::Loader
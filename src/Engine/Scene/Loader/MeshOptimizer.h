@@ -0,0 +1,67 @@
+#pragma once
+
+#include <Types.h>
+#include <Scene/Vertex.h>
+#include <Scene/Meshlet.h>
+#include <Scene/MeshLod.h>
+
+#include <span>
+#include <vector>
+
+namespace Engine::Scene::Loader
+{
+    struct VertexCacheStatistics
+    {
+        Size verticesCount = 0;
+        Size trianglesCount = 0;
+        // Average cache miss ratio: transformed vertices per triangle.
+        float32 acmr = 0.0f;
+        // Average transform to vertex ratio: transformed vertices per unique vertex.
+        float32 atvr = 0.0f;
+    };
+
+    class MeshOptimizer
+    {
+    public:
+        // Size of the FIFO cache used for statistics and cluster boundaries.
+        static constexpr Size FifoCacheSize = 16;
+        // Size of the LRU cache modelled by the triangle reordering.
+        static constexpr Size LruCacheSize = 32;
+        // Meshlet limits, the usual mesh shader output sizes.
+        static constexpr Size MaxMeshletVertices = 64;
+        static constexpr Size MaxMeshletTriangles = 124;
+        // LOD chain limits, the error is relative to the mesh bounding radius.
+        static constexpr Size MaxLodsCount = 6;
+        static constexpr float32 MaxLodError = 0.05f;
+
+    public:
+        // Runs the whole pipeline on a triangle list: vertex deduplication,
+        // post-transform cache reordering, overdraw-aware cluster sorting and vertex fetch reordering.
+        static void Optimize(std::vector<Vertex> &vertices, std::vector<uint32> &indices);
+
+        static void RemoveDuplicateVertices(std::vector<Vertex> &vertices, std::vector<uint32> &indices);
+        static void OptimizeVertexCache(std::vector<uint32> &indices, Size verticesCount);
+        static void OptimizeOverdraw(const std::vector<Vertex> &vertices, std::vector<uint32> &indices);
+        static void OptimizeVertexFetch(std::vector<Vertex> &vertices, std::vector<uint32> &indices);
+
+        // Splits a triangle list into meshlets of consecutive triangles, the index order is kept
+        // so the meshlets are ranges of the index buffer.
+        static std::vector<Meshlet> BuildMeshlets(const std::vector<Vertex> &vertices, std::span<const uint32> indices);
+
+        // Quadric error edge collapse that only rewrites the index list, vertices stay untouched.
+        // Attribute seams and non-manifold vertices are locked, borders only collapse along themselves.
+        // The error is the mesh space deviation introduced by the simplification.
+        static std::vector<uint32> Simplify(
+            const std::vector<Vertex> &vertices,
+            std::span<const uint32> indices,
+            Size targetIndicesCount,
+            float32 targetError,
+            float32 &resultError);
+
+        // Appends a chain of simplified index lists after the full detail indices, halving the triangles per LOD.
+        // The meshlets of every LOD are appended to meshlets.
+        static std::vector<MeshLod> BuildLods(const std::vector<Vertex> &vertices, std::vector<uint32> &indices, std::vector<Meshlet> &meshlets);
+
+        static VertexCacheStatistics AnalyzeVertexCache(std::span<const uint32> indices, Size verticesCount, Size cacheSize = FifoCacheSize);
+    };
+} // namespace Engine::Scene::Loader
@@ -0,0 +1,466 @@
+#include "SceneCache.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+
+namespace Engine::Scene::Loader
+{
+    namespace
+    {
+        class CacheWriter
+        {
+        public:
+            CacheWriter(std::ofstream& stream) : mStream(stream) {}
+
+            template <typename T>
+            void Write(const T& value)
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+                mStream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+            }
+
+            void Write(const String& value)
+            {
+                Write(static_cast<uint32>(value.size()));
+                mStream.write(value.data(), value.size());
+            }
+
+            void Write(std::span<const Byte> data)
+            {
+                Write(static_cast<uint64>(data.size()));
+                mStream.write(reinterpret_cast<const char*>(data.data()), data.size());
+            }
+
+        private:
+            std::ofstream& mStream;
+        };
+
+        class CacheReader
+        {
+        public:
+            CacheReader(std::span<const Byte> data) : mData(data), mOffset(0), mValid(true) {}
+
+            template <typename T>
+            T Read()
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+                static_assert(!std::is_same_v<T, bool>, "Read bools as uint8, any other byte value is not a valid bool");
+                T value{};
+                if (Require(sizeof(T)))
+                {
+                    memcpy(&value, mData.data() + mOffset, sizeof(T));
+                    mOffset += sizeof(T);
+                }
+                return value;
+            }
+
+            String ReadString()
+            {
+                auto size = Read<uint32>();
+                if (!Require(size))
+                {
+                    return {};
+                }
+
+                String value(reinterpret_cast<const char*>(mData.data() + mOffset), size);
+                mOffset += size;
+                return value;
+            }
+
+            std::span<const Byte> ReadBlob()
+            {
+                auto size = Read<uint64>();
+                if (!Require(size))
+                {
+                    return {};
+                }
+
+                auto blob = mData.subspan(mOffset, static_cast<Size>(size));
+                mOffset += static_cast<Size>(size);
+                return blob;
+            }
+
+            bool IsValid() const { return mValid; }
+            bool IsAtEnd() const { return mOffset == mData.size(); }
+
+        private:
+            bool Require(uint64 size)
+            {
+                if (mValid && (mData.size() - mOffset) < size)
+                {
+                    mValid = false;
+                }
+                return mValid;
+            }
+
+        private:
+            std::span<const Byte> mData;
+            Size mOffset;
+            bool mValid;
+        };
+
+        bool IsValidIndex(int32 index, Size count)
+        {
+            return index >= 0 && static_cast<Size>(index) < count;
+        }
+
+        void GetFileStamp(const String& path, uint64& size, int64& writeTime)
+        {
+            std::error_code error;
+            auto fileSize = std::filesystem::file_size(path, error);
+            size = error ? 0 : static_cast<uint64>(fileSize);
+
+            auto fileWriteTime = std::filesystem::last_write_time(path, error);
+            writeTime = error ? 0 : static_cast<int64>(fileWriteTime.time_since_epoch().count());
+        }
+
+        // Vertex streams are written by the loader with the stride of their format, anything else comes from a corrupt or older cache.
+        bool IsValidVertexLayout(const SceneDescription::MeshEntry& mesh, bool isPositionSplit)
+        {
+            if (mesh.vertexFormat != VertexFormat::Full && mesh.vertexFormat != VertexFormat::Compact)
+            {
+                return false;
+            }
+
+            const Size vertexSize = mesh.vertexFormat == VertexFormat::Compact ? sizeof(CompactVertex) : sizeof(Vertex);
+            const Size positionSize = isPositionSplit ? Vertex::GetPositionSize(mesh.vertexFormat) : 0;
+
+            return mesh.positionSize == positionSize && mesh.vertexSize == vertexSize - positionSize;
+        }
+    }
+
+    SceneCache::SceneCache() = default;
+
+    SceneCache::~SceneCache() = default;
+
+    String SceneCache::GetCachePath(const String& sourcePath)
+    {
+        std::filesystem::path cachePath = sourcePath;
+        cachePath.replace_extension("dxscene");
+
+        return cachePath.string();
+    }
+
+    SceneCacheKey SceneCache::GetCacheKey(const String& sourcePath, Optional<float32> scale, VertexFormat vertexFormat, bool isPositionSplit)
+    {
+        SceneCacheKey key = {};
+
+        GetFileStamp(sourcePath, key.sourceSize, key.sourceWriteTime);
+
+        key.hasScale = scale.has_value() ? 1 : 0;
+        key.scale = scale.value_or(0.0f);
+        key.vertexFormat = vertexFormat;
+        key.isPositionSplit = isPositionSplit ? 1 : 0;
+
+        return key;
+    }
+
+    SceneCacheDependency SceneCache::GetDependency(const String& path)
+    {
+        SceneCacheDependency dependency;
+        dependency.path = path;
+        GetFileStamp(path, dependency.size, dependency.writeTime);
+
+        return dependency;
+    }
+
+    bool SceneCache::Write(const String& cachePath, const SceneCacheKey& key, std::span<const SceneCacheDependency> dependencies, const SceneDescription& description)
+    {
+        String temporaryPath = cachePath + ".tmp";
+
+        {
+            std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+            if (!stream)
+            {
+                return false;
+            }
+
+            CacheWriter writer(stream);
+
+            writer.Write(Magic);
+            writer.Write(Version);
+            writer.Write(key);
+
+            writer.Write(static_cast<uint32>(dependencies.size()));
+            for (const auto& dependency : dependencies)
+            {
+                writer.Write(dependency.path);
+                writer.Write(dependency.size);
+                writer.Write(dependency.writeTime);
+            }
+
+            writer.Write(static_cast<uint32>(description.textures.size()));
+            for (const auto& texture : description.textures)
+            {
+                writer.Write(texture.path);
+                writer.Write(texture.formatHint);
+                writer.Write(texture.data);
+                writer.Write(static_cast<uint8>(texture.isSRGB ? 1 : 0));
+            }
+
+            writer.Write(static_cast<uint32>(description.materials.size()));
+            for (const auto& material : description.materials)
+            {
+                writer.Write(material.properties);
+                writer.Write(material.textures);
+            }
+
+            writer.Write(static_cast<uint32>(description.meshes.size()));
+            for (const auto& mesh : description.meshes)
+            {
+                writer.Write(mesh.name);
+                writer.Write(mesh.material);
+                writer.Write(mesh.primitiveTopology);
+                writer.Write(mesh.boundingBox);
+                writer.Write(mesh.vertexFormat);
+                writer.Write(mesh.positionQuantization);
+                writer.Write(mesh.verticesCount);
+                writer.Write(mesh.positionSize);
+                writer.Write(mesh.positions);
+                writer.Write(mesh.vertexSize);
+                writer.Write(mesh.vertices);
+                writer.Write(mesh.indicesCount);
+                writer.Write(mesh.indexSize);
+                writer.Write(mesh.indices);
+                writer.Write(mesh.meshletsCount);
+                writer.Write(mesh.meshlets);
+                writer.Write(mesh.lodsCount);
+                writer.Write(mesh.lods);
+            }
+
+            writer.Write(static_cast<uint32>(description.lights.size()));
+            for (const auto& light : description.lights)
+            {
+                writer.Write(light);
+            }
+
+            writer.Write(static_cast<uint32>(description.cameras.size()));
+            for (const auto& camera : description.cameras)
+            {
+                writer.Write(camera);
+            }
+
+            writer.Write(static_cast<uint32>(description.nodes.size()));
+            for (const auto& node : description.nodes)
+            {
+                writer.Write(node.name);
+                writer.Write(node.transform);
+                writer.Write(node.parent);
+                writer.Write(node.type);
+                writer.Write(node.index);
+            }
+
+            if (!stream)
+            {
+                stream.close();
+
+                std::error_code error;
+                std::filesystem::remove(temporaryPath, error);
+                return false;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporaryPath, cachePath, error);
+        if (error)
+        {
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+
+        return true;
+    }
+
+    bool SceneCache::Read(const String& cachePath, const SceneCacheKey& key, SceneDescription& description)
+    {
+        if (!mFile.Open(cachePath))
+        {
+            return false;
+        }
+
+        CacheReader reader(mFile.GetData());
+
+        auto magic = reader.Read<uint32>();
+        auto version = reader.Read<uint32>();
+        auto cacheKey = reader.Read<SceneCacheKey>();
+
+        if (!reader.IsValid() || magic != Magic || version != Version ||
+            cacheKey.sourceSize != key.sourceSize ||
+            cacheKey.sourceWriteTime != key.sourceWriteTime ||
+            cacheKey.hasScale != key.hasScale ||
+            cacheKey.scale != key.scale ||
+            cacheKey.vertexFormat != key.vertexFormat ||
+            cacheKey.isPositionSplit != key.isPositionSplit)
+        {
+            mFile.Close();
+            return false;
+        }
+
+        auto dependenciesCount = reader.Read<uint32>();
+        for (uint32 i = 0; i < dependenciesCount && reader.IsValid(); ++i)
+        {
+            SceneCacheDependency dependency;
+            dependency.path = reader.ReadString();
+            dependency.size = reader.Read<uint64>();
+            dependency.writeTime = reader.Read<int64>();
+
+            uint64 size;
+            int64 writeTime;
+            GetFileStamp(dependency.path, size, writeTime);
+            if (size != dependency.size || writeTime != dependency.writeTime)
+            {
+                mFile.Close();
+                return false;
+            }
+        }
+
+        SceneDescription result;
+
+        auto texturesCount = reader.Read<uint32>();
+        for (uint32 i = 0; i < texturesCount && reader.IsValid(); ++i)
+        {
+            auto& texture = result.textures.emplace_back();
+            texture.path = reader.ReadString();
+            texture.formatHint = reader.ReadString();
+            texture.data = reader.ReadBlob();
+            texture.isSRGB = reader.Read<uint8>() != 0;
+        }
+
+        auto materialsCount = reader.Read<uint32>();
+        for (uint32 i = 0; i < materialsCount && reader.IsValid(); ++i)
+        {
+            auto& material = result.materials.emplace_back();
+            material.properties = reader.Read<MaterialProperties>();
+            material.textures = reader.Read<std::array<int32, MaterialTextureSlotsCount>>();
+
+            for (auto textureIndex : material.textures)
+            {
+                if (textureIndex != -1 && !IsValidIndex(textureIndex, result.textures.size()))
+                {
+                    mFile.Close();
+                    return false;
+                }
+            }
+        }
+
+        auto meshesCount = reader.Read<uint32>();
+        for (uint32 i = 0; i < meshesCount && reader.IsValid(); ++i)
+        {
+            auto& mesh = result.meshes.emplace_back();
+            mesh.name = reader.ReadString();
+            mesh.material = reader.Read<int32>();
+            mesh.primitiveTopology = reader.Read<D3D_PRIMITIVE_TOPOLOGY>();
+            mesh.boundingBox = reader.Read<dx::BoundingBox>();
+            mesh.vertexFormat = reader.Read<VertexFormat>();
+            mesh.positionQuantization = reader.Read<VertexCompression::PositionQuantization>();
+            mesh.verticesCount = reader.Read<uint32>();
+            mesh.positionSize = reader.Read<uint32>();
+            mesh.positions = reader.ReadBlob();
+            mesh.vertexSize = reader.Read<uint32>();
+            mesh.vertices = reader.ReadBlob();
+            mesh.indicesCount = reader.Read<uint32>();
+            mesh.indexSize = reader.Read<uint32>();
+            mesh.indices = reader.ReadBlob();
+            mesh.meshletsCount = reader.Read<uint32>();
+            mesh.meshlets = reader.ReadBlob();
+            mesh.lodsCount = reader.Read<uint32>();
+            mesh.lods = reader.ReadBlob();
+
+            if (!IsValidIndex(mesh.material, result.materials.size()) ||
+                !IsValidVertexLayout(mesh, key.isPositionSplit != 0) ||
+                (mesh.indexSize != sizeof(uint16) && mesh.indexSize != sizeof(uint32)) ||
+                mesh.positions.size() != static_cast<Size>(mesh.verticesCount) * mesh.positionSize ||
+                mesh.vertices.size() != static_cast<Size>(mesh.verticesCount) * mesh.vertexSize ||
+                mesh.indices.size() != static_cast<Size>(mesh.indicesCount) * mesh.indexSize ||
+                mesh.meshlets.size() != static_cast<Size>(mesh.meshletsCount) * sizeof(Meshlet) ||
+                mesh.lods.size() != static_cast<Size>(mesh.lodsCount) * sizeof(MeshLod))
+            {
+                mFile.Close();
+                return false;
+            }
+
+            for (uint32 j = 0; j < mesh.meshletsCount; ++j)
+            {
+                Meshlet meshlet;
+                memcpy(&meshlet, mesh.meshlets.data() + j * sizeof(Meshlet), sizeof(Meshlet));
+                if (static_cast<uint64>(meshlet.indexOffset) + meshlet.indexCount > mesh.indicesCount)
+                {
+                    mFile.Close();
+                    return false;
+                }
+            }
+
+            for (uint32 j = 0; j < mesh.lodsCount; ++j)
+            {
+                MeshLod lod;
+                memcpy(&lod, mesh.lods.data() + j * sizeof(MeshLod), sizeof(MeshLod));
+                if (static_cast<uint64>(lod.indexOffset) + lod.indexCount > mesh.indicesCount ||
+                    static_cast<uint64>(lod.meshletOffset) + lod.meshletsCount > mesh.meshletsCount)
+                {
+                    mFile.Close();
+                    return false;
+                }
+            }
+        }
+
+        auto lightsCount = reader.Read<uint32>();
+        for (uint32 i = 0; i < lightsCount && reader.IsValid(); ++i)
+        {
+            result.lights.push_back(reader.Read<PunctualLight>());
+        }
+
+        auto camerasCount = reader.Read<uint32>();
+        for (uint32 i = 0; i < camerasCount && reader.IsValid(); ++i)
+        {
+            result.cameras.push_back(reader.Read<Camera>());
+        }
+
+        auto nodesCount = reader.Read<uint32>();
+        for (uint32 i = 0; i < nodesCount && reader.IsValid(); ++i)
+        {
+            auto& node = result.nodes.emplace_back();
+            node.name = reader.ReadString();
+            node.transform = reader.Read<dx::XMFLOAT4X4>();
+            node.parent = reader.Read<int32>();
+            node.type = reader.Read<SceneNodeType>();
+            node.index = reader.Read<int32>();
+
+            bool isValid = node.parent == -1 || IsValidIndex(node.parent, i);
+            switch (node.type)
+            {
+            case SceneNodeType::Empty:
+                break;
+            case SceneNodeType::Mesh:
+                isValid &= IsValidIndex(node.index, result.meshes.size());
+                break;
+            case SceneNodeType::Light:
+                isValid &= IsValidIndex(node.index, result.lights.size());
+                break;
+            case SceneNodeType::Camera:
+                isValid &= IsValidIndex(node.index, result.cameras.size());
+                break;
+            default:
+                isValid = false;
+                break;
+            }
+
+            if (!isValid)
+            {
+                mFile.Close();
+                return false;
+            }
+        }
+
+        if (!reader.IsValid() || !reader.IsAtEnd())
+        {
+            mFile.Close();
+            return false;
+        }
+
+        description = std::move(result);
+
+        return true;
+    }
+} // namespace Engine::Scene::Loader
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <Types.h>
+
+#include <IO/MappedFile.h>
+#include <Scene/Material.h>
+#include <Scene/PunctualLight.h>
+#include <Scene/Camera.h>
+#include <Scene/Vertex.h>
+#include <Scene/VertexCompression.h>
+#include <Scene/Meshlet.h>
+#include <Scene/MeshLod.h>
+
+#include <d3d12.h>
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include <array>
+#include <span>
+#include <vector>
+
+namespace Engine::Scene::Loader
+{
+    enum class SceneNodeType : uint32
+    {
+        Empty = 0,
+        Mesh = 1,
+        Light = 2,
+        Camera = 3
+    };
+
+    enum MaterialTextureSlot : uint32
+    {
+        BaseColorSlot = 0,
+        NormalSlot,
+        MetallicRoughnessSlot,
+        AmbientOcclusionSlot,
+        EmissiveSlot,
+        MaterialTextureSlotsCount
+    };
+
+    struct SceneDescription
+    {
+        // Image files are referenced by their path relative to the scene. Textures embedded in the source
+        // (glb buffers, data URIs) have no file of their own, their encoded bytes are kept in data.
+        struct TextureEntry
+        {
+            String path;
+            String formatHint;
+            std::span<const Byte> data;
+            bool isSRGB = false;
+        };
+
+        struct MaterialEntry
+        {
+            MaterialProperties properties;
+            std::array<int32, MaterialTextureSlotsCount> textures;
+        };
+
+        struct MeshEntry
+        {
+            String name;
+            int32 material = -1;
+            D3D_PRIMITIVE_TOPOLOGY primitiveTopology = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+            dx::BoundingBox boundingBox;
+            VertexFormat vertexFormat = VertexFormat::Full;
+            VertexCompression::PositionQuantization positionQuantization;
+            uint32 verticesCount = 0;
+            uint32 positionSize = 0;
+            std::span<const Byte> positions;
+            uint32 vertexSize = 0;
+            std::span<const Byte> vertices;
+            uint32 indicesCount = 0;
+            uint32 indexSize = 0;
+            std::span<const Byte> indices;
+            uint32 meshletsCount = 0;
+            std::span<const Byte> meshlets;
+            uint32 lodsCount = 0;
+            std::span<const Byte> lods;
+        };
+
+        struct NodeEntry
+        {
+            String name;
+            dx::XMFLOAT4X4 transform;
+            int32 parent = -1;
+            SceneNodeType type = SceneNodeType::Empty;
+            int32 index = -1;
+        };
+
+        std::vector<TextureEntry> textures;
+        std::vector<MaterialEntry> materials;
+        std::vector<MeshEntry> meshes;
+        std::vector<PunctualLight> lights;
+        std::vector<Camera> cameras;
+        std::vector<NodeEntry> nodes;
+    };
+
+    struct SceneCacheKey
+    {
+        uint64 sourceSize = 0;
+        int64 sourceWriteTime = 0;
+        uint32 hasScale = 0;
+        float32 scale = 0.0f;
+        VertexFormat vertexFormat = VertexFormat::Full;
+        uint32 isPositionSplit = 0;
+    };
+
+    // A file the scene was imported from besides its source, like the external buffers of a glTF or its images.
+    // The cache is stale once any of them changes, a missing file is stamped with a zero size and write time.
+    struct SceneCacheDependency
+    {
+        String path;
+        uint64 size = 0;
+        int64 writeTime = 0;
+    };
+
+    class SceneCache
+    {
+    public:
+        static constexpr uint32 Magic = 0x43535844; // DXSC
+        static constexpr uint32 Version = 8;
+
+        static String GetCachePath(const String& sourcePath);
+        static SceneCacheKey GetCacheKey(const String& sourcePath, Optional<float32> scale, VertexFormat vertexFormat, bool isPositionSplit);
+
+        static SceneCacheDependency GetDependency(const String& path);
+
+        static bool Write(const String& cachePath, const SceneCacheKey& key, std::span<const SceneCacheDependency> dependencies, const SceneDescription& description);
+
+    public:
+        SceneCache();
+        ~SceneCache();
+
+        bool Read(const String& cachePath, const SceneCacheKey& key, SceneDescription& description);
+
+    private:
+        MappedFile mFile;
+    };
+} // namespace Engine::Scene::Loader
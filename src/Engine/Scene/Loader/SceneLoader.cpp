@@ -1,17 +1,22 @@
 #include "SceneLoader.h"
+#include "MeshOptimizer.h"
 
 #include <StringUtils.h>
+#include <ThreadPool.h>
+#include <EngineConfig.h>
 
 #include <assimp/Importer.hpp>
-#include <assimp/Exporter.hpp>
+#include <assimp/DefaultIOSystem.h>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 #include <assimp/pbrmaterial.h>
 
 #include <Scene/Image.h>
+#include <Scene/ImageCache.h>
 #include <Scene/Texture.h>
 #include <Scene/Material.h>
 #include <Scene/Vertex.h>
+#include <Scene/VertexCompression.h>
 #include <Scene/CubeMap.h>
 #include <Scene/SceneObject.h>
 #include <Scene/Mesh.h>
@@ -30,28 +35,150 @@
 #include <Memory/IndexBuffer.h>
 #include <Memory/VertexBuffer.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <filesystem>
+#include <unordered_set>
 
 #include <entt/entt.hpp>
 #include <DirectXCollision.h>
 
 namespace Engine::Scene::Loader
 {
-    UniquePtr<SceneObject> SceneLoader::LoadScene(String path, Optional<float32> scale)
+    namespace
+    {
+        // Remembers the files assimp reads, the external buffers of a glTF change the scene without touching its source file.
+        class RecordingIOSystem : public Assimp::DefaultIOSystem
+        {
+        public:
+            RecordingIOSystem(std::vector<String> &paths) : mPaths(paths) {}
+
+            Assimp::IOStream *Open(const char *file, const char *mode) override
+            {
+                Assimp::IOStream *stream = DefaultIOSystem::Open(file, mode);
+                if (stream && std::find(mPaths.begin(), mPaths.end(), file) == mPaths.end())
+                {
+                    mPaths.push_back(file);
+                }
+                return stream;
+            }
+
+        private:
+            std::vector<String> &mPaths;
+        };
+
+        std::vector<uint32> GetIndices(const aiMesh *aMesh)
+        {
+            std::vector<uint32> indices;
+            indices.reserve(aMesh->mNumFaces * 3);
+            for (uint32 i = 0; i < aMesh->mNumFaces; ++i)
+            {
+                const auto &face = aMesh->mFaces[i];
+                indices.push_back(face.mIndices[0]);
+                indices.push_back(face.mIndices[1]);
+                indices.push_back(face.mIndices[2]);
+            }
+
+            return indices;
+        }
+
+        // Moves the leading position of every vertex into its own stream when the engine is configured so.
+        void SetVertexData(Mesh &mesh, Size verticesCount, Size vertexSize, std::span<const Byte> data)
+        {
+            if (!EngineConfig::SplitPositionStream)
+            {
+                mesh.vertexBuffer->SetData(verticesCount, vertexSize, data);
+                return;
+            }
+
+            const Size positionSize = Vertex::GetPositionSize(mesh.vertexFormat);
+            const Size attributesSize = vertexSize - positionSize;
+
+            std::vector<Byte> positions(verticesCount * positionSize);
+            std::vector<Byte> attributes(verticesCount * attributesSize);
+            for (Size i = 0; i < verticesCount; ++i)
+            {
+                const Byte *vertex = data.data() + i * vertexSize;
+                memcpy(positions.data() + i * positionSize, vertex, positionSize);
+                memcpy(attributes.data() + i * attributesSize, vertex + positionSize, attributesSize);
+            }
+
+            mesh.positionBuffer = MakeShared<Memory::VertexBuffer>();
+            mesh.positionBuffer->SetData(verticesCount, positionSize, positions);
+            mesh.vertexBuffer->SetData(verticesCount, attributesSize, attributes);
+        }
+
+        // One line per optimized mesh, then the scene total with the ratios weighted by mesh size.
+        // Logged after the parallel parse so the lines of different meshes are not interleaved.
+        void LogVertexCacheStatistics(const aiScene *aScene, std::span<const VertexCacheStatistics> source, std::span<const VertexCacheStatistics> optimized)
+        {
+            char message[512];
+
+            Size meshesCount = 0;
+            Size trianglesCount = 0;
+            Size sourceVerticesCount = 0;
+            Size optimizedVerticesCount = 0;
+            float64 sourceMisses = 0.0;
+            float64 optimizedMisses = 0.0;
+            for (Size i = 0; i < optimized.size(); ++i)
+            {
+                if (optimized[i].trianglesCount == 0)
+                {
+                    continue;
+                }
+
+                snprintf(message, sizeof(message), "Mesh '%s': %zu -> %zu vertices, %zu triangles, ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n",
+                    aScene->mMeshes[i]->mName.C_Str(), source[i].verticesCount, optimized[i].verticesCount, optimized[i].trianglesCount,
+                    source[i].acmr, optimized[i].acmr, source[i].atvr, optimized[i].atvr);
+                OutputDebugStringA(message);
+
+                ++meshesCount;
+                trianglesCount += optimized[i].trianglesCount;
+                sourceVerticesCount += source[i].verticesCount;
+                optimizedVerticesCount += optimized[i].verticesCount;
+                sourceMisses += static_cast<float64>(source[i].acmr) * source[i].trianglesCount;
+                optimizedMisses += static_cast<float64>(optimized[i].acmr) * optimized[i].trianglesCount;
+            }
+
+            if (meshesCount == 0)
+            {
+                return;
+            }
+
+            snprintf(message, sizeof(message), "Optimized %zu meshes: %zu -> %zu vertices, %zu triangles, ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n",
+                meshesCount, sourceVerticesCount, optimizedVerticesCount, trianglesCount,
+                sourceMisses / trianglesCount, optimizedMisses / trianglesCount,
+                sourceMisses / sourceVerticesCount, optimizedMisses / optimizedVerticesCount);
+            OutputDebugStringA(message);
+        }
+    }
+
+    UniquePtr<SceneObject> SceneLoader::LoadScene(String path, Optional<float32> scale, VertexFormat vertexFormat)
     {
         std::filesystem::path filePath = path;
-        std::filesystem::path exportPath = filePath;
-        exportPath.replace_extension("assbin");
 
-        Assimp::Importer importer;
+        auto scene = MakeUnique<SceneObject>();
+
+        LoadingContext context = {};
+        context.RootPath = filePath.parent_path().string();
+        context.registry = &scene->GetRegistry();
+        context.vertexFormat = vertexFormat;
+
+        String cachePath = SceneCache::GetCachePath(path);
+        SceneCacheKey cacheKey = SceneCache::GetCacheKey(path, scale, vertexFormat, EngineConfig::SplitPositionStream);
 
-        const aiScene *aScene;
-        // if (std::filesystem::exists(exportPath) && std::filesystem::is_regular_file(exportPath))
+        SceneCache cache;
+        if (cache.Read(cachePath, cacheKey, context.description))
         {
-            //      aScene = importer.ReadFile(exportPath.string(), 0);
+            LoadDescription(context);
         }
-        //  else
+        else
         {
+            Assimp::Importer importer;
+            // The importer owns the IO system and deletes it.
+            importer.SetIOHandler(new RecordingIOSystem(context.dependencies));
+
             unsigned int preprocessFlags = 0
                 //| aiProcess_Triangulate 
                 | aiProcess_ConvertToLeftHanded
@@ -68,68 +195,27 @@ namespace Engine::Scene::Loader
                 importer.SetPropertyFloat(AI_CONFIG_GLOBAL_SCALE_FACTOR_KEY, scale.value());
             }
 
-            aScene = importer.ReadFile(filePath.string(), preprocessFlags);
+            const aiScene *aScene = importer.ReadFile(filePath.string(), preprocessFlags);
 
             if (aScene)
             {
-                // Export the preprocessed scene file for faster loading next time.
-                // Assimp::Exporter exporter;
-                // exporter.Export(aScene, "assbin", exportPath.string(), preprocessFlags);
-            }
-        }
-
-        auto scene = MakeUnique<SceneObject>();
-
-        LoadingContext context = {};
-        context.RootPath = filePath.parent_path().string();
-        context.registry = &scene->GetRegistry();
-
-        context.dataTextures.reserve(aScene->mNumTextures);
-        for (uint32 i = 0; i < aScene->mNumTextures; ++i)
-        {
-            aiTexture *aTexture = aScene->mTextures[i];
-            auto texture = GetTexture(aTexture, context);
-            context.dataTextures.push_back(texture);
-        }
-
-        context.materials.reserve(static_cast<Size>(aScene->mNumMaterials));
-        for (uint32 i = 0; i < aScene->mNumMaterials; ++i)
-        {
-            aiMaterial *aMaterial = aScene->mMaterials[i];
-            auto material = ParseMaterial(aMaterial, context);
-            context.materials.emplace_back(material);
-        }
+                ImportScene(aScene, context);
 
-        context.meshes.reserve(static_cast<Size>(aScene->mNumMeshes));
-        for (uint32 i = 0; i < aScene->mNumMeshes; ++i)
-        {
-            aiMesh *aMesh = aScene->mMeshes[i];
-            auto mesh = ParseMesh(aMesh, context);
-            context.meshes.push_back(mesh);
-        }
+                std::vector<SceneCacheDependency> dependencies;
+                dependencies.reserve(context.dependencies.size());
+                for (const auto& dependency : context.dependencies)
+                {
+                    dependencies.push_back(SceneCache::GetDependency(dependency));
+                }
 
-        context.lightsMap.reserve(static_cast<Size>(aScene->mNumLights));
-        for (uint32 i = 0; i < aScene->mNumLights; ++i)
-        {
-            aiLight *aLight = aScene->mLights[i];
-            context.lightsMap[aLight->mName.C_Str()] = aLight;
+                // Bake the imported scene so the next load can skip assimp entirely.
+                SceneCache::Write(cachePath, cacheKey, dependencies, context.description);
+            }
         }
 
-        context.camerasMap.reserve(static_cast<Size>(aScene->mNumCameras));
-		for (uint32 i = 0; i < aScene->mNumCameras; ++i)
-		{
-			aiCamera* aCamera = aScene->mCameras[i];
-			context.camerasMap[aCamera->mName.C_Str()] = aCamera;
-		}
-
-        auto rootEntity = context.registry->create();
-        Engine::Scene::Components::RelationshipComponent relationship;
-        ParseNode(aScene, aScene->mRootNode, context, rootEntity, &relationship);
-
-        context.registry->emplace<Components::RelationshipComponent>(rootEntity, relationship);
-        context.registry->emplace<Components::Root>(rootEntity);
+        CreateEntities(context);
 
-        if (aScene->mNumCameras == 0)
+        if (!context.isMainCameraAssigned)
         {
             auto cameraEntity = context.registry->create();
             context.registry->emplace<Components::CameraComponent>(cameraEntity, Camera());
@@ -171,10 +257,380 @@ namespace Engine::Scene::Loader
 
         addLight(pointLight2, DirectX::XMMatrixTranslation(0.0f, 2.0f, 0.0f), "Custom light 2");
 
+        ImageCache::Instance().Trim(EngineConfig::UnusedImagesCacheBudget);
+
         return scene;
     }
 
-    void SceneLoader::ParseNode(const aiScene *aScene, const aiNode *aNode, LoadingContext &context, entt::entity entity, Engine::Scene::Components::RelationshipComponent* relationship)
+    void SceneLoader::ImportScene(const aiScene *aScene, LoadingContext &context)
+    {
+        LoadTextures(aScene, context);
+
+        context.materials.reserve(static_cast<Size>(aScene->mNumMaterials));
+        context.description.materials.reserve(static_cast<Size>(aScene->mNumMaterials));
+        for (uint32 i = 0; i < aScene->mNumMaterials; ++i)
+        {
+            aiMaterial *aMaterial = aScene->mMaterials[i];
+            auto material = ParseMaterial(aMaterial, context);
+            context.materials.emplace_back(material);
+
+            SceneDescription::MaterialEntry materialEntry = {};
+            materialEntry.properties = material->GetProperties();
+            materialEntry.textures[BaseColorSlot] = GetTextureIndex(material->GetBaseColorTexture(), context);
+            materialEntry.textures[NormalSlot] = GetTextureIndex(material->GetNormalTexture(), context);
+            materialEntry.textures[MetallicRoughnessSlot] = GetTextureIndex(material->GetMetallicRoughnessTexture(), context);
+            materialEntry.textures[AmbientOcclusionSlot] = GetTextureIndex(material->GetAmbientOcclusionTexture(), context);
+            materialEntry.textures[EmissiveSlot] = GetTextureIndex(material->GetEmissiveTexture(), context);
+            context.description.materials.push_back(materialEntry);
+        }
+
+        for (Size i = 0; i < context.textures.size(); ++i)
+        {
+            context.description.textures[i].isSRGB = context.textures[i]->IsSRGB();
+        }
+
+        context.meshes.resize(static_cast<Size>(aScene->mNumMeshes));
+        std::vector<VertexCacheStatistics> sourceStatistics(context.meshes.size());
+        std::vector<VertexCacheStatistics> optimizedStatistics(context.meshes.size());
+        ThreadPool::Instance().ParallelFor(context.meshes.size(), [&](Size i)
+        {
+            context.meshes[i] = ParseMesh(aScene->mMeshes[i], context, sourceStatistics[i], optimizedStatistics[i]);
+        });
+        LogVertexCacheStatistics(aScene, sourceStatistics, optimizedStatistics);
+
+        context.description.meshes.reserve(static_cast<Size>(aScene->mNumMeshes));
+        for (uint32 i = 0; i < aScene->mNumMeshes; ++i)
+        {
+            const aiMesh *aMesh = aScene->mMeshes[i];
+            const auto& meshData = context.meshes[i];
+
+            const auto& mesh = std::get<1>(meshData);
+            const auto& vertexBuffer = mesh.vertexBuffer;
+            const auto& indexBuffer = mesh.indexBuffer;
+
+            SceneDescription::MeshEntry meshEntry = {};
+            meshEntry.name = std::get<0>(meshData);
+            meshEntry.material = static_cast<int32>(aMesh->mMaterialIndex);
+            meshEntry.primitiveTopology = mesh.primitiveTopology;
+            meshEntry.boundingBox = std::get<2>(meshData);
+            meshEntry.vertexFormat = mesh.vertexFormat;
+            meshEntry.positionQuantization = mesh.positionQuantization;
+            meshEntry.verticesCount = static_cast<uint32>(vertexBuffer->GetElementsCount());
+            if (mesh.positionBuffer)
+            {
+                meshEntry.positionSize = static_cast<uint32>(mesh.positionBuffer->GetElementSize());
+                meshEntry.positions = { static_cast<const Byte*>(mesh.positionBuffer->GetData()), mesh.positionBuffer->GetDataSize() };
+            }
+            meshEntry.vertexSize = static_cast<uint32>(vertexBuffer->GetElementSize());
+            meshEntry.vertices = { static_cast<const Byte*>(vertexBuffer->GetData()), vertexBuffer->GetDataSize() };
+            meshEntry.indicesCount = static_cast<uint32>(indexBuffer->GetElementsCount());
+            meshEntry.indexSize = static_cast<uint32>(indexBuffer->GetElementSize());
+            meshEntry.indices = { static_cast<const Byte*>(indexBuffer->GetData()), indexBuffer->GetDataSize() };
+            if (mesh.meshlets)
+            {
+                meshEntry.meshletsCount = static_cast<uint32>(mesh.meshlets->size());
+                meshEntry.meshlets = std::as_bytes(std::span(*mesh.meshlets));
+            }
+            if (mesh.lods)
+            {
+                meshEntry.lodsCount = static_cast<uint32>(mesh.lods->size());
+                meshEntry.lods = std::as_bytes(std::span(*mesh.lods));
+            }
+            context.description.meshes.push_back(meshEntry);
+        }
+
+        context.lightsMap.reserve(static_cast<Size>(aScene->mNumLights));
+        for (uint32 i = 0; i < aScene->mNumLights; ++i)
+        {
+            aiLight *aLight = aScene->mLights[i];
+            context.lightsMap[aLight->mName.C_Str()] = static_cast<int32>(context.description.lights.size());
+            context.description.lights.push_back(ParseLight(aLight));
+        }
+
+        context.camerasMap.reserve(static_cast<Size>(aScene->mNumCameras));
+		for (uint32 i = 0; i < aScene->mNumCameras; ++i)
+		{
+			aiCamera* aCamera = aScene->mCameras[i];
+			context.camerasMap[aCamera->mName.C_Str()] = static_cast<int32>(context.description.cameras.size());
+            context.description.cameras.push_back(ParseCamera(aCamera));
+		}
+
+        ParseNode(aScene, aScene->mRootNode, context, -1);
+    }
+
+    void SceneLoader::LoadTextures(const aiScene *aScene, LoadingContext &context)
+    {
+        const std::pair<aiTextureType, unsigned int> textureSlots[] = {
+            { AI_MATKEY_GLTF_PBRMETALLICROUGHNESS_BASE_COLOR_TEXTURE },
+            { aiTextureType_NORMALS, 0 },
+            { AI_MATKEY_GLTF_PBRMETALLICROUGHNESS_METALLICROUGHNESS_TEXTURE },
+            { aiTextureType_LIGHTMAP, 0 },
+            { aiTextureType_EMISSIVE, 0 }
+        };
+
+        std::vector<String> paths;
+        std::unordered_set<String> uniquePaths;
+        for (uint32 i = 0; i < aScene->mNumMaterials; ++i)
+        {
+            const aiMaterial *aMaterial = aScene->mMaterials[i];
+            for (const auto& [textureType, index] : textureSlots)
+            {
+                aiString path;
+                if (aMaterial->GetTexture(textureType, index, &path) != aiReturn_SUCCESS || path.C_Str()[0] == '*')
+                {
+                    continue;
+                }
+
+                String filePath = context.RootPath + "\\" + path.C_Str();
+                if (!uniquePaths.insert(filePath).second)
+                {
+                    continue;
+                }
+
+                // A missing image is a dependency too, the scene changes once it is added.
+                context.dependencies.push_back(filePath);
+                if (std::filesystem::exists(filePath))
+                {
+                    paths.push_back(path.C_Str());
+                }
+            }
+        }
+
+        Size filesCount = paths.size();
+        std::vector<SharedPtr<Scene::Image>> images(filesCount + aScene->mNumTextures);
+
+        ThreadPool::Instance().ParallelFor(images.size(), [&](Size i)
+        {
+            if (i < filesCount)
+            {
+                images[i] = ImageCache::Instance().LoadImageFromFile(context.RootPath + "\\" + paths[i]);
+            }
+            else
+            {
+                const aiTexture *aTexture = aScene->mTextures[i - filesCount];
+
+                std::span<const Byte> data = { reinterpret_cast<const Byte*>(aTexture->pcData), aTexture->mWidth };
+                String name = context.RootPath + "\\" + aTexture->mFilename.C_Str();
+                images[i] = ImageCache::Instance().LoadImageFromData(data, aTexture->achFormatHint, name);
+            }
+        });
+
+        // Textures are registered in a fixed order, independent of how the decoding was scheduled.
+        for (Size i = 0; i < filesCount; ++i)
+        {
+            SharedPtr<Texture> texture = MakeShared<Texture>(StringToWString(images[i]->GetName()));
+            texture->SetImage(images[i]);
+            context.fileTextures[context.RootPath + "\\" + paths[i]] = texture;
+
+            SceneDescription::TextureEntry textureEntry = {};
+            textureEntry.path = paths[i];
+            RegisterTexture(texture, textureEntry, context);
+        }
+
+        context.dataTextures.reserve(aScene->mNumTextures);
+        for (uint32 i = 0; i < aScene->mNumTextures; ++i)
+        {
+            const aiTexture *aTexture = aScene->mTextures[i];
+            const auto& image = images[filesCount + i];
+
+            SharedPtr<Texture> texture = MakeShared<Texture>(StringToWString(image->GetName()));
+            texture->SetImage(image);
+            context.dataTextures.push_back(texture);
+
+            SceneDescription::TextureEntry textureEntry = {};
+            textureEntry.path = aTexture->mFilename.C_Str();
+            textureEntry.formatHint = aTexture->achFormatHint;
+            textureEntry.data = { reinterpret_cast<const Byte*>(aTexture->pcData), aTexture->mWidth };
+            RegisterTexture(texture, textureEntry, context);
+        }
+    }
+
+    void SceneLoader::LoadDescription(LoadingContext &context)
+    {
+        const auto& description = context.description;
+
+        context.textures.resize(description.textures.size());
+        ThreadPool::Instance().ParallelFor(context.textures.size(), [&context](Size i)
+        {
+            const auto& textureEntry = context.description.textures[i];
+            String path = context.RootPath + "\\" + textureEntry.path;
+
+            SharedPtr<Scene::Image> image;
+            if (!textureEntry.data.empty())
+            {
+                image = ImageCache::Instance().LoadImageFromData(textureEntry.data, textureEntry.formatHint, path);
+            }
+            else if (std::filesystem::exists(path))
+            {
+                image = ImageCache::Instance().LoadImageFromFile(path);
+            }
+
+            if (image)
+            {
+                auto texture = MakeShared<Texture>(StringToWString(image->GetName()));
+                texture->SetImage(image);
+                texture->SetSRGB(textureEntry.isSRGB);
+                context.textures[i] = texture;
+            }
+        });
+
+        auto getTexture = [&context](int32 index) -> SharedPtr<Texture>
+        {
+            return index == -1 ? nullptr : context.textures[index];
+        };
+
+        context.materials.reserve(description.materials.size());
+        for (const auto& materialEntry : description.materials)
+        {
+            SharedPtr<Material> material = MakeShared<Material>();
+            material->SetProperties(materialEntry.properties);
+            material->SetBaseColorTexture(getTexture(materialEntry.textures[BaseColorSlot]));
+            material->SetNormalTexture(getTexture(materialEntry.textures[NormalSlot]));
+            material->SetMetallicRoughnessTexture(getTexture(materialEntry.textures[MetallicRoughnessSlot]));
+            material->SetAmbientOcclusionTexture(getTexture(materialEntry.textures[AmbientOcclusionSlot]));
+            material->SetEmissiveTexture(getTexture(materialEntry.textures[EmissiveSlot]));
+            context.materials.push_back(material);
+        }
+
+        context.meshes.resize(description.meshes.size());
+        ThreadPool::Instance().ParallelFor(context.meshes.size(), [&context](Size i)
+        {
+            const auto& meshEntry = context.description.meshes[i];
+
+            Mesh mesh;
+            mesh.vertexBuffer = MakeShared<Memory::VertexBuffer>(StringToWString("Vertices: " + meshEntry.name));
+            mesh.vertexBuffer->SetData(meshEntry.verticesCount, meshEntry.vertexSize, meshEntry.vertices);
+
+            if (!meshEntry.positions.empty())
+            {
+                mesh.positionBuffer = MakeShared<Memory::VertexBuffer>(StringToWString("Positions: " + meshEntry.name));
+                mesh.positionBuffer->SetData(meshEntry.verticesCount, meshEntry.positionSize, meshEntry.positions);
+            }
+
+            mesh.indexBuffer = MakeShared<Memory::IndexBuffer>(StringToWString("Indices: " + meshEntry.name));
+            mesh.indexBuffer->SetData(meshEntry.indicesCount, meshEntry.indexSize, meshEntry.indices);
+
+            if (meshEntry.meshletsCount > 0)
+            {
+                auto meshlets = MakeShared<std::vector<Meshlet>>(meshEntry.meshletsCount);
+                memcpy(meshlets->data(), meshEntry.meshlets.data(), meshEntry.meshlets.size());
+                mesh.meshlets = meshlets;
+            }
+
+            if (meshEntry.lodsCount > 0)
+            {
+                auto lods = MakeShared<std::vector<MeshLod>>(meshEntry.lodsCount);
+                memcpy(lods->data(), meshEntry.lods.data(), meshEntry.lods.size());
+                mesh.lods = lods;
+            }
+
+            mesh.material = context.materials[meshEntry.material];
+            mesh.primitiveTopology = meshEntry.primitiveTopology;
+            mesh.vertexFormat = meshEntry.vertexFormat;
+            mesh.positionQuantization = meshEntry.positionQuantization;
+
+            context.meshes[i] = std::make_tuple(meshEntry.name, mesh, meshEntry.boundingBox);
+        });
+    }
+
+    void SceneLoader::CreateEntities(LoadingContext &context)
+    {
+        const auto& nodes = context.description.nodes;
+
+        std::vector<entt::entity> entities(nodes.size());
+        context.registry->create(entities.begin(), entities.end());
+
+        std::vector<Components::RelationshipComponent> relationships(nodes.size());
+        std::vector<int32> lastChildren(nodes.size(), -1);
+
+        for (Size i = 0; i < nodes.size(); ++i)
+        {
+            const auto& node = nodes[i];
+            if (node.parent == -1)
+            {
+                continue;
+            }
+
+            auto& parentRelationship = relationships[node.parent];
+            auto& relationship = relationships[i];
+            relationship.parent = entities[node.parent];
+            relationship.depth = parentRelationship.depth + 1;
+
+            if (lastChildren[node.parent] == -1)
+            {
+                parentRelationship.first = entities[i];
+            }
+            else
+            {
+                relationships[lastChildren[node.parent]].next = entities[i];
+            }
+
+            lastChildren[node.parent] = static_cast<int32>(i);
+            parentRelationship.childsCount++;
+        }
+
+        for (Size i = 0; i < nodes.size(); ++i)
+        {
+            const auto& node = nodes[i];
+            auto entity = entities[i];
+
+            context.registry->emplace<Components::NameComponent>(entity, node.name);
+            context.registry->emplace<Components::LocalTransformComponent>(entity, dx::XMLoadFloat4x4(&node.transform));
+
+            switch (node.type)
+            {
+            case SceneNodeType::Mesh:
+            {
+                const auto& meshData = context.meshes[node.index];
+
+                Components::MeshComponent meshComponent;
+                meshComponent.mesh = std::get<1>(meshData);
+                context.registry->emplace<Components::MeshComponent>(entity, meshComponent);
+
+                Components::AABBComponent aabbComponent = {};
+                aabbComponent.originalBoundingBox = std::get<2>(meshData);
+                aabbComponent.boundingBox = std::get<2>(meshData);
+                context.registry->emplace<Components::AABBComponent>(entity, aabbComponent);
+                break;
+            }
+            case SceneNodeType::Light:
+            {
+                Components::LightComponent lightComponent;
+                lightComponent.light = context.description.lights[node.index];
+
+                context.registry->emplace<Components::LightComponent>(entity, lightComponent);
+                context.registry->emplace<Components::CameraComponent>(entity, Camera());
+                break;
+            }
+            case SceneNodeType::Camera:
+            {
+                Components::CameraComponent cameraComponent;
+                cameraComponent.camera = context.description.cameras[node.index];
+
+                context.registry->emplace<Components::CameraComponent>(entity, cameraComponent);
+
+                if (!context.isMainCameraAssigned)
+                {
+                    context.isMainCameraAssigned = true;
+                    context.registry->emplace<Components::MainCameraComponent>(entity);
+                }
+                break;
+            }
+            case SceneNodeType::Empty:
+            default:
+                break;
+            }
+
+            context.registry->emplace<Components::RelationshipComponent>(entity, relationships[i]);
+
+            if (node.parent == -1)
+            {
+                context.registry->emplace<Components::Root>(entity);
+            }
+        }
+    }
+
+    void SceneLoader::ParseNode(const aiScene *aScene, const aiNode *aNode, LoadingContext &context, int32 parent)
     {
         aiVector3D scaling;
 		aiQuaternion rotation;
@@ -187,65 +643,58 @@ namespace Engine::Scene::Loader
 
         DirectX::XMMATRIX srt = s * r * t;
 
+        auto& nodes = context.description.nodes;
+        int32 nodeIndex = static_cast<int32>(nodes.size());
+
+        SceneDescription::NodeEntry node = {};
+        node.parent = parent;
+        DirectX::XMStoreFloat4x4(&node.transform, srt);
+
 		if (IsMeshNode(aNode, context))
 		{
-            context.registry->emplace<Components::NameComponent>(entity, "Mesh_" + std::string(aNode->mName.C_Str()));
-            context.registry->emplace<Scene::Components::LocalTransformComponent>(entity, srt);
+            node.name = "Mesh_" + std::string(aNode->mName.C_Str());
+            nodes.push_back(node);
 
-            CreateMeshNode(aNode, context, entity, relationship);
-            
+            for (uint32 i = 0; i < aNode->mNumMeshes; ++i)
+            {
+                int32 meshIndex = aNode->mMeshes[i];
+
+                SceneDescription::NodeEntry meshNode = {};
+                meshNode.name = std::get<0>(context.meshes[meshIndex]);
+                meshNode.parent = nodeIndex;
+                meshNode.type = SceneNodeType::Mesh;
+                meshNode.index = meshIndex;
+                DirectX::XMStoreFloat4x4(&meshNode.transform, DirectX::XMMatrixIdentity());
+                nodes.push_back(meshNode);
+            }
 		}
         else if (IsLightNode(aNode, context))
         {
-            CreateLightNode(aNode, context, entity);
-
-            context.registry->emplace<Components::NameComponent>(entity, "Light_" + std::string(aNode->mName.C_Str()));
-            context.registry->emplace<Scene::Components::LocalTransformComponent>(entity, srt);
+            node.name = "Light_" + std::string(aNode->mName.C_Str());
+            node.type = SceneNodeType::Light;
+            node.index = context.lightsMap.find(aNode->mName.C_Str())->second;
+            nodes.push_back(node);
         }
         else if (IsCameraNode(aNode, context))
         {
-            CreateCameraNode(aNode, context, entity);
-
-            context.registry->emplace<Components::NameComponent>(entity, "Camera_" + std::string(aNode->mName.C_Str()));
-            context.registry->emplace<Scene::Components::LocalTransformComponent>(entity, srt);
+            node.name = "Camera_" + std::string(aNode->mName.C_Str());
+            node.type = SceneNodeType::Camera;
+            node.index = context.camerasMap.find(aNode->mName.C_Str())->second;
+            nodes.push_back(node);
         }
         else
         {
-            context.registry->emplace<Components::NameComponent>(entity, aNode->mName.C_Str());
-            context.registry->emplace<Scene::Components::LocalTransformComponent>(entity, srt);
-
-            entt::entity nextEntity = aNode->mNumChildren > 0 ? context.registry->create() : entt::null;
-            relationship->first = nextEntity;
-            relationship->childsCount = aNode->mNumChildren;
-
-            for (uint32 i = 0; i < aNode->mNumChildren; i++)
-            {
-                auto aChild = aNode->mChildren[i];
-
-                auto childEntity = nextEntity;
-
-                if (i < (aNode->mNumChildren - 1))
-                {
-                    nextEntity = context.registry->create();
-                }
-                else
-                {
-                    nextEntity = entt::null;
-                }
-
-                Components::RelationshipComponent childRelationship;
-                childRelationship.parent = entity;
-                childRelationship.next = nextEntity;
-                childRelationship.depth = relationship->depth + 1;
-
-                ParseNode(aScene, aChild, context, childEntity, &childRelationship);
+            node.name = aNode->mName.C_Str();
+            nodes.push_back(node);
+        }
 
-                context.registry->emplace<Components::RelationshipComponent>(childEntity, childRelationship);
-            }
+        for (uint32 i = 0; i < aNode->mNumChildren; i++)
+        {
+            ParseNode(aScene, aNode->mChildren[i], context, nodeIndex);
         }
     }
 
-    std::tuple<String, Mesh, dx::BoundingBox> SceneLoader::ParseMesh(const aiMesh *aMesh, const LoadingContext &context)
+    std::tuple<String, Mesh, dx::BoundingBox> SceneLoader::ParseMesh(const aiMesh *aMesh, const LoadingContext &context, VertexCacheStatistics &sourceStatistics, VertexCacheStatistics &optimizedStatistics)
     {
         Mesh mesh;
         mesh.indexBuffer = MakeShared<Memory::IndexBuffer>();
@@ -283,24 +732,6 @@ namespace Engine::Scene::Loader
             vertices.emplace_back(vertex);
         }
 
-        mesh.vertexBuffer->SetData(vertices);
-        mesh.vertexBuffer->SetName(StringToWString("Vertices: " + (std::string)(aMesh->mName.C_Str())));
-
-        std::vector<uint16> indices;
-        indices.reserve(aMesh->mNumFaces * 3);
-        for (uint32 i = 0; i < aMesh->mNumFaces; ++i)
-        {
-            const auto &face = aMesh->mFaces[i];
-            indices.push_back(face.mIndices[0]);
-            indices.push_back(face.mIndices[1]);
-            indices.push_back(face.mIndices[2]);
-        }
-
-        mesh.indexBuffer->SetData(indices);
-        mesh.indexBuffer->SetName(StringToWString("Indices: " + (std::string)(aMesh->mName.C_Str())));
-
-        mesh.material = context.materials[aMesh->mMaterialIndex];
-
         switch (aMesh->mPrimitiveTypes)
         {
             case aiPrimitiveType_POINT:
@@ -315,6 +746,48 @@ namespace Engine::Scene::Loader
                 break;
         }
 
+        std::vector<uint32> indices = GetIndices(aMesh);
+        if (aMesh->mPrimitiveTypes == aiPrimitiveType_TRIANGLE)
+        {
+            sourceStatistics = MeshOptimizer::AnalyzeVertexCache(indices, vertices.size());
+            MeshOptimizer::Optimize(vertices, indices);
+            optimizedStatistics = MeshOptimizer::AnalyzeVertexCache(indices, vertices.size());
+
+            std::vector<Meshlet> meshlets;
+            auto lods = MeshOptimizer::BuildLods(vertices, indices, meshlets);
+            mesh.meshlets = MakeShared<std::vector<Meshlet>>(std::move(meshlets));
+            mesh.lods = MakeShared<std::vector<MeshLod>>(std::move(lods));
+        }
+
+        if (context.vertexFormat == VertexFormat::Compact)
+        {
+            mesh.vertexFormat = VertexFormat::Compact;
+            mesh.positionQuantization = VertexCompression::GetPositionQuantization(vertices);
+            auto compactVertices = VertexCompression::Encode(vertices, mesh.positionQuantization);
+            SetVertexData(mesh, compactVertices.size(), sizeof(CompactVertex), std::as_bytes(std::span(compactVertices)));
+        }
+        else
+        {
+            SetVertexData(mesh, vertices.size(), sizeof(Vertex), std::as_bytes(std::span(vertices)));
+        }
+        if (mesh.positionBuffer)
+        {
+            mesh.positionBuffer->SetName(StringToWString("Positions: " + (std::string)(aMesh->mName.C_Str())));
+        }
+        mesh.vertexBuffer->SetName(StringToWString("Vertices: " + (std::string)(aMesh->mName.C_Str())));
+
+        if (vertices.size() <= 0x10000)
+        {
+            mesh.indexBuffer->SetData(std::vector<uint16>(indices.begin(), indices.end()));
+        }
+        else
+        {
+            mesh.indexBuffer->SetData(indices);
+        }
+        mesh.indexBuffer->SetName(StringToWString("Indices: " + (std::string)(aMesh->mName.C_Str())));
+
+        mesh.material = context.materials[aMesh->mMaterialIndex];
+
         const auto& aabbMin = aMesh->mAABB.mMin;
         const auto& aabbMax = aMesh->mAABB.mMax;
 
@@ -476,44 +949,15 @@ namespace Engine::Scene::Loader
         }
     }
 
-    SharedPtr<Texture> SceneLoader::GetTexture(const aiTexture *aTexture, const LoadingContext &context)
-    {
-        std::vector<Byte> buffer;
-        buffer.resize(aTexture->mWidth);
-        memcpy(buffer.data(), aTexture->pcData, aTexture->mWidth);
-        String name = context.RootPath + "\\" + aTexture->mFilename.C_Str();
-        SharedPtr<Scene::Image> image = Scene::Image::LoadImageFromData(buffer, aTexture->achFormatHint, name);
-
-        SharedPtr<Texture> texture = MakeShared<Texture>(StringToWString(image->GetName()));
-        texture->SetImage(image);
-        
-        return texture;
-    }
-
-    SharedPtr<Texture> SceneLoader::GetTexture(const aiString &path, LoadingContext &context)
+    SharedPtr<Texture> SceneLoader::GetTexture(const aiString &path, const LoadingContext &context)
     {
         if (path.C_Str()[0] != '*')
         {
-            std::filesystem::path filePath = context.RootPath + "\\" + path.C_Str();
-
-            String filePathStr = filePath.string();
-            auto iter = context.fileTextures.find(filePathStr);
+            auto iter = context.fileTextures.find(context.RootPath + "\\" + path.C_Str());
             if (iter != context.fileTextures.end())
             {
                 return iter->second;
             }
-            else
-            {
-                if (std::filesystem::exists(filePath))
-                {
-                    auto image = Scene::Image::LoadImageFromFile(filePathStr);
-                    SharedPtr<Texture> texture = MakeShared<Texture>(StringToWString(image->GetName()));
-                    texture->SetImage(image);        
-                    context.fileTextures[filePathStr] = texture;
-
-                    return texture;
-                }
-            }
         }
         else
         {
@@ -524,6 +968,19 @@ namespace Engine::Scene::Loader
         return nullptr;
     }
 
+    void SceneLoader::RegisterTexture(const SharedPtr<Texture>& texture, SceneDescription::TextureEntry entry, LoadingContext& context)
+    {
+        context.textureIndices[texture.get()] = static_cast<int32>(context.textures.size());
+        context.textures.push_back(texture);
+        context.description.textures.push_back(std::move(entry));
+    }
+
+    int32 SceneLoader::GetTextureIndex(const SharedPtr<Texture>& texture, const LoadingContext& context)
+    {
+        auto iter = context.textureIndices.find(texture.get());
+        return iter != context.textureIndices.end() ? iter->second : -1;
+    }
+
 	bool SceneLoader::IsLightNode(const aiNode* aNode, const LoadingContext& context)
 	{
 		auto iter = context.lightsMap.find(aNode->mName.C_Str());
@@ -541,11 +998,8 @@ namespace Engine::Scene::Loader
         return iter != context.camerasMap.end();
 	}
 
-    void SceneLoader::CreateLightNode(const aiNode* aNode, const LoadingContext &context, entt::entity entity)
+    PunctualLight SceneLoader::ParseLight(const aiLight* aLight)
     {
-		auto iter = context.lightsMap.find(aNode->mName.C_Str());
-        aiLight* aLight = iter->second;
-
         PunctualLight light;
 
         light.SetEnabled(true);
@@ -578,79 +1032,18 @@ namespace Engine::Scene::Loader
         light.SetInnerConeAngle(aLight->mAngleInnerCone);
         light.SetOuterConeAngle(aLight->mAngleOuterCone);
 
-        Components::LightComponent lightComponent;
-        lightComponent.light = light;
-
-        context.registry->emplace<Components::LightComponent>(entity, lightComponent);
-        context.registry->emplace<Components::CameraComponent>(entity, Camera());
-
+        return light;
     }
 
-    void SceneLoader::CreateMeshNode(const aiNode* aNode, const LoadingContext& context, entt::entity entity, Engine::Scene::Components::RelationshipComponent* relationship)
+    Camera SceneLoader::ParseCamera(const aiCamera* aCamera)
     {
-        entt::entity nextEntity = context.registry->create();;
-        relationship->first = nextEntity;
-        relationship->childsCount = aNode->mNumMeshes;
-
-		for (uint32 i = 0; i < aNode->mNumMeshes; ++i)
-		{
-			int32 meshIndex = aNode->mMeshes[i];
-			auto meshData = context.meshes[meshIndex];
-
-            auto meshEntity = nextEntity;
-            if (i < (aNode->mNumMeshes - 1))
-            {
-                nextEntity = context.registry->create();
-            }
-            else
-            {
-                nextEntity = entt::null;
-            }
-
-            context.registry->emplace<Components::LocalTransformComponent>(meshEntity, DirectX::XMMatrixIdentity());
-
-            context.registry->emplace<Components::NameComponent>(meshEntity, std::get<0>(meshData));
-
-            Components::RelationshipComponent meshRelationship;
-            meshRelationship.next = nextEntity;
-            meshRelationship.parent = entity;
-            meshRelationship.depth = relationship->depth + 1;
-            context.registry->emplace<Components::RelationshipComponent>(meshEntity, meshRelationship);
-
-            Components::MeshComponent meshComponent;
-            meshComponent.mesh = std::get<1>(meshData);
-
-            context.registry->emplace<Components::MeshComponent>(meshEntity, meshComponent);
-
-            Components::AABBComponent aabbComponent = {};
-            aabbComponent.originalBoundingBox = std::get<2>(meshData);
-            aabbComponent.boundingBox = std::get<2>(meshData);
-            context.registry->emplace<Components::AABBComponent>(meshEntity, aabbComponent);
-		}
-    }
-
-    void SceneLoader::CreateCameraNode(const aiNode* aNode, LoadingContext& context, entt::entity entity)
-    {
-        auto iter = context.camerasMap.find(aNode->mName.C_Str());
-
-        aiCamera* aCamera = iter->second;
-
         Camera camera;
 
         camera.SetNearPlane(aCamera->mClipPlaneNear);
         camera.SetFarPlane(aCamera->mClipPlaneFar);
         camera.SetFoV(aCamera->mHorizontalFOV);
 
-        Components::CameraComponent cameraComponent;
-        cameraComponent.camera = camera;
-
-        context.registry->emplace<Components::CameraComponent>(entity, cameraComponent);
-
-        if (!context.isMainCameraAssigned)
-        {
-            context.isMainCameraAssigned = true;
-            context.registry->emplace<Components::MainCameraComponent>(entity);
-        }
+        return camera;
     }
 
     void SceneLoader::AddCubeMapToScene(SceneObject* scene, String texturePath)
@@ -661,7 +1054,7 @@ namespace Engine::Scene::Loader
         }
 
         CubeMap cubeMap;
-        auto image = Scene::Image::LoadImageFromFile(texturePath);
+        auto image = ImageCache::Instance().LoadImageFromFile(texturePath);
         SharedPtr<Texture> texture = MakeShared<Texture>(StringToWString(image->GetName()));
         texture->SetImage(image);
         texture->SetSRGB(true);
@@ -4,6 +4,7 @@
 
 #include <Scene/SceneForwards.h>
 #include <Scene/Components/ComponentsForwards.h>
+#include <Scene/Loader/SceneCache.h>
 
 #include <d3d12.h>
 #include <DirectXMath.h>
@@ -26,6 +27,8 @@ enum aiTextureType;
 
 namespace Engine::Scene::Loader
 {
+    struct VertexCacheStatistics;
+
     class SceneLoader
     {
     private:
@@ -34,10 +37,15 @@ namespace Engine::Scene::Loader
             String RootPath;
             std::vector<std::tuple<String, Mesh, dx::BoundingBox>> meshes;
             std::vector<SharedPtr<Material>> materials;
+            std::vector<SharedPtr<Texture>> textures;
             std::vector<SharedPtr<Texture>> dataTextures;
             std::unordered_map<String, SharedPtr<Scene::Texture>> fileTextures;
-            std::unordered_map<String, aiLight*> lightsMap;
-            std::unordered_map<String, aiCamera*> camerasMap;
+            std::unordered_map<const Texture*, int32> textureIndices;
+            std::unordered_map<String, int32> lightsMap;
+            std::unordered_map<String, int32> camerasMap;
+            std::vector<String> dependencies;
+            SceneDescription description;
+            VertexFormat vertexFormat;
             bool isMainCameraAssigned;
 
             entt::registry* registry;
@@ -64,22 +72,26 @@ namespace Engine::Scene::Loader
     };
 
     public:
-        UniquePtr<SceneObject> LoadScene(String path, Optional<float32> scale = {});
+        UniquePtr<SceneObject> LoadScene(String path, Optional<float32> scale = {}, VertexFormat vertexFormat = VertexFormat::Full);
 
         void AddCubeMapToScene(SceneObject* scene, String texturePath);
 
     private:
-        void ParseNode(const aiScene* aScene, const aiNode* aNode, LoadingContext& context, entt::entity entity, Engine::Scene::Components::RelationshipComponent* relationship);
-        SharedPtr<Texture> GetTexture(const aiString& path, LoadingContext& context);
-        SharedPtr<Texture> GetTexture(const aiTexture* aTexture, const LoadingContext& context);
+        void ImportScene(const aiScene* aScene, LoadingContext& context);
+        void LoadTextures(const aiScene* aScene, LoadingContext& context);
+        void LoadDescription(LoadingContext& context);
+        void CreateEntities(LoadingContext& context);
+        void ParseNode(const aiScene* aScene, const aiNode* aNode, LoadingContext& context, int32 parent);
+        SharedPtr<Texture> GetTexture(const aiString& path, const LoadingContext& context);
+        void RegisterTexture(const SharedPtr<Texture>& texture, SceneDescription::TextureEntry entry, LoadingContext& context);
+        int32 GetTextureIndex(const SharedPtr<Texture>& texture, const LoadingContext& context);
         SharedPtr<Material> ParseMaterial(const aiMaterial* aMaterial, LoadingContext& context);
         void ParseSampler(const aiMaterial* aMaterial, aiTextureType textureType, unsigned int idx);
-        std::tuple<String, Mesh, dx::BoundingBox> ParseMesh(const aiMesh* aMesh, const LoadingContext& context);
+        std::tuple<String, Mesh, dx::BoundingBox> ParseMesh(const aiMesh* aMesh, const LoadingContext& context, VertexCacheStatistics& sourceStatistics, VertexCacheStatistics& optimizedStatistics);
+        PunctualLight ParseLight(const aiLight* aLight);
+        Camera ParseCamera(const aiCamera* aCamera);
         bool IsLightNode(const aiNode* aNode, const LoadingContext& context);
         bool IsMeshNode(const aiNode* aNode, const LoadingContext& context);
         bool IsCameraNode(const aiNode* aNode, const LoadingContext& context);
-        void CreateLightNode(const aiNode* aNode, const LoadingContext& context, entt::entity entity);
-        void CreateMeshNode(const aiNode* aNode, const LoadingContext& context, entt::entity entity, Engine::Scene::Components::RelationshipComponent* relationship);
-        void CreateCameraNode(const aiNode* aNode, LoadingContext& context, entt::entity entity);
     }; 
 } // namespace Engine::Scene
\ No newline at end of file
@@ -3,8 +3,13 @@
 #include <Types.h>
 #include <Memory/MemoryForwards.h>
 #include <Scene/SceneForwards.h>
+#include <Scene/Vertex.h>
+#include <Scene/VertexCompression.h>
+#include <Scene/Meshlet.h>
+#include <Scene/MeshLod.h>
 
 #include <d3d12.h>
+#include <vector>
 
 namespace Engine::Scene
 {
@@ -13,7 +18,15 @@ namespace Engine::Scene
     public:
         SharedPtr<Memory::IndexBuffer> indexBuffer;
         SharedPtr<Memory::VertexBuffer> vertexBuffer;
+        // Optional position stream, vertexBuffer holds the remaining attributes when it is set.
+        SharedPtr<Memory::VertexBuffer> positionBuffer;
+        // Optional partition of the index buffer, triangle lists only.
+        SharedPtr<const std::vector<Meshlet>> meshlets;
+        // Optional simplification chain, the first LOD is the full detail mesh.
+        SharedPtr<const std::vector<MeshLod>> lods;
         SharedPtr<Material> material;
         D3D_PRIMITIVE_TOPOLOGY primitiveTopology;
+        VertexFormat vertexFormat = VertexFormat::Full;
+        VertexCompression::PositionQuantization positionQuantization;
     };
 }
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <Types.h>
+
+namespace Engine::Scene
+{
+    // A simplified version of a mesh: a range of its index buffer and the meshlets covering that range.
+    struct MeshLod
+    {
+        uint32 indexOffset = 0;
+        uint32 indexCount = 0;
+        uint32 meshletOffset = 0;
+        uint32 meshletsCount = 0;
+
+        // Upper bound of the mesh space deviation from the full detail surface.
+        float32 error = 0.0f;
+    };
+} // namespace Engine::Scene
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <Types.h>
+
+#include <DirectXMath.h>
+
+namespace Engine::Scene
+{
+    // A contiguous range of a mesh index buffer with bounds for culling, all in mesh space.
+    struct Meshlet
+    {
+        uint32 indexOffset = 0;
+        uint32 indexCount = 0;
+        uint32 verticesCount = 0;
+
+        DirectX::XMFLOAT3 center = {0.0f, 0.0f, 0.0f};
+        float32 radius = 0.0f;
+
+        // Every triangle normal is within the cone: dot(normal, coneAxis) >= sqrt(1 - coneCutoff^2).
+        // A cutoff of 1 disables backface culling for the meshlet.
+        DirectX::XMFLOAT3 coneAxis = {0.0f, 0.0f, 0.0f};
+        float32 coneCutoff = 1.0f;
+    };
+} // namespace Engine::Scene
@@ -0,0 +1,174 @@
+#include "MeshletCulling.h"
+
+#include <EngineConfig.h>
+
+#include <Scene/Mesh.h>
+#include <Scene/Meshlet.h>
+#include <Scene/MeshLod.h>
+#include <Scene/Material.h>
+#include <Scene/Components/CameraComponent.h>
+#include <Memory/IndexBuffer.h>
+
+#include <span>
+
+namespace Engine::Scene::MeshletCulling
+{
+    namespace
+    {
+        void GetScaleRange(const dx::XMMATRIX &world, float32 &minScale, float32 &maxScale)
+        {
+            const float32 scaleX = dx::XMVectorGetX(dx::XMVector3Length(world.r[0]));
+            const float32 scaleY = dx::XMVectorGetX(dx::XMVector3Length(world.r[1]));
+            const float32 scaleZ = dx::XMVectorGetX(dx::XMVector3Length(world.r[2]));
+
+            maxScale = scaleX > scaleY ? (scaleX > scaleZ ? scaleX : scaleZ) : (scaleY > scaleZ ? scaleY : scaleZ);
+            minScale = scaleX < scaleY ? (scaleX < scaleZ ? scaleX : scaleZ) : (scaleY < scaleZ ? scaleY : scaleZ);
+        }
+
+        void AddRange(std::vector<DrawRange> &ranges, Size firstRange, uint32 indexOffset, uint32 indexCount)
+        {
+            if (ranges.size() > firstRange)
+            {
+                auto &last = ranges.back();
+                if (last.indexOffset + last.indexCount == indexOffset)
+                {
+                    last.indexCount += indexCount;
+                    return;
+                }
+            }
+
+            ranges.push_back({indexOffset, indexCount});
+        }
+    }
+
+    View GetView(const Components::CameraComponent &camera)
+    {
+        View view;
+        view.frustum = camera.frustum;
+        view.eyePosition = camera.eyePosition;
+        view.isPerspective = camera.camera.GetType() == CameraType::Perspective;
+
+        // The projection scales view space y to [-1, 1], the viewport maps that to its height.
+        const float32 projectionScale = dx::XMVectorGetY(camera.projection.r[1]);
+        view.pixelsPerUnit = projectionScale * camera.viewportHeight * 0.5f;
+
+        return view;
+    }
+
+    View GetView(const ShadowCascades::Cascade &cascade, uint32 resolution)
+    {
+        View view;
+        view.box = cascade.bounds;
+        view.isBox = true;
+        view.eyePosition = dx::XMVectorZero();
+        view.isPerspective = false;
+        view.pixelsPerUnit = dx::XMVectorGetY(cascade.projection.r[1]) * static_cast<float32>(resolution) * 0.5f;
+
+        return view;
+    }
+
+    uint32 SelectLod(const Mesh &mesh, const dx::XMMATRIX &world, const dx::BoundingBox &bounds, const View &view)
+    {
+        if (!mesh.lods || mesh.lods->size() < 2 || view.pixelsPerUnit <= 0.0f)
+        {
+            return 0;
+        }
+
+        float32 distance = 1.0f;
+        if (view.isPerspective)
+        {
+            auto offset = dx::XMVectorSubtract(
+                dx::XMVectorAbs(dx::XMVectorSubtract(view.eyePosition, dx::XMLoadFloat3(&bounds.Center))),
+                dx::XMLoadFloat3(&bounds.Extents));
+            distance = dx::XMVectorGetX(dx::XMVector3Length(dx::XMVectorMax(offset, dx::XMVectorZero())));
+
+            if (distance <= 0.0f)
+            {
+                return 0;
+            }
+        }
+
+        float32 minScale;
+        float32 maxScale;
+        GetScaleRange(world, minScale, maxScale);
+
+        const float32 pixelsPerError = maxScale * view.pixelsPerUnit / distance;
+
+        const auto &lods = *mesh.lods;
+        uint32 lod = 0;
+        while (lod + 1 < lods.size() && lods[lod + 1].error * pixelsPerError <= EngineConfig::LodErrorThreshold)
+        {
+            ++lod;
+        }
+
+        return lod;
+    }
+
+    uint32 Cull(const Mesh &mesh, const dx::XMMATRIX &world, uint32 lod, const View &view, std::vector<DrawRange> &ranges)
+    {
+        std::span<const Meshlet> meshlets;
+        if (mesh.meshlets)
+        {
+            meshlets = *mesh.meshlets;
+        }
+
+        if (mesh.lods && lod < mesh.lods->size())
+        {
+            const auto &meshLod = (*mesh.lods)[lod];
+            if (meshLod.meshletsCount == 0)
+            {
+                ranges.push_back({meshLod.indexOffset, meshLod.indexCount});
+                return 1;
+            }
+
+            meshlets = meshlets.subspan(meshLod.meshletOffset, meshLod.meshletsCount);
+        }
+
+        if (meshlets.empty())
+        {
+            ranges.push_back({0, static_cast<uint32>(mesh.indexBuffer->GetElementsCount())});
+            return 1;
+        }
+
+        float32 minScale;
+        float32 maxScale;
+        GetScaleRange(world, minScale, maxScale);
+
+        // Normal cones survive rotations and uniform scales only, a mirroring transform flips the facing.
+        const bool isConeCullingEnabled = view.isPerspective &&
+            !mesh.material->GetProperties().doubleSided &&
+            (maxScale - minScale) <= maxScale * 1e-3f;
+        const float32 facing = dx::XMVectorGetX(dx::XMMatrixDeterminant(world)) < 0.0f ? -1.0f : 1.0f;
+
+        const Size firstRange = ranges.size();
+        for (const auto &meshlet : meshlets)
+        {
+            dx::BoundingSphere sphere(meshlet.center, meshlet.radius);
+            sphere.Transform(sphere, world);
+
+            if (view.isBox ? !view.box.Intersects(sphere) : !view.frustum.Intersects(sphere))
+            {
+                continue;
+            }
+
+            if (isConeCullingEnabled && meshlet.coneCutoff < 1.0f)
+            {
+                auto axis = dx::XMVector3Normalize(dx::XMVector3TransformNormal(dx::XMLoadFloat3(&meshlet.coneAxis), world));
+                auto direction = dx::XMVectorSubtract(dx::XMLoadFloat3(&sphere.Center), view.eyePosition);
+
+                const float32 distance = dx::XMVectorGetX(dx::XMVector3Length(direction));
+                const float32 projection = facing * dx::XMVectorGetX(dx::XMVector3Dot(direction, axis));
+
+                // Every point of the sphere sees every normal of the cone from behind.
+                if (projection >= meshlet.coneCutoff * distance + sphere.Radius)
+                {
+                    continue;
+                }
+            }
+
+            AddRange(ranges, firstRange, meshlet.indexOffset, meshlet.indexCount);
+        }
+
+        return static_cast<uint32>(ranges.size() - firstRange);
+    }
+} // namespace Engine::Scene::MeshletCulling
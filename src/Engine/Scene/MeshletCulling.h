@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Types.h>
+#include <Scene/SceneForwards.h>
+#include <Scene/Components/ComponentsForwards.h>
+#include <Scene/ShadowCascades.h>
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include <vector>
+
+namespace Engine::Scene::MeshletCulling
+{
+    struct DrawRange
+    {
+        uint32 indexOffset = 0;
+        uint32 indexCount = 0;
+    };
+
+    struct View
+    {
+        DirectX::BoundingFrustum frustum;
+        // Views fit to shadow cascades are culled against a box, BoundingFrustum only describes perspective volumes.
+        DirectX::BoundingOrientedBox box;
+        bool isBox = false;
+        DirectX::XMVECTOR eyePosition;
+        // Pixels covered by one world unit, at unit distance for perspective views.
+        float32 pixelsPerUnit = 0.0f;
+        // Backface cone tests and distance based LOD selection need a perspective eye.
+        bool isPerspective = true;
+    };
+
+    View GetView(const Components::CameraComponent &camera);
+    View GetView(const ShadowCascades::Cascade &cascade, uint32 resolution);
+
+    // Picks the coarsest LOD whose error projects under EngineConfig::LodErrorThreshold pixels at the closest point of the world bounds.
+    uint32 SelectLod(const Mesh &mesh, const DirectX::XMMATRIX &world, const DirectX::BoundingBox &bounds, const View &view);
+
+    // Appends the index ranges of the visible meshlets of a mesh LOD, adjacent ranges are merged.
+    // A mesh without meshlets produces a single range over all of its indices.
+    // Returns the number of appended ranges, zero when the whole mesh is culled.
+    uint32 Cull(const Mesh &mesh, const DirectX::XMMATRIX &world, uint32 lod, const View &view, std::vector<DrawRange> &ranges);
+} // namespace Engine::Scene::MeshletCulling
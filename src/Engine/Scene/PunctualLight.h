@@ -3,6 +3,9 @@
 #include <ShaderTypes.h>
 
 #include <DirectXMath.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace Engine::Scene
 {
@@ -59,6 +62,30 @@ namespace Engine::Scene
         void SetOuterConeAngle(float coneAngle) { mOuterConeAngle = coneAngle; }
         float GetOuterConeAngle() const { return mOuterConeAngle; }
 
+        // Distance where the attenuated intensity falls below cutoff, lights without falloff reach infinitely far.
+        float GetRange(float cutoff) const
+        {
+            const float intensity = mIntensity * std::max(mColor.x, std::max(mColor.y, mColor.z));
+            const float threshold = intensity / cutoff - mConstantAttenuation;
+            if (threshold <= 0.0f)
+            {
+                return 0.0f;
+            }
+
+            if (mQuadraticAttenuation > 0.0f)
+            {
+                const float discriminant = mLinearAttenuation * mLinearAttenuation + 4.0f * mQuadraticAttenuation * threshold;
+                return (std::sqrt(discriminant) - mLinearAttenuation) / (2.0f * mQuadraticAttenuation);
+            }
+
+            if (mLinearAttenuation > 0.0f)
+            {
+                return threshold / mLinearAttenuation;
+            }
+
+            return std::numeric_limits<float>::infinity();
+        }
+
     private:
         LightType mLightType;
         bool mEnabled;
@@ -0,0 +1,57 @@
+#include "SceneBounds.h"
+
+#include <Scene/Components/AABBComponent.h>
+#include <Scene/Components/IsDisabledComponent.h>
+
+#include <cfloat>
+
+namespace Engine::Scene
+{
+    void SceneBounds::Connect(entt::registry &registry)
+    {
+        registry.on_construct<Components::AABBComponent>().connect<&SceneBounds::OnBoundsChanged>(this);
+        registry.on_destroy<Components::AABBComponent>().connect<&SceneBounds::OnBoundsChanged>(this);
+        registry.on_construct<Components::IsDisabledComponent>().connect<&SceneBounds::OnBoundsChanged>(this);
+        registry.on_destroy<Components::IsDisabledComponent>().connect<&SceneBounds::OnBoundsChanged>(this);
+
+        mIsDirty = true;
+    }
+
+    bool SceneBounds::Update(entt::registry &registry)
+    {
+        if (!mIsDirty)
+        {
+            return false;
+        }
+
+        const auto &boundingBoxes = registry.view<Components::AABBComponent>(entt::exclude<Components::IsDisabledComponent>);
+
+        auto min = dx::XMVectorReplicate(FLT_MAX);
+        auto max = dx::XMVectorReplicate(-FLT_MAX);
+        bool isEmpty = true;
+
+        for (auto &&[entity, aabb] : boundingBoxes.each())
+        {
+            const auto center = dx::XMLoadFloat3(&aabb.boundingBox.Center);
+            const auto extents = dx::XMLoadFloat3(&aabb.boundingBox.Extents);
+
+            min = dx::XMVectorMin(min, dx::XMVectorSubtract(center, extents));
+            max = dx::XMVectorMax(max, dx::XMVectorAdd(center, extents));
+            isEmpty = false;
+        }
+
+        mBounds = dx::BoundingBox();
+        if (!isEmpty)
+        {
+            dx::BoundingBox::CreateFromPoints(mBounds, min, max);
+        }
+
+        mIsDirty = false;
+        return true;
+    }
+
+    void SceneBounds::OnBoundsChanged(entt::registry &registry, entt::entity entity)
+    {
+        mIsDirty = true;
+    }
+} // namespace Engine::Scene
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <Types.h>
+
+#include <DirectXCollision.h>
+#include <entt/entt.hpp>
+
+namespace Engine::Scene
+{
+    // Union of the world AABBs of all enabled entities. It is only recomputed after a box changed
+    // or the set of boxes did, so camera and light movement leave it alone.
+    class SceneBounds
+    {
+    public:
+        // Tracks AABB and IsDisabled components being added or removed.
+        void Connect(entt::registry &registry);
+
+        // Call when boxes were rewritten in place, e.g. by TransformHierarchy::Update.
+        void MarkDirty() { mIsDirty = true; }
+        // Returns true when the bounds were recomputed.
+        bool Update(entt::registry &registry);
+
+        // The default box while no enabled entity has bounds.
+        const DirectX::BoundingBox &GetBounds() const { return mBounds; }
+
+    private:
+        void OnBoundsChanged(entt::registry &registry, entt::entity entity);
+
+    private:
+        DirectX::BoundingBox mBounds;
+        bool mIsDirty = true;
+    };
+} // namespace Engine::Scene
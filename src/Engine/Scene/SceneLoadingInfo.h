@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Scene/SceneForwards.h>
+#include <Scene/Vertex.h>
 
 #include <map>
 #include <string>
@@ -18,6 +19,7 @@ namespace Engine::Scene
         bool loadScene;
         std::map<std::string, std::string> scenes;
         std::string scenePath;
+        VertexFormat vertexFormat = VertexFormat::Full;
 
         std::future<std::unique_ptr<SceneObject>> sceneFuture;
 
@@ -42,11 +44,16 @@ namespace Engine::Scene
 
                 auto& selected = scenes[keys[item_current]];
 
-                if (scenePath != selected)
+                static bool isCompact = vertexFormat == VertexFormat::Compact;
+                ImGui::Checkbox("Compact vertices", &isCompact);
+                auto selectedVertexFormat = isCompact ? VertexFormat::Compact : VertexFormat::Full;
+
+                if (scenePath != selected || vertexFormat != selectedVertexFormat)
                 {
                     if (ImGui::Button("Load"))
                     {
                         scenePath = selected;
+                        vertexFormat = selectedVertexFormat;
                         loadScene = true;
                     }
                 }
@@ -20,6 +20,16 @@ namespace Engine::Scene
         return {cameraEntity, component};
     }
 
+    const DirectX::BoundingBox& SceneObject::GetBounds() const
+    {
+        return mBounds;
+    }
+
+    void SceneObject::SetBounds(const DirectX::BoundingBox& bounds)
+    {
+        mBounds = bounds;
+    }
+
     void SceneObject::AddSystem(UniquePtr<Systems::System> system)
     {
         system->Init(this);
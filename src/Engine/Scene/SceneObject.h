@@ -9,6 +9,7 @@
 #include <vector>
 #include <tuple>
 #include <entt/entt.hpp>
+#include <DirectXCollision.h>
 
 namespace Engine::Scene
 {
@@ -23,6 +24,10 @@ namespace Engine::Scene
 
         std::tuple<entt::entity, Scene::Components::CameraComponent> GetMainCamera();
 
+        // Union of the world bounds of all enabled entities, kept by WorldTransformSystem.
+        const DirectX::BoundingBox& GetBounds() const;
+        void SetBounds(const DirectX::BoundingBox& bounds);
+
         void AddSystem(UniquePtr<Systems::System> system);
 
         void Process(const Timer& timer);
@@ -30,5 +35,6 @@ namespace Engine::Scene
     private:
         entt::registry registry;
         std::vector<UniquePtr<Systems::System>> mSystems;
+        DirectX::BoundingBox mBounds;
     };
 }
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "ShadowAtlas.h"
+
+#include <algorithm>
+#include <bit>
+#include <numeric>
+
+namespace Engine::Scene
+{
+    ShadowAtlas::ShadowAtlas(uint32 size, uint32 minTileSize)
+        : mSize(std::bit_floor(size))
+        , mMinTileSize(std::clamp(std::bit_ceil(minTileSize), 1u, std::bit_floor(size)))
+    {
+        mFreeTiles.resize(std::countr_zero(mSize / mMinTileSize) + 1);
+    }
+
+    void ShadowAtlas::Allocate(std::span<const ShadowAtlasRequest> requests, std::vector<ShadowAtlasAllocation> &allocations, std::vector<dx::XMUINT3> &tiles)
+    {
+        allocations.assign(requests.size(), {});
+
+        mOrder.resize(requests.size());
+        std::iota(mOrder.begin(), mOrder.end(), 0);
+        std::stable_sort(mOrder.begin(), mOrder.end(), [&requests](uint32 a, uint32 b)
+        {
+            return requests[a].importance > requests[b].importance;
+        });
+
+        // Tile sizes are settled first, a request is halved until the area left holds all of its tiles.
+        uint64 freeArea = static_cast<uint64>(mSize) * mSize;
+        for (auto index : mOrder)
+        {
+            const auto &request = requests[index];
+            if (request.tileSize == 0 || request.tilesCount == 0)
+            {
+                continue;
+            }
+
+            uint32 tileSize = std::bit_floor(std::clamp(request.tileSize, mMinTileSize, mSize));
+            while (tileSize >= mMinTileSize && static_cast<uint64>(tileSize) * tileSize * request.tilesCount > freeArea)
+            {
+                tileSize /= 2;
+            }
+
+            if (tileSize < mMinTileSize)
+            {
+                continue;
+            }
+
+            freeArea -= static_cast<uint64>(tileSize) * tileSize * request.tilesCount;
+            allocations[index].tileSize = tileSize;
+            allocations[index].tilesCount = request.tilesCount;
+        }
+
+        uint32 tilesCount = 0;
+        for (auto &allocation : allocations)
+        {
+            allocation.firstTile = tilesCount;
+            tilesCount += allocation.tilesCount;
+        }
+        tiles.resize(tilesCount);
+
+        for (auto &freeTiles : mFreeTiles)
+        {
+            freeTiles.clear();
+        }
+        mFreeTiles[0].push_back(dx::XMUINT2(0, 0));
+
+        // Every free tile is at least as large as the tiles that come next, so they fit as long as their area does.
+        std::stable_sort(mOrder.begin(), mOrder.end(), [&allocations](uint32 a, uint32 b)
+        {
+            return allocations[a].tileSize > allocations[b].tileSize;
+        });
+
+        for (auto index : mOrder)
+        {
+            const auto &allocation = allocations[index];
+            for (uint32 i = 0; i < allocation.tilesCount; ++i)
+            {
+                tiles[allocation.firstTile + i] = AllocateTile(allocation.tileSize);
+            }
+        }
+    }
+
+    dx::XMUINT3 ShadowAtlas::AllocateTile(uint32 tileSize)
+    {
+        const uint32 level = std::countr_zero(mSize / tileSize);
+
+        uint32 parent = level;
+        while (parent > 0 && mFreeTiles[parent].empty())
+        {
+            --parent;
+        }
+
+        for (; parent < level; ++parent)
+        {
+            const auto tile = mFreeTiles[parent].back();
+            mFreeTiles[parent].pop_back();
+
+            // Pushed in reverse so the children are handed out row by row.
+            const uint32 half = mSize >> (parent + 1);
+            auto &children = mFreeTiles[parent + 1];
+            children.push_back(dx::XMUINT2(tile.x + half, tile.y + half));
+            children.push_back(dx::XMUINT2(tile.x, tile.y + half));
+            children.push_back(dx::XMUINT2(tile.x + half, tile.y));
+            children.push_back(dx::XMUINT2(tile.x, tile.y));
+        }
+
+        const auto tile = mFreeTiles[level].back();
+        mFreeTiles[level].pop_back();
+
+        return dx::XMUINT3(tile.x, tile.y, tileSize);
+    }
+
+    float32 GetShadowImportance(const dx::BoundingSphere &bounds, const dx::BoundingFrustum &frustum, dx::FXMVECTOR eyePosition, float32 projectionScale)
+    {
+        if (!frustum.Intersects(bounds))
+        {
+            return 0.0f;
+        }
+
+        const float32 distance = dx::XMVectorGetX(dx::XMVector3Length(dx::XMVectorSubtract(dx::XMLoadFloat3(&bounds.Center), eyePosition)));
+        if (distance <= bounds.Radius)
+        {
+            return 1.0f;
+        }
+
+        // Projected radius over half the viewport height, the diameter over the whole of it.
+        return std::min(1.0f, bounds.Radius * projectionScale / distance);
+    }
+
+    uint32 GetShadowTileSize(float32 importance, uint32 minTileSize, uint32 maxTileSize)
+    {
+        if (importance <= 0.0f)
+        {
+            return 0;
+        }
+
+        const uint32 tileSize = static_cast<uint32>(importance * static_cast<float32>(maxTileSize));
+        return std::bit_floor(std::clamp(tileSize, minTileSize, maxTileSize));
+    }
+} // namespace Engine::Scene
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <Types.h>
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include <span>
+#include <vector>
+
+namespace Engine::Scene
+{
+    struct ShadowAtlasRequest
+    {
+        // Requests are served in order of importance, the most important ones keep their tile size.
+        float32 importance = 0.0f;
+        // Wanted size of every tile, halved while the atlas has no room left for all of them.
+        uint32 tileSize = 0;
+        // One tile per view, six for the cube faces of point lights.
+        uint32 tilesCount = 1;
+    };
+
+    struct ShadowAtlasAllocation
+    {
+        uint32 firstTile = 0;
+        // Zero when the request got no room in the atlas.
+        uint32 tilesCount = 0;
+        uint32 tileSize = 0;
+    };
+
+    // Square power of two tiles of a shadow map handed out by a quadtree, a split tile gives four equal children.
+    // The atlas is rebuilt from scratch on every Allocate, so tiles follow the lights from frame to frame.
+    class ShadowAtlas
+    {
+    public:
+        ShadowAtlas(uint32 size, uint32 minTileSize);
+
+        // Tiles of request i are tiles[allocations[i].firstTile] onwards, offset and size in texels.
+        void Allocate(std::span<const ShadowAtlasRequest> requests, std::vector<ShadowAtlasAllocation> &allocations, std::vector<DirectX::XMUINT3> &tiles);
+
+        uint32 GetSize() const { return mSize; }
+        uint32 GetMinTileSize() const { return mMinTileSize; }
+
+    private:
+        DirectX::XMUINT3 AllocateTile(uint32 tileSize);
+
+    private:
+        uint32 mSize;
+        uint32 mMinTileSize;
+        // Free tiles of every quadtree level, tiles of level i are mSize >> i texels wide.
+        std::vector<std::vector<DirectX::XMUINT2>> mFreeTiles;
+        std::vector<uint32> mOrder;
+    };
+
+    // Share of the viewport height covered by the light volume, one when the eye is inside it and zero when it is out of view.
+    // projectionScale is the y scale of the camera projection.
+    float32 GetShadowImportance(const DirectX::BoundingSphere &bounds, const DirectX::BoundingFrustum &frustum, DirectX::FXMVECTOR eyePosition, float32 projectionScale);
+
+    // Largest power of two under importance * maxTileSize, clamped to the tile size limits. Zero for unimportant lights.
+    uint32 GetShadowTileSize(float32 importance, uint32 minTileSize, uint32 maxTileSize);
+} // namespace Engine::Scene
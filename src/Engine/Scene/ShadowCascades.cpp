@@ -0,0 +1,97 @@
+#include "ShadowCascades.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Engine::Scene::ShadowCascades
+{
+    namespace
+    {
+        dx::XMMATRIX GetLightRotation(dx::FXMVECTOR lightDirection)
+        {
+            static const dx::XMVECTOR up = dx::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+            static const dx::XMVECTOR forward = dx::XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
+
+            const auto direction = dx::XMVector3Normalize(lightDirection);
+            const float32 dot = std::abs(dx::XMVectorGetX(dx::XMVector3Dot(direction, up)));
+
+            return dx::XMMatrixLookToLH(dx::XMVectorZero(), direction, std::abs(dot - 1.0f) <= 0.0001f ? forward : up);
+        }
+    }
+
+    void ComputeSplits(float32 nearPlane, float32 farPlane, float32 lambda, std::span<float32> splits)
+    {
+        const float32 count = static_cast<float32>(splits.size());
+        for (Size i = 0; i < splits.size(); ++i)
+        {
+            const float32 part = static_cast<float32>(i + 1) / count;
+            const float32 logarithmic = nearPlane * std::pow(farPlane / nearPlane, part);
+            const float32 uniform = nearPlane + (farPlane - nearPlane) * part;
+
+            splits[i] = lambda * logarithmic + (1.0f - lambda) * uniform;
+        }
+
+        if (!splits.empty())
+        {
+            splits.back() = farPlane;
+        }
+    }
+
+    Cascade Fit(
+        const dx::XMMATRIX &cameraWorld,
+        float32 tanHalfWidth,
+        float32 tanHalfHeight,
+        float32 sliceNear,
+        float32 sliceFar,
+        dx::FXMVECTOR lightDirection,
+        uint32 resolution,
+        const dx::BoundingBox &sceneBounds)
+    {
+        // Corners of the slice are k times their depth away from the view axis, the sphere center is equally far from the near and far ones.
+        const float32 k2 = tanHalfWidth * tanHalfWidth + tanHalfHeight * tanHalfHeight;
+        float32 centerDepth = 0.5f * (sliceNear + sliceFar) * (1.0f + k2);
+        if (centerDepth > sliceFar)
+        {
+            centerDepth = sliceFar;
+        }
+        const float32 farDistance = sliceFar - centerDepth;
+        const float32 sphereRadius = std::sqrt(farDistance * farDistance + sliceFar * sliceFar * k2);
+
+        const auto center = dx::XMVector3Transform(dx::XMVectorSet(0.0f, 0.0f, centerDepth, 1.0f), cameraWorld);
+
+        const auto lightView = GetLightRotation(lightDirection);
+        dx::XMFLOAT3 lightCenter;
+        dx::XMStoreFloat3(&lightCenter, dx::XMVector3Transform(center, lightView));
+
+        // Snapping moves the center by up to a texel, so the cascade is one texel wider than the sphere on every side.
+        const float32 texelSize = 2.0f * sphereRadius / static_cast<float32>(resolution - 2);
+        const float32 radius = 0.5f * static_cast<float32>(resolution) * texelSize;
+        lightCenter.x = std::floor(lightCenter.x / texelSize) * texelSize;
+        lightCenter.y = std::floor(lightCenter.y / texelSize) * texelSize;
+
+        dx::BoundingBox lightSceneBounds;
+        sceneBounds.Transform(lightSceneBounds, lightView);
+
+        const float32 nearPlane = std::min(lightSceneBounds.Center.z - lightSceneBounds.Extents.z, lightCenter.z - radius);
+        const float32 farPlane = lightCenter.z + radius;
+
+        Cascade cascade;
+        cascade.view = lightView;
+        cascade.projection = dx::XMMatrixOrthographicOffCenterLH(
+            lightCenter.x - radius, lightCenter.x + radius,
+            lightCenter.y - radius, lightCenter.y + radius,
+            nearPlane, farPlane);
+        cascade.viewProjection = dx::XMMatrixMultiply(cascade.view, cascade.projection);
+        cascade.splitDepth = sliceFar;
+
+        // The light view is a pure rotation, its transpose brings the box back to world space.
+        const auto inverseLightView = dx::XMMatrixTranspose(lightView);
+        const auto boxCenter = dx::XMVectorSet(lightCenter.x, lightCenter.y, 0.5f * (nearPlane + farPlane), 1.0f);
+
+        dx::XMStoreFloat3(&cascade.bounds.Center, dx::XMVector3Transform(boxCenter, inverseLightView));
+        cascade.bounds.Extents = dx::XMFLOAT3(radius, radius, 0.5f * (farPlane - nearPlane));
+        dx::XMStoreFloat4(&cascade.bounds.Orientation, dx::XMQuaternionRotationMatrix(inverseLightView));
+
+        return cascade;
+    }
+} // namespace Engine::Scene::ShadowCascades
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <Types.h>
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include <span>
+
+namespace Engine::Scene::ShadowCascades
+{
+    struct Cascade
+    {
+        DirectX::XMMATRIX view;
+        DirectX::XMMATRIX projection;
+        DirectX::XMMATRIX viewProjection;
+        // World space volume covered by the orthographic projection.
+        DirectX::BoundingOrientedBox bounds;
+        // View space depth of the camera where the cascade ends.
+        float32 splitDepth = 0.0f;
+    };
+
+    // Practical split scheme, lambda blends logarithmic (1) and uniform (0) splits.
+    // Writes the far depth of every cascade, the last one is farPlane.
+    void ComputeSplits(float32 nearPlane, float32 farPlane, float32 lambda, std::span<float32> splits);
+
+    // Fits an orthographic projection around the bounding sphere of a slice of a perspective camera frustum.
+    // The sphere only depends on the slice depths, so the projection keeps its size while the camera rotates,
+    // and its origin is snapped to whole shadow map texels, so it does not shimmer while the camera moves.
+    // tanHalfWidth and tanHalfHeight are the slopes of the camera frustum, depth is extended towards
+    // the light to keep every caster of the scene bounds.
+    Cascade Fit(
+        const DirectX::XMMATRIX &cameraWorld,
+        float32 tanHalfWidth,
+        float32 tanHalfHeight,
+        float32 sliceNear,
+        float32 sliceFar,
+        DirectX::FXMVECTOR lightDirection,
+        uint32 resolution,
+        const DirectX::BoundingBox &sceneBounds);
+} // namespace Engine::Scene::ShadowCascades
@@ -62,6 +62,7 @@ namespace Engine::Scene::Systems
             dx::XMStoreFloat3(&frustum.Origin, tr);
             dx::XMStoreFloat4(&frustum.Orientation, rt);
             cameraComponent.frustum = frustum;
+            cameraComponent.viewportHeight = height;
         }
     }
 } // namespace Engine::Scene::Systems
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include "CullingSystem.h"
+
+#include <Scene/SceneObject.h>
+#include <Scene/Components/CameraComponent.h>
+#include <Scene/Components/MeshComponent.h>
+#include <Scene/Components/AABBComponent.h>
+#include <Scene/Components/IsDisabledComponent.h>
+#include <Scene/Components/LocalTransformComponent.h>
+#include <Scene/Components/RelationshipComponent.h>
+#include <Scene/Components/VisibilityComponent.h>
+#include <Scene/Components/ShadowCascadesComponent.h>
+#include <Scene/Components/ShadowViewsComponent.h>
+#include <Scene/Components/LightComponent.h>
+
+namespace Engine::Scene::Systems
+{
+    CullingSystem::CullingSystem() : System()
+    {
+    }
+
+    CullingSystem::~CullingSystem() = default;
+
+    void CullingSystem::Init(SceneObject *scene)
+    {
+        auto& registry = scene->GetRegistry();
+        registry.on_construct<Components::MeshComponent>().connect<&CullingSystem::MarkStructureAsDirty>(this);
+        registry.on_construct<Components::AABBComponent>().connect<&CullingSystem::MarkStructureAsDirty>(this);
+        registry.on_construct<Components::IsDisabledComponent>().connect<&CullingSystem::MarkStructureAsDirty>(this);
+        registry.on_destroy<Components::MeshComponent>().connect<&CullingSystem::MarkStructureAsDirty>(this);
+        registry.on_destroy<Components::AABBComponent>().connect<&CullingSystem::MarkStructureAsDirty>(this);
+        registry.on_destroy<Components::IsDisabledComponent>().connect<&CullingSystem::MarkStructureAsDirty>(this);
+
+        registry.on_update<Components::LocalTransformComponent>().connect<&CullingSystem::MarkBoundsAsDirty>(this);
+        registry.on_update<Components::RelationshipComponent>().connect<&CullingSystem::MarkBoundsAsDirty>(this);
+
+        mIsStructureDirty = true;
+    }
+
+    void CullingSystem::Process(SceneObject *scene, const Timer &timer)
+    {
+        auto& registry = scene->GetRegistry();
+
+        if (mIsStructureDirty)
+        {
+            mEntities.clear();
+
+            const auto& meshesView = registry.view<Components::MeshComponent, Components::AABBComponent>(entt::exclude<Components::IsDisabledComponent>);
+            for (auto entity : meshesView)
+            {
+                mEntities.push_back(entity);
+            }
+
+            GatherBounds(registry);
+            mHierarchy.Build(mBounds);
+
+            mIsStructureDirty = false;
+            mIsBoundsDirty = false;
+        }
+        else if (mIsBoundsDirty)
+        {
+            GatherBounds(registry);
+            mHierarchy.Refit(mBounds);
+
+            mIsBoundsDirty = false;
+        }
+
+        // Lights are culled through their shadow views, only those that got room in the shadow atlas.
+        for (auto entity : registry.view<Components::CameraComponent>(entt::exclude<Components::LightComponent>))
+        {
+            registry.get_or_emplace<Components::VisibilityComponent>(entity);
+        }
+
+        mViews.clear();
+        mFrusta.clear();
+
+        const auto& camerasView = registry.view<Components::CameraComponent, Components::VisibilityComponent>(entt::exclude<Components::LightComponent>);
+        for (auto&& [entity, cameraComponent, visibility] : camerasView.each())
+        {
+            mViews.push_back(&visibility.visibleEntities);
+            mFrusta.emplace_back(cameraComponent.frustum);
+        }
+
+        const auto& cascadesView = registry.view<Components::ShadowCascadesComponent>();
+        for (auto&& [entity, cascadesComponent] : cascadesView.each())
+        {
+            cascadesComponent.visibleEntities.resize(cascadesComponent.cascades.size());
+            for (Size i = 0; i < cascadesComponent.cascades.size(); ++i)
+            {
+                mViews.push_back(&cascadesComponent.visibleEntities[i]);
+                mFrusta.emplace_back(cascadesComponent.cascades[i].bounds);
+            }
+        }
+
+        const auto& shadowViewsView = registry.view<Components::ShadowViewsComponent>();
+        for (auto&& [entity, shadowViews] : shadowViewsView.each())
+        {
+            shadowViews.visibleEntities.resize(shadowViews.views.size());
+            for (Size i = 0; i < shadowViews.views.size(); ++i)
+            {
+                mViews.push_back(&shadowViews.visibleEntities[i]);
+                mFrusta.emplace_back(shadowViews.views[i].frustum);
+            }
+        }
+
+        // The main camera, every cascade and every view of a shadow casting light are culled by the same walk over the tree.
+        mVisibleItems.resize(mViews.size());
+        for (auto& visibleItems : mVisibleItems)
+        {
+            visibleItems.clear();
+        }
+
+        mHierarchy.Query(mFrusta, mVisibleItems);
+
+        for (Size i = 0; i < mViews.size(); ++i)
+        {
+            auto& visibleEntities = *mViews[i];
+            visibleEntities.clear();
+            visibleEntities.reserve(mVisibleItems[i].size());
+
+            for (auto item : mVisibleItems[i])
+            {
+                visibleEntities.push_back(mEntities[item]);
+            }
+        }
+    }
+
+    void CullingSystem::GatherBounds(entt::registry& r)
+    {
+        mBounds.resize(mEntities.size());
+        for (Size i = 0; i < mEntities.size(); ++i)
+        {
+            mBounds[i] = r.get<Components::AABBComponent>(mEntities[i]).boundingBox;
+        }
+    }
+
+    void CullingSystem::MarkStructureAsDirty(entt::registry& r, entt::entity entity)
+    {
+        mIsStructureDirty = true;
+    }
+
+    void CullingSystem::MarkBoundsAsDirty(entt::registry& r, entt::entity entity)
+    {
+        // Cameras and lights move every frame without moving any mesh bounds.
+        const auto* relationship = r.try_get<Components::RelationshipComponent>(entity);
+        if (r.has<Components::AABBComponent>(entity) || (relationship && relationship->childsCount > 0))
+        {
+            mIsBoundsDirty = true;
+        }
+    }
+} // namespace Engine::Scene::Systems
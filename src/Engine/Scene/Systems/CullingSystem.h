@@ -0,0 +1,39 @@
+#pragma once
+
+#include <Types.h>
+#include <Timer.h>
+#include <Scene/SceneForwards.h>
+#include <Scene/Systems/System.h>
+#include <Scene/BoundingVolumeHierarchy.h>
+
+#include <entt/entt.hpp>
+#include <DirectXCollision.h>
+#include <vector>
+
+namespace Engine::Scene::Systems
+{
+    class CullingSystem : public System
+    {
+        public:
+            CullingSystem();
+            ~CullingSystem() override;
+        public:
+            void Init(SceneObject *scene) override;
+            void Process(SceneObject *scene, const Timer& timer) override;
+        private:
+            void GatherBounds(entt::registry& r);
+            void MarkStructureAsDirty(entt::registry& r, entt::entity entity);
+            void MarkBoundsAsDirty(entt::registry& r, entt::entity entity);
+
+        private:
+            BoundingVolumeHierarchy mHierarchy;
+            std::vector<entt::entity> mEntities;
+            std::vector<DirectX::BoundingBox> mBounds;
+            // Lists the query results of every view go to, in the order of mFrusta.
+            std::vector<std::vector<entt::entity>*> mViews;
+            std::vector<CullingFrustum> mFrusta;
+            std::vector<std::vector<uint32>> mVisibleItems;
+            bool mIsStructureDirty = false;
+            bool mIsBoundsDirty = false;
+    };
+}
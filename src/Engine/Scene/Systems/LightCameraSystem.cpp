@@ -10,17 +10,85 @@
 #include <Scene/Components/CameraComponent.h>
 #include <Scene/Components/LightComponent.h>
 #include <Scene/Components/WorldTransformComponent.h>
-
-#include <Scene/Components/AABBComponent.h>
-#include <Scene/Components/IsDisabledComponent.h>
+#include <Scene/Components/ShadowCascadesComponent.h>
+#include <Scene/Components/ShadowViewsComponent.h>
+#include <Scene/ShadowCascades.h>
 
 #include <entt/entt.hpp>
+#include <algorithm>
 #include <cmath>
 #include <DirectXCollision.h>
-#include <vector>
 
 namespace Engine::Scene::Systems
 {
+    namespace
+    {
+        void UpdateShadowCascades(
+            Components::ShadowCascadesComponent &component,
+            const Components::CameraComponent &camera,
+            dx::FXMVECTOR lightDirection,
+            const dx::BoundingBox &sceneBounds)
+        {
+            constexpr Size cascadesCount = EngineConfig::ShadowCascadesCount;
+            constexpr uint32 resolution = EngineConfig::ShadowCascadeResolution;
+
+            float32 splits[cascadesCount];
+            ShadowCascades::ComputeSplits(camera.camera.GetNearPlane(), camera.camera.GetFarPlane(), EngineConfig::ShadowCascadeSplitLambda, splits);
+
+            dx::XMVECTOR determinant;
+            const auto cameraWorld = dx::XMMatrixInverse(&determinant, camera.view);
+            const float32 tanHalfWidth = 1.0f / dx::XMVectorGetX(camera.projection.r[0]);
+            const float32 tanHalfHeight = 1.0f / dx::XMVectorGetY(camera.projection.r[1]);
+
+            component.cascades.resize(cascadesCount);
+
+            float32 sliceNear = camera.camera.GetNearPlane();
+            for (uint32 i = 0; i < cascadesCount; ++i)
+            {
+                component.cascades[i] = ShadowCascades::Fit(cameraWorld, tanHalfWidth, tanHalfHeight, sliceNear, splits[i], lightDirection, resolution, sceneBounds);
+
+                sliceNear = splits[i];
+            }
+        }
+
+        // Shadows of local lights end where the light fades out, lights without falloff keep the far plane of their camera.
+        float32 GetShadowRange(const PunctualLight &light, const Camera &camera)
+        {
+            const float32 range = light.GetRange(EngineConfig::LightRangeCutoff);
+            return std::isfinite(range) && range > camera.GetNearPlane() ? range : camera.GetFarPlane();
+        }
+
+        void UpdateCubeShadowViews(Components::ShadowViewsComponent &component, const Camera &camera, dx::FXMVECTOR position)
+        {
+            static const dx::XMVECTOR directions[] = {
+                dx::XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f), dx::XMVectorSet(-1.0f, 0.0f, 0.0f, 0.0f),
+                dx::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), dx::XMVectorSet(0.0f, -1.0f, 0.0f, 0.0f),
+                dx::XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f), dx::XMVectorSet(0.0f, 0.0f, -1.0f, 0.0f)};
+            static const dx::XMVECTOR ups[] = {
+                dx::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), dx::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f),
+                dx::XMVectorSet(0.0f, 0.0f, -1.0f, 0.0f), dx::XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f),
+                dx::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), dx::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)};
+
+            const auto projection = camera.GetProjectionMatrix(1.0f, 1.0f);
+
+            component.views.resize(std::size(directions));
+            for (Size i = 0; i < std::size(directions); ++i)
+            {
+                auto &view = component.views[i];
+                view.camera = camera;
+                view.view = dx::XMMatrixLookToLH(position, directions[i], ups[i]);
+                view.projection = projection;
+                view.viewProjection = dx::XMMatrixTranspose(dx::XMMatrixMultiply(view.view, projection));
+                view.eyePosition = position;
+
+                // The view is a rotation around the light, its transpose turns the frustum back to world space.
+                view.frustum = dx::BoundingFrustum(projection);
+                dx::XMStoreFloat3(&view.frustum.Origin, position);
+                dx::XMStoreFloat4(&view.frustum.Orientation, dx::XMQuaternionRotationMatrix(dx::XMMatrixTranspose(view.view)));
+            }
+        }
+    }
+
     LightCameraSystem::LightCameraSystem(SharedPtr<Render::RenderContext> renderContext) : mRenderContext(renderContext)
     {
     }
@@ -77,16 +145,19 @@ namespace Engine::Scene::Systems
                     const auto inverseView = dx::XMMatrixInverse(&D, viewMatrix);
                     dx::XMMatrixDecompose(&unused, &rt, &unused, inverseView);
                     camera.SetType(CameraType::Perspective);
+                    // The outer cone angle is measured from the axis, the square frustum encloses the whole cone.
+                    camera.SetFoV(std::clamp(2.0f * light.GetOuterConeAngle(), dx::XMConvertToRadians(1), dx::XMConvertToRadians(170)));
+                    camera.SetFarPlane(GetShadowRange(light, camera));
                     projectionMatrix = camera.GetProjectionMatrix(EngineConfig::ShadowWidth, EngineConfig::ShadowHeight);
-                    camera.SetFoV(light.GetOuterConeAngle());
                     cameraType = CameraType::Perspective;
                 }
                 break;
-                case LightType::PointLight: // not supported for now, but light will show only forward camera
+                case LightType::PointLight: // the light camera looks forward, shadows are rendered for every cube face
                     viewMatrix = dx::XMMatrixLookAtLH(tr, tr + forward, up);
                     camera.SetType(CameraType::Perspective);
-                    projectionMatrix = camera.GetProjectionMatrix(EngineConfig::ShadowWidth, EngineConfig::ShadowHeight);
                     camera.SetFoV(dx::XMConvertToRadians(90));
+                    camera.SetFarPlane(GetShadowRange(light, camera));
+                    projectionMatrix = camera.GetProjectionMatrix(EngineConfig::ShadowWidth, EngineConfig::ShadowHeight);
                     cameraType = CameraType::Perspective;
                 break;
                 case LightType::DirectionalLight:
@@ -104,24 +175,9 @@ namespace Engine::Scene::Systems
                     dx::XMMatrixDecompose(&unused, &rt, &unused, inverseView);
                     camera.SetType(CameraType::Orthographic);
 
-                    const auto &boundingBoxes = registry.view<Scene::Components::AABBComponent>(entt::exclude<Scene::Components::IsDisabledComponent>);
+                    dx::BoundingBox box = scene->GetBounds();
 
-                    std::vector<dx::XMFLOAT3> points;
                     dx::XMFLOAT3 corners[dx::BoundingBox::CORNER_COUNT];
-                    points.reserve(boundingBoxes.size_hint() * dx::BoundingBox::CORNER_COUNT);
-                    for (auto&& [entity, aabb] : boundingBoxes.each())
-                    {
-                        aabb.boundingBox.GetCorners(corners);
-
-                        for (size_t i = 0; i < dx::BoundingBox::CORNER_COUNT; ++i)
-                        {
-                            points.push_back(corners[i]);
-                        }
-                    }
-
-                    dx::BoundingBox box;
-                    dx::BoundingBox::CreateFromPoints(box, points.size(), points.data(), sizeof(dx::XMFLOAT3));
-
                     box.GetCorners(corners);
 
                     for (size_t i = 0; i < dx::BoundingBox::CORNER_COUNT; ++i)
@@ -150,6 +206,9 @@ namespace Engine::Scene::Systems
                     viewMatrix = dx::XMMatrixLookAtLH(tr, tr + direction, newUp);
                     const auto maxDimension = 2 * std::max(boxWidth, boxHeight);
                     projectionMatrix = camera.GetProjectionMatrix(maxDimension, maxDimension);
+
+                    auto &cascades = registry.get_or_emplace<Components::ShadowCascadesComponent>(entity);
+                    UpdateShadowCascades(cascades, mainCamera, direction, scene->GetBounds());
                 }
                 break;
             }
@@ -167,6 +226,19 @@ namespace Engine::Scene::Systems
             dx::XMStoreFloat3(&frustum.Origin, tr);
             dx::XMStoreFloat4(&frustum.Orientation, rt);
             cameraComponent.frustum = frustum;
+            cameraComponent.viewportHeight = static_cast<float32>(EngineConfig::ShadowHeight);
+
+            // Tiles and their sizes are assigned later by the shadow atlas.
+            if (light.GetLightType() == LightType::SpotLight)
+            {
+                auto &shadowViews = registry.get_or_emplace<Components::ShadowViewsComponent>(entity);
+                shadowViews.views.assign(1, cameraComponent);
+            }
+            else if (light.GetLightType() == LightType::PointLight)
+            {
+                auto &shadowViews = registry.get_or_emplace<Components::ShadowViewsComponent>(entity);
+                UpdateCubeShadowViews(shadowViews, camera, tr);
+            }
         }
     }
 } // namespace Engine::Scene::Systems
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "ShadowAtlasSystem.h"
+
+#include <EngineConfig.h>
+
+#include <Scene/SceneObject.h>
+#include <Scene/PunctualLight.h>
+#include <Scene/Components/CameraComponent.h>
+#include <Scene/Components/LightComponent.h>
+#include <Scene/Components/ShadowCascadesComponent.h>
+#include <Scene/Components/ShadowViewsComponent.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace Engine::Scene::Systems
+{
+    ShadowAtlasSystem::ShadowAtlasSystem() : System(), mAtlas(EngineConfig::ShadowWidth, EngineConfig::ShadowMinTileSize)
+    {
+    }
+
+    ShadowAtlasSystem::~ShadowAtlasSystem() = default;
+
+    void ShadowAtlasSystem::Process(SceneObject *scene, const Timer &timer)
+    {
+        auto& registry = scene->GetRegistry();
+
+        const auto [cameraEntity, mainCamera] = scene->GetMainCamera();
+        const float32 projectionScale = dx::XMVectorGetY(mainCamera.projection.r[1]);
+
+        mLights.clear();
+        mRequests.clear();
+
+        // Only the first directional light casts shadows, its cascades go first and keep their resolution.
+        bool hasCascades = false;
+        const auto& cascadesView = registry.view<Components::LightComponent, Components::ShadowCascadesComponent>();
+        for (auto&& [entity, lightComponent, cascadesComponent] : cascadesView.each())
+        {
+            cascadesComponent.tiles.clear();
+            if (hasCascades || !lightComponent.light.IsEnabled())
+            {
+                continue;
+            }
+            hasCascades = true;
+
+            ShadowAtlasRequest request = {};
+            request.importance = std::numeric_limits<float32>::max();
+            request.tileSize = EngineConfig::ShadowCascadeResolution;
+            request.tilesCount = static_cast<uint32>(cascadesComponent.cascades.size());
+
+            mLights.push_back(entity);
+            mRequests.push_back(request);
+        }
+
+        const auto& shadowViewsView = registry.view<Components::LightComponent, Components::ShadowViewsComponent>();
+        for (auto&& [entity, lightComponent, shadowViews] : shadowViewsView.each())
+        {
+            shadowViews.tiles.clear();
+            if (!lightComponent.light.IsEnabled() || shadowViews.views.empty())
+            {
+                continue;
+            }
+
+            // Every view of a light starts at the light and ends at its range.
+            const auto &lightView = shadowViews.views.front();
+            dx::BoundingSphere bounds;
+            dx::XMStoreFloat3(&bounds.Center, lightView.eyePosition);
+            bounds.Radius = lightView.camera.GetFarPlane();
+
+            ShadowAtlasRequest request = {};
+            request.importance = GetShadowImportance(bounds, mainCamera.frustum, mainCamera.eyePosition, projectionScale);
+            request.tileSize = GetShadowTileSize(request.importance, EngineConfig::ShadowMinTileSize, EngineConfig::ShadowMaxTileSize);
+            request.tilesCount = static_cast<uint32>(shadowViews.views.size());
+            if (request.tileSize == 0)
+            {
+                continue;
+            }
+
+            // Cube faces cover a quarter of the solid angle of a single view each.
+            if (request.tilesCount > 1)
+            {
+                request.tileSize = std::max<uint32>(request.tileSize / 2, EngineConfig::ShadowMinTileSize);
+            }
+
+            mLights.push_back(entity);
+            mRequests.push_back(request);
+        }
+
+        mAtlas.Allocate(mRequests, mAllocations, mTiles);
+
+        for (Size i = 0; i < mLights.size(); ++i)
+        {
+            const auto &allocation = mAllocations[i];
+            const auto tiles = std::span(mTiles).subspan(allocation.firstTile, allocation.tilesCount);
+
+            if (auto *cascadesComponent = registry.try_get<Components::ShadowCascadesComponent>(mLights[i]))
+            {
+                cascadesComponent->tiles.assign(tiles.begin(), tiles.end());
+            }
+            else
+            {
+                auto &shadowViews = registry.get<Components::ShadowViewsComponent>(mLights[i]);
+                shadowViews.tiles.assign(tiles.begin(), tiles.end());
+
+                for (Size view = 0; view < shadowViews.tiles.size(); ++view)
+                {
+                    shadowViews.views[view].viewportHeight = static_cast<float32>(shadowViews.tiles[view].z);
+                }
+            }
+        }
+
+        // Lights left without tiles are neither culled nor rendered this frame.
+        for (auto&& [entity, lightComponent, cascadesComponent] : cascadesView.each())
+        {
+            if (cascadesComponent.tiles.empty())
+            {
+                cascadesComponent.cascades.clear();
+            }
+        }
+
+        for (auto&& [entity, lightComponent, shadowViews] : shadowViewsView.each())
+        {
+            if (shadowViews.tiles.empty())
+            {
+                shadowViews.views.clear();
+            }
+        }
+    }
+} // namespace Engine::Scene::Systems
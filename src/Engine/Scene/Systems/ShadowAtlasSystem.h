@@ -0,0 +1,30 @@
+#pragma once
+
+#include <Types.h>
+#include <Timer.h>
+#include <Scene/SceneForwards.h>
+#include <Scene/Systems/System.h>
+#include <Scene/ShadowAtlas.h>
+
+#include <entt/entt.hpp>
+#include <DirectXMath.h>
+#include <vector>
+
+namespace Engine::Scene::Systems
+{
+    class ShadowAtlasSystem : public System
+    {
+        public:
+            ShadowAtlasSystem();
+            ~ShadowAtlasSystem() override;
+        public:
+            void Process(SceneObject *scene, const Timer& timer) override;
+        private:
+            ShadowAtlas mAtlas;
+            // Light entity of every request.
+            std::vector<entt::entity> mLights;
+            std::vector<ShadowAtlasRequest> mRequests;
+            std::vector<ShadowAtlasAllocation> mAllocations;
+            std::vector<DirectX::XMUINT3> mTiles;
+    };
+}
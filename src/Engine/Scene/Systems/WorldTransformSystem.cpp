@@ -5,11 +5,8 @@
 #include <Scene/Components/LocalTransformComponent.h>
 #include <Scene/Components/RelationshipComponent.h>
 #include <Scene/Components/WorldTransformComponent.h>
-#include <Scene/Components/AABBComponent.h>
 
 #include <entt/entt.hpp>
-#include <DirectXMath.h>
-#include <queue>
 
 namespace Engine::Scene::Systems
 {
@@ -22,95 +19,50 @@ namespace Engine::Scene::Systems
     void WorldTransformSystem::Init(SceneObject *scene)
     {
         auto& registry = scene->GetRegistry();
-        registry.on_construct<Components::LocalTransformComponent>().connect<&WorldTransformSystem::InitWithDirty>(this);
-        registry.on_construct<Components::RelationshipComponent>().connect<&WorldTransformSystem::InitWithDirty>(this);
+        registry.on_construct<Components::LocalTransformComponent>().connect<&WorldTransformSystem::MarkStructureAsDirty>(this);
+        registry.on_construct<Components::RelationshipComponent>().connect<&WorldTransformSystem::MarkStructureAsDirty>(this);
+        registry.on_update<Components::RelationshipComponent>().connect<&WorldTransformSystem::MarkStructureAsDirty>(this);
+        registry.on_destroy<Components::LocalTransformComponent>().connect<&WorldTransformSystem::MarkStructureAsDirty>(this);
+        registry.on_destroy<Components::RelationshipComponent>().connect<&WorldTransformSystem::MarkStructureAsDirty>(this);
 
         registry.on_update<Components::LocalTransformComponent>().connect<&WorldTransformSystem::MarkAsDirty>(this);
 
-        const auto& view = registry.view<Components::RelationshipComponent, Components::LocalTransformComponent>();
-        for (auto e : view)
-        {
-            registry.emplace_or_replace<Components::Dirty>(e);
-        }
+        mSceneBounds.Connect(registry);
+
+        mIsStructureDirty = true;
     }
 
     void WorldTransformSystem::Process(SceneObject *scene, const Timer &timer)
     {
         auto& registry = scene->GetRegistry();
-        auto group = registry.group<Scene::Components::Dirty, Scene::Components::LocalTransformComponent, Scene::Components::RelationshipComponent>();
-        group.sort([this, &registry](const entt::entity left, const entt::entity right) 
-        {
-            const auto &leftRshp = registry.get<Scene::Components::RelationshipComponent>(left);
-            const auto &rightRshp = registry.get<Scene::Components::RelationshipComponent>(right);
-            
-            return leftRshp.depth < rightRshp.depth;
-        });
 
-        for (auto e : group)
+        if (mIsStructureDirty)
         {
-            const auto& local = registry.get<Scene::Components::LocalTransformComponent>(e);
-            const auto& relationship = registry.get<Scene::Components::RelationshipComponent>(e);
-
-            DirectX::XMMATRIX worldTransform;
-            if (relationship.parent == entt::null)
-            {
-                worldTransform = local.transform;                
-            }
-            else
-            {
-                const auto& parentWorld = registry.get<Scene::Components::WorldTransformComponent>(relationship.parent);
-
-                worldTransform = DirectX::XMMatrixMultiply(local.transform, parentWorld.transform);
-            }
-
-            registry.emplace_or_replace<Scene::Components::WorldTransformComponent>(e, worldTransform);
-
-            if (auto* aabbPtr = registry.try_get<Components::AABBComponent>(e); aabbPtr)
-            {
-                aabbPtr->originalBoundingBox.Transform(aabbPtr->boundingBox, worldTransform);
-            }
+            mHierarchy.Rebuild(registry);
+            mIsStructureDirty = false;
+        }
 
-            registry.remove<Scene::Components::Dirty>(e);
+        if (mHierarchy.Update(registry))
+        {
+            mSceneBounds.MarkDirty();
         }
 
-        registry.remove<Scene::Components::Dirty>(group.begin(), group.end());
+        if (mSceneBounds.Update(registry))
+        {
+            scene->SetBounds(mSceneBounds.GetBounds());
+        }
     }
 
-    void WorldTransformSystem::InitWithDirty(entt::registry& r, entt::entity entity)
+    void WorldTransformSystem::MarkStructureAsDirty(entt::registry& r, entt::entity entity)
     {
-        if (r.has<Components::RelationshipComponent, Components::LocalTransformComponent>(entity))
-        {
-            r.emplace_or_replace<Components::Dirty>(entity);
-        }
+        mIsStructureDirty = true;
     }
 
     void WorldTransformSystem::MarkAsDirty(entt::registry& r, entt::entity entity)
     {
-        if (auto* relationshipPtr = r.try_get<Components::RelationshipComponent>(entity); relationshipPtr)
-        {
-            std::queue<std::tuple<entt::entity, Components::RelationshipComponent>> entities;
-            auto relationship = *relationshipPtr;
-
-            entities.push(std::make_tuple(entity, relationship));
-
-            while(!entities.empty())
-            {
-                auto e = entities.front();
-                entities.pop();
-
-                r.emplace_or_replace<Components::Dirty>(std::get<0>(e));
-                relationship = std::get<1>(e);
-
-                auto child = relationship.first;
-                while(child != entt::null)
-                {
-                    relationship = r.get<Components::RelationshipComponent>(child);
-                    entities.push(std::make_tuple(child, relationship));
-
-                    child = relationship.next;
-                }
-            }
-        }
+        // Descendants inherit the flag while their level is updated, so nothing walks the subtree here
+        // and repeated updates of the same entity within a frame only set the same flag again.
+        mHierarchy.MarkDirty(entity);
     }
 
 } // namespace Engine::Scene::Systems
\ No newline at end of file
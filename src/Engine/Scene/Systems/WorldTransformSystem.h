@@ -3,6 +3,8 @@
 #include <Timer.h>
 #include <Scene/SceneForwards.h>
 #include <Scene/Systems/System.h>
+#include <Scene/SceneBounds.h>
+#include <Scene/TransformHierarchy.h>
 
 #include <entt/fwd.hpp>
 
@@ -17,8 +19,13 @@ namespace Engine::Scene::Systems
             void Init(SceneObject *scene) override;
             void Process(SceneObject *scene, const Timer& timer) override;
         private:
-            void InitWithDirty(entt::registry& r, entt::entity entity);
+            void MarkStructureAsDirty(entt::registry& r, entt::entity entity);
             void MarkAsDirty(entt::registry& r, entt::entity entity);
 
+        private:
+            TransformHierarchy mHierarchy;
+            SceneBounds mSceneBounds;
+            bool mIsStructureDirty = false;
+
     };
 }
\ No newline at end of file
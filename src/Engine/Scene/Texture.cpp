@@ -17,6 +17,8 @@ namespace Engine::Scene
 
     D3D12_CPU_DESCRIPTOR_HANDLE Texture::GetShaderResourceView(ComPtr<ID3D12Device> device, SharedPtr<Memory::DescriptorAllocator> allocator, const D3D12_SHADER_RESOURCE_VIEW_DESC *desc)
         {
+            std::lock_guard<std::mutex> lock(mDescriptorsMutex);
+
             size_t hash = 0;
             if (desc)
             {
@@ -6,6 +6,7 @@
 #include <Scene/SceneForwards.h>
 
 
+#include <mutex>
 #include <vector>
 #include <unordered_map>
 
@@ -32,6 +33,8 @@ namespace Engine::Scene
     private:
         Memory::DescriptorAllocation mAllocaion;
         std::unordered_map<size_t, Memory::DescriptorAllocation> mSRDescriptors;
+        // Materials are bound by several recording threads at once.
+        std::mutex mDescriptorsMutex;
         bool isSRGB = false;
         SharedPtr<Scene::Image> mImage;
     };
@@ -0,0 +1,171 @@
+#include "TransformHierarchy.h"
+
+#include <ThreadPool.h>
+
+#include <Scene/Components/LocalTransformComponent.h>
+#include <Scene/Components/RelationshipComponent.h>
+#include <Scene/Components/WorldTransformComponent.h>
+#include <Scene/Components/AABBComponent.h>
+
+#include <algorithm>
+#include <atomic>
+
+namespace Engine::Scene
+{
+    namespace
+    {
+        // Small levels are cheaper to update on the calling thread than to split.
+        constexpr uint32 NodesPerTask = 512;
+
+        // Transforms the center and sums the absolute axes scaled by the extents, exact for affine transforms.
+        void TransformBoundingBox(const dx::BoundingBox &bounds, const dx::XMMATRIX &world, dx::BoundingBox &result)
+        {
+            auto center = dx::XMVector3Transform(dx::XMLoadFloat3(&bounds.Center), world);
+
+            auto extents = dx::XMLoadFloat3(&bounds.Extents);
+            auto transformedExtents = dx::XMVectorMultiply(dx::XMVectorAbs(world.r[0]), dx::XMVectorSplatX(extents));
+            transformedExtents = dx::XMVectorMultiplyAdd(dx::XMVectorAbs(world.r[1]), dx::XMVectorSplatY(extents), transformedExtents);
+            transformedExtents = dx::XMVectorMultiplyAdd(dx::XMVectorAbs(world.r[2]), dx::XMVectorSplatZ(extents), transformedExtents);
+
+            dx::XMStoreFloat3(&result.Center, center);
+            dx::XMStoreFloat3(&result.Extents, transformedExtents);
+        }
+    }
+
+    void TransformHierarchy::Rebuild(entt::registry &registry)
+    {
+        auto view = registry.view<Components::RelationshipComponent, Components::LocalTransformComponent>();
+
+        std::vector<uint32> levelSizes;
+        for (auto entity : view)
+        {
+            const Size depth = view.get<Components::RelationshipComponent>(entity).depth;
+            if (depth >= levelSizes.size())
+            {
+                levelSizes.resize(depth + 1, 0);
+            }
+            ++levelSizes[depth];
+        }
+
+        mLevels.resize(levelSizes.size() + 1);
+        mLevels[0] = 0;
+        for (Size level = 0; level < levelSizes.size(); ++level)
+        {
+            mLevels[level + 1] = mLevels[level] + levelSizes[level];
+        }
+
+        const Size nodesCount = mLevels.back();
+        mEntities.resize(nodesCount);
+
+        std::vector<uint32> cursors(mLevels.begin(), mLevels.end() - 1);
+        for (auto entity : view)
+        {
+            const Size depth = view.get<Components::RelationshipComponent>(entity).depth;
+            mEntities[cursors[depth]++] = entity;
+        }
+
+        mIndices.clear();
+        mIndices.reserve(nodesCount);
+        for (uint32 i = 0; i < nodesCount; ++i)
+        {
+            mIndices[mEntities[i]] = i;
+        }
+
+        mParents.resize(nodesCount);
+        for (uint32 i = 0; i < nodesCount; ++i)
+        {
+            const auto parent = view.get<Components::RelationshipComponent>(mEntities[i]).parent;
+            const auto it = parent == entt::null ? mIndices.end() : mIndices.find(parent);
+
+            mParents[i] = it == mIndices.end() ? InvalidIndex : it->second;
+        }
+
+        for (auto entity : mEntities)
+        {
+            if (!registry.has<Components::WorldTransformComponent>(entity))
+            {
+                registry.emplace<Components::WorldTransformComponent>(entity, dx::XMMatrixIdentity());
+            }
+        }
+
+        mWorldTransforms.resize(nodesCount);
+        mDirty.assign(nodesCount, 1);
+        mHasDirty = nodesCount > 0;
+    }
+
+    void TransformHierarchy::MarkDirty(entt::entity entity)
+    {
+        if (auto it = mIndices.find(entity); it != mIndices.end())
+        {
+            mDirty[it->second] = 1;
+            mHasDirty = true;
+        }
+    }
+
+    bool TransformHierarchy::Update(entt::registry &registry)
+    {
+        if (!mHasDirty)
+        {
+            return false;
+        }
+
+        // Views are taken up front, the workers only look components up and never touch the pools.
+        auto localView = registry.view<Components::LocalTransformComponent>();
+        auto worldView = registry.view<Components::WorldTransformComponent>();
+        auto boundsView = registry.view<Components::AABBComponent>();
+
+        std::atomic<bool> isBoundsChanged = false;
+
+        for (Size level = 0; level + 1 < mLevels.size(); ++level)
+        {
+            const uint32 levelBegin = mLevels[level];
+            const uint32 levelEnd = mLevels[level + 1];
+            const Size tasksCount = (levelEnd - levelBegin + NodesPerTask - 1) / NodesPerTask;
+
+            ThreadPool::Instance().ParallelFor(tasksCount, [&](Size task)
+            {
+                const uint32 begin = levelBegin + static_cast<uint32>(task) * NodesPerTask;
+                const uint32 end = std::min(begin + NodesPerTask, levelEnd);
+
+                bool isTaskBoundsChanged = false;
+
+                for (uint32 i = begin; i < end; ++i)
+                {
+                    const uint32 parent = mParents[i];
+                    if (parent != InvalidIndex)
+                    {
+                        mDirty[i] |= mDirty[parent];
+                    }
+
+                    if (!mDirty[i])
+                    {
+                        continue;
+                    }
+
+                    const auto entity = mEntities[i];
+                    const auto &local = localView.get<Components::LocalTransformComponent>(entity).transform;
+
+                    mWorldTransforms[i] = parent == InvalidIndex ? local : dx::XMMatrixMultiply(local, mWorldTransforms[parent]);
+                    worldView.get<Components::WorldTransformComponent>(entity).transform = mWorldTransforms[i];
+
+                    if (boundsView.contains(entity))
+                    {
+                        auto &bounds = boundsView.get<Components::AABBComponent>(entity);
+                        TransformBoundingBox(bounds.originalBoundingBox, mWorldTransforms[i], bounds.boundingBox);
+                        isTaskBoundsChanged = true;
+                    }
+                }
+
+                if (isTaskBoundsChanged)
+                {
+                    isBoundsChanged.store(true, std::memory_order_relaxed);
+                }
+            });
+        }
+
+        std::fill(mDirty.begin(), mDirty.end(), static_cast<uint8>(0));
+        mHasDirty = false;
+
+        return isBoundsChanged.load();
+    }
+} // namespace Engine::Scene
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <Types.h>
+
+#include <DirectXMath.h>
+#include <entt/entt.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace Engine::Scene
+{
+    // World transforms of the scene graph stored in depth order, a level only reads parents of the previous one.
+    // Levels are updated in parallel, only dirty nodes and their descendants are recomputed.
+    class TransformHierarchy
+    {
+    public:
+        void Rebuild(entt::registry &registry);
+        void MarkDirty(entt::entity entity);
+        // Returns true when any bounding box was recomputed.
+        bool Update(entt::registry &registry);
+
+        Size GetNodesCount() const { return mEntities.size(); }
+
+    private:
+        static constexpr uint32 InvalidIndex = ~0u;
+
+        std::vector<entt::entity> mEntities;
+        std::vector<uint32> mParents;
+        std::vector<DirectX::XMMATRIX> mWorldTransforms;
+        std::vector<uint8> mDirty;
+        // First node of every depth, followed by the nodes count.
+        std::vector<uint32> mLevels;
+        std::unordered_map<entt::entity, uint32> mIndices;
+        bool mHasDirty = false;
+    };
+} // namespace Engine::Scene
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <Types.h>
+
 #include <DirectXMath.h>
 #include <d3dx12.h>
 
@@ -7,6 +9,12 @@
 
 namespace Engine::Scene
 {
+    enum class VertexFormat : uint32
+    {
+        Full = 0,
+        Compact = 1
+    };
+
     struct Vertex
     {
         DirectX::XMFLOAT3 Vertex;
@@ -14,8 +22,44 @@ namespace Engine::Scene
         DirectX::XMFLOAT2 TextureCoord;
         DirectX::XMFLOAT4 Tangent;
 
-        static std::vector<D3D12_INPUT_ELEMENT_DESC> GetInputLayout()
+        // With a split position stream the position comes from slot 0 and the other attributes from slot 1.
+        static std::vector<D3D12_INPUT_ELEMENT_DESC> GetInputLayout(VertexFormat format = VertexFormat::Full, bool isPositionSplit = false)
+        {
+            auto layout = GetInterleavedInputLayout(format);
+            if (isPositionSplit)
+            {
+                for (Size i = 1; i < layout.size(); ++i)
+                {
+                    layout[i].InputSlot = 1;
+                }
+            }
+            return layout;
+        }
+
+        static std::vector<D3D12_INPUT_ELEMENT_DESC> GetPositionInputLayout(VertexFormat format = VertexFormat::Full)
         {
+            return {GetInterleavedInputLayout(format).front()};
+        }
+
+        static Size GetPositionSize(VertexFormat format)
+        {
+            return format == VertexFormat::Compact ? 4 * sizeof(uint16) : sizeof(DirectX::XMFLOAT3);
+        }
+
+    private:
+        static std::vector<D3D12_INPUT_ELEMENT_DESC> GetInterleavedInputLayout(VertexFormat format)
+        {
+            if (format == VertexFormat::Compact)
+            {
+                return
+                {
+                    {"POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+                    {"NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+                    {"TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+                    {"TANGENT", 0, DXGI_FORMAT_R16G16_SNORM, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0}
+                };
+            }
+
             return 
             {
                 {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
@@ -25,4 +69,14 @@ namespace Engine::Scene
             };
         }
     };
+
+    // 20 byte vertex: position quantized to the mesh bounds with the tangent sign in w,
+    // octahedral encoded normal and tangent, half precision texture coordinates.
+    struct CompactVertex
+    {
+        uint16 Position[4];
+        int16 Normal[2];
+        uint16 TextureCoord[2];
+        int16 Tangent[2];
+    };
 } // namespace Engine::Scene
\ No newline at end of file
@@ -0,0 +1,172 @@
+#include "VertexCompression.h"
+
+#include <DirectXPackedVector.h>
+
+#include <cmath>
+
+namespace Engine::Scene::VertexCompression
+{
+    namespace
+    {
+        float32 SignNotZero(float32 value)
+        {
+            return value >= 0.0f ? 1.0f : -1.0f;
+        }
+
+        float32 Clamp(float32 value, float32 min, float32 max)
+        {
+            return value < min ? min : (value > max ? max : value);
+        }
+
+        uint16 ToUnorm16(float32 value)
+        {
+            return static_cast<uint16>(std::lround(Clamp(value, 0.0f, 1.0f) * 65535.0f));
+        }
+
+        float32 FromUnorm16(uint16 value)
+        {
+            return value / 65535.0f;
+        }
+
+        int16 ToSnorm16(float32 value)
+        {
+            return static_cast<int16>(std::lround(Clamp(value, -1.0f, 1.0f) * 32767.0f));
+        }
+
+        float32 FromSnorm16(int16 value)
+        {
+            return Clamp(value / 32767.0f, -1.0f, 1.0f);
+        }
+
+        // Any unit vector perpendicular to the normal, for meshes without tangents.
+        DirectX::XMFLOAT3 GetPerpendicular(const DirectX::XMFLOAT3 &normal)
+        {
+            using namespace DirectX;
+
+            XMVECTOR n = XMLoadFloat3(&normal);
+            XMVECTOR axis = std::abs(normal.x) < 0.9f ? XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f) : XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+
+            XMFLOAT3 result;
+            XMStoreFloat3(&result, XMVector3Normalize(XMVector3Cross(n, axis)));
+            return result;
+        }
+    }
+
+    PositionQuantization GetPositionQuantization(std::span<const Vertex> vertices)
+    {
+        PositionQuantization quantization;
+        if (vertices.empty())
+        {
+            return quantization;
+        }
+
+        DirectX::XMFLOAT3 min = vertices[0].Vertex;
+        DirectX::XMFLOAT3 max = vertices[0].Vertex;
+        for (const auto &vertex : vertices)
+        {
+            const auto &position = vertex.Vertex;
+            min = {position.x < min.x ? position.x : min.x, position.y < min.y ? position.y : min.y, position.z < min.z ? position.z : min.z};
+            max = {position.x > max.x ? position.x : max.x, position.y > max.y ? position.y : max.y, position.z > max.z ? position.z : max.z};
+        }
+
+        quantization.offset = min;
+        quantization.scale = {max.x - min.x, max.y - min.y, max.z - min.z};
+
+        return quantization;
+    }
+
+    DirectX::XMFLOAT2 EncodeOctahedron(const DirectX::XMFLOAT3 &direction)
+    {
+        float32 length = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+        if (length == 0.0f)
+        {
+            return {0.0f, 0.0f};
+        }
+
+        float32 x = direction.x / length;
+        float32 y = direction.y / length;
+        if (direction.z < 0.0f)
+        {
+            float32 foldedX = (1.0f - std::abs(y)) * SignNotZero(x);
+            float32 foldedY = (1.0f - std::abs(x)) * SignNotZero(y);
+            x = foldedX;
+            y = foldedY;
+        }
+
+        return {x, y};
+    }
+
+    DirectX::XMFLOAT3 DecodeOctahedron(const DirectX::XMFLOAT2 &encoded)
+    {
+        using namespace DirectX;
+
+        XMFLOAT3 direction = {encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y)};
+        float32 fold = Clamp(-direction.z, 0.0f, 1.0f);
+        direction.x += direction.x >= 0.0f ? -fold : fold;
+        direction.y += direction.y >= 0.0f ? -fold : fold;
+
+        XMStoreFloat3(&direction, XMVector3Normalize(XMLoadFloat3(&direction)));
+        return direction;
+    }
+
+    CompactVertex Encode(const Vertex &vertex, const PositionQuantization &quantization)
+    {
+        auto quantize = [](float32 value, float32 scale, float32 offset)
+        {
+            return scale > 0.0f ? ToUnorm16((value - offset) / scale) : static_cast<uint16>(0);
+        };
+
+        DirectX::XMFLOAT3 tangent = {vertex.Tangent.x, vertex.Tangent.y, vertex.Tangent.z};
+        if (tangent.x == 0.0f && tangent.y == 0.0f && tangent.z == 0.0f)
+        {
+            tangent = GetPerpendicular(vertex.Normal);
+        }
+
+        auto normal = EncodeOctahedron(vertex.Normal);
+        auto encodedTangent = EncodeOctahedron(tangent);
+
+        CompactVertex result = {};
+        result.Position[0] = quantize(vertex.Vertex.x, quantization.scale.x, quantization.offset.x);
+        result.Position[1] = quantize(vertex.Vertex.y, quantization.scale.y, quantization.offset.y);
+        result.Position[2] = quantize(vertex.Vertex.z, quantization.scale.z, quantization.offset.z);
+        result.Position[3] = vertex.Tangent.w < 0.0f ? 0 : 65535;
+        result.Normal[0] = ToSnorm16(normal.x);
+        result.Normal[1] = ToSnorm16(normal.y);
+        result.TextureCoord[0] = DirectX::PackedVector::XMConvertFloatToHalf(vertex.TextureCoord.x);
+        result.TextureCoord[1] = DirectX::PackedVector::XMConvertFloatToHalf(vertex.TextureCoord.y);
+        result.Tangent[0] = ToSnorm16(encodedTangent.x);
+        result.Tangent[1] = ToSnorm16(encodedTangent.y);
+
+        return result;
+    }
+
+    Vertex Decode(const CompactVertex &vertex, const PositionQuantization &quantization)
+    {
+        Vertex result = {};
+        result.Vertex = {
+            FromUnorm16(vertex.Position[0]) * quantization.scale.x + quantization.offset.x,
+            FromUnorm16(vertex.Position[1]) * quantization.scale.y + quantization.offset.y,
+            FromUnorm16(vertex.Position[2]) * quantization.scale.z + quantization.offset.z};
+        result.Normal = DecodeOctahedron({FromSnorm16(vertex.Normal[0]), FromSnorm16(vertex.Normal[1])});
+        result.TextureCoord = {
+            DirectX::PackedVector::XMConvertHalfToFloat(vertex.TextureCoord[0]),
+            DirectX::PackedVector::XMConvertHalfToFloat(vertex.TextureCoord[1])};
+
+        auto tangent = DecodeOctahedron({FromSnorm16(vertex.Tangent[0]), FromSnorm16(vertex.Tangent[1])});
+        result.Tangent = {tangent.x, tangent.y, tangent.z, FromUnorm16(vertex.Position[3]) * 2.0f - 1.0f};
+
+        return result;
+    }
+
+    std::vector<CompactVertex> Encode(std::span<const Vertex> vertices, const PositionQuantization &quantization)
+    {
+        std::vector<CompactVertex> result;
+        result.reserve(vertices.size());
+        for (const auto &vertex : vertices)
+        {
+            result.push_back(Encode(vertex, quantization));
+        }
+
+        return result;
+    }
+} // namespace Engine::Scene::VertexCompression
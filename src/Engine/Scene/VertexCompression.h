@@ -0,0 +1,28 @@
+#pragma once
+
+#include <Types.h>
+#include <Scene/Vertex.h>
+
+#include <DirectXMath.h>
+#include <span>
+#include <vector>
+
+namespace Engine::Scene::VertexCompression
+{
+    // Dequantization parameters: position = quantized * scale + offset.
+    struct PositionQuantization
+    {
+        DirectX::XMFLOAT3 scale = {1.0f, 1.0f, 1.0f};
+        DirectX::XMFLOAT3 offset = {0.0f, 0.0f, 0.0f};
+    };
+
+    PositionQuantization GetPositionQuantization(std::span<const Vertex> vertices);
+
+    DirectX::XMFLOAT2 EncodeOctahedron(const DirectX::XMFLOAT3 &direction);
+    DirectX::XMFLOAT3 DecodeOctahedron(const DirectX::XMFLOAT2 &encoded);
+
+    CompactVertex Encode(const Vertex &vertex, const PositionQuantization &quantization);
+    Vertex Decode(const CompactVertex &vertex, const PositionQuantization &quantization);
+
+    std::vector<CompactVertex> Encode(std::span<const Vertex> vertices, const PositionQuantization &quantization);
+} // namespace Engine::Scene::VertexCompression
@@ -0,0 +1,166 @@
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <exception>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+namespace Engine
+{
+    namespace
+    {
+        struct ParallelForState
+        {
+            Size count;
+            std::function<void(Size)> body;
+            std::atomic<Size> next{0};
+            std::atomic<Size> completed{0};
+            std::atomic<bool> isFailed{false};
+            std::exception_ptr exception;
+            std::mutex mutex;
+            std::condition_variable condition;
+
+            void Run()
+            {
+                for (Size index = next++; index < count; index = next++)
+                {
+                    if (!isFailed)
+                    {
+                        try
+                        {
+                            body(index);
+                        }
+                        catch (...)
+                        {
+                            std::lock_guard<std::mutex> lock(mutex);
+                            if (!isFailed.exchange(true))
+                            {
+                                exception = std::current_exception();
+                            }
+                        }
+                    }
+
+                    if (++completed == count)
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        condition.notify_all();
+                    }
+                }
+            }
+        };
+
+        Size GetDefaultWorkersCount()
+        {
+            // Leave one hardware thread for the thread that submits the work.
+            Size hardwareThreads = std::thread::hardware_concurrency();
+            return hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+        }
+    }
+
+    ThreadPool &ThreadPool::Instance()
+    {
+        static ThreadPool instance(GetDefaultWorkersCount());
+        return instance;
+    }
+
+    ThreadPool::ThreadPool(Size workersCount) : mIsStopping(false)
+    {
+        mWorkers.reserve(workersCount);
+        for (Size i = 0; i < workersCount; ++i)
+        {
+            mWorkers.emplace_back(&ThreadPool::WorkerLoop, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mIsStopping = true;
+        }
+        mCondition.notify_all();
+
+        for (auto &worker : mWorkers)
+        {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::ParallelFor(Size count, const std::function<void(Size)> &body)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        if (count == 1)
+        {
+            body(0);
+            return;
+        }
+
+        auto state = MakeShared<ParallelForState>();
+        state->count = count;
+        state->body = body;
+
+        Size helpersCount = mWorkers.size() < count - 1 ? mWorkers.size() : count - 1;
+        for (Size i = 0; i < helpersCount; ++i)
+        {
+            Enqueue([state]() { state->Run(); });
+        }
+
+        state->Run();
+
+        {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->condition.wait(lock, [&state]() { return state->completed == state->count; });
+        }
+
+        if (state->exception)
+        {
+            std::rethrow_exception(state->exception);
+        }
+    }
+
+    void ThreadPool::Enqueue(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mTasks.push(std::move(task));
+        }
+        mCondition.notify_one();
+    }
+
+    void ThreadPool::WorkerLoop()
+    {
+#ifdef _WIN32
+        // Image decoding goes through WIC, so every worker needs COM.
+        CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+#endif
+
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mCondition.wait(lock, [this]() { return mIsStopping || !mTasks.empty(); });
+
+                if (mIsStopping && mTasks.empty())
+                {
+                    break;
+                }
+
+                task = std::move(mTasks.front());
+                mTasks.pop();
+            }
+
+            task();
+        }
+
+#ifdef _WIN32
+        CoUninitialize();
+#endif
+    }
+} // namespace Engine
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <Types.h>
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Engine
+{
+    class ThreadPool
+    {
+    public:
+        static ThreadPool &Instance();
+
+    private:
+        ThreadPool(Size workersCount);
+        ~ThreadPool();
+
+    public:
+        Size GetWorkersCount() const { return mWorkers.size(); }
+
+        template <typename F>
+        auto Submit(F &&task) -> std::future<std::invoke_result_t<F>>
+        {
+            using Result = std::invoke_result_t<F>;
+
+            auto packagedTask = MakeShared<std::packaged_task<Result()>>(std::forward<F>(task));
+            auto future = packagedTask->get_future();
+
+            Enqueue([packagedTask]() { (*packagedTask)(); });
+
+            return future;
+        }
+
+        // Calls body(i) for every i in [0, count). The calling thread takes part in the work,
+        // so it is safe to call from inside a pool task. Rethrows the first exception thrown by body.
+        void ParallelFor(Size count, const std::function<void(Size)> &body);
+
+    private:
+        void Enqueue(std::function<void()> task);
+        void WorkerLoop();
+
+    private:
+        std::vector<std::thread> mWorkers;
+        std::queue<std::function<void()>> mTasks;
+        std::mutex mMutex;
+        std::condition_variable mCondition;
+        bool mIsStopping;
+    };
+} // namespace Engine
@@ -0,0 +1,141 @@
+#include <TestFramework.h>
+
+#include <Render/DrawSortKey.h>
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+using namespace Engine;
+using namespace Engine::Render;
+
+namespace
+{
+    constexpr float32 DepthStep = 1.0f / ((1u << 22) - 1);
+
+    struct Draw
+    {
+        bool isDoubleSided = false;
+        bool isCompact = false;
+        uint32 material = 0;
+        uint32 mesh = 0;
+        float32 depth = 0.0f;
+        uint64 sortKey = 0;
+    };
+
+    uint32 GetPipelineState(const Draw &draw)
+    {
+        return (draw.isDoubleSided ? 2 : 0) | (draw.isCompact ? 1 : 0);
+    }
+
+    // Few pipeline states, more materials and meshes, and depths on both sides of the clip range.
+    std::vector<Draw> CreateDraws(std::mt19937 &random, Size count)
+    {
+        std::bernoulli_distribution flag(0.3);
+        std::uniform_int_distribution<uint32> material(0, 40);
+        std::uniform_int_distribution<uint32> mesh(0, 200);
+        std::uniform_real_distribution<float32> depth(-0.1f, 1.1f);
+
+        std::vector<Draw> draws(count);
+        for (auto &draw : draws)
+        {
+            draw.isDoubleSided = flag(random);
+            draw.isCompact = flag(random);
+            draw.material = material(random);
+            draw.mesh = mesh(random);
+            draw.depth = depth(random);
+            draw.sortKey = GetDrawSortKey(draw.isDoubleSided, draw.isCompact, draw.material, draw.mesh, draw.depth);
+        }
+        return draws;
+    }
+}
+
+TEST_CASE("Sorted draws are grouped by pipeline state, material and mesh, then go front to back")
+{
+    std::mt19937 random(25);
+
+    auto draws = CreateDraws(random, 20000);
+    std::stable_sort(draws.begin(), draws.end(), [](const Draw &a, const Draw &b) { return a.sortKey < b.sortKey; });
+
+    Size misorderedCount = 0;
+    for (Size i = 1; i < draws.size(); ++i)
+    {
+        const auto &a = draws[i - 1];
+        const auto &b = draws[i];
+
+        const auto groupA = std::make_tuple(GetPipelineState(a), a.material, a.mesh);
+        const auto groupB = std::make_tuple(GetPipelineState(b), b.material, b.mesh);
+        if (groupA > groupB)
+        {
+            ++misorderedCount;
+        }
+        else if (groupA == groupB)
+        {
+            // Depths closer than a step of the key may keep either order.
+            misorderedCount += std::clamp(a.depth, 0.0f, 1.0f) <= std::clamp(b.depth, 0.0f, 1.0f) + DepthStep ? 0 : 1;
+        }
+    }
+    CHECK_EQUAL(misorderedCount, 0);
+
+    // Every state is set once per group of draws sharing it.
+    std::set<uint32> pipelineStates;
+    std::set<std::tuple<uint32, uint32>> materials;
+    std::set<std::tuple<uint32, uint32, uint32>> meshes;
+    Size pipelineStateChangesCount = 1;
+    Size materialChangesCount = 1;
+    Size meshChangesCount = 1;
+    for (Size i = 0; i < draws.size(); ++i)
+    {
+        const auto &draw = draws[i];
+        pipelineStates.insert(GetPipelineState(draw));
+        materials.insert({GetPipelineState(draw), draw.material});
+        meshes.insert({GetPipelineState(draw), draw.material, draw.mesh});
+
+        if (i > 0)
+        {
+            const auto &previous = draws[i - 1];
+            pipelineStateChangesCount += GetPipelineState(previous) != GetPipelineState(draw) ? 1 : 0;
+            materialChangesCount += GetPipelineState(previous) != GetPipelineState(draw) || previous.material != draw.material ? 1 : 0;
+            meshChangesCount += GetPipelineState(previous) != GetPipelineState(draw) || previous.material != draw.material || previous.mesh != draw.mesh ? 1 : 0;
+        }
+    }
+    CHECK_EQUAL(pipelineStateChangesCount, pipelineStates.size());
+    CHECK_EQUAL(materialChangesCount, materials.size());
+    CHECK_EQUAL(meshChangesCount, meshes.size());
+}
+
+TEST_CASE("Ids and depths out of range don't spill into the other fields of the key")
+{
+    const uint32 largestMaterial = (1u << 20) - 1;
+    const uint32 largestMesh = (1u << 20) - 1;
+
+    // Clamped ids share the largest value.
+    CHECK_EQUAL(GetDrawSortKey(false, false, largestMaterial + 5, 0, 0.0f), GetDrawSortKey(false, false, largestMaterial, 0, 0.0f));
+    CHECK_EQUAL(GetDrawSortKey(false, false, 0, largestMesh + 5, 0.0f), GetDrawSortKey(false, false, 0, largestMesh, 0.0f));
+
+    // The largest value of a field stays below the next value of the field above it.
+    CHECK(GetDrawSortKey(false, false, ~0u, ~0u, 2.0f) < GetDrawSortKey(false, true, 0, 0, 0.0f));
+    CHECK(GetDrawSortKey(false, true, ~0u, ~0u, 2.0f) < GetDrawSortKey(true, false, 0, 0, 0.0f));
+    CHECK(GetDrawSortKey(false, false, 3, ~0u, 2.0f) < GetDrawSortKey(false, false, 4, 0, 0.0f));
+    CHECK(GetDrawSortKey(false, false, 3, 7, 2.0f) < GetDrawSortKey(false, false, 3, 8, -1.0f));
+
+    // Depth is clamped to the clip range and keeps its order inside it.
+    CHECK_EQUAL(GetDrawSortKey(true, true, 1, 1, -0.5f), GetDrawSortKey(true, true, 1, 1, 0.0f));
+    CHECK_EQUAL(GetDrawSortKey(true, true, 1, 1, 1.5f), GetDrawSortKey(true, true, 1, 1, 1.0f));
+    CHECK(GetDrawSortKey(true, true, 1, 1, 0.25f) < GetDrawSortKey(true, true, 1, 1, 0.25f + 2.0f * DepthStep));
+}
+
+TEST_CASE("Sort ids are dense in the order the objects are first seen")
+{
+    int32 objects[4] = {};
+    std::unordered_map<const void *, uint32> ids;
+
+    CHECK_EQUAL(GetSortId(ids, &objects[2]), 0);
+    CHECK_EQUAL(GetSortId(ids, &objects[0]), 1);
+    CHECK_EQUAL(GetSortId(ids, &objects[2]), 0);
+    CHECK_EQUAL(GetSortId(ids, &objects[3]), 2);
+    CHECK_EQUAL(GetSortId(ids, &objects[0]), 1);
+    CHECK_EQUAL(ids.size(), 3);
+}
@@ -0,0 +1,402 @@
+#include <TestFramework.h>
+
+#include <Render/PassStateCache.h>
+#include <Scene/Material.h>
+
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+using namespace Engine::Render;
+
+namespace
+{
+    constexpr uint32 MaterialsCount = 6;
+
+    // A material binds a uniform in a new upload allocation every time, its contents are what a draw sees.
+    constexpr D3D12_GPU_VIRTUAL_ADDRESS MaterialUniformBase = 1ull << 40;
+
+    uint32 GetTablesCount(uint32 material)
+    {
+        return material % 5;
+    }
+
+    // State a draw sees, root arguments are unset after a change of the root signature.
+    struct BoundState
+    {
+        Name rootSignature;
+        Name pso;
+        D3D12_PRIMITIVE_TOPOLOGY primitiveTopology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+        std::map<uint32, D3D12_GPU_VIRTUAL_ADDRESS> rootConstantBufferViews;
+        std::map<uint32, D3D12_GPU_VIRTUAL_ADDRESS> rootShaderResourceViews;
+        D3D12_GPU_VIRTUAL_ADDRESS vertexBuffers[2] = {};
+        D3D12_GPU_VIRTUAL_ADDRESS indexBuffer = 0;
+        // Material whose textures are staged, MaterialsCount when none is.
+        uint32 materialTables = MaterialsCount;
+
+        bool operator==(const BoundState &other) const = default;
+    };
+
+    // Keeps what a D3D12 command list would have bound and every draw it records.
+    struct MockCommandList
+    {
+        BoundState state;
+        std::vector<BoundState> draws;
+        Size commandsCount = 0;
+
+        // Setting the bound root signature again keeps its arguments.
+        void SetRootSignature(const Name &rootSignature)
+        {
+            if (state.rootSignature != rootSignature)
+            {
+                state.rootSignature = rootSignature;
+                state.rootConstantBufferViews.clear();
+                state.rootShaderResourceViews.clear();
+                state.materialTables = MaterialsCount;
+            }
+            ++commandsCount;
+        }
+
+        void SetPipelineState(const Name &pso)
+        {
+            state.pso = pso;
+            ++commandsCount;
+        }
+
+        void SetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY primitiveTopology)
+        {
+            state.primitiveTopology = primitiveTopology;
+            ++commandsCount;
+        }
+
+        void SetRootConstantBufferView(uint32 rootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS address)
+        {
+            state.rootConstantBufferViews[rootParameterIndex] = address;
+            ++commandsCount;
+        }
+
+        void SetRootShaderResourceView(uint32 rootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS address)
+        {
+            state.rootShaderResourceViews[rootParameterIndex] = address;
+            ++commandsCount;
+        }
+
+        void SetVertexBuffer(uint32 slot, D3D12_GPU_VIRTUAL_ADDRESS address)
+        {
+            state.vertexBuffers[slot] = address;
+            ++commandsCount;
+        }
+
+        void SetIndexBuffer(D3D12_GPU_VIRTUAL_ADDRESS address)
+        {
+            state.indexBuffer = address;
+            ++commandsCount;
+        }
+
+        // The uniform and the staged tables of CommandListUtils::BindMaterial.
+        uint32 BindMaterial(uint32 material)
+        {
+            state.rootConstantBufferViews[PassStateCache::MaterialRootParameterIndex] = MaterialUniformBase + material;
+            state.materialTables = material;
+            commandsCount += 1 + GetTablesCount(material);
+            return GetTablesCount(material);
+        }
+
+        void Draw()
+        {
+            draws.push_back(state);
+        }
+    };
+
+    enum class CommandType
+    {
+        RootSignature,
+        PipelineState,
+        PrimitiveTopology,
+        RootConstantBufferView,
+        RootShaderResourceView,
+        VertexBuffer,
+        IndexBuffer,
+        Material,
+        Draw
+    };
+
+    struct Command
+    {
+        CommandType type = CommandType::Draw;
+        uint32 index = 0;
+        uint32 value = 0;
+    };
+
+    const Name RootSignatures[] = {"Forward", "Depth"};
+    const Name PipelineStates[] = {"ForwardCullBack", "ForwardCullNone", "ForwardCullBackCompact", "ForwardCullNoneCompact"};
+
+    D3D12_GPU_VIRTUAL_ADDRESS GetAddress(uint32 value)
+    {
+        return 0x10000ull * (value + 1);
+    }
+
+    // Draws of a few passes. Values come from small pools biased to their first entry, like sorted draws, so most
+    // of the commands repeat what is bound. A few uniforms are written straight to the material root parameter.
+    std::vector<Command> CreateCommands(std::mt19937 &random, Size count)
+    {
+        std::discrete_distribution<uint32> type({1, 8, 3, 10, 4, 10, 6, 8, 12});
+        std::discrete_distribution<uint32> value({12, 3, 1, 1});
+        std::discrete_distribution<uint32> material({8, 3, 1, 1, 1, 1});
+        std::uniform_int_distribution<uint32> constantBufferView(0, PassStateCache::MaterialRootParameterIndex);
+        std::uniform_int_distribution<uint32> shaderResourceView(3, 5);
+        std::uniform_int_distribution<uint32> slot(0, 1);
+
+        std::vector<Command> commands(count);
+        for (auto &command : commands)
+        {
+            command.type = static_cast<CommandType>(type(random));
+            switch (command.type)
+            {
+            case CommandType::RootSignature:
+                command.value = value(random) % 2;
+                break;
+            case CommandType::RootConstantBufferView:
+                command.index = constantBufferView(random);
+                command.value = value(random);
+                break;
+            case CommandType::RootShaderResourceView:
+                command.index = shaderResourceView(random);
+                command.value = value(random);
+                break;
+            case CommandType::VertexBuffer:
+                command.index = slot(random);
+                command.value = value(random);
+                break;
+            case CommandType::Material:
+                command.value = material(random);
+                break;
+            default:
+                command.value = value(random);
+                break;
+            }
+        }
+        return commands;
+    }
+
+    // Records the commands through the cache like PassCommandRecorder does, or all of them without it.
+    // Returns the tables of the skipped materials.
+    uint32 Record(const std::vector<Command> &commands, const Scene::Material *materials, PassStateCache *cache, MockCommandList &commandList)
+    {
+        uint32 skippedTablesCount = 0;
+        for (const auto &command : commands)
+        {
+            switch (command.type)
+            {
+            case CommandType::RootSignature:
+                if (!cache || cache->SetRootSignature(RootSignatures[command.value]))
+                {
+                    commandList.SetRootSignature(RootSignatures[command.value]);
+                }
+                break;
+            case CommandType::PipelineState:
+                if (!cache || cache->SetPipelineState(PipelineStates[command.value]))
+                {
+                    commandList.SetPipelineState(PipelineStates[command.value]);
+                }
+                break;
+            case CommandType::PrimitiveTopology:
+            {
+                const auto primitiveTopology = command.value % 2 ? D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP : D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+                if (!cache || cache->SetPrimitiveTopology(primitiveTopology))
+                {
+                    commandList.SetPrimitiveTopology(primitiveTopology);
+                }
+                break;
+            }
+            case CommandType::RootConstantBufferView:
+                if (!cache || cache->SetRootConstantBufferView(command.index, GetAddress(command.value)))
+                {
+                    commandList.SetRootConstantBufferView(command.index, GetAddress(command.value));
+                }
+                break;
+            case CommandType::RootShaderResourceView:
+                if (!cache || cache->SetRootShaderResourceView(command.index, GetAddress(command.value)))
+                {
+                    commandList.SetRootShaderResourceView(command.index, GetAddress(command.value));
+                }
+                break;
+            case CommandType::VertexBuffer:
+                if (!cache || cache->SetVertexBuffer(command.index, GetAddress(command.value)))
+                {
+                    commandList.SetVertexBuffer(command.index, GetAddress(command.value));
+                }
+                break;
+            case CommandType::IndexBuffer:
+                if (!cache || cache->SetIndexBuffer(GetAddress(command.value)))
+                {
+                    commandList.SetIndexBuffer(GetAddress(command.value));
+                }
+                break;
+            case CommandType::Material:
+                if (!cache || cache->SetMaterial(&materials[command.value]))
+                {
+                    const uint32 tablesCount = commandList.BindMaterial(command.value);
+                    if (cache)
+                    {
+                        cache->SetMaterialTablesCount(tablesCount);
+                    }
+                }
+                else
+                {
+                    skippedTablesCount += GetTablesCount(command.value);
+                }
+                break;
+            case CommandType::Draw:
+                commandList.Draw();
+                break;
+            }
+        }
+        return skippedTablesCount;
+    }
+}
+
+TEST_CASE("Filtered commands leave every draw with the state of an unfiltered replay")
+{
+    std::mt19937 random(25);
+
+    Scene::Material materials[MaterialsCount];
+    const auto commands = CreateCommands(random, 20000);
+
+    MockCommandList unfiltered;
+    Record(commands, materials, nullptr, unfiltered);
+
+    PassStateCache cache;
+    MockCommandList filtered;
+    Record(commands, materials, &cache, filtered);
+
+    CHECK_EQUAL(filtered.draws.size(), unfiltered.draws.size());
+
+    Size mismatchesCount = 0;
+    for (Size i = 0; i < filtered.draws.size() && i < unfiltered.draws.size(); ++i)
+    {
+        mismatchesCount += filtered.draws[i] == unfiltered.draws[i] ? 0 : 1;
+    }
+    CHECK_EQUAL(mismatchesCount, 0);
+
+    // Biased pools make a good part of the commands redundant.
+    CHECK(filtered.commandsCount * 3 < unfiltered.commandsCount * 2);
+}
+
+TEST_CASE("Statistics count every filtered command as recorded or skipped")
+{
+    std::mt19937 random(26);
+
+    Scene::Material materials[MaterialsCount];
+    const auto commands = CreateCommands(random, 20000);
+
+    PassStateCache cache;
+    MockCommandList commandList;
+    const uint32 skippedTablesCount = Record(commands, materials, &cache, commandList);
+
+    uint32 pipelineStatesCount = 0;
+    uint32 rootConstantBufferViewsCount = 0;
+    uint32 rootShaderResourceViewsCount = 0;
+    uint32 inputBuffersCount = 0;
+    for (const auto &command : commands)
+    {
+        switch (command.type)
+        {
+        case CommandType::PipelineState:
+            ++pipelineStatesCount;
+            break;
+        case CommandType::RootConstantBufferView:
+            ++rootConstantBufferViewsCount;
+            break;
+        case CommandType::RootShaderResourceView:
+            ++rootShaderResourceViewsCount;
+            break;
+        case CommandType::VertexBuffer:
+        case CommandType::IndexBuffer:
+            ++inputBuffersCount;
+            break;
+        case CommandType::Material:
+            ++rootConstantBufferViewsCount;
+            break;
+        default:
+            break;
+        }
+    }
+
+    const auto &statistics = cache.GetStatistics();
+    CHECK_EQUAL(statistics.pipelineStates + statistics.skippedPipelineStates, pipelineStatesCount);
+    CHECK_EQUAL(statistics.rootConstantBufferViews + statistics.skippedRootConstantBufferViews, rootConstantBufferViewsCount);
+    CHECK_EQUAL(statistics.rootShaderResourceViews + statistics.skippedRootShaderResourceViews, rootShaderResourceViewsCount);
+    CHECK_EQUAL(statistics.inputBuffers + statistics.skippedInputBuffers, inputBuffersCount);
+    CHECK(statistics.skippedPipelineStates > 0);
+    CHECK(statistics.skippedRootConstantBufferViews > 0);
+    CHECK(statistics.skippedRootShaderResourceViews > 0);
+    CHECK(statistics.skippedInputBuffers > 0);
+    CHECK_EQUAL(statistics.skippedDescriptorTables, skippedTablesCount);
+    CHECK(skippedTablesCount > 0);
+
+    // Only the command list sees the tables it stages, the cache counts them when they are committed.
+    CHECK_EQUAL(statistics.descriptorTables, 0);
+    cache.AddDescriptorTables(3);
+    CHECK_EQUAL(cache.GetStatistics().descriptorTables, 3);
+
+    PassCommandStatistics total;
+    total += statistics;
+    total += statistics;
+    CHECK_EQUAL(total.skippedInputBuffers, 2 * statistics.skippedInputBuffers);
+    CHECK_EQUAL(total.descriptorTables, 6);
+}
+
+TEST_CASE("A material is bound again after its root parameter was overwritten")
+{
+    Scene::Material materials[2];
+
+    PassStateCache cache;
+    CHECK(cache.SetRootSignature("Forward"));
+    CHECK(cache.SetMaterial(&materials[0]));
+    cache.SetMaterialTablesCount(3);
+
+    CHECK(!cache.SetMaterial(&materials[0]));
+    CHECK_EQUAL(cache.GetStatistics().skippedDescriptorTables, 3);
+
+    // A uniform written over the material one.
+    CHECK(cache.SetRootConstantBufferView(PassStateCache::MaterialRootParameterIndex, GetAddress(0)));
+    CHECK(cache.SetMaterial(&materials[0]));
+
+    // The material uniform replaced the written one, so writing it again is not redundant.
+    CHECK(cache.SetRootConstantBufferView(PassStateCache::MaterialRootParameterIndex, GetAddress(0)));
+
+    // Nor is anything bound before a root signature change.
+    CHECK(cache.SetMaterial(&materials[1]));
+    CHECK(cache.SetRootSignature("Depth"));
+    CHECK(cache.SetMaterial(&materials[1]));
+    CHECK(!cache.SetRootSignature("Depth"));
+    CHECK(!cache.SetMaterial(&materials[1]));
+}
+
+TEST_CASE("State survives a root signature change, root arguments don't")
+{
+    PassStateCache cache;
+    CHECK(cache.SetRootSignature("Forward"));
+    CHECK(cache.SetPipelineState("ForwardCullBack"));
+    CHECK(cache.SetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+    CHECK(cache.SetVertexBuffer(0, GetAddress(0)));
+    CHECK(cache.SetVertexBuffer(1, GetAddress(0)));
+    CHECK(cache.SetIndexBuffer(GetAddress(1)));
+    CHECK(cache.SetRootConstantBufferView(1, GetAddress(2)));
+    CHECK(cache.SetRootShaderResourceView(3, GetAddress(2)));
+
+    CHECK(cache.SetRootSignature("Depth"));
+    CHECK(!cache.SetPipelineState("ForwardCullBack"));
+    CHECK(!cache.SetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+    CHECK(!cache.SetVertexBuffer(0, GetAddress(0)));
+    CHECK(!cache.SetVertexBuffer(1, GetAddress(0)));
+    CHECK(!cache.SetIndexBuffer(GetAddress(1)));
+    CHECK(cache.SetRootConstantBufferView(1, GetAddress(2)));
+    CHECK(cache.SetRootShaderResourceView(3, GetAddress(2)));
+
+    CHECK(cache.SetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP));
+    CHECK(cache.SetVertexBuffer(1, GetAddress(1)));
+    CHECK(!cache.SetVertexBuffer(0, GetAddress(0)));
+}
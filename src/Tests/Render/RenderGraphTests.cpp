@@ -0,0 +1,619 @@
+#include <TestFramework.h>
+
+#include <Render/RenderGraph.h>
+#include <Render/ResourcePlanner.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+
+using namespace Engine;
+using namespace Engine::Render;
+
+namespace
+{
+    const TextureCreationInfo TextureInfo = {};
+
+    // Position of a pass in the execution order, the passes count when it doesn't run.
+    uint32 GetPosition(const RenderGraph &graph, uint32 pass)
+    {
+        const auto &order = graph.GetExecutionOrder();
+        const auto iter = std::find(order.begin(), order.end(), pass);
+        return iter != order.end() ? static_cast<uint32>(iter - order.begin()) : graph.GetPassesCount();
+    }
+
+    const RenderGraphResource &GetResource(const RenderGraph &graph, const Name &name)
+    {
+        const auto &resources = graph.GetResources();
+        return *std::find_if(resources.begin(), resources.end(), [&name](const RenderGraphResource &resource) { return resource.name == name; });
+    }
+
+    uint32 GetResourceIndex(const RenderGraph &graph, const Name &name)
+    {
+        return static_cast<uint32>(&GetResource(graph, name) - graph.GetResources().data());
+    }
+
+    std::vector<RenderGraphBarrier> GetResourceBarriers(const RenderGraph &graph, uint32 pass, const Name &name)
+    {
+        std::vector<RenderGraphBarrier> barriers;
+        for (const auto &barrier : graph.GetBarriers(pass))
+        {
+            if (graph.GetResources()[barrier.resource].name == name)
+            {
+                barriers.push_back(barrier);
+            }
+        }
+        return barriers;
+    }
+
+    // Replays the barriers of a frame from the state every resource left the previous frame in. Every pass has to find
+    // its resources in the states it uses them in, a split transition has to end before the resource is used again,
+    // and the frame has to end in the states it started from. planners are indexed by pass. Returns the errors count.
+    Size CountBarrierErrors(const RenderGraph &graph, std::span<const ResourcePlanner> planners)
+    {
+        const auto &resources = graph.GetResources();
+
+        std::vector<D3D12_RESOURCE_STATES> states(resources.size());
+        std::vector<bool> isTransitioning(resources.size(), false);
+        for (Size i = 0; i < resources.size(); ++i)
+        {
+            states[i] = resources[i].initialState;
+        }
+
+        Size errorsCount = 0;
+        for (auto pass : graph.GetExecutionOrder())
+        {
+            for (const auto &barrier : graph.GetBarriers(pass))
+            {
+                const uint32 resource = barrier.resource;
+                errorsCount += barrier.stateBefore != states[resource] ? 1 : 0;
+                errorsCount += barrier.stateBefore == barrier.stateAfter ? 1 : 0;
+                errorsCount += isTransitioning[resource] != (barrier.flags == D3D12_RESOURCE_BARRIER_FLAG_END_ONLY) ? 1 : 0;
+
+                isTransitioning[resource] = barrier.flags == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY;
+                if (barrier.flags != D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY)
+                {
+                    states[resource] = barrier.stateAfter;
+                }
+            }
+
+            for (const auto &access : planners[pass].GetResourceAccesses())
+            {
+                const uint32 resource = GetResourceIndex(graph, access.name);
+                errorsCount += isTransitioning[resource] ? 1 : 0;
+                errorsCount += (states[resource] & access.state) != access.state ? 1 : 0;
+            }
+        }
+
+        for (Size i = 0; i < resources.size(); ++i)
+        {
+            errorsCount += isTransitioning[i] || states[i] != resources[i].initialState ? 1 : 0;
+        }
+        return errorsCount;
+    }
+}
+
+TEST_CASE("Passes nothing reads from are culled")
+{
+    RenderGraph graph;
+
+    ResourcePlanner shadows;
+    shadows.NewDepthStencil("Shadow Map", TextureInfo);
+    ResourcePlanner debug;
+    debug.NewRenderTarget("Debug View", TextureInfo);
+    debug.ReadTexture("Shadow Map");
+    ResourcePlanner forward;
+    forward.NewRenderTarget("Scene Color", TextureInfo);
+    forward.ReadTexture("Shadow Map");
+    ResourcePlanner unusedProducer;
+    unusedProducer.NewRenderTarget("Unused Input", TextureInfo);
+    ResourcePlanner unusedConsumer;
+    unusedConsumer.NewRenderTarget("Unused Output", TextureInfo);
+    unusedConsumer.ReadTexture("Unused Input");
+    ResourcePlanner tonemap;
+    tonemap.ReadRenderTarget("Scene Color");
+    tonemap.WriteBackBuffer();
+    ResourcePlanner overlay;
+    overlay.WriteBackBuffer();
+
+    const uint32 shadowsPass = graph.AddPass(shadows);
+    const uint32 debugPass = graph.AddPass(debug);
+    const uint32 forwardPass = graph.AddPass(forward);
+    const uint32 unusedProducerPass = graph.AddPass(unusedProducer);
+    const uint32 unusedConsumerPass = graph.AddPass(unusedConsumer);
+    const uint32 tonemapPass = graph.AddPass(tonemap);
+    const uint32 overlayPass = graph.AddPass(overlay);
+
+    CHECK(graph.Compile());
+
+    // Culling follows producers through several passes, a back buffer pass without inputs still runs.
+    CHECK(!graph.IsCulled(shadowsPass));
+    CHECK(!graph.IsCulled(forwardPass));
+    CHECK(!graph.IsCulled(tonemapPass));
+    CHECK(!graph.IsCulled(overlayPass));
+    CHECK(graph.IsCulled(debugPass));
+    CHECK(graph.IsCulled(unusedProducerPass));
+    CHECK(graph.IsCulled(unusedConsumerPass));
+
+    CHECK(graph.GetExecutionOrder() == std::vector<uint32>({shadowsPass, forwardPass, tonemapPass, overlayPass}));
+
+    // Resources of culled passes are not used and get no barriers.
+    CHECK(!GetResource(graph, "Debug View").IsUsed());
+    CHECK(!GetResource(graph, "Unused Input").IsUsed());
+    CHECK(!GetResource(graph, "Unused Output").IsUsed());
+    CHECK(graph.GetBarriers(debugPass).empty());
+}
+
+TEST_CASE("Producers run before their readers whatever the registration order")
+{
+    RenderGraph graph;
+
+    ResourcePlanner tonemap;
+    tonemap.ReadRenderTarget("Scene Color");
+    tonemap.WriteBackBuffer();
+    ResourcePlanner forward;
+    forward.NewRenderTarget("Scene Color", TextureInfo);
+    forward.NewDepthStencil("Scene Depth", TextureInfo);
+    forward.ReadTexture("Shadow Map");
+    ResourcePlanner sky;
+    sky.WriteRenderTarget("Scene Color");
+    sky.ReadDeptStencil("Scene Depth");
+    ResourcePlanner shadows;
+    shadows.NewDepthStencil("Shadow Map", TextureInfo);
+
+    const uint32 tonemapPass = graph.AddPass(tonemap);
+    const uint32 forwardPass = graph.AddPass(forward);
+    const uint32 skyPass = graph.AddPass(sky);
+    const uint32 shadowsPass = graph.AddPass(shadows);
+
+    // The tonemap read is registered before any write, so it sees the first one and nothing needs the sky.
+    CHECK(graph.Compile());
+    CHECK(graph.GetExecutionOrder() == std::vector<uint32>({shadowsPass, forwardPass, tonemapPass}));
+    CHECK(graph.IsCulled(skyPass));
+
+    // Registered after the sky, the tonemap reads what the sky drew.
+    graph.Reset();
+    const uint32 lateForwardPass = graph.AddPass(forward);
+    const uint32 lateSkyPass = graph.AddPass(sky);
+    const uint32 lateTonemapPass = graph.AddPass(tonemap);
+    const uint32 lateShadowsPass = graph.AddPass(shadows);
+
+    CHECK(graph.Compile());
+    CHECK(graph.GetExecutionOrder() == std::vector<uint32>({lateShadowsPass, lateForwardPass, lateSkyPass, lateTonemapPass}));
+}
+
+TEST_CASE("Reads run before the write that follows them")
+{
+    RenderGraph graph;
+
+    // The blur reads the first version of Color, the composite draws the second on top of it.
+    ResourcePlanner lighting;
+    lighting.NewRenderTarget("Color", TextureInfo);
+    ResourcePlanner blur;
+    blur.ReadTexture("Color");
+    blur.NewRenderTarget("Blurred", TextureInfo);
+    // Reads the first version too, but waits on an input registered last. Only the read orders it before the composite.
+    ResourcePlanner probe;
+    probe.ReadTexture("Color");
+    probe.ReadTexture("Probe Input");
+    probe.NewRenderTarget("Probe", TextureInfo);
+    ResourcePlanner composite;
+    composite.WriteRenderTarget("Color");
+    composite.ReadTexture("Blurred");
+    ResourcePlanner present;
+    present.ReadTexture("Color");
+    present.ReadTexture("Probe");
+    present.WriteBackBuffer();
+    // Registered before the pass creating Luminance, a read before any write sees the first one.
+    ResourcePlanner histogram;
+    histogram.ReadTexture("Luminance");
+    histogram.WriteBackBuffer();
+    ResourcePlanner luminance;
+    luminance.ReadTexture("Color");
+    luminance.NewRenderTarget("Luminance", TextureInfo);
+    ResourcePlanner probeInput;
+    probeInput.NewRenderTarget("Probe Input", TextureInfo);
+
+    const uint32 lightingPass = graph.AddPass(lighting);
+    const uint32 blurPass = graph.AddPass(blur);
+    const uint32 probePass = graph.AddPass(probe);
+    const uint32 compositePass = graph.AddPass(composite);
+    const uint32 presentPass = graph.AddPass(present);
+    const uint32 histogramPass = graph.AddPass(histogram);
+    const uint32 luminancePass = graph.AddPass(luminance);
+    const uint32 probeInputPass = graph.AddPass(probeInput);
+
+    CHECK(graph.Compile());
+    CHECK(GetPosition(graph, lightingPass) < GetPosition(graph, blurPass));
+    CHECK(GetPosition(graph, blurPass) < GetPosition(graph, compositePass));
+    CHECK(GetPosition(graph, probeInputPass) < GetPosition(graph, probePass));
+    CHECK(GetPosition(graph, probePass) < GetPosition(graph, compositePass));
+    CHECK(GetPosition(graph, compositePass) < GetPosition(graph, presentPass));
+    CHECK(GetPosition(graph, luminancePass) < GetPosition(graph, histogramPass));
+
+    // The luminance reads the last write registered before it, the composite one.
+    CHECK(GetPosition(graph, compositePass) < GetPosition(graph, luminancePass));
+    CHECK_EQUAL(graph.GetExecutionOrder().size(), 8);
+}
+
+TEST_CASE("Cycles and missing producers fall back to the registration order")
+{
+    {
+        RenderGraph graph;
+
+        ResourcePlanner first;
+        first.ReadTexture("Cycle B");
+        first.NewRenderTarget("Cycle A", TextureInfo);
+        first.WriteBackBuffer();
+        ResourcePlanner second;
+        second.ReadTexture("Cycle A");
+        second.NewRenderTarget("Cycle B", TextureInfo);
+        ResourcePlanner unused;
+        unused.NewRenderTarget("Cycle C", TextureInfo);
+
+        graph.AddPass(first);
+        graph.AddPass(second);
+        graph.AddPass(unused);
+
+        CHECK(!graph.Compile());
+        CHECK(graph.GetExecutionOrder() == std::vector<uint32>({0, 1, 2}));
+        for (uint32 pass = 0; pass < graph.GetPassesCount(); ++pass)
+        {
+            CHECK(!graph.IsCulled(pass));
+            CHECK(graph.GetBarriers(pass).empty());
+        }
+    }
+
+    {
+        RenderGraph graph;
+
+        ResourcePlanner pass;
+        pass.ReadTexture("Never Written");
+        pass.WriteBackBuffer();
+        graph.AddPass(pass);
+
+        CHECK(!graph.Compile());
+        CHECK(graph.GetExecutionOrder() == std::vector<uint32>({0}));
+    }
+
+    // A resource only drawn on top of has no creation info.
+    {
+        RenderGraph graph;
+
+        ResourcePlanner pass;
+        pass.WriteRenderTarget("Never Created");
+        pass.WriteBackBuffer();
+        graph.AddPass(pass);
+
+        CHECK(!graph.Compile());
+    }
+}
+
+TEST_CASE("Lifetimes span the first and the last pass using a resource")
+{
+    RenderGraph graph;
+
+    ResourcePlanner shadows;
+    shadows.NewDepthStencil("Lifetime Shadow", TextureInfo);
+    ResourcePlanner depth;
+    depth.NewDepthStencil("Lifetime Depth", TextureInfo);
+    ResourcePlanner forward;
+    forward.NewRenderTarget("Lifetime Color", TextureInfo);
+    forward.ReadDeptStencil("Lifetime Depth");
+    forward.ReadTexture("Lifetime Shadow");
+    ResourcePlanner bloom;
+    bloom.NewRenderTarget("Lifetime Bloom", TextureInfo);
+    bloom.ReadTexture("Lifetime Color");
+    ResourcePlanner tonemap;
+    tonemap.ReadTexture("Lifetime Color");
+    tonemap.ReadTexture("Lifetime Bloom");
+    tonemap.WriteBackBuffer();
+
+    graph.AddPass(tonemap);
+    graph.AddPass(bloom);
+    graph.AddPass(forward);
+    graph.AddPass(depth);
+    graph.AddPass(shadows);
+
+    CHECK(graph.Compile());
+    CHECK(graph.GetExecutionOrder() == std::vector<uint32>({3, 4, 2, 1, 0}));
+
+    const auto checkLifetime = [&graph](const Name &name, uint32 firstUse, uint32 lastUse)
+    {
+        const auto &resource = GetResource(graph, name);
+        CHECK_EQUAL(resource.firstUse, firstUse);
+        CHECK_EQUAL(resource.lastUse, lastUse);
+    };
+    checkLifetime("Lifetime Depth", 0, 2);
+    checkLifetime("Lifetime Shadow", 1, 2);
+    checkLifetime("Lifetime Color", 2, 4);
+    checkLifetime("Lifetime Bloom", 3, 4);
+
+    // Resources are left in the state of their last use.
+    CHECK_EQUAL(GetResource(graph, "Lifetime Bloom").initialState, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    CHECK_EQUAL(GetResource(graph, "Lifetime Depth").initialState, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+
+    // Compiling again after a reset starts from scratch.
+    graph.Reset();
+    CHECK_EQUAL(graph.GetPassesCount(), 0);
+    CHECK(graph.GetResources().empty());
+    CHECK(graph.Compile());
+    CHECK(graph.GetExecutionOrder().empty());
+}
+
+TEST_CASE("Random graphs run producers first, cull what the outputs don't reach and track lifetimes")
+{
+    std::mt19937 random(21);
+
+    for (int iteration = 0; iteration < 200; ++iteration)
+    {
+        std::uniform_int_distribution<uint32> passesCountDistribution(1, 40);
+        const uint32 passesCount = passesCountDistribution(random);
+
+        // Pass i of the dependency order creates resource i and reads resources of passes before it.
+        std::vector<std::vector<uint32>> reads(passesCount);
+        std::vector<bool> writesBackBuffer(passesCount);
+        std::uniform_real_distribution<float32> unit(0.0f, 1.0f);
+        for (uint32 pass = 0; pass < passesCount; ++pass)
+        {
+            for (uint32 producer = 0; producer < pass; ++producer)
+            {
+                if (unit(random) < 3.0f / passesCount)
+                {
+                    reads[pass].push_back(producer);
+                }
+            }
+            writesBackBuffer[pass] = unit(random) < 0.15f;
+        }
+
+        const auto getName = [iteration](uint32 resource)
+        {
+            return Name("Random " + std::to_string(iteration) + " " + std::to_string(resource));
+        };
+
+        // Registered in a random order, so the graph has to sort them.
+        std::vector<uint32> registrationOrder(passesCount);
+        std::iota(registrationOrder.begin(), registrationOrder.end(), 0);
+        std::shuffle(registrationOrder.begin(), registrationOrder.end(), random);
+
+        RenderGraph graph;
+        std::vector<uint32> passIndices(passesCount);
+        std::vector<ResourcePlanner> planners(passesCount);
+        for (auto pass : registrationOrder)
+        {
+            auto &planner = planners[graph.GetPassesCount()];
+            planner.NewRenderTarget(getName(pass), TextureInfo);
+            for (auto producer : reads[pass])
+            {
+                planner.ReadTexture(getName(producer));
+            }
+            if (writesBackBuffer[pass])
+            {
+                planner.WriteBackBuffer();
+            }
+            passIndices[pass] = graph.AddPass(planner);
+        }
+
+        CHECK(graph.Compile());
+
+        // Passes writing the back buffer and everything they read from, directly or not, run.
+        std::vector<bool> isLive(writesBackBuffer);
+        for (uint32 pass = passesCount; pass-- > 0;)
+        {
+            if (isLive[pass])
+            {
+                for (auto producer : reads[pass])
+                {
+                    isLive[producer] = true;
+                }
+            }
+        }
+
+        Size mismatchesCount = 0;
+        for (uint32 pass = 0; pass < passesCount; ++pass)
+        {
+            const uint32 index = passIndices[pass];
+            mismatchesCount += graph.IsCulled(index) == isLive[pass] ? 1 : 0;
+            mismatchesCount += (GetPosition(graph, index) < passesCount) != isLive[pass] ? 1 : 0;
+
+            for (auto producer : reads[pass])
+            {
+                mismatchesCount += isLive[pass] && GetPosition(graph, passIndices[producer]) >= GetPosition(graph, index) ? 1 : 0;
+            }
+
+            // A resource lives from its producer to its last live reader.
+            const auto &resource = GetResource(graph, getName(pass));
+            if (!isLive[pass])
+            {
+                mismatchesCount += resource.IsUsed() ? 1 : 0;
+                continue;
+            }
+
+            uint32 lastUse = GetPosition(graph, index);
+            for (uint32 reader = pass + 1; reader < passesCount; ++reader)
+            {
+                if (isLive[reader] && std::find(reads[reader].begin(), reads[reader].end(), pass) != reads[reader].end())
+                {
+                    lastUse = std::max(lastUse, GetPosition(graph, passIndices[reader]));
+                }
+            }
+            mismatchesCount += resource.firstUse != GetPosition(graph, index) ? 1 : 0;
+            mismatchesCount += resource.lastUse != lastUse ? 1 : 0;
+        }
+
+        CHECK_EQUAL(mismatchesCount, 0);
+        CHECK_EQUAL(CountBarrierErrors(graph, planners), 0);
+    }
+}
+
+TEST_CASE("Reads following each other share one transition")
+{
+    RenderGraph graph;
+
+    ResourcePlanner lighting;
+    lighting.NewRenderTarget("Merged Color", TextureInfo);
+    ResourcePlanner bloom;
+    bloom.ReadTexture("Merged Color");
+    bloom.NewRenderTarget("Merged Bloom", TextureInfo);
+    ResourcePlanner histogram;
+    histogram.ReadTexture("Merged Color");
+    histogram.NewRenderTarget("Merged Histogram", TextureInfo);
+    ResourcePlanner tonemap;
+    tonemap.ReadTexture("Merged Color");
+    tonemap.ReadTexture("Merged Bloom");
+    tonemap.ReadTexture("Merged Histogram");
+    tonemap.WriteBackBuffer();
+
+    const std::vector<ResourcePlanner> planners = {lighting, bloom, histogram, tonemap};
+    for (const auto &planner : planners)
+    {
+        graph.AddPass(planner);
+    }
+
+    CHECK(graph.Compile());
+    CHECK(graph.GetExecutionOrder() == std::vector<uint32>({0, 1, 2, 3}));
+    CHECK_EQUAL(CountBarrierErrors(graph, planners), 0);
+
+    // Back to the render target state the lighting draws in, then one transition for all three reads.
+    const auto lightingBarriers = GetResourceBarriers(graph, 0, "Merged Color");
+    CHECK_EQUAL(lightingBarriers.size(), 1);
+    CHECK_EQUAL(lightingBarriers[0].stateBefore, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    CHECK_EQUAL(lightingBarriers[0].stateAfter, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+    const auto bloomBarriers = GetResourceBarriers(graph, 1, "Merged Color");
+    CHECK_EQUAL(bloomBarriers.size(), 1);
+    CHECK_EQUAL(bloomBarriers[0].stateAfter, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    CHECK_EQUAL(bloomBarriers[0].flags, D3D12_RESOURCE_BARRIER_FLAG_NONE);
+
+    CHECK(GetResourceBarriers(graph, 2, "Merged Color").empty());
+    CHECK(GetResourceBarriers(graph, 3, "Merged Color").empty());
+    CHECK_EQUAL(GetResource(graph, "Merged Color").initialState, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+
+    // Depth tests keep the depth writable, so they don't merge with the sampling reads around them.
+    graph.Reset();
+
+    ResourcePlanner depth;
+    depth.NewDepthStencil("Merged Depth", TextureInfo);
+    ResourcePlanner sky;
+    sky.ReadDeptStencil("Merged Depth");
+    sky.NewRenderTarget("Merged Sky", TextureInfo);
+    ResourcePlanner fog;
+    fog.ReadTexture("Merged Depth");
+    fog.ReadTexture("Merged Sky");
+    fog.NewRenderTarget("Merged Fog", TextureInfo);
+    ResourcePlanner particles;
+    particles.ReadDeptStencil("Merged Depth");
+    particles.ReadTexture("Merged Fog");
+    particles.WriteBackBuffer();
+
+    const std::vector<ResourcePlanner> depthPlanners = {depth, sky, fog, particles};
+    for (const auto &planner : depthPlanners)
+    {
+        graph.AddPass(planner);
+    }
+
+    CHECK(graph.Compile());
+    CHECK_EQUAL(CountBarrierErrors(graph, depthPlanners), 0);
+
+    CHECK(GetResourceBarriers(graph, 1, "Merged Depth").empty());
+    const auto fogBarriers = GetResourceBarriers(graph, 2, "Merged Depth");
+    const auto particlesBarriers = GetResourceBarriers(graph, 3, "Merged Depth");
+    CHECK(fogBarriers.size() == 1 && fogBarriers[0].stateAfter == D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    CHECK(particlesBarriers.size() == 1 && particlesBarriers[0].stateAfter == D3D12_RESOURCE_STATE_DEPTH_WRITE);
+}
+
+TEST_CASE("Transitions of resources idle between two passes are split")
+{
+    RenderGraph graph;
+
+    ResourcePlanner shadows;
+    shadows.NewDepthStencil("Split Shadow", TextureInfo);
+    ResourcePlanner depth;
+    depth.NewDepthStencil("Split Depth", TextureInfo);
+    ResourcePlanner forward;
+    forward.NewRenderTarget("Split Color", TextureInfo);
+    forward.ReadDeptStencil("Split Depth");
+    forward.ReadTexture("Split Shadow");
+    forward.WriteBackBuffer();
+
+    const std::vector<ResourcePlanner> planners = {shadows, depth, forward};
+    for (const auto &planner : planners)
+    {
+        graph.AddPass(planner);
+    }
+
+    CHECK(graph.Compile());
+    CHECK(graph.GetExecutionOrder() == std::vector<uint32>({0, 1, 2}));
+    CHECK_EQUAL(CountBarrierErrors(graph, planners), 0);
+
+    // The shadow map is idle while the depth pass runs, its transition begins there and ends before the forward pass.
+    const auto beginBarriers = GetResourceBarriers(graph, 1, "Split Shadow");
+    const auto endBarriers = GetResourceBarriers(graph, 2, "Split Shadow");
+    CHECK_EQUAL(beginBarriers.size(), 1);
+    CHECK_EQUAL(endBarriers.size(), 1);
+    if (beginBarriers.size() == 1 && endBarriers.size() == 1)
+    {
+        CHECK_EQUAL(beginBarriers[0].flags, D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY);
+        CHECK_EQUAL(endBarriers[0].flags, D3D12_RESOURCE_BARRIER_FLAG_END_ONLY);
+        CHECK_EQUAL(beginBarriers[0].stateBefore, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+        CHECK_EQUAL(beginBarriers[0].stateAfter, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+        CHECK_EQUAL(endBarriers[0].stateBefore, beginBarriers[0].stateBefore);
+        CHECK_EQUAL(endBarriers[0].stateAfter, beginBarriers[0].stateAfter);
+    }
+
+    // Depth is used in the same state by its two passes and needs no transition.
+    for (uint32 pass = 0; pass < graph.GetPassesCount(); ++pass)
+    {
+        CHECK(GetResourceBarriers(graph, pass, "Split Depth").empty());
+    }
+}
+
+TEST_CASE("The first transition of a resource in the frame is never split")
+{
+    RenderGraph graph;
+
+    // The color is idle from the start of the frame to the lighting, but its memory may belong to another resource until then.
+    ResourcePlanner shadows;
+    shadows.NewDepthStencil("First Shadow", TextureInfo);
+    ResourcePlanner culling;
+    culling.NewRenderTarget("First Visibility", TextureInfo);
+    ResourcePlanner lighting;
+    lighting.NewRenderTarget("First Color", TextureInfo);
+    lighting.ReadTexture("First Shadow");
+    lighting.ReadTexture("First Visibility");
+    ResourcePlanner tonemap;
+    tonemap.ReadTexture("First Color");
+    tonemap.WriteBackBuffer();
+
+    const std::vector<ResourcePlanner> planners = {shadows, culling, lighting, tonemap};
+    for (const auto &planner : planners)
+    {
+        graph.AddPass(planner);
+    }
+
+    CHECK(graph.Compile());
+    CHECK_EQUAL(CountBarrierErrors(graph, planners), 0);
+
+    for (uint32 pass = 0; pass < graph.GetPassesCount(); ++pass)
+    {
+        for (const auto &barrier : graph.GetBarriers(pass))
+        {
+            const auto &resource = graph.GetResources()[barrier.resource];
+            if (GetPosition(graph, pass) == resource.firstUse)
+            {
+                CHECK_EQUAL(barrier.flags, D3D12_RESOURCE_BARRIER_FLAG_NONE);
+            }
+        }
+    }
+
+    const auto colorBarriers = GetResourceBarriers(graph, 2, "First Color");
+    CHECK_EQUAL(colorBarriers.size(), 1);
+    CHECK(colorBarriers.size() == 1 && colorBarriers[0].flags == D3D12_RESOURCE_BARRIER_FLAG_NONE);
+    CHECK(GetResourceBarriers(graph, 0, "First Color").empty());
+    CHECK(GetResourceBarriers(graph, 1, "First Color").empty());
+
+    // The shadow map does get a split transition later, while the culling runs.
+    const auto shadowBarriers = GetResourceBarriers(graph, 1, "First Shadow");
+    CHECK(shadowBarriers.size() == 1 && shadowBarriers[0].flags == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY);
+}
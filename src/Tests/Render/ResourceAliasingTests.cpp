@@ -0,0 +1,201 @@
+#include <TestFramework.h>
+
+#include <MathUtils.h>
+#include <Render/ResourceAliasing.h>
+
+#include <algorithm>
+#include <random>
+
+using namespace Engine;
+using namespace Engine::Render;
+
+namespace
+{
+    constexpr uint64 KB = 1024;
+    constexpr uint64 MB = 1024 * KB;
+
+    AliasedResourceRequest CreateRequest(uint64 size, uint32 firstUse, uint32 lastUse, uint64 alignment = 64 * KB)
+    {
+        return {size, alignment, firstUse, lastUse};
+    }
+
+    bool AreAliveTogether(const AliasedResourceRequest &a, const AliasedResourceRequest &b)
+    {
+        return a.firstUse <= b.lastUse && b.firstUse <= a.lastUse;
+    }
+
+    bool AreOverlapping(const AliasedResourcesLayout &layout, std::span<const AliasedResourceRequest> requests, Size a, Size b)
+    {
+        return layout.offsets[a] < layout.offsets[b] + requests[b].size && layout.offsets[b] < layout.offsets[a] + requests[a].size;
+    }
+
+    // Resources alive during the same pass never share memory, offsets keep the alignment and the flags and sizes
+    // match the layout. Returns the largest memory alive during one pass, the lower bound of any heap.
+    uint64 CheckLayout(std::span<const AliasedResourceRequest> requests, const AliasedResourcesLayout &layout)
+    {
+        CHECK_EQUAL(layout.offsets.size(), requests.size());
+        CHECK_EQUAL(layout.isAliased.size(), requests.size());
+
+        uint64 heapSize = 0;
+        uint64 naiveSize = 0;
+        Size conflictsCount = 0;
+        for (Size a = 0; a < requests.size(); ++a)
+        {
+            CHECK_EQUAL(layout.offsets[a] % requests[a].alignment, 0);
+            heapSize = std::max(heapSize, layout.offsets[a] + requests[a].size);
+            naiveSize += Math::AlignUp(requests[a].size, requests[a].alignment);
+
+            bool isAliased = false;
+            for (Size b = 0; b < requests.size(); ++b)
+            {
+                if (a != b && AreOverlapping(layout, requests, a, b))
+                {
+                    isAliased = true;
+                    conflictsCount += AreAliveTogether(requests[a], requests[b]) ? 1 : 0;
+                }
+            }
+            CHECK_EQUAL(layout.isAliased[a], isAliased);
+        }
+
+        CHECK_EQUAL(conflictsCount, 0);
+        CHECK_EQUAL(layout.heapSize, heapSize);
+        CHECK_EQUAL(layout.naiveSize, naiveSize);
+
+        uint32 lastPass = 0;
+        for (const auto &request : requests)
+        {
+            lastPass = std::max(lastPass, request.lastUse);
+        }
+
+        uint64 peakSize = 0;
+        for (uint32 pass = 0; pass <= lastPass && !requests.empty(); ++pass)
+        {
+            uint64 aliveSize = 0;
+            for (const auto &request : requests)
+            {
+                aliveSize += (request.firstUse <= pass && pass <= request.lastUse) ? request.size : 0;
+            }
+            peakSize = std::max(peakSize, aliveSize);
+        }
+        return peakSize;
+    }
+}
+
+TEST_CASE("Resources alive together never share memory")
+{
+    std::mt19937 random(22);
+    std::uniform_int_distribution<Size> requestsCount(0, 40);
+    std::uniform_int_distribution<uint32> pass(0, 20);
+    std::uniform_int_distribution<uint64> size(1, 64 * MB);
+    std::uniform_int_distribution<int> alignmentShift(12, 22);
+
+    AliasedResourcesLayout layout;
+    for (int iteration = 0; iteration < 500; ++iteration)
+    {
+        std::vector<AliasedResourceRequest> requests(requestsCount(random));
+        for (auto &request : requests)
+        {
+            const uint32 firstUse = pass(random);
+            const uint32 lastUse = pass(random);
+            request = CreateRequest(size(random), std::min(firstUse, lastUse), std::max(firstUse, lastUse), uint64(1) << alignmentShift(random));
+        }
+
+        PackAliasedResources(requests, layout);
+        const uint64 peakSize = CheckLayout(requests, layout);
+
+        CHECK(layout.heapSize >= peakSize);
+    }
+}
+
+TEST_CASE("Resources used one after another share the same memory")
+{
+    // A chain of passes each reading the previous output, only two textures are alive at a time.
+    std::vector<AliasedResourceRequest> requests;
+    for (uint32 pass = 0; pass < 8; ++pass)
+    {
+        requests.push_back(CreateRequest(8 * MB, pass, pass + 1));
+    }
+
+    AliasedResourcesLayout layout;
+    PackAliasedResources(requests, layout);
+    CheckLayout(requests, layout);
+
+    CHECK_EQUAL(layout.heapSize, 16 * MB);
+    CHECK_EQUAL(layout.naiveSize, 64 * MB);
+    for (Size i = 0; i < requests.size(); ++i)
+    {
+        CHECK_EQUAL(layout.offsets[i], (i % 2) * 8 * MB);
+        CHECK(layout.isAliased[i]);
+    }
+}
+
+TEST_CASE("Resources alive in the same pass are stacked, largest first")
+{
+    const std::vector<AliasedResourceRequest> requests = {
+        CreateRequest(4 * MB, 0, 5),
+        CreateRequest(8 * MB, 1, 4),
+        CreateRequest(1 * MB, 2, 2),
+        // Lifetimes include both ends, this one meets the first in pass 5 but takes the memory of the second.
+        CreateRequest(2 * MB, 5, 7),
+    };
+
+    AliasedResourcesLayout layout;
+    PackAliasedResources(requests, layout);
+    CheckLayout(requests, layout);
+
+    CHECK_EQUAL(layout.heapSize, 13 * MB);
+    CHECK(layout.isAliased == std::vector<bool>({false, true, false, true}));
+
+    // Largest first, each at the lowest free offset.
+    CHECK_EQUAL(layout.offsets[1], 0);
+    CHECK_EQUAL(layout.offsets[0], 8 * MB);
+    CHECK_EQUAL(layout.offsets[3], 0);
+    CHECK_EQUAL(layout.offsets[2], 12 * MB);
+}
+
+TEST_CASE("Small resources fill the gaps between larger ones")
+{
+    // The large resources leave a 4 MB hole between them while the small ones live.
+    const std::vector<AliasedResourceRequest> requests = {
+        CreateRequest(16 * MB, 0, 1),
+        CreateRequest(8 * MB, 0, 9),
+        CreateRequest(12 * MB, 2, 9),
+        CreateRequest(2 * MB, 4, 5),
+        CreateRequest(2 * MB, 3, 6),
+        CreateRequest(3 * MB, 7, 8),
+    };
+
+    AliasedResourcesLayout layout;
+    PackAliasedResources(requests, layout);
+    CheckLayout(requests, layout);
+
+    CHECK_EQUAL(layout.offsets[0], 0);
+    CHECK_EQUAL(layout.offsets[1], 16 * MB);
+    CHECK_EQUAL(layout.offsets[2], 0);
+    CHECK_EQUAL(layout.offsets[3], 12 * MB);
+    CHECK_EQUAL(layout.offsets[4], 14 * MB);
+    CHECK_EQUAL(layout.offsets[5], 12 * MB);
+    CHECK_EQUAL(layout.heapSize, 24 * MB);
+
+    // The last request fits the 3 MB gap between 5 MB and 8 MB, unless its alignment moves it past the gap end.
+    for (auto [alignment, offset] : {std::pair{64 * KB, 5 * MB}, {4 * MB, 12 * MB}})
+    {
+        const std::vector<AliasedResourceRequest> gapRequests = {
+            CreateRequest(8 * MB, 0, 0),
+            CreateRequest(3 * MB + 512 * KB, 0, 3),
+            CreateRequest(5 * MB, 2, 3),
+            CreateRequest(3 * MB, 2, 3, alignment),
+        };
+        PackAliasedResources(gapRequests, layout);
+        CheckLayout(gapRequests, layout);
+
+        CHECK_EQUAL(layout.offsets[1], 8 * MB);
+        CHECK_EQUAL(layout.offsets[2], 0);
+        CHECK_EQUAL(layout.offsets[3], offset);
+    }
+
+    PackAliasedResources({}, layout);
+    CHECK(layout.offsets.empty());
+    CHECK_EQUAL(layout.heapSize, 0);
+    CHECK_EQUAL(layout.naiveSize, 0);
+}
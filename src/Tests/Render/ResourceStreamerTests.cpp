@@ -0,0 +1,223 @@
+#include <TestFramework.h>
+
+#include <Render/ResourceStreamer.h>
+#include <Memory/Buffer.h>
+
+#include <algorithm>
+#include <random>
+
+using namespace Engine;
+using namespace Engine::Render;
+
+namespace
+{
+    // Stands in for the copy queue: fences complete only when the test says so and every batch
+    // holds one of a fixed number of staging buffers until the streamer completes it.
+    class FakeCopyQueue : public StreamingCopyQueue
+    {
+    public:
+        struct Submission
+        {
+            uint64 fenceValue = 0;
+            std::vector<StreamingRequest> requests;
+            Size batchSize = 0;
+        };
+
+    public:
+        FakeCopyQueue(Size stagingBuffersCount) : freeStagingBuffersCount(stagingBuffersCount) {}
+
+        uint64 Submit(const std::vector<StreamingRequest> &batch, Size batchSize) override
+        {
+            CHECK(freeStagingBuffersCount > 0);
+            --freeStagingBuffersCount;
+
+            submissions.push_back({++lastFenceValue, batch, batchSize});
+            return lastFenceValue;
+        }
+
+        bool IsFenceCompleted(uint64 fenceValue) override
+        {
+            return fenceValue <= completedFenceValue;
+        }
+
+        void Complete(uint64 fenceValue) override
+        {
+            CHECK(fenceValue <= completedFenceValue);
+            CHECK_EQUAL(fenceValue, lastPublishedFenceValue + 1);
+
+            lastPublishedFenceValue = fenceValue;
+            ++freeStagingBuffersCount;
+        }
+
+    public:
+        std::vector<Submission> submissions;
+        Size freeStagingBuffersCount;
+        uint64 lastFenceValue = 0;
+        uint64 completedFenceValue = 0;
+        uint64 lastPublishedFenceValue = 0;
+    };
+
+    StreamingRequest CreateRequest(Size sizeInBytes)
+    {
+        StreamingRequest request;
+        request.buffer = MakeShared<Memory::Buffer>(L"Streamed Buffer");
+        request.sizeInBytes = sizeInBytes;
+        return request;
+    }
+
+    const dx::XMVECTOR Eye = dx::XMVectorZero();
+}
+
+TEST_CASE("A batch never exceeds the frame budget unless a single request does")
+{
+    ResourceStreamer streamer(100, 8);
+    FakeCopyQueue copyQueue(8);
+
+    for (Size size : {40, 40, 40, 30, 250, 10})
+    {
+        streamer.Enqueue(CreateRequest(size));
+    }
+    CHECK_EQUAL(streamer.GetPendingCount(), 6);
+    CHECK_EQUAL(streamer.GetPendingBytes(), 410);
+
+    Size submittedBytes = 0;
+    for (int frame = 0; frame < 10 && streamer.GetPendingCount() > 0; ++frame)
+    {
+        streamer.Update(copyQueue, Eye);
+
+        const auto &submission = copyQueue.submissions.back();
+        Size batchSize = 0;
+        for (const auto &request : submission.requests)
+        {
+            batchSize += request.sizeInBytes;
+        }
+
+        CHECK_EQUAL(submission.batchSize, batchSize);
+        CHECK(batchSize <= 100 || submission.requests.size() == 1);
+        submittedBytes += batchSize;
+    }
+
+    CHECK_EQUAL(streamer.GetPendingCount(), 0);
+    CHECK_EQUAL(streamer.GetPendingBytes(), 0);
+    CHECK_EQUAL(submittedBytes, 410);
+}
+
+TEST_CASE("Requests stream by distance to the eye, unplaced requests first")
+{
+    ResourceStreamer streamer(1, 64);
+    FakeCopyQueue copyQueue(64);
+
+    std::vector<float32> distances(20);
+    for (Size i = 0; i < distances.size(); ++i)
+    {
+        distances[i] = 1.0f + i;
+    }
+    std::shuffle(distances.begin(), distances.end(), std::mt19937(10));
+
+    std::vector<std::pair<const Memory::Resource *, float32>> expected;
+    for (float32 distance : distances)
+    {
+        auto request = CreateRequest(1);
+        expected.emplace_back(request.buffer.get(), distance);
+
+        // Only the closest location of a resource used in several places counts.
+        streamer.Enqueue(request, {0.0f, 0.0f, distance * 10.0f});
+        streamer.Enqueue(request, {distance, 0.0f, 0.0f});
+        streamer.Enqueue(request, {0.0f, -distance * 2.0f, 0.0f});
+    }
+
+    auto unplaced = CreateRequest(1);
+    streamer.Enqueue(unplaced, {0.0f, 0.5f, 0.0f});
+    streamer.Enqueue(unplaced);
+    expected.emplace_back(unplaced.buffer.get(), 0.0f);
+
+    std::sort(expected.begin(), expected.end(), [](const auto &a, const auto &b) { return a.second < b.second; });
+
+    while (streamer.GetPendingCount() > 0)
+    {
+        streamer.Update(copyQueue, Eye);
+    }
+
+    CHECK_EQUAL(copyQueue.submissions.size(), expected.size());
+    for (Size i = 0; i < expected.size() && i < copyQueue.submissions.size(); ++i)
+    {
+        CHECK_EQUAL(copyQueue.submissions[i].requests.size(), 1);
+        CHECK(copyQueue.submissions[i].requests.front().buffer.get() == expected[i].first);
+    }
+}
+
+TEST_CASE("Staging buffers are reused only after their batch fence completes")
+{
+    constexpr Size MaxBatchesInFlight = 2;
+
+    ResourceStreamer streamer(10, MaxBatchesInFlight);
+    FakeCopyQueue copyQueue(MaxBatchesInFlight);
+
+    std::vector<StreamingRequest> requests;
+    for (int i = 0; i < 6; ++i)
+    {
+        requests.push_back(CreateRequest(10));
+        streamer.Enqueue(requests.back());
+    }
+
+    // Without completed fences the streamer stops at the batches in flight limit.
+    for (int frame = 0; frame < 5; ++frame)
+    {
+        streamer.Update(copyQueue, Eye);
+    }
+    CHECK_EQUAL(copyQueue.submissions.size(), MaxBatchesInFlight);
+    CHECK_EQUAL(copyQueue.freeStagingBuffersCount, 0);
+    CHECK_EQUAL(copyQueue.lastPublishedFenceValue, 0);
+
+    // Requests already in flight are not queued again.
+    streamer.Enqueue(copyQueue.submissions.front().requests.front());
+    CHECK_EQUAL(streamer.GetPendingCount(), 4);
+
+    // Completing the first fence publishes that batch only and frees one staging buffer for the next one.
+    copyQueue.completedFenceValue = 1;
+    streamer.Update(copyQueue, Eye);
+    CHECK_EQUAL(copyQueue.lastPublishedFenceValue, 1);
+    CHECK_EQUAL(copyQueue.submissions.size(), 3);
+    CHECK_EQUAL(copyQueue.freeStagingBuffersCount, 0);
+
+    // Fences completing out of step with the frames publish every finished batch in order.
+    copyQueue.completedFenceValue = 3;
+    streamer.Update(copyQueue, Eye);
+    CHECK_EQUAL(copyQueue.lastPublishedFenceValue, 3);
+    CHECK_EQUAL(copyQueue.submissions.size(), 4);
+
+    while (!streamer.IsIdle())
+    {
+        copyQueue.completedFenceValue = copyQueue.lastFenceValue;
+        streamer.Update(copyQueue, Eye);
+    }
+
+    CHECK_EQUAL(copyQueue.submissions.size(), requests.size());
+    CHECK_EQUAL(copyQueue.lastPublishedFenceValue, copyQueue.lastFenceValue);
+    CHECK_EQUAL(copyQueue.freeStagingBuffersCount, MaxBatchesInFlight);
+
+    std::vector<const Memory::Resource *> submitted;
+    for (const auto &submission : copyQueue.submissions)
+    {
+        for (const auto &request : submission.requests)
+        {
+            submitted.push_back(request.buffer.get());
+        }
+    }
+    std::sort(submitted.begin(), submitted.end());
+    CHECK(std::adjacent_find(submitted.begin(), submitted.end()) == submitted.end());
+}
+
+TEST_CASE("Enqueuing a resource twice keeps a single pending request")
+{
+    ResourceStreamer streamer(100, 1);
+
+    auto request = CreateRequest(64);
+    streamer.Enqueue(request, {1.0f, 2.0f, 3.0f});
+    streamer.Enqueue(request, {4.0f, 5.0f, 6.0f});
+    streamer.Enqueue(request);
+
+    CHECK_EQUAL(streamer.GetPendingCount(), 1);
+    CHECK_EQUAL(streamer.GetPendingBytes(), 64);
+    CHECK(!streamer.IsIdle());
+}
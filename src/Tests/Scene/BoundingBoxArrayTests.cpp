@@ -0,0 +1,213 @@
+#include <TestFramework.h>
+
+#include <MathUtils.h>
+#include <Scene/BoundingBoxArray.h>
+
+#include <algorithm>
+#include <random>
+
+using namespace Engine;
+using namespace Engine::Scene;
+
+namespace
+{
+    dx::BoundingFrustum CreateFrustum(std::mt19937 &random, const dx::XMFLOAT3 &origin)
+    {
+        std::uniform_real_distribution<float32> angle(-Math::PI, Math::PI);
+        std::uniform_real_distribution<float32> fov(0.3f, 2.0f);
+
+        const auto projection = dx::XMMatrixPerspectiveFovLH(fov(random), fov(random), 0.1f, 200.0f);
+        const auto rotation = dx::XMMatrixRotationRollPitchYaw(angle(random), angle(random), angle(random));
+        const auto world = dx::XMMatrixMultiply(rotation, dx::XMMatrixTranslation(origin.x, origin.y, origin.z));
+
+        dx::BoundingFrustum frustum(projection);
+        dx::BoundingFrustum result;
+        frustum.Transform(result, world);
+        return result;
+    }
+
+    dx::BoundingOrientedBox CreateOrientedBox(std::mt19937 &random, const dx::XMFLOAT3 &center)
+    {
+        std::uniform_real_distribution<float32> angle(-Math::PI, Math::PI);
+        std::uniform_real_distribution<float32> extent(1.0f, 60.0f);
+
+        dx::XMFLOAT4 orientation;
+        dx::XMStoreFloat4(&orientation, dx::XMQuaternionRotationMatrix(dx::XMMatrixRotationRollPitchYaw(angle(random), angle(random), angle(random))));
+
+        return dx::BoundingOrientedBox(center, {extent(random), extent(random), extent(random)}, orientation);
+    }
+
+    // Boxes with a corner, an edge or a face placed on a point of the volume surface, nudged by less than
+    // the batched test tolerance so they land on both sides of it. These are the boxes the fast path has to defer.
+    template <Size CornersCount>
+    std::vector<dx::BoundingBox> CreateBoundaryBoxes(std::mt19937 &random, const dx::XMFLOAT3 (&corners)[CornersCount], Size count)
+    {
+        std::uniform_int_distribution<Size> corner(0, CornersCount - 1);
+        std::uniform_real_distribution<float32> unit(0.0f, 1.0f);
+        std::uniform_real_distribution<float32> extent(0.01f, 20.0f);
+        std::uniform_real_distribution<float32> nudge(-2e-4f, 2e-4f);
+        std::uniform_int_distribution<int> side(0, 2);
+
+        std::vector<dx::BoundingBox> boxes(count);
+        for (auto &box : boxes)
+        {
+            // A point on a corner, on an edge or anywhere between two corners.
+            const auto &a = corners[corner(random)];
+            const auto &b = corners[corner(random)];
+            const float32 t = (unit(random) < 0.3f) ? 0.0f : unit(random);
+            const dx::XMFLOAT3 point = {a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t};
+
+            box.Extents = {extent(random), extent(random), extent(random)};
+
+            // Every axis puts the point on the lower face, the upper face or the middle of the box.
+            // A third of the boxes touch the point exactly, the others are nudged relative to the coordinates.
+            const float32 *extents = &box.Extents.x;
+            const bool isNudged = unit(random) > 0.3f;
+            float32 center[3];
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                const float32 coordinate = (&point.x)[axis];
+                const float32 offset = (side(random) - 1) * extents[axis];
+                center[axis] = coordinate + offset + (isNudged ? nudge(random) * (1.0f + std::abs(coordinate) + extents[axis]) : 0.0f);
+            }
+            box.Center = {center[0], center[1], center[2]};
+        }
+        return boxes;
+    }
+
+    std::vector<dx::BoundingBox> CreateRandomBoxes(std::mt19937 &random, const dx::XMFLOAT3 &origin, float32 range, Size count)
+    {
+        std::uniform_real_distribution<float32> position(-range, range);
+        std::uniform_real_distribution<float32> extent(0.0f, range * 0.1f);
+
+        std::vector<dx::BoundingBox> boxes(count);
+        for (auto &box : boxes)
+        {
+            box.Center = {origin.x + position(random), origin.y + position(random), origin.z + position(random)};
+            box.Extents = {extent(random), extent(random), extent(random)};
+        }
+        return boxes;
+    }
+
+    // Compares every batch of the array with one call of the exact test per box, returns the mismatches count.
+    template <typename Volume>
+    Size CountMismatches(const Volume &volume, std::span<const dx::BoundingBox> boxes)
+    {
+        const CullingFrustum frustum(volume);
+
+        BoundingBoxArray array;
+        array.Assign(boxes);
+
+        Size mismatchesCount = 0;
+        for (Size first = 0; first < boxes.size(); first += BoundingBoxArray::BatchSize)
+        {
+            const Size count = std::min<Size>(BoundingBoxArray::BatchSize, boxes.size() - first);
+            const uint32 visible = array.CullBatch(frustum, first, count);
+
+            CHECK((visible >> count) == 0);
+            for (Size i = 0; i < count; ++i)
+            {
+                const bool isVisible = (visible >> i) & 1;
+                mismatchesCount += isVisible != volume.Intersects(boxes[first + i]) ? 1 : 0;
+            }
+        }
+        return mismatchesCount;
+    }
+
+    const dx::XMFLOAT3 Origins[] = {{0.0f, 0.0f, 0.0f}, {-35.0f, 12.0f, 80.0f}, {4000.0f, -150.0f, 9000.0f}};
+}
+
+TEST_CASE("Batched frustum culling matches DirectXCollision on random boxes")
+{
+    std::mt19937 random(15);
+    for (const auto &origin : Origins)
+    {
+        for (int i = 0; i < 20; ++i)
+        {
+            const auto frustum = CreateFrustum(random, origin);
+            CHECK_EQUAL(CountMismatches(frustum, CreateRandomBoxes(random, origin, 200.0f, 2000)), 0);
+        }
+    }
+}
+
+TEST_CASE("Batched frustum culling matches DirectXCollision on boxes touching the frustum")
+{
+    std::mt19937 random(16);
+    for (const auto &origin : Origins)
+    {
+        for (int i = 0; i < 20; ++i)
+        {
+            const auto frustum = CreateFrustum(random, origin);
+
+            dx::XMFLOAT3 corners[dx::BoundingFrustum::CORNER_COUNT];
+            frustum.GetCorners(corners);
+
+            CHECK_EQUAL(CountMismatches(frustum, CreateBoundaryBoxes(random, corners, 2000)), 0);
+        }
+    }
+}
+
+TEST_CASE("Batched orthographic culling matches DirectXCollision on random and touching boxes")
+{
+    std::mt19937 random(17);
+    for (const auto &origin : Origins)
+    {
+        for (int i = 0; i < 20; ++i)
+        {
+            const auto box = CreateOrientedBox(random, origin);
+
+            dx::XMFLOAT3 corners[dx::BoundingOrientedBox::CORNER_COUNT];
+            box.GetCorners(corners);
+
+            CHECK_EQUAL(CountMismatches(box, CreateRandomBoxes(random, origin, 100.0f, 1000)), 0);
+            CHECK_EQUAL(CountMismatches(box, CreateBoundaryBoxes(random, corners, 1000)), 0);
+        }
+    }
+}
+
+TEST_CASE("Degenerate boxes match DirectXCollision")
+{
+    std::mt19937 random(18);
+    const auto frustum = CreateFrustum(random, Origins[0]);
+
+    dx::XMFLOAT3 corners[dx::BoundingFrustum::CORNER_COUNT];
+    frustum.GetCorners(corners);
+
+    // Points and flat boxes on the corners and the origin of the frustum.
+    std::vector<dx::BoundingBox> boxes;
+    for (const auto &corner : corners)
+    {
+        boxes.emplace_back(corner, dx::XMFLOAT3(0.0f, 0.0f, 0.0f));
+        boxes.emplace_back(corner, dx::XMFLOAT3(5.0f, 0.0f, 0.0f));
+        boxes.emplace_back(corner, dx::XMFLOAT3(0.0f, 5.0f, 5.0f));
+    }
+    boxes.emplace_back(frustum.Origin, dx::XMFLOAT3(0.0f, 0.0f, 0.0f));
+    boxes.emplace_back(frustum.Origin, dx::XMFLOAT3(0.01f, 0.01f, 0.01f));
+
+    CHECK_EQUAL(CountMismatches(frustum, boxes), 0);
+}
+
+TEST_CASE("Cull writes one bit per box and leaves the padding clear")
+{
+    std::mt19937 random(19);
+    const auto frustum = CreateFrustum(random, Origins[1]);
+    const CullingFrustum cullingFrustum(frustum);
+
+    for (Size count : {0, 1, 3, 4, 5, 31, 32, 33, 63, 64, 65, 1001})
+    {
+        const auto boxes = CreateRandomBoxes(random, Origins[1], 150.0f, count);
+
+        BoundingBoxArray array;
+        array.Assign(boxes);
+
+        std::vector<uint32> visibilityMask;
+        array.Cull(cullingFrustum, visibilityMask);
+        CHECK_EQUAL(visibilityMask.size(), (count + 31) / 32);
+
+        for (Size i = 0; i < visibilityMask.size() * 32; ++i)
+        {
+            const bool isVisible = (visibilityMask[i / 32] >> (i % 32)) & 1;
+            CHECK_EQUAL(isVisible, i < count && frustum.Intersects(boxes[i]));
+        }
+    }
+}
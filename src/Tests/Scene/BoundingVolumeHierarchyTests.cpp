@@ -0,0 +1,177 @@
+#include <TestFramework.h>
+
+#include <MathUtils.h>
+#include <Scene/BoundingBoxArray.h>
+#include <Scene/BoundingVolumeHierarchy.h>
+
+#include <algorithm>
+#include <random>
+#include <variant>
+
+using namespace Engine;
+using namespace Engine::Scene;
+
+namespace
+{
+    constexpr float32 SceneSize = 400.0f;
+
+    using View = std::variant<dx::BoundingFrustum, dx::BoundingOrientedBox>;
+
+    std::vector<dx::BoundingBox> CreateBoxes(std::mt19937 &random, Size count)
+    {
+        std::uniform_real_distribution<float32> position(-SceneSize * 0.5f, SceneSize * 0.5f);
+        std::uniform_real_distribution<float32> extent(0.1f, 4.0f);
+
+        std::vector<dx::BoundingBox> boxes(count);
+        for (auto &box : boxes)
+        {
+            box.Center = {position(random), position(random) * 0.2f, position(random)};
+            box.Extents = {extent(random), extent(random), extent(random)};
+        }
+        return boxes;
+    }
+
+    // Cameras and cascade-like boxes scattered over the scene, a quarter of the views are boxes.
+    std::vector<View> CreateViews(std::mt19937 &random, Size count)
+    {
+        std::uniform_real_distribution<float32> angle(-Math::PI, Math::PI);
+        std::uniform_real_distribution<float32> position(-SceneSize * 0.5f, SceneSize * 0.5f);
+        std::uniform_real_distribution<float32> fov(0.3f, 2.0f);
+        std::uniform_real_distribution<float32> extent(5.0f, 80.0f);
+
+        std::vector<View> views;
+        for (Size i = 0; i < count; ++i)
+        {
+            const auto rotation = dx::XMMatrixRotationRollPitchYaw(angle(random), angle(random), angle(random));
+            const dx::XMFLOAT3 center = {position(random), position(random) * 0.2f, position(random)};
+
+            if (i % 4 == 3)
+            {
+                dx::XMFLOAT4 orientation;
+                dx::XMStoreFloat4(&orientation, dx::XMQuaternionRotationMatrix(rotation));
+                views.emplace_back(dx::BoundingOrientedBox(center, {extent(random), extent(random), extent(random)}, orientation));
+            }
+            else
+            {
+                dx::BoundingFrustum frustum(dx::XMMatrixPerspectiveFovLH(fov(random), fov(random), 0.1f, 150.0f));
+                dx::BoundingFrustum result;
+                frustum.Transform(result, dx::XMMatrixMultiply(rotation, dx::XMMatrixTranslation(center.x, center.y, center.z)));
+                views.emplace_back(result);
+            }
+        }
+        return views;
+    }
+
+    std::vector<CullingFrustum> GetCullingFrusta(const std::vector<View> &views)
+    {
+        std::vector<CullingFrustum> frusta;
+        for (const auto &view : views)
+        {
+            std::visit([&frusta](const auto &volume) { frusta.emplace_back(volume); }, view);
+        }
+        return frusta;
+    }
+
+    // Items of every view in ascending order, tested box by box with DirectXCollision.
+    std::vector<std::vector<uint32>> QueryBruteForce(const std::vector<dx::BoundingBox> &boxes, const std::vector<View> &views)
+    {
+        std::vector<std::vector<uint32>> items(views.size());
+        for (Size view = 0; view < views.size(); ++view)
+        {
+            for (uint32 i = 0; i < boxes.size(); ++i)
+            {
+                if (std::visit([&box = boxes[i]](const auto &volume) { return volume.Intersects(box); }, views[view]))
+                {
+                    items[view].push_back(i);
+                }
+            }
+        }
+        return items;
+    }
+
+    // Views whose query result differs from the brute force one, duplicates count as a difference.
+    Size CountMismatches(std::vector<std::vector<uint32>> items, const std::vector<std::vector<uint32>> &expected)
+    {
+        Size mismatchesCount = 0;
+        for (Size view = 0; view < expected.size(); ++view)
+        {
+            std::sort(items[view].begin(), items[view].end());
+            mismatchesCount += items[view] == expected[view] ? 0 : 1;
+        }
+        return mismatchesCount;
+    }
+}
+
+TEST_CASE("A single walk for many views matches brute force culling of every view")
+{
+    std::mt19937 random(16);
+
+    auto boxes = CreateBoxes(random, 20000);
+    const auto views = CreateViews(random, BoundingVolumeHierarchy::MaxQueryViews + 8);
+    const auto frusta = GetCullingFrusta(views);
+
+    BoundingVolumeHierarchy hierarchy;
+    hierarchy.Build(boxes);
+    CHECK_EQUAL(hierarchy.GetItemsCount(), boxes.size());
+
+    auto expected = QueryBruteForce(boxes, views);
+
+    Size visibleViewsCount = 0;
+    for (const auto &items : expected)
+    {
+        visibleViewsCount += items.empty() || items.size() == boxes.size() ? 0 : 1;
+    }
+    CHECK(visibleViewsCount > views.size() / 2);
+
+    // More views than a query mask holds, the last chunk is partial.
+    std::vector<std::vector<uint32>> items(views.size());
+    hierarchy.Query(frusta, items);
+    CHECK_EQUAL(CountMismatches(items, expected), 0);
+
+    // Every view on its own gives the same result.
+    std::vector<std::vector<uint32>> singleItems(views.size());
+    for (Size view = 0; view < views.size(); ++view)
+    {
+        hierarchy.Query(std::span(frusta).subspan(view, 1), std::span(singleItems).subspan(view, 1));
+    }
+    CHECK_EQUAL(CountMismatches(singleItems, expected), 0);
+
+    // Moved boxes are found after a refit of the same tree.
+    std::uniform_real_distribution<float32> offset(-20.0f, 20.0f);
+    for (auto &box : boxes)
+    {
+        box.Center.x += offset(random);
+        box.Center.z += offset(random);
+    }
+    hierarchy.Refit(boxes);
+    expected = QueryBruteForce(boxes, views);
+
+    for (auto &viewItems : items)
+    {
+        viewItems.clear();
+    }
+    hierarchy.Query(frusta, items);
+    CHECK_EQUAL(CountMismatches(items, expected), 0);
+}
+
+TEST_CASE("The frustum overload matches brute force culling")
+{
+    std::mt19937 random(17);
+
+    const auto boxes = CreateBoxes(random, 5000);
+
+    BoundingVolumeHierarchy hierarchy;
+    hierarchy.Build(boxes);
+
+    Size mismatchesCount = 0;
+    for (const auto &view : CreateViews(random, 24))
+    {
+        if (const auto *frustum = std::get_if<dx::BoundingFrustum>(&view))
+        {
+            std::vector<std::vector<uint32>> items(1);
+            hierarchy.Query(*frustum, items[0]);
+            mismatchesCount += CountMismatches(items, QueryBruteForce(boxes, {view}));
+        }
+    }
+    CHECK_EQUAL(mismatchesCount, 0);
+}
@@ -0,0 +1,316 @@
+#include <TestFramework.h>
+
+#include <MathUtils.h>
+#include <Scene/LightClusters.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <random>
+
+using namespace Engine;
+using namespace Engine::Scene;
+
+namespace
+{
+    constexpr uint32 Width = 16;
+    constexpr uint32 Height = 9;
+    constexpr uint32 Depth = 24;
+    constexpr float32 NearPlane = 0.1f;
+    constexpr float32 FarPlane = 500.0f;
+
+    const float32 TanHalfHeight = std::tan(dx::XMConvertToRadians(30.0f));
+    const float32 TanHalfWidth = TanHalfHeight * 16.0f / 9.0f;
+
+    dx::XMMATRIX CreateView(std::mt19937 &random)
+    {
+        std::uniform_real_distribution<float32> angle(-Math::PI, Math::PI);
+        std::uniform_real_distribution<float32> position(-50.0f, 50.0f);
+
+        const auto world = dx::XMMatrixMultiply(
+            dx::XMMatrixRotationRollPitchYaw(angle(random), angle(random), angle(random)),
+            dx::XMMatrixTranslation(position(random), position(random), position(random)));
+        return dx::XMMatrixInverse(nullptr, world);
+    }
+
+    std::vector<uint32> GetClusterLights(const LightClusters &clusters, uint32 clusterIndex)
+    {
+        const auto &cluster = clusters.GetClusters()[clusterIndex];
+        const auto &indices = clusters.GetLightIndices();
+        return {indices.begin() + cluster.x, indices.begin() + cluster.x + cluster.y};
+    }
+
+    // Lights around the eye, from small ones covering a few clusters to large ones covering most of the view.
+    std::vector<dx::BoundingSphere> CreateLights(std::mt19937 &random, const dx::XMMATRIX &view, Size count)
+    {
+        std::uniform_real_distribution<float32> position(-1.0f, 1.0f);
+        std::uniform_real_distribution<float32> distance(0.0f, 1.0f);
+        std::uniform_real_distribution<float32> radius(0.05f, 1.0f);
+
+        const auto world = dx::XMMatrixInverse(nullptr, view);
+
+        std::vector<dx::BoundingSphere> lights(count);
+        for (auto &light : lights)
+        {
+            // Denser close to the eye, where the clusters are small.
+            const float32 depth = FarPlane * std::pow(distance(random), 3.0f) * 1.2f;
+            const auto viewCenter = dx::XMVectorSet(position(random) * depth, position(random) * depth, depth * (position(random) > -0.8f ? 1.0f : -1.0f), 1.0f);
+
+            dx::XMStoreFloat3(&light.Center, dx::XMVector3Transform(viewCenter, world));
+            light.Radius = radius(random) * (1.0f + depth * 0.1f);
+        }
+        return lights;
+    }
+
+    struct Point
+    {
+        float64 x, y, z;
+    };
+
+    Point operator-(const Point &a, const Point &b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+    float64 Dot(const Point &a, const Point &b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+    Point Cross(const Point &a, const Point &b) { return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x}; }
+
+    float64 GetSegmentDistance(const Point &point, const Point &a, const Point &b)
+    {
+        const Point edge = b - a;
+        const float64 t = std::clamp(Dot(point - a, edge) / Dot(edge, edge), 0.0, 1.0);
+        const Point offset = point - Point{a.x + edge.x * t, a.y + edge.y * t, a.z + edge.z * t};
+        return std::sqrt(Dot(offset, offset));
+    }
+
+    // Distance from a point to a planar convex quad, corners in winding order.
+    float64 GetFaceDistance(const Point &point, const std::array<Point, 4> &face)
+    {
+        const Point normal = Cross(face[1] - face[0], face[2] - face[0]);
+        const float64 planeDistance = Dot(point - face[0], normal) / std::sqrt(Dot(normal, normal));
+
+        bool isAbove = true;
+        float64 distance = std::numeric_limits<float64>::max();
+        for (Size i = 0; i < face.size(); ++i)
+        {
+            const auto &a = face[i];
+            const auto &b = face[(i + 1) % face.size()];
+            isAbove &= Dot(Cross(b - a, point - a), normal) >= 0.0;
+            distance = std::min(distance, GetSegmentDistance(point, a, b));
+        }
+        return isAbove ? std::abs(planeDistance) : distance;
+    }
+
+    // Distance from a view space point to the exact froxel, the part of the view between two slice depths
+    // and four tile planes through the eye. Zero inside.
+    float64 GetFroxelDistance(uint32 x, uint32 y, uint32 z, const Point &point)
+    {
+        const float64 depthRatio = std::log(static_cast<float64>(FarPlane) / NearPlane);
+        const float64 nearDepth = NearPlane * std::exp(depthRatio * z / Depth);
+        const float64 farDepth = NearPlane * std::exp(depthRatio * (z + 1) / Depth);
+        const float64 left = (-1.0 + 2.0 * x / Width) * TanHalfWidth;
+        const float64 right = (-1.0 + 2.0 * (x + 1) / Width) * TanHalfWidth;
+        const float64 top = (1.0 - 2.0 * y / Height) * TanHalfHeight;
+        const float64 bottom = (1.0 - 2.0 * (y + 1) / Height) * TanHalfHeight;
+
+        const bool isInside = point.z >= nearDepth && point.z <= farDepth &&
+            point.x >= left * point.z && point.x <= right * point.z &&
+            point.y >= bottom * point.z && point.y <= top * point.z;
+        if (isInside)
+        {
+            return 0.0;
+        }
+
+        const auto corner = [&](float64 u, float64 v, float64 depth) { return Point{u * depth, v * depth, depth}; };
+        const Point corners[8] = {
+            corner(left, bottom, nearDepth), corner(right, bottom, nearDepth), corner(right, top, nearDepth), corner(left, top, nearDepth),
+            corner(left, bottom, farDepth), corner(right, bottom, farDepth), corner(right, top, farDepth), corner(left, top, farDepth),
+        };
+        const std::array<std::array<Point, 4>, 6> faces = {{
+            {corners[0], corners[1], corners[2], corners[3]},
+            {corners[4], corners[7], corners[6], corners[5]},
+            {corners[0], corners[3], corners[7], corners[4]},
+            {corners[1], corners[5], corners[6], corners[2]},
+            {corners[0], corners[4], corners[5], corners[1]},
+            {corners[3], corners[2], corners[6], corners[7]},
+        }};
+
+        float64 distance = std::numeric_limits<float64>::max();
+        for (const auto &face : faces)
+        {
+            distance = std::min(distance, GetFaceDistance(point, face));
+        }
+        return distance;
+    }
+
+    struct ExpectedLights
+    {
+        // Lights touching the exact froxel, every one of them has to be in the cluster.
+        std::vector<uint32> required;
+        // Lights touching the view space bounds of the cluster, the binning may keep these too.
+        std::vector<uint32> allowed;
+    };
+
+    // Brute force sphere against froxel binning of every light, in index order.
+    ExpectedLights GetExpectedLights(const LightClusters &clusters, uint32 x, uint32 y, uint32 z, const dx::XMMATRIX &view, std::span<const dx::BoundingSphere> lights)
+    {
+        const auto bounds = clusters.GetClusterBounds(clusters.GetClusterIndex(x, y, z));
+
+        ExpectedLights expected;
+        for (uint32 i = 0; i < lights.size(); ++i)
+        {
+            dx::BoundingSphere viewLight;
+            lights[i].Transform(viewLight, view);
+
+            // Spheres barely touching the froxel may go either way in single precision.
+            const Point center = {viewLight.Center.x, viewLight.Center.y, viewLight.Center.z};
+            if (GetFroxelDistance(x, y, z, center) < viewLight.Radius * (1.0 - 1e-4))
+            {
+                expected.required.push_back(i);
+            }
+            if (viewLight.Intersects(bounds))
+            {
+                expected.allowed.push_back(i);
+            }
+        }
+        return expected;
+    }
+
+    bool IsBetween(std::span<const uint32> clusterLights, const ExpectedLights &expected)
+    {
+        return std::includes(clusterLights.begin(), clusterLights.end(), expected.required.begin(), expected.required.end()) &&
+            std::includes(expected.allowed.begin(), expected.allowed.end(), clusterLights.begin(), clusterLights.end());
+    }
+}
+
+TEST_CASE("Clusters list the lights a brute force sphere against froxel test finds")
+{
+    std::mt19937 random(20);
+    LightClusters clusters(Width, Height, Depth, 1024);
+
+    for (int frame = 0; frame < 4; ++frame)
+    {
+        const auto view = CreateView(random);
+        const auto lights = CreateLights(random, view, 200);
+        clusters.Build(view, TanHalfWidth, TanHalfHeight, NearPlane, FarPlane, lights);
+
+        CHECK_EQUAL(clusters.GetClusters().size(), Width * Height * Depth);
+
+        Size mismatchesCount = 0;
+        Size requiredCount = 0;
+        Size allowedCount = 0;
+        for (uint32 z = 0; z < Depth; ++z)
+        {
+            for (uint32 y = 0; y < Height; ++y)
+            {
+                for (uint32 x = 0; x < Width; ++x)
+                {
+                    const auto expected = GetExpectedLights(clusters, x, y, z, view, lights);
+                    mismatchesCount += IsBetween(GetClusterLights(clusters, clusters.GetClusterIndex(x, y, z)), expected) ? 0 : 1;
+                    requiredCount += expected.required.size();
+                    allowedCount += expected.allowed.size();
+                }
+            }
+        }
+
+        CHECK_EQUAL(mismatchesCount, 0);
+        CHECK(requiredCount > 0 && allowedCount > requiredCount);
+    }
+}
+
+TEST_CASE("Full clusters keep the lowest light indices up to the limit")
+{
+    constexpr uint32 MaxLightsPerCluster = 8;
+
+    std::mt19937 random(21);
+    LightClusters clusters(Width, Height, Depth, MaxLightsPerCluster);
+    LightClusters unlimitedClusters(Width, Height, Depth, 1024);
+
+    const auto view = CreateView(random);
+    const auto lights = CreateLights(random, view, 500);
+    clusters.Build(view, TanHalfWidth, TanHalfHeight, NearPlane, FarPlane, lights);
+    unlimitedClusters.Build(view, TanHalfWidth, TanHalfHeight, NearPlane, FarPlane, lights);
+
+    Size fullClustersCount = 0;
+    Size mismatchesCount = 0;
+    for (uint32 i = 0; i < Width * Height * Depth; ++i)
+    {
+        auto expected = GetClusterLights(unlimitedClusters, i);
+        if (expected.size() > MaxLightsPerCluster)
+        {
+            expected.resize(MaxLightsPerCluster);
+            ++fullClustersCount;
+        }
+
+        const auto clusterLights = GetClusterLights(clusters, i);
+        CHECK(clusterLights.size() <= MaxLightsPerCluster);
+        mismatchesCount += clusterLights != expected ? 1 : 0;
+    }
+
+    CHECK_EQUAL(mismatchesCount, 0);
+    CHECK(fullClustersCount > 0);
+}
+
+TEST_CASE("Cluster ranges are packed in cluster order with increasing light indices")
+{
+    std::mt19937 random(22);
+    LightClusters clusters(Width, Height, Depth, 64);
+
+    const auto view = CreateView(random);
+    const auto lights = CreateLights(random, view, 200);
+    clusters.Build(view, TanHalfWidth, TanHalfHeight, NearPlane, FarPlane, lights);
+
+    uint32 offset = 0;
+    for (const auto &cluster : clusters.GetClusters())
+    {
+        CHECK_EQUAL(cluster.x, offset);
+        for (uint32 i = 1; i < cluster.y; ++i)
+        {
+            CHECK(clusters.GetLightIndices()[cluster.x + i - 1] < clusters.GetLightIndices()[cluster.x + i]);
+        }
+        offset += cluster.y;
+    }
+    CHECK_EQUAL(offset, clusters.GetLightIndices().size());
+
+    // Lights behind the eye or past the far plane are in no cluster, one around the eye is in the first slice.
+    const std::vector<dx::BoundingSphere> outsideLights = {
+        dx::BoundingSphere({0.0f, 0.0f, -5.0f}, 2.0f),
+        dx::BoundingSphere({0.0f, 0.0f, FarPlane + 10.0f}, 5.0f),
+        dx::BoundingSphere({0.0f, 0.0f, 0.0f}, 1.0f),
+    };
+    clusters.Build(dx::XMMatrixIdentity(), TanHalfWidth, TanHalfHeight, NearPlane, FarPlane, outsideLights);
+
+    for (uint32 i = 0; i < Width * Height * Depth; ++i)
+    {
+        const auto clusterLights = GetClusterLights(clusters, i);
+        CHECK(clusterLights.empty() || (clusterLights.size() == 1 && clusterLights[0] == 2));
+    }
+    CHECK(GetClusterLights(clusters, clusters.GetClusterIndex(0, 0, 0)) == std::vector<uint32>{2});
+}
+
+TEST_CASE("Points of the view map to the cluster whose bounds contain them")
+{
+    std::mt19937 random(23);
+    std::uniform_real_distribution<float32> unit(0.0f, 1.0f);
+
+    LightClusters clusters(Width, Height, Depth, 1);
+    clusters.Build(dx::XMMatrixIdentity(), TanHalfWidth, TanHalfHeight, NearPlane, FarPlane, {});
+
+    // The lookup the shading does: tiles over the viewport and slices from the logarithm of the depth.
+    for (int i = 0; i < 20000; ++i)
+    {
+        const float32 depth = NearPlane * std::pow(FarPlane / NearPlane, unit(random));
+        const float32 ndcX = unit(random) * 2.0f - 1.0f;
+        const float32 ndcY = unit(random) * 2.0f - 1.0f;
+
+        const uint32 x = std::min(static_cast<uint32>((ndcX + 1.0f) * 0.5f * Width), Width - 1);
+        const uint32 y = std::min(static_cast<uint32>((1.0f - ndcY) * 0.5f * Height), Height - 1);
+        const float32 slice = std::log(depth) * clusters.GetDepthSliceScale() + clusters.GetDepthSliceBias();
+        const uint32 z = std::min(static_cast<uint32>(std::max(slice, 0.0f)), Depth - 1);
+
+        const auto bounds = clusters.GetClusterBounds(clusters.GetClusterIndex(x, y, z));
+        const dx::XMFLOAT3 point(ndcX * TanHalfWidth * depth, ndcY * TanHalfHeight * depth, depth);
+
+        const float32 tolerance = 1e-4f * (1.0f + depth);
+        CHECK(std::abs(point.x - bounds.Center.x) <= bounds.Extents.x + tolerance);
+        CHECK(std::abs(point.y - bounds.Center.y) <= bounds.Extents.y + tolerance);
+        CHECK(std::abs(point.z - bounds.Center.z) <= bounds.Extents.z + tolerance);
+    }
+}
@@ -0,0 +1,333 @@
+#include <TestFramework.h>
+
+#include <Scene/Loader/MeshOptimizer.h>
+
+#include <DirectXCollision.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <set>
+
+using namespace Engine;
+using namespace Engine::Scene;
+using namespace Engine::Scene::Loader;
+
+namespace
+{
+    // A height field of size x size vertices over the unit square, two triangles per cell.
+    void CreateGrid(Size size, float32 height, std::vector<Vertex> &vertices, std::vector<uint32> &indices)
+    {
+        vertices.clear();
+        indices.clear();
+
+        for (Size y = 0; y < size; ++y)
+        {
+            for (Size x = 0; x < size; ++x)
+            {
+                const float32 u = static_cast<float32>(x) / static_cast<float32>(size - 1);
+                const float32 v = static_cast<float32>(y) / static_cast<float32>(size - 1);
+
+                Vertex vertex = {};
+                vertex.Vertex = {u, height * std::sin(3.0f * u) * std::cos(2.0f * v), v};
+                vertex.Normal = {0.0f, 1.0f, 0.0f};
+                vertex.TextureCoord = {u, v};
+                vertex.Tangent = {1.0f, 0.0f, 0.0f, 1.0f};
+                vertices.push_back(vertex);
+            }
+        }
+
+        for (Size y = 0; y + 1 < size; ++y)
+        {
+            for (Size x = 0; x + 1 < size; ++x)
+            {
+                const uint32 corner = static_cast<uint32>(y * size + x);
+                const uint32 right = corner + 1;
+                const uint32 top = corner + static_cast<uint32>(size);
+
+                indices.insert(indices.end(), {corner, top, right, right, top, top + 1});
+            }
+        }
+    }
+
+    void ShuffleTriangles(std::mt19937 &random, std::vector<uint32> &indices)
+    {
+        std::vector<std::array<uint32, 3>> triangles(indices.size() / 3);
+        memcpy(triangles.data(), indices.data(), indices.size() * sizeof(uint32));
+        std::shuffle(triangles.begin(), triangles.end(), random);
+        memcpy(indices.data(), triangles.data(), indices.size() * sizeof(uint32));
+    }
+
+    // Triangles as the texture coordinates of their corners, rotated to start at the smallest one so
+    // the set does not depend on the vertex order or on which corner a triangle starts with.
+    std::multiset<std::array<float32, 6>> GetTriangles(const std::vector<Vertex> &vertices, std::span<const uint32> indices)
+    {
+        std::multiset<std::array<float32, 6>> triangles;
+        for (Size i = 0; i + 2 < indices.size(); i += 3)
+        {
+            std::array<std::pair<float32, float32>, 3> corners;
+            for (Size k = 0; k < 3; ++k)
+            {
+                const auto &textureCoord = vertices[indices[i + k]].TextureCoord;
+                corners[k] = {textureCoord.x, textureCoord.y};
+            }
+            std::rotate(corners.begin(), std::min_element(corners.begin(), corners.end()), corners.end());
+
+            triangles.insert({corners[0].first, corners[0].second, corners[1].first, corners[1].second, corners[2].first, corners[2].second});
+        }
+        return triangles;
+    }
+
+    // Invalid or degenerate triangles, and the signed area of the triangles projected on the xz plane.
+    // The projection of a simplified grid still covers the unit square once when its borders stay in place.
+    Size CountInvalidTriangles(const std::vector<Vertex> &vertices, std::span<const uint32> indices, float32 &projectedArea)
+    {
+        Size invalidCount = indices.size() % 3;
+        projectedArea = 0.0f;
+        for (Size i = 0; i + 2 < indices.size(); i += 3)
+        {
+            const uint32 a = indices[i];
+            const uint32 b = indices[i + 1];
+            const uint32 c = indices[i + 2];
+            if (a >= vertices.size() || b >= vertices.size() || c >= vertices.size() || a == b || b == c || a == c)
+            {
+                ++invalidCount;
+                continue;
+            }
+
+            const auto &p0 = vertices[a].Vertex;
+            const auto &p1 = vertices[b].Vertex;
+            const auto &p2 = vertices[c].Vertex;
+            const auto edge0 = dx::XMVectorSubtract(dx::XMLoadFloat3(&p1), dx::XMLoadFloat3(&p0));
+            const auto edge1 = dx::XMVectorSubtract(dx::XMLoadFloat3(&p2), dx::XMLoadFloat3(&p0));
+            invalidCount += dx::XMVectorGetX(dx::XMVector3LengthSq(dx::XMVector3Cross(edge0, edge1))) <= 0.0f ? 1 : 0;
+            projectedArea += 0.5f * ((p2.x - p0.x) * (p1.z - p0.z) - (p1.x - p0.x) * (p2.z - p0.z));
+        }
+        return invalidCount;
+    }
+}
+
+TEST_CASE("Vertex cache statistics count the misses of a FIFO cache")
+{
+    const std::vector<uint32> triangle = {0, 1, 2};
+    auto statistics = MeshOptimizer::AnalyzeVertexCache(triangle, 3);
+    CHECK_EQUAL(statistics.trianglesCount, 1);
+    CHECK_EQUAL(statistics.verticesCount, 3);
+    CHECK_EQUAL(statistics.acmr, 3.0f);
+    CHECK_EQUAL(statistics.atvr, 1.0f);
+
+    // The second triangle of a quad only misses its new corner.
+    const std::vector<uint32> quad = {0, 1, 2, 2, 1, 3};
+    statistics = MeshOptimizer::AnalyzeVertexCache(quad, 4);
+    CHECK_EQUAL(statistics.acmr, 2.0f);
+    CHECK_EQUAL(statistics.atvr, 1.0f);
+
+    // With a cache of three a vertex is evicted after three newer ones and transformed again.
+    const std::vector<uint32> strip = {0, 1, 2, 3, 4, 5, 0, 1, 2};
+    statistics = MeshOptimizer::AnalyzeVertexCache(strip, 6, 3);
+    CHECK_EQUAL(statistics.verticesCount, 6);
+    CHECK_EQUAL(statistics.acmr, 3.0f);
+    CHECK_EQUAL(statistics.atvr, 1.5f);
+
+    statistics = MeshOptimizer::AnalyzeVertexCache({}, 0);
+    CHECK_EQUAL(statistics.trianglesCount, 0);
+    CHECK_EQUAL(statistics.acmr, 0.0f);
+}
+
+TEST_CASE("Optimizing a shuffled grid lowers its ACMR and ATVR and keeps its triangles")
+{
+    std::mt19937 random(5);
+
+    for (Size size : {8, 33, 100})
+    {
+        std::vector<Vertex> vertices;
+        std::vector<uint32> indices;
+        CreateGrid(size, 0.2f, vertices, indices);
+        ShuffleTriangles(random, indices);
+
+        const auto sourceTriangles = GetTriangles(vertices, indices);
+        const auto source = MeshOptimizer::AnalyzeVertexCache(indices, vertices.size());
+
+        MeshOptimizer::Optimize(vertices, indices);
+        const auto optimized = MeshOptimizer::AnalyzeVertexCache(indices, vertices.size());
+
+        CHECK(GetTriangles(vertices, indices) == sourceTriangles);
+        CHECK_EQUAL(optimized.trianglesCount, source.trianglesCount);
+        CHECK_EQUAL(optimized.verticesCount, vertices.size());
+
+        // A random order transforms close to three vertices per triangle, a good order about one per new vertex.
+        CHECK(optimized.acmr < source.acmr);
+        CHECK(optimized.atvr < source.atvr);
+        if (size > 8)
+        {
+            CHECK(source.acmr > 2.0f);
+            CHECK(optimized.acmr < 0.8f);
+            CHECK(optimized.atvr < 1.5f);
+        }
+
+        // Vertex fetch order follows the first use of every vertex.
+        uint32 nextVertex = 0;
+        Size outOfOrderCount = 0;
+        for (auto index : indices)
+        {
+            outOfOrderCount += index > nextVertex ? 1 : 0;
+            nextVertex = std::max(nextVertex, index + 1);
+        }
+        CHECK_EQUAL(outOfOrderCount, 0);
+        CHECK_EQUAL(nextVertex, vertices.size());
+    }
+}
+
+TEST_CASE("Duplicate vertices are merged before the reordering")
+{
+    std::vector<Vertex> vertices;
+    std::vector<uint32> indices;
+    CreateGrid(16, 0.0f, vertices, indices);
+    const Size uniqueVerticesCount = vertices.size();
+
+    // Unindexed copy, every triangle corner gets its own vertex.
+    std::vector<Vertex> expanded;
+    for (auto &index : indices)
+    {
+        expanded.push_back(vertices[index]);
+        index = static_cast<uint32>(expanded.size() - 1);
+    }
+    const auto sourceTriangles = GetTriangles(expanded, indices);
+
+    MeshOptimizer::Optimize(expanded, indices);
+
+    CHECK_EQUAL(expanded.size(), uniqueVerticesCount);
+    CHECK(GetTriangles(expanded, indices) == sourceTriangles);
+    CHECK(MeshOptimizer::AnalyzeVertexCache(indices, expanded.size()).acmr < 0.8f);
+}
+
+TEST_CASE("Simplification reaches its target count on a flat grid without error")
+{
+    std::vector<Vertex> vertices;
+    std::vector<uint32> indices;
+    CreateGrid(33, 0.0f, vertices, indices);
+
+    for (Size target : {indices.size() / 2, indices.size() / 8, indices.size() / 64})
+    {
+        const Size targetIndicesCount = target / 3 * 3;
+
+        float32 error = -1.0f;
+        const auto simplified = MeshOptimizer::Simplify(vertices, indices, targetIndicesCount, 0.01f, error);
+
+        float32 area = 0.0f;
+        CHECK_EQUAL(CountInvalidTriangles(vertices, simplified, area), 0);
+        CHECK(simplified.size() <= targetIndicesCount);
+        CHECK(simplified.size() > 0);
+        CHECK_NEAR(error, 0.0f, 1e-5f);
+        // Borders only collapse along themselves, so the simplified grid still covers the unit square once.
+        CHECK_NEAR(area, 1.0f, 1e-4f);
+    }
+}
+
+TEST_CASE("Simplification stops at the error target on a curved grid")
+{
+    std::vector<Vertex> vertices;
+    std::vector<uint32> indices;
+    CreateGrid(33, 0.3f, vertices, indices);
+
+    float32 previousError = 0.0f;
+    Size previousCount = indices.size() + 1;
+    for (float32 targetError : {1e-4f, 1e-3f, 1e-2f, 1e-1f})
+    {
+        float32 error = -1.0f;
+        const auto simplified = MeshOptimizer::Simplify(vertices, indices, 6, targetError, error);
+
+        float32 area = 0.0f;
+        CHECK_EQUAL(CountInvalidTriangles(vertices, simplified, area), 0);
+        CHECK_NEAR(area, 1.0f, 1e-4f);
+        CHECK(error >= 0.0f && error <= targetError);
+
+        // A larger error budget only ever allows more collapses.
+        CHECK(simplified.size() < indices.size());
+        CHECK(simplified.size() <= previousCount);
+        CHECK(error >= previousError);
+        previousCount = simplified.size();
+        previousError = error;
+    }
+    CHECK(previousCount * 8 < indices.size());
+}
+
+TEST_CASE("LODs append shrinking index ranges with their own meshlets")
+{
+    std::mt19937 random(9);
+
+    // A noisy grid runs out of error budget before the LOD count limit.
+    for (float32 height : {0.0f, 0.2f, 1.0f, -1.0f})
+    {
+        std::vector<Vertex> vertices;
+        std::vector<uint32> indices;
+        CreateGrid(65, std::max(height, 0.0f), vertices, indices);
+        if (height < 0.0f)
+        {
+            std::uniform_real_distribution<float32> noise(-0.05f, 0.05f);
+            for (auto &vertex : vertices)
+            {
+                vertex.Vertex.y += noise(random);
+            }
+        }
+        MeshOptimizer::Optimize(vertices, indices);
+
+        const auto sourceIndices = indices;
+        std::vector<Meshlet> meshlets;
+        const auto lods = MeshOptimizer::BuildLods(vertices, indices, meshlets);
+
+        dx::BoundingSphere bounds;
+        dx::BoundingSphere::CreateFromPoints(bounds, vertices.size(), &vertices[0].Vertex, sizeof(Vertex));
+
+        CHECK(lods.size() >= 2);
+        CHECK(lods.size() <= MeshOptimizer::MaxLodsCount);
+        CHECK(std::equal(sourceIndices.begin(), sourceIndices.end(), indices.begin()));
+
+        Size invalidCount = 0;
+        uint32 nextIndex = 0;
+        uint32 nextMeshlet = 0;
+        for (Size i = 0; i < lods.size(); ++i)
+        {
+            const auto &lod = lods[i];
+
+            // Every LOD follows the previous one in the index buffer and drops at least a quarter of its triangles.
+            invalidCount += lod.indexOffset != nextIndex || lod.meshletOffset != nextMeshlet ? 1 : 0;
+            if (i > 0)
+            {
+                invalidCount += static_cast<Size>(lod.indexCount) * 4 > static_cast<Size>(lods[i - 1].indexCount) * 3 ? 1 : 0;
+                invalidCount += lod.error < lods[i - 1].error ? 1 : 0;
+            }
+            invalidCount += lod.error > MeshOptimizer::MaxLodError * bounds.Radius ? 1 : 0;
+
+            float32 area = 0.0f;
+            invalidCount += CountInvalidTriangles(vertices, std::span(indices).subspan(lod.indexOffset, lod.indexCount), area);
+            // Moving the border of the unit square by the error changes its area by at most its perimeter times the error.
+            invalidCount += std::abs(area - 1.0f) > 4.0f * lod.error + 1e-4f ? 1 : 0;
+
+            // The meshlets of a LOD partition its index range.
+            uint32 meshletIndex = lod.indexOffset;
+            for (uint32 m = lod.meshletOffset; m < lod.meshletOffset + lod.meshletsCount; ++m)
+            {
+                invalidCount += meshlets[m].indexOffset != meshletIndex ? 1 : 0;
+                meshletIndex += meshlets[m].indexCount;
+            }
+            invalidCount += meshletIndex != lod.indexOffset + lod.indexCount ? 1 : 0;
+
+            nextIndex = lod.indexOffset + lod.indexCount;
+            nextMeshlet = lod.meshletOffset + lod.meshletsCount;
+        }
+
+        CHECK_EQUAL(invalidCount, 0);
+        CHECK_EQUAL(lods[0].indexCount, sourceIndices.size());
+        CHECK_EQUAL(lods[0].error, 0.0f);
+        CHECK_EQUAL(nextIndex, indices.size());
+        CHECK_EQUAL(nextMeshlet, meshlets.size());
+        if (height == 0.0f)
+        {
+            // Nothing limits a flat grid but the LOD count.
+            CHECK_EQUAL(lods.size(), MeshOptimizer::MaxLodsCount);
+        }
+    }
+}
@@ -0,0 +1,402 @@
+#include <TestFramework.h>
+
+#include <MathUtils.h>
+#include <Scene/Loader/MeshOptimizer.h>
+#include <Scene/Material.h>
+#include <Scene/Mesh.h>
+#include <Scene/MeshletCulling.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+
+using namespace Engine;
+using namespace Engine::Scene;
+using namespace Engine::Scene::Loader;
+
+namespace
+{
+    constexpr float32 FovY = 1.0f;
+    constexpr float32 AspectRatio = 1.5f;
+    constexpr float32 NearZ = 0.1f;
+    constexpr float32 FarZ = 100.0f;
+
+    // A closed unit sphere with clockwise front faces seen from the outside, single vertices at the poles.
+    void CreateSphere(uint32 rings, uint32 segments, std::vector<Vertex> &vertices, std::vector<uint32> &indices)
+    {
+        vertices.clear();
+        indices.clear();
+
+        auto addVertex = [&](float32 theta, float32 phi) {
+            Vertex vertex = {};
+            vertex.Vertex = {std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)};
+            vertex.Normal = vertex.Vertex;
+            vertex.TextureCoord = {phi / (2.0f * Math::PI), theta / Math::PI};
+            vertex.Tangent = {1.0f, 0.0f, 0.0f, 1.0f};
+            vertices.push_back(vertex);
+        };
+
+        addVertex(0.0f, 0.0f);
+        for (uint32 ring = 1; ring < rings; ++ring)
+        {
+            for (uint32 segment = 0; segment < segments; ++segment)
+            {
+                addVertex(Math::PI * ring / rings, 2.0f * Math::PI * segment / segments);
+            }
+        }
+        addVertex(Math::PI, 0.0f);
+
+        const uint32 bottom = static_cast<uint32>(vertices.size() - 1);
+        auto ringVertex = [&](uint32 ring, uint32 segment) { return 1 + (ring - 1) * segments + segment % segments; };
+
+        auto addTriangle = [&](uint32 a, uint32 b, uint32 c) {
+            // Flip the winding so the normal points away from the center.
+            auto p0 = dx::XMLoadFloat3(&vertices[a].Vertex);
+            auto normal = dx::XMVector3Cross(
+                dx::XMVectorSubtract(dx::XMLoadFloat3(&vertices[b].Vertex), p0),
+                dx::XMVectorSubtract(dx::XMLoadFloat3(&vertices[c].Vertex), p0));
+            if (dx::XMVectorGetX(dx::XMVector3Dot(normal, p0)) < 0.0f)
+            {
+                std::swap(b, c);
+            }
+            indices.insert(indices.end(), {a, b, c});
+        };
+
+        for (uint32 segment = 0; segment < segments; ++segment)
+        {
+            addTriangle(0, ringVertex(1, segment), ringVertex(1, segment + 1));
+            for (uint32 ring = 1; ring + 1 < rings; ++ring)
+            {
+                addTriangle(ringVertex(ring, segment), ringVertex(ring + 1, segment), ringVertex(ring, segment + 1));
+                addTriangle(ringVertex(ring, segment + 1), ringVertex(ring + 1, segment), ringVertex(ring + 1, segment + 1));
+            }
+            addTriangle(bottom, ringVertex(rings - 1, segment + 1), ringVertex(rings - 1, segment));
+        }
+    }
+
+    dx::XMMATRIX CreateWorld(std::mt19937 &random, bool isUniform, bool isMirrored)
+    {
+        std::uniform_real_distribution<float32> angle(-Math::PI, Math::PI);
+        std::uniform_real_distribution<float32> scale(0.5f, 3.0f);
+        std::uniform_real_distribution<float32> side(-20.0f, 20.0f);
+        std::uniform_real_distribution<float32> depth(-5.0f, 60.0f);
+
+        const float32 uniformScale = scale(random);
+        auto scaling = isUniform ? dx::XMMatrixScaling(uniformScale, uniformScale, uniformScale) : dx::XMMatrixScaling(scale(random), scale(random), scale(random));
+        if (isMirrored)
+        {
+            scaling = dx::XMMatrixMultiply(scaling, dx::XMMatrixScaling(-1.0f, 1.0f, 1.0f));
+        }
+
+        return dx::XMMatrixMultiply(
+            dx::XMMatrixMultiply(scaling, dx::XMMatrixRotationRollPitchYaw(angle(random), angle(random), angle(random))),
+            dx::XMMatrixTranslation(side(random), side(random), depth(random)));
+    }
+
+    // A camera at the origin looking along +z.
+    MeshletCulling::View CreateView()
+    {
+        MeshletCulling::View view;
+        view.frustum = dx::BoundingFrustum(dx::XMMatrixPerspectiveFovLH(FovY, AspectRatio, NearZ, FarZ));
+        view.eyePosition = dx::XMVectorZero();
+        view.isPerspective = true;
+        return view;
+    }
+
+    bool IsInsideFrustum(dx::FXMVECTOR position)
+    {
+        const float32 z = dx::XMVectorGetZ(position);
+        const float32 tanHalfHeight = std::tan(FovY * 0.5f);
+
+        return z >= NearZ && z <= FarZ &&
+            std::abs(dx::XMVectorGetX(position)) <= z * tanHalfHeight * AspectRatio &&
+            std::abs(dx::XMVectorGetY(position)) <= z * tanHalfHeight;
+    }
+
+    // Rasterizer facing of a world space triangle seen from the origin, grazing triangles count as neither.
+    int32 GetFacing(const dx::XMVECTOR (&positions)[3])
+    {
+        auto normal = dx::XMVector3Cross(dx::XMVectorSubtract(positions[1], positions[0]), dx::XMVectorSubtract(positions[2], positions[0]));
+        const float32 dot = dx::XMVectorGetX(dx::XMVector3Dot(normal, positions[0]));
+        const float32 scale = dx::XMVectorGetX(dx::XMVector3Length(normal)) * dx::XMVectorGetX(dx::XMVector3Length(positions[0]));
+
+        return dot < -1e-4f * scale ? 1 : (dot > 1e-4f * scale ? -1 : 0);
+    }
+
+    struct CullResult
+    {
+        Size keptCount = 0;
+        Size culledFrontFacingCount = 0;
+        Size culledBackFacingCount = 0;
+        Size invalidRangesCount = 0;
+    };
+
+    // Culls the mesh and compares the kept meshlets with their world space triangles.
+    CullResult CullAndCheck(const Mesh &mesh, const std::vector<Vertex> &vertices, const std::vector<uint32> &indices, const dx::XMMATRIX &world)
+    {
+        const auto &meshlets = *mesh.meshlets;
+
+        std::vector<MeshletCulling::DrawRange> ranges = {{0, 0}};
+        const uint32 rangesCount = MeshletCulling::Cull(mesh, world, 0, CreateView(), ranges);
+
+        CullResult result;
+        result.invalidRangesCount += rangesCount + 1 != ranges.size() ? 1 : 0;
+
+        // Ranges are merged, so they are sorted, disjoint and never touch.
+        std::vector<bool> isKept(meshlets.size(), false);
+        for (Size i = 1; i < ranges.size(); ++i)
+        {
+            if (i > 1 && ranges[i - 1].indexOffset + ranges[i - 1].indexCount >= ranges[i].indexOffset)
+            {
+                ++result.invalidRangesCount;
+            }
+
+            const uint32 end = ranges[i].indexOffset + ranges[i].indexCount;
+            bool isAligned = false;
+            for (Size m = 0; m < meshlets.size(); ++m)
+            {
+                const auto &meshlet = meshlets[m];
+                isAligned |= meshlet.indexOffset + meshlet.indexCount == end;
+                if (meshlet.indexOffset >= ranges[i].indexOffset && meshlet.indexOffset < end)
+                {
+                    isKept[m] = true;
+                    isAligned |= meshlet.indexOffset == ranges[i].indexOffset;
+                }
+            }
+            result.invalidRangesCount += isAligned ? 0 : 1;
+        }
+
+        for (Size m = 0; m < meshlets.size(); ++m)
+        {
+            if (isKept[m])
+            {
+                ++result.keptCount;
+                continue;
+            }
+
+            // A culled meshlet may only hold triangles that are invisible: outside the frustum or back facing.
+            bool isFrontFacingVisible = false;
+            bool isBackFacingVisible = false;
+            const auto &meshlet = meshlets[m];
+            for (uint32 i = meshlet.indexOffset; i < meshlet.indexOffset + meshlet.indexCount; i += 3)
+            {
+                dx::XMVECTOR positions[3];
+                bool isInside = false;
+                for (uint32 k = 0; k < 3; ++k)
+                {
+                    positions[k] = dx::XMVector3Transform(dx::XMLoadFloat3(&vertices[indices[i + k]].Vertex), world);
+                    isInside |= IsInsideFrustum(positions[k]);
+                }
+
+                if (isInside)
+                {
+                    const int32 facing = GetFacing(positions);
+                    isFrontFacingVisible |= facing > 0 || (facing == 0 && mesh.material->GetProperties().doubleSided);
+                    isBackFacingVisible |= facing < 0;
+                }
+            }
+
+            result.culledFrontFacingCount += isFrontFacingVisible ? 1 : 0;
+            result.culledBackFacingCount += !isFrontFacingVisible && isBackFacingVisible ? 1 : 0;
+        }
+
+        return result;
+    }
+
+    struct MeshletErrors
+    {
+        Size invalidCount = 0;
+        Size outsideCount = 0;
+        Size outsideConeCount = 0;
+        Size conesCount = 0;
+        // Meshlets closed by the triangle limit.
+        Size fullCount = 0;
+    };
+
+    // Checks the ranges, limits, spheres and cones of meshlets against their triangles.
+    MeshletErrors CheckMeshlets(const std::vector<Vertex> &vertices, const std::vector<uint32> &indices, const std::vector<Meshlet> &meshlets)
+    {
+        MeshletErrors errors;
+        uint32 nextIndex = 0;
+        for (Size m = 0; m < meshlets.size(); ++m)
+        {
+            const auto &meshlet = meshlets[m];
+
+            // Meshlets cover the index buffer in order.
+            errors.invalidCount += meshlet.indexOffset != nextIndex || meshlet.indexCount == 0 || meshlet.indexCount % 3 != 0 ? 1 : 0;
+            nextIndex = meshlet.indexOffset + meshlet.indexCount;
+
+            std::set<uint32> unique(indices.begin() + meshlet.indexOffset, indices.begin() + nextIndex);
+            errors.invalidCount += unique.size() != meshlet.verticesCount ? 1 : 0;
+            errors.invalidCount += meshlet.verticesCount > MeshOptimizer::MaxMeshletVertices ? 1 : 0;
+            errors.invalidCount += meshlet.indexCount > MeshOptimizer::MaxMeshletTriangles * 3 ? 1 : 0;
+            errors.fullCount += meshlet.indexCount == MeshOptimizer::MaxMeshletTriangles * 3 ? 1 : 0;
+
+            // A meshlet only ends when the next triangle would not fit.
+            if (m + 1 < meshlets.size())
+            {
+                Size newVerticesCount = 0;
+                for (Size k = 0; k < 3; ++k)
+                {
+                    newVerticesCount += unique.count(indices[nextIndex + k]) == 0 ? 1 : 0;
+                }
+                errors.invalidCount += meshlet.verticesCount + newVerticesCount <= MeshOptimizer::MaxMeshletVertices &&
+                        meshlet.indexCount < MeshOptimizer::MaxMeshletTriangles * 3 ? 1 : 0;
+            }
+
+            const auto center = dx::XMLoadFloat3(&meshlet.center);
+            for (auto index : unique)
+            {
+                const float32 distance = dx::XMVectorGetX(dx::XMVector3Length(dx::XMVectorSubtract(dx::XMLoadFloat3(&vertices[index].Vertex), center)));
+                errors.outsideCount += distance > meshlet.radius * 1.0001f + 1e-6f ? 1 : 0;
+            }
+
+            if (meshlet.coneCutoff < 1.0f)
+            {
+                ++errors.conesCount;
+                const float32 minDot = std::sqrt(1.0f - meshlet.coneCutoff * meshlet.coneCutoff);
+                const auto axis = dx::XMLoadFloat3(&meshlet.coneAxis);
+                for (uint32 i = meshlet.indexOffset; i < nextIndex; i += 3)
+                {
+                    auto p0 = dx::XMLoadFloat3(&vertices[indices[i]].Vertex);
+                    auto normal = dx::XMVector3Cross(
+                        dx::XMVectorSubtract(dx::XMLoadFloat3(&vertices[indices[i + 1]].Vertex), p0),
+                        dx::XMVectorSubtract(dx::XMLoadFloat3(&vertices[indices[i + 2]].Vertex), p0));
+                    errors.outsideConeCount += dx::XMVectorGetX(dx::XMVector3Dot(dx::XMVector3Normalize(normal), axis)) < minDot - 1e-4f ? 1 : 0;
+                }
+            }
+        }
+
+        errors.invalidCount += nextIndex != indices.size() ? 1 : 0;
+        return errors;
+    }
+
+    Mesh CreateMesh(const std::vector<Meshlet> &meshlets, bool isDoubleSided)
+    {
+        MaterialProperties properties;
+        properties.doubleSided = isDoubleSided;
+
+        Mesh mesh;
+        mesh.meshlets = MakeShared<const std::vector<Meshlet>>(meshlets);
+        mesh.material = MakeShared<Material>();
+        mesh.material->SetProperties(properties);
+        return mesh;
+    }
+}
+
+TEST_CASE("Meshlets respect the vertex limit and bound their triangles")
+{
+    std::vector<Vertex> vertices;
+    std::vector<uint32> indices;
+    CreateSphere(48, 96, vertices, indices);
+    MeshOptimizer::Optimize(vertices, indices);
+
+    const auto meshlets = MeshOptimizer::BuildMeshlets(vertices, indices);
+    CHECK(meshlets.size() > 1);
+
+    const auto errors = CheckMeshlets(vertices, indices, meshlets);
+    CHECK_EQUAL(errors.invalidCount, 0);
+    CHECK_EQUAL(errors.outsideCount, 0);
+    CHECK_EQUAL(errors.outsideConeCount, 0);
+    // Patches of a smooth closed surface have narrow cones.
+    CHECK(errors.conesCount * 2 > meshlets.size());
+}
+
+TEST_CASE("Meshlets respect the triangle limit when triangles share their vertices")
+{
+    std::mt19937 random(124);
+
+    std::vector<Vertex> vertices;
+    std::vector<uint32> indices;
+    CreateSphere(4, 6, vertices, indices);
+
+    // Random triangles over a few vertices reach the triangle limit long before the vertex limit.
+    std::uniform_int_distribution<uint32> vertex(0, static_cast<uint32>(vertices.size() - 1));
+    indices.clear();
+    while (indices.size() < 3000)
+    {
+        const uint32 a = vertex(random);
+        const uint32 b = vertex(random);
+        const uint32 c = vertex(random);
+        if (a != b && b != c && a != c)
+        {
+            indices.insert(indices.end(), {a, b, c});
+        }
+    }
+
+    const auto meshlets = MeshOptimizer::BuildMeshlets(vertices, indices);
+    const auto errors = CheckMeshlets(vertices, indices, meshlets);
+    CHECK_EQUAL(errors.invalidCount, 0);
+    CHECK_EQUAL(errors.outsideCount, 0);
+    CHECK_EQUAL(errors.outsideConeCount, 0);
+    CHECK_EQUAL(errors.fullCount, meshlets.size() - 1);
+}
+
+TEST_CASE("Culling only drops meshlets outside the frustum or facing away from the eye")
+{
+    std::mt19937 random(8);
+
+    std::vector<Vertex> vertices;
+    std::vector<uint32> indices;
+    CreateSphere(32, 64, vertices, indices);
+    MeshOptimizer::Optimize(vertices, indices);
+    const auto meshlets = MeshOptimizer::BuildMeshlets(vertices, indices);
+
+    const Mesh mesh = CreateMesh(meshlets, false);
+    const Mesh doubleSidedMesh = CreateMesh(meshlets, true);
+
+    CullResult total;
+    CullResult doubleSidedTotal;
+    Size visibleCount = 0;
+    for (uint32 i = 0; i < 300; ++i)
+    {
+        const auto world = CreateWorld(random, i % 3 != 2, i % 4 == 1);
+
+        const auto result = CullAndCheck(mesh, vertices, indices, world);
+        total.keptCount += result.keptCount;
+        total.culledFrontFacingCount += result.culledFrontFacingCount;
+        total.culledBackFacingCount += result.culledBackFacingCount;
+        total.invalidRangesCount += result.invalidRangesCount;
+        visibleCount += result.keptCount > 0 ? 1 : 0;
+
+        const auto doubleSidedResult = CullAndCheck(doubleSidedMesh, vertices, indices, world);
+        doubleSidedTotal.culledFrontFacingCount += doubleSidedResult.culledFrontFacingCount;
+        doubleSidedTotal.culledBackFacingCount += doubleSidedResult.culledBackFacingCount;
+        doubleSidedTotal.invalidRangesCount += doubleSidedResult.invalidRangesCount;
+    }
+
+    CHECK_EQUAL(total.invalidRangesCount, 0);
+    CHECK_EQUAL(total.culledFrontFacingCount, 0);
+    CHECK_EQUAL(doubleSidedTotal.invalidRangesCount, 0);
+    CHECK_EQUAL(doubleSidedTotal.culledFrontFacingCount, 0);
+
+    // The back of the sphere is culled by the cones, unless the material is double sided.
+    CHECK(total.culledBackFacingCount > 0);
+    CHECK_EQUAL(doubleSidedTotal.culledBackFacingCount, 0);
+    CHECK(visibleCount > 0 && visibleCount < 300);
+}
+
+TEST_CASE("The back of a sphere in front of the camera is cone culled")
+{
+    std::vector<Vertex> vertices;
+    std::vector<uint32> indices;
+    CreateSphere(32, 64, vertices, indices);
+    MeshOptimizer::Optimize(vertices, indices);
+    const auto meshlets = MeshOptimizer::BuildMeshlets(vertices, indices);
+
+    const Mesh mesh = CreateMesh(meshlets, false);
+    const auto world = dx::XMMatrixMultiply(dx::XMMatrixScaling(2.0f, 2.0f, 2.0f), dx::XMMatrixTranslation(0.0f, 0.0f, 20.0f));
+
+    const auto result = CullAndCheck(mesh, vertices, indices, world);
+    CHECK_EQUAL(result.invalidRangesCount, 0);
+    CHECK_EQUAL(result.culledFrontFacingCount, 0);
+    CHECK(result.culledBackFacingCount > 0);
+    CHECK_EQUAL(result.keptCount + result.culledBackFacingCount, meshlets.size());
+
+    // Behind the camera nothing survives.
+    std::vector<MeshletCulling::DrawRange> ranges;
+    const auto behind = dx::XMMatrixTranslation(0.0f, 0.0f, -20.0f);
+    CHECK_EQUAL(MeshletCulling::Cull(mesh, behind, 0, CreateView(), ranges), 0);
+    CHECK(ranges.empty());
+}
@@ -0,0 +1,248 @@
+#include <TestFramework.h>
+
+#include <MathUtils.h>
+#include <Scene/Components/AABBComponent.h>
+#include <Scene/Components/IsDisabledComponent.h>
+#include <Scene/Components/LocalTransformComponent.h>
+#include <Scene/Components/RelationshipComponent.h>
+#include <Scene/SceneBounds.h>
+#include <Scene/TransformHierarchy.h>
+
+#include <cfloat>
+#include <random>
+
+using namespace Engine;
+using namespace Engine::Scene;
+
+namespace
+{
+    struct Node
+    {
+        entt::entity entity = entt::null;
+        int32 parent = -1;
+    };
+
+    dx::XMMATRIX CreateLocalTransform(std::mt19937 &random)
+    {
+        std::uniform_real_distribution<float32> angle(-Math::PI, Math::PI);
+        std::uniform_real_distribution<float32> offset(-50.0f, 50.0f);
+
+        return dx::XMMatrixMultiply(
+            dx::XMMatrixRotationRollPitchYaw(angle(random), angle(random), angle(random)),
+            dx::XMMatrixTranslation(offset(random), offset(random), offset(random)));
+    }
+
+    // Roots with a few children each, every third node has no bounds.
+    std::vector<Node> CreateScene(std::mt19937 &random, entt::registry &registry)
+    {
+        std::uniform_int_distribution<int32> childrenCount(0, 5);
+        std::uniform_real_distribution<float32> extent(0.1f, 5.0f);
+
+        std::vector<Node> nodes;
+        for (int32 root = 0; root < 50; ++root)
+        {
+            const int32 parent = static_cast<int32>(nodes.size());
+            nodes.push_back({registry.create(), -1});
+            for (int32 i = childrenCount(random); i > 0; --i)
+            {
+                nodes.push_back({registry.create(), parent});
+            }
+        }
+
+        for (Size i = 0; i < nodes.size(); ++i)
+        {
+            Components::RelationshipComponent relationship;
+            relationship.depth = nodes[i].parent < 0 ? 0 : 1;
+            relationship.parent = nodes[i].parent < 0 ? entt::entity(entt::null) : nodes[nodes[i].parent].entity;
+
+            registry.emplace<Components::RelationshipComponent>(nodes[i].entity, relationship);
+            registry.emplace<Components::LocalTransformComponent>(nodes[i].entity, CreateLocalTransform(random));
+
+            if (i % 3 != 0)
+            {
+                const dx::BoundingBox bounds({0.0f, 0.0f, 0.0f}, {extent(random), extent(random), extent(random)});
+                registry.emplace<Components::AABBComponent>(nodes[i].entity, bounds, dx::BoundingBox());
+            }
+        }
+
+        return nodes;
+    }
+
+    // Union of the transformed corners of every enabled box, false when no enabled entity has bounds.
+    bool GetNaiveBounds(entt::registry &registry, const std::vector<Node> &nodes, dx::BoundingBox &bounds)
+    {
+        auto min = dx::XMVectorReplicate(FLT_MAX);
+        auto max = dx::XMVectorReplicate(-FLT_MAX);
+        bool isEmpty = true;
+
+        for (const auto &node : nodes)
+        {
+            if (!registry.has<Components::AABBComponent>(node.entity) || registry.has<Components::IsDisabledComponent>(node.entity))
+            {
+                continue;
+            }
+
+            auto world = registry.get<Components::LocalTransformComponent>(node.entity).transform;
+            if (node.parent >= 0)
+            {
+                world = dx::XMMatrixMultiply(world, registry.get<Components::LocalTransformComponent>(nodes[node.parent].entity).transform);
+            }
+
+            dx::XMFLOAT3 corners[dx::BoundingBox::CORNER_COUNT];
+            registry.get<Components::AABBComponent>(node.entity).originalBoundingBox.GetCorners(corners);
+            for (const auto &corner : corners)
+            {
+                const auto point = dx::XMVector3Transform(dx::XMLoadFloat3(&corner), world);
+                min = dx::XMVectorMin(min, point);
+                max = dx::XMVectorMax(max, point);
+            }
+            isEmpty = false;
+        }
+
+        if (!isEmpty)
+        {
+            dx::BoundingBox::CreateFromPoints(bounds, min, max);
+        }
+        return !isEmpty;
+    }
+
+    bool IsNear(const dx::BoundingBox &left, const dx::BoundingBox &right)
+    {
+        const auto epsilon = dx::XMVectorReplicate(1e-3f);
+        return dx::XMVector3NearEqual(dx::XMLoadFloat3(&left.Center), dx::XMLoadFloat3(&right.Center), epsilon) &&
+            dx::XMVector3NearEqual(dx::XMLoadFloat3(&left.Extents), dx::XMLoadFloat3(&right.Extents), epsilon);
+    }
+
+    // The order of WorldTransformSystem::Process.
+    bool Process(TransformHierarchy &hierarchy, SceneBounds &sceneBounds, entt::registry &registry)
+    {
+        if (hierarchy.Update(registry))
+        {
+            sceneBounds.MarkDirty();
+        }
+        return sceneBounds.Update(registry);
+    }
+
+    bool IsUnion(const SceneBounds &sceneBounds, entt::registry &registry, const std::vector<Node> &nodes)
+    {
+        dx::BoundingBox expected;
+        return GetNaiveBounds(registry, nodes, expected) && IsNear(sceneBounds.GetBounds(), expected);
+    }
+}
+
+TEST_CASE("Scene bounds are the union of the enabled world AABBs and stay cached")
+{
+    std::mt19937 random(17);
+
+    SceneBounds sceneBounds;
+    entt::registry registry;
+    sceneBounds.Connect(registry);
+
+    const auto nodes = CreateScene(random, registry);
+
+    // A node without bounds, like a camera or a light.
+    const auto camera = registry.create();
+    registry.emplace<Components::RelationshipComponent>(camera);
+    registry.emplace<Components::LocalTransformComponent>(camera, dx::XMMatrixIdentity());
+
+    TransformHierarchy hierarchy;
+    hierarchy.Rebuild(registry);
+
+    CHECK(Process(hierarchy, sceneBounds, registry));
+    CHECK(IsUnion(sceneBounds, registry, nodes));
+
+    // Neither a frame without changes nor a moving camera recomputes the union.
+    CHECK(!Process(hierarchy, sceneBounds, registry));
+    registry.get<Components::LocalTransformComponent>(camera).transform = CreateLocalTransform(random);
+    hierarchy.MarkDirty(camera);
+    CHECK(!Process(hierarchy, sceneBounds, registry));
+
+    // Moving a box does.
+    registry.get<Components::LocalTransformComponent>(nodes[1].entity).transform = CreateLocalTransform(random);
+    hierarchy.MarkDirty(nodes[1].entity);
+    CHECK(Process(hierarchy, sceneBounds, registry));
+    CHECK(IsUnion(sceneBounds, registry, nodes));
+}
+
+TEST_CASE("Scene bounds follow moved, disabled, removed and added boxes")
+{
+    std::mt19937 random(18);
+
+    SceneBounds sceneBounds;
+    entt::registry registry;
+    sceneBounds.Connect(registry);
+
+    const auto nodes = CreateScene(random, registry);
+
+    TransformHierarchy hierarchy;
+    hierarchy.Rebuild(registry);
+    Process(hierarchy, sceneBounds, registry);
+
+    std::uniform_int_distribution<Size> node(0, nodes.size() - 1);
+    Size mismatchesCount = 0;
+    Size recomputedCount = 0;
+    for (uint32 round = 0; round < 200; ++round)
+    {
+        const auto entity = nodes[node(random)].entity;
+        switch (round % 4)
+        {
+        case 0:
+            registry.get<Components::LocalTransformComponent>(entity).transform = CreateLocalTransform(random);
+            hierarchy.MarkDirty(entity);
+            break;
+        case 1:
+            if (registry.has<Components::IsDisabledComponent>(entity))
+            {
+                registry.remove<Components::IsDisabledComponent>(entity);
+            }
+            else
+            {
+                registry.emplace<Components::IsDisabledComponent>(entity);
+            }
+            break;
+        case 2:
+            if (registry.has<Components::AABBComponent>(entity))
+            {
+                registry.remove<Components::AABBComponent>(entity);
+                break;
+            }
+            // A new box only gets its world bounds from the next hierarchy update.
+            registry.emplace<Components::AABBComponent>(entity, dx::BoundingBox({1.0f, 2.0f, 3.0f}, {4.0f, 5.0f, 6.0f}), dx::BoundingBox());
+            hierarchy.MarkDirty(entity);
+            break;
+        default:
+            break;
+        }
+
+        recomputedCount += Process(hierarchy, sceneBounds, registry) ? 1 : 0;
+        mismatchesCount += IsUnion(sceneBounds, registry, nodes) ? 0 : 1;
+    }
+
+    CHECK_EQUAL(mismatchesCount, 0);
+    // Every fourth round changes nothing, so the cache is used.
+    CHECK(recomputedCount <= 150);
+    CHECK(recomputedCount > 100);
+}
+
+TEST_CASE("Scene bounds fall back to the default box without enabled boxes")
+{
+    std::mt19937 random(19);
+
+    SceneBounds sceneBounds;
+    entt::registry registry;
+    sceneBounds.Connect(registry);
+
+    const auto nodes = CreateScene(random, registry);
+
+    TransformHierarchy hierarchy;
+    hierarchy.Rebuild(registry);
+    Process(hierarchy, sceneBounds, registry);
+
+    for (const auto &node : nodes)
+    {
+        registry.emplace<Components::IsDisabledComponent>(node.entity);
+    }
+
+    CHECK(Process(hierarchy, sceneBounds, registry));
+    CHECK(IsNear(sceneBounds.GetBounds(), dx::BoundingBox()));
+}
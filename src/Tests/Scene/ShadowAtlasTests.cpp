@@ -0,0 +1,251 @@
+#include <TestFramework.h>
+
+#include <Scene/ShadowAtlas.h>
+
+#include <algorithm>
+#include <bit>
+#include <random>
+
+using namespace Engine;
+using namespace Engine::Scene;
+
+namespace
+{
+    constexpr uint32 AtlasSize = 4096;
+    constexpr uint32 MinTileSize = 64;
+
+    // Tiles stay inside the atlas, are aligned to their power of two size and never overlap,
+    // returns the area they cover.
+    uint64 CheckTiles(const ShadowAtlas &atlas, std::span<const dx::XMUINT3> tiles)
+    {
+        uint64 area = 0;
+        Size overlapsCount = 0;
+        for (Size i = 0; i < tiles.size(); ++i)
+        {
+            const auto &tile = tiles[i];
+            CHECK(std::has_single_bit(tile.z));
+            CHECK(tile.z >= atlas.GetMinTileSize() && tile.z <= atlas.GetSize());
+            CHECK(tile.x % tile.z == 0 && tile.y % tile.z == 0);
+            CHECK(tile.x + tile.z <= atlas.GetSize() && tile.y + tile.z <= atlas.GetSize());
+
+            for (Size j = 0; j < i; ++j)
+            {
+                const auto &other = tiles[j];
+                const bool isOverlapping = tile.x < other.x + other.z && other.x < tile.x + tile.z &&
+                    tile.y < other.y + other.z && other.y < tile.y + tile.z;
+                overlapsCount += isOverlapping ? 1 : 0;
+            }
+
+            area += static_cast<uint64>(tile.z) * tile.z;
+        }
+
+        CHECK_EQUAL(overlapsCount, 0);
+        CHECK(area <= static_cast<uint64>(atlas.GetSize()) * atlas.GetSize());
+        return area;
+    }
+
+    // Allocations follow the requests order, get all of their tiles or none and never grow past the wanted size.
+    void CheckAllocations(
+        const ShadowAtlas &atlas,
+        std::span<const ShadowAtlasRequest> requests,
+        std::span<const ShadowAtlasAllocation> allocations,
+        std::span<const dx::XMUINT3> tiles)
+    {
+        CHECK_EQUAL(allocations.size(), requests.size());
+
+        uint32 firstTile = 0;
+        for (Size i = 0; i < allocations.size() && i < requests.size(); ++i)
+        {
+            const auto &allocation = allocations[i];
+            CHECK_EQUAL(allocation.firstTile, firstTile);
+            CHECK(allocation.tilesCount == 0 || allocation.tilesCount == requests[i].tilesCount);
+
+            if (allocation.tilesCount > 0)
+            {
+                CHECK(allocation.tileSize <= std::bit_floor(std::clamp(requests[i].tileSize, atlas.GetMinTileSize(), atlas.GetSize())));
+                for (uint32 j = 0; j < allocation.tilesCount; ++j)
+                {
+                    CHECK_EQUAL(tiles[allocation.firstTile + j].z, allocation.tileSize);
+                }
+            }
+
+            firstTile += allocation.tilesCount;
+        }
+        CHECK_EQUAL(tiles.size(), firstTile);
+    }
+
+    std::vector<ShadowAtlasRequest> CreateRequests(std::mt19937 &random, Size count)
+    {
+        std::uniform_real_distribution<float32> importance(0.0f, 1.0f);
+        std::uniform_int_distribution<uint32> tileSize(0, 5000);
+
+        std::vector<ShadowAtlasRequest> requests(count);
+        for (auto &request : requests)
+        {
+            request.importance = importance(random);
+            request.tileSize = tileSize(random);
+            request.tilesCount = (importance(random) < 0.3f) ? 6 : 1;
+        }
+        return requests;
+    }
+}
+
+TEST_CASE("Tiles never overlap and stay aligned to their power of two size")
+{
+    std::mt19937 random(19);
+    std::uniform_int_distribution<Size> requestsCount(0, 80);
+
+    // One atlas for every frame, as the system keeps it.
+    ShadowAtlas atlas(AtlasSize, MinTileSize);
+    std::vector<ShadowAtlasAllocation> allocations;
+    std::vector<dx::XMUINT3> tiles;
+
+    for (int frame = 0; frame < 300; ++frame)
+    {
+        const auto requests = CreateRequests(random, requestsCount(random));
+        atlas.Allocate(requests, allocations, tiles);
+
+        CheckAllocations(atlas, requests, allocations, tiles);
+        CheckTiles(atlas, tiles);
+    }
+}
+
+TEST_CASE("Atlas and tile sizes are rounded to powers of two within the limits")
+{
+    const ShadowAtlas atlas(3000, 100);
+    CHECK_EQUAL(atlas.GetSize(), 2048);
+    CHECK_EQUAL(atlas.GetMinTileSize(), 128);
+
+    const ShadowAtlas tinyAtlas(100, 4096);
+    CHECK_EQUAL(tinyAtlas.GetSize(), 64);
+    CHECK_EQUAL(tinyAtlas.GetMinTileSize(), 64);
+
+    ShadowAtlas limitedAtlas(AtlasSize, MinTileSize);
+    std::vector<ShadowAtlasAllocation> allocations;
+    std::vector<dx::XMUINT3> tiles;
+
+    // Sizes over the atlas are clamped to it, sizes under the minimum raised to it, the others rounded down.
+    for (auto [wanted, expected] : {std::pair{10000u, AtlasSize}, {4096u, 4096u}, {3000u, 2048u}, {1u, MinTileSize}, {MinTileSize, MinTileSize}, {65u, 64u}, {0u, 0u}})
+    {
+        const ShadowAtlasRequest request = {1.0f, wanted, 1};
+        limitedAtlas.Allocate({&request, 1}, allocations, tiles);
+
+        CHECK_EQUAL(allocations[0].tileSize, expected);
+        CHECK_EQUAL(tiles.size(), expected > 0 ? 1 : 0);
+    }
+
+    CHECK_EQUAL(GetShadowTileSize(0.0f, MinTileSize, 2048), 0);
+    CHECK_EQUAL(GetShadowTileSize(-1.0f, MinTileSize, 2048), 0);
+    CHECK_EQUAL(GetShadowTileSize(0.001f, MinTileSize, 2048), MinTileSize);
+    CHECK_EQUAL(GetShadowTileSize(0.3f, MinTileSize, 2048), 512);
+    CHECK_EQUAL(GetShadowTileSize(0.5f, MinTileSize, 2048), 1024);
+    CHECK_EQUAL(GetShadowTileSize(1.0f, MinTileSize, 2048), 2048);
+    CHECK_EQUAL(GetShadowTileSize(4.0f, MinTileSize, 2048), 2048);
+}
+
+TEST_CASE("Less important requests are halved or dropped first when the atlas is full")
+{
+    ShadowAtlas atlas(AtlasSize, MinTileSize);
+    std::vector<ShadowAtlasAllocation> allocations;
+    std::vector<dx::XMUINT3> tiles;
+
+    // Room for four of the five wanted tiles, the least important one has to shrink to fit the rest.
+    const std::vector<ShadowAtlasRequest> requests = {
+        {0.2f, 2048, 1},
+        {0.9f, 2048, 1},
+        {0.1f, 2048, 1},
+        {0.5f, 2048, 1},
+        {0.7f, 2048, 1},
+    };
+    atlas.Allocate(requests, allocations, tiles);
+    CheckAllocations(atlas, requests, allocations, tiles);
+
+    CHECK_EQUAL(allocations[1].tileSize, 2048);
+    CHECK_EQUAL(allocations[4].tileSize, 2048);
+    CHECK_EQUAL(allocations[3].tileSize, 2048);
+    CHECK_EQUAL(allocations[0].tileSize, 2048);
+    CHECK_EQUAL(allocations[2].tilesCount, 0);
+    CHECK_EQUAL(CheckTiles(atlas, tiles), static_cast<uint64>(AtlasSize) * AtlasSize);
+
+    // A point light needs room for all six faces, it is halved until they fit.
+    const std::vector<ShadowAtlasRequest> pointRequests = {
+        {1.0f, 2048, 1},
+        {0.5f, 2048, 6},
+    };
+    atlas.Allocate(pointRequests, allocations, tiles);
+    CheckAllocations(atlas, pointRequests, allocations, tiles);
+    CHECK_EQUAL(allocations[0].tileSize, 2048);
+    CHECK_EQUAL(allocations[1].tileSize, 1024);
+    CHECK_EQUAL(allocations[1].tilesCount, 6);
+    CheckTiles(atlas, tiles);
+}
+
+TEST_CASE("Tiles of lights that leave are reclaimed by the remaining ones")
+{
+    ShadowAtlas atlas(AtlasSize, MinTileSize);
+    std::vector<ShadowAtlasAllocation> allocations;
+    std::vector<dx::XMUINT3> tiles;
+
+    std::vector<ShadowAtlasRequest> requests = {
+        {1.0f, 2048, 6},
+        {0.5f, 4096, 1},
+    };
+
+    // The point light takes a large part of the atlas, the spot light is halved to fit in what is left.
+    atlas.Allocate(requests, allocations, tiles);
+    CheckAllocations(atlas, requests, allocations, tiles);
+    CheckTiles(atlas, tiles);
+    CHECK_EQUAL(allocations[0].tileSize, 1024);
+    CHECK_EQUAL(allocations[1].tileSize, 2048);
+
+    // Once it goes out of view the spot light gets the whole atlas it asked for.
+    requests[0].tileSize = 0;
+    atlas.Allocate(requests, allocations, tiles);
+    CheckAllocations(atlas, requests, allocations, tiles);
+    CHECK_EQUAL(CheckTiles(atlas, tiles), static_cast<uint64>(AtlasSize) * AtlasSize);
+    CHECK_EQUAL(allocations[0].tilesCount, 0);
+    CHECK_EQUAL(allocations[1].tileSize, AtlasSize);
+
+    // Coming back it gets its tiles again, nothing of the frames before is left over.
+    requests[0].tileSize = 2048;
+    atlas.Allocate(requests, allocations, tiles);
+    CheckAllocations(atlas, requests, allocations, tiles);
+    CheckTiles(atlas, tiles);
+    CHECK_EQUAL(allocations[0].tileSize, 1024);
+    CHECK_EQUAL(allocations[0].tilesCount, 6);
+    CHECK_EQUAL(allocations[1].tileSize, 2048);
+
+    // Filling the atlas with minimum tiles frame after frame always hands out all of it,
+    // and a new light more important than the others takes the tile of the least important one.
+    const Size capacity = (AtlasSize / MinTileSize) * (AtlasSize / MinTileSize);
+    std::vector<ShadowAtlasRequest> smallRequests(capacity, {0.1f, MinTileSize, 1});
+    for (int frame = 0; frame < 3; ++frame)
+    {
+        atlas.Allocate(smallRequests, allocations, tiles);
+        CHECK_EQUAL(tiles.size(), capacity);
+        CHECK_EQUAL(CheckTiles(atlas, tiles), static_cast<uint64>(AtlasSize) * AtlasSize);
+        CHECK_EQUAL(allocations.back().tileSize, MinTileSize);
+
+        smallRequests.push_back({1.0f + frame, MinTileSize, 1});
+    }
+}
+
+TEST_CASE("Importance is the share of the viewport covered by the light")
+{
+    const auto projection = dx::XMMatrixPerspectiveFovLH(dx::XMConvertToRadians(60.0f), 1.0f, 0.1f, 1000.0f);
+    const dx::BoundingFrustum frustum(projection);
+    const float32 projectionScale = 1.0f / std::tan(dx::XMConvertToRadians(30.0f));
+    const auto eye = dx::XMVectorZero();
+
+    // Inside the light volume and out of view.
+    CHECK_EQUAL(GetShadowImportance(dx::BoundingSphere({0.0f, 0.0f, 1.0f}, 5.0f), frustum, eye, projectionScale), 1.0f);
+    CHECK_EQUAL(GetShadowImportance(dx::BoundingSphere({0.0f, 0.0f, -50.0f}, 5.0f), frustum, eye, projectionScale), 0.0f);
+
+    // Twice as far is half as important.
+    const float32 near = GetShadowImportance(dx::BoundingSphere({0.0f, 0.0f, 50.0f}, 5.0f), frustum, eye, projectionScale);
+    const float32 far = GetShadowImportance(dx::BoundingSphere({0.0f, 0.0f, 100.0f}, 5.0f), frustum, eye, projectionScale);
+    CHECK_NEAR(near, 5.0f * projectionScale / 50.0f, 1e-5f);
+    CHECK_NEAR(far, near * 0.5f, 1e-5f);
+
+    CHECK(GetShadowImportance(dx::BoundingSphere({0.0f, 0.0f, 6.0f}, 5.0f), frustum, eye, projectionScale) <= 1.0f);
+}
@@ -0,0 +1,242 @@
+#include <TestFramework.h>
+
+#include <MathUtils.h>
+#include <Scene/ShadowCascades.h>
+
+#include <array>
+#include <random>
+
+using namespace Engine;
+using namespace Engine::Scene;
+
+namespace
+{
+    constexpr float32 Epsilon = 1e-4f;
+    constexpr uint32 Resolution = 2048;
+
+    struct CameraSetup
+    {
+        dx::XMMATRIX world;
+        float32 tanHalfWidth;
+        float32 tanHalfHeight;
+    };
+
+    CameraSetup CreateCamera(std::mt19937 &random, float32 fovY, float32 aspectRatio)
+    {
+        std::uniform_real_distribution<float32> angle(-Math::PI, Math::PI);
+        std::uniform_real_distribution<float32> position(-500.0f, 500.0f);
+
+        CameraSetup camera;
+        camera.world = dx::XMMatrixMultiply(
+            dx::XMMatrixRotationRollPitchYaw(angle(random), angle(random), angle(random)),
+            dx::XMMatrixTranslation(position(random), position(random), position(random)));
+        camera.tanHalfHeight = std::tan(fovY * 0.5f);
+        camera.tanHalfWidth = camera.tanHalfHeight * aspectRatio;
+        return camera;
+    }
+
+    // World space corners of the camera frustum between two view depths.
+    std::array<dx::XMVECTOR, 8> GetSliceCorners(const CameraSetup &camera, float32 sliceNear, float32 sliceFar)
+    {
+        std::array<dx::XMVECTOR, 8> corners;
+        for (uint32 i = 0; i < corners.size(); ++i)
+        {
+            const float32 depth = (i & 4) ? sliceFar : sliceNear;
+            const float32 x = ((i & 1) ? 1.0f : -1.0f) * camera.tanHalfWidth * depth;
+            const float32 y = ((i & 2) ? 1.0f : -1.0f) * camera.tanHalfHeight * depth;
+            corners[i] = dx::XMVector3Transform(dx::XMVectorSet(x, y, depth, 1.0f), camera.world);
+        }
+        return corners;
+    }
+
+    bool IsInsideClipVolume(dx::FXMVECTOR position, const dx::XMMATRIX &viewProjection)
+    {
+        dx::XMFLOAT4 clip;
+        dx::XMStoreFloat4(&clip, dx::XMVector4Transform(dx::XMVectorSetW(position, 1.0f), viewProjection));
+
+        return std::abs(clip.x) <= 1.0f + Epsilon && std::abs(clip.y) <= 1.0f + Epsilon &&
+            clip.z >= -Epsilon && clip.z <= 1.0f + Epsilon;
+    }
+
+    // Compares in light space, where the bounds are axis aligned, with a tolerance relative to the world coordinates.
+    bool IsInsideBounds(dx::FXMVECTOR position, const ShadowCascades::Cascade &cascade)
+    {
+        const auto &bounds = cascade.bounds;
+        const auto offset = dx::XMVector3Transform(dx::XMVectorSubtract(position, dx::XMLoadFloat3(&bounds.Center)), cascade.view);
+        const float32 tolerance = Epsilon * (1.0f + dx::XMVectorGetX(dx::XMVector3Length(position)));
+
+        dx::XMFLOAT3 local;
+        dx::XMStoreFloat3(&local, offset);
+        return std::abs(local.x) <= bounds.Extents.x + tolerance && std::abs(local.y) <= bounds.Extents.y + tolerance &&
+            std::abs(local.z) <= bounds.Extents.z + tolerance;
+    }
+
+    // Shadow map texel coordinates of a world position, the orthographic projection keeps w at one.
+    dx::XMFLOAT2 GetTexelPosition(dx::FXMVECTOR position, const dx::XMMATRIX &viewProjection)
+    {
+        dx::XMFLOAT4 clip;
+        dx::XMStoreFloat4(&clip, dx::XMVector4Transform(dx::XMVectorSetW(position, 1.0f), viewProjection));
+
+        return {(clip.x * 0.5f + 0.5f) * Resolution, (0.5f - clip.y * 0.5f) * Resolution};
+    }
+
+    const dx::BoundingBox SceneBounds({0.0f, 0.0f, 0.0f}, {800.0f, 200.0f, 800.0f});
+}
+
+TEST_CASE("Splits blend uniform and logarithmic partitions and end at the far plane")
+{
+    constexpr float32 Near = 0.5f;
+    constexpr float32 Far = 400.0f;
+
+    std::array<float32, 4> uniform;
+    ShadowCascades::ComputeSplits(Near, Far, 0.0f, uniform);
+    for (Size i = 0; i < uniform.size(); ++i)
+    {
+        CHECK_NEAR(uniform[i], Near + (Far - Near) * (i + 1) / uniform.size(), Far * Epsilon);
+    }
+
+    // Logarithmic splits grow by the same ratio from the near plane on.
+    std::array<float32, 4> logarithmic;
+    ShadowCascades::ComputeSplits(Near, Far, 1.0f, logarithmic);
+    const float32 ratio = std::pow(Far / Near, 1.0f / logarithmic.size());
+    CHECK_NEAR(logarithmic[0] / Near, ratio, ratio * Epsilon);
+    for (Size i = 1; i < logarithmic.size(); ++i)
+    {
+        CHECK_NEAR(logarithmic[i] / logarithmic[i - 1], ratio, ratio * Epsilon);
+    }
+
+    std::array<float32, 4> practical;
+    ShadowCascades::ComputeSplits(Near, Far, 0.75f, practical);
+    for (Size i = 0; i < practical.size(); ++i)
+    {
+        CHECK(practical[i] >= logarithmic[i] - Epsilon && practical[i] <= uniform[i] + Epsilon);
+        CHECK(i == 0 || practical[i] > practical[i - 1]);
+    }
+
+    for (const auto &splits : {uniform, logarithmic, practical})
+    {
+        CHECK_EQUAL(splits.back(), Far);
+    }
+
+    std::array<float32, 1> single;
+    ShadowCascades::ComputeSplits(Near, Far, 0.5f, single);
+    CHECK_EQUAL(single[0], Far);
+}
+
+TEST_CASE("Cascades contain their whole camera slice")
+{
+    std::mt19937 random(18);
+    std::uniform_real_distribution<float32> direction(-1.0f, 1.0f);
+
+    for (int i = 0; i < 500; ++i)
+    {
+        // Narrow and very wide cameras, the wide ones move the sphere center to the far plane.
+        const float32 fovY = (i % 2 == 0) ? dx::XMConvertToRadians(60.0f) : dx::XMConvertToRadians(150.0f);
+        const auto camera = CreateCamera(random, fovY, 16.0f / 9.0f);
+        const auto lightDirection = dx::XMVectorSet(direction(random), -1.0f, direction(random), 0.0f);
+
+        std::array<float32, 4> splits;
+        ShadowCascades::ComputeSplits(0.1f, 300.0f, 0.7f, splits);
+
+        float32 sliceNear = 0.1f;
+        for (float32 sliceFar : splits)
+        {
+            const auto cascade = ShadowCascades::Fit(camera.world, camera.tanHalfWidth, camera.tanHalfHeight,
+                sliceNear, sliceFar, lightDirection, Resolution, SceneBounds);
+            CHECK_EQUAL(cascade.splitDepth, sliceFar);
+
+            for (const auto &corner : GetSliceCorners(camera, sliceNear, sliceFar))
+            {
+                CHECK(IsInsideClipVolume(corner, cascade.viewProjection));
+
+                // The world space bounds the cascade is culled with cover the same volume as its projection.
+                CHECK(IsInsideBounds(corner, cascade));
+            }
+
+            sliceNear = sliceFar;
+        }
+    }
+}
+
+TEST_CASE("Cascades keep every caster of the scene between the camera slice and the light")
+{
+    std::mt19937 random(19);
+    std::uniform_real_distribution<float32> direction(-1.0f, 1.0f);
+
+    dx::XMFLOAT3 sceneCorners[dx::BoundingBox::CORNER_COUNT];
+    SceneBounds.GetCorners(sceneCorners);
+
+    for (int i = 0; i < 200; ++i)
+    {
+        const auto camera = CreateCamera(random, dx::XMConvertToRadians(60.0f), 1.5f);
+        const auto lightDirection = dx::XMVectorSet(direction(random), -1.0f, direction(random), 0.0f);
+
+        const auto cascade = ShadowCascades::Fit(camera.world, camera.tanHalfWidth, camera.tanHalfHeight,
+            1.0f, 50.0f, lightDirection, Resolution, SceneBounds);
+
+        // The near plane is pulled back to the scene bounds, so no caster in front of the slice gets clipped.
+        for (const auto &corner : sceneCorners)
+        {
+            dx::XMFLOAT4 clip;
+            dx::XMStoreFloat4(&clip, dx::XMVector4Transform(dx::XMVectorSet(corner.x, corner.y, corner.z, 1.0f), cascade.viewProjection));
+            CHECK(clip.z >= -Epsilon);
+        }
+    }
+}
+
+TEST_CASE("Cascade size does not change while the camera rotates")
+{
+    std::mt19937 random(20);
+    const auto lightDirection = dx::XMVectorSet(0.3f, -1.0f, 0.2f, 0.0f);
+
+    float32 width = 0.0f;
+    for (int i = 0; i < 100; ++i)
+    {
+        const auto camera = CreateCamera(random, dx::XMConvertToRadians(70.0f), 16.0f / 9.0f);
+        const auto cascade = ShadowCascades::Fit(camera.world, camera.tanHalfWidth, camera.tanHalfHeight,
+            5.0f, 40.0f, lightDirection, Resolution, SceneBounds);
+
+        dx::XMFLOAT4X4 projection;
+        dx::XMStoreFloat4x4(&projection, cascade.projection);
+
+        const float32 cascadeWidth = 2.0f / projection._11;
+        CHECK_NEAR(2.0f / projection._22, cascadeWidth, cascadeWidth * Epsilon);
+        CHECK(i == 0 || std::abs(cascadeWidth - width) <= width * Epsilon);
+        width = cascadeWidth;
+    }
+}
+
+TEST_CASE("Moving the camera shifts the cascade by whole texels")
+{
+    std::mt19937 random(21);
+    std::uniform_real_distribution<float32> step(-3.0f, 3.0f);
+
+    for (auto lightDirection : {dx::XMVectorSet(0.3f, -1.0f, 0.2f, 0.0f), dx::XMVectorSet(0.0f, -1.0f, 0.0f, 0.0f)})
+    {
+        auto camera = CreateCamera(random, dx::XMConvertToRadians(60.0f), 16.0f / 9.0f);
+
+        // A fixed world point lands on the same spot inside its texel wherever the camera goes.
+        const auto probe = dx::XMVectorSet(12.5f, 3.25f, -7.75f, 1.0f);
+
+        dx::XMFLOAT2 firstTexel = {};
+        for (int i = 0; i < 100; ++i)
+        {
+            const auto cascade = ShadowCascades::Fit(camera.world, camera.tanHalfWidth, camera.tanHalfHeight,
+                1.0f, 20.0f, lightDirection, Resolution, SceneBounds);
+
+            const auto texel = GetTexelPosition(probe, cascade.viewProjection);
+            CHECK(!std::isnan(texel.x) && !std::isnan(texel.y));
+            if (i == 0)
+            {
+                firstTexel = texel;
+            }
+
+            const float32 shiftX = texel.x - firstTexel.x;
+            const float32 shiftY = texel.y - firstTexel.y;
+            CHECK_NEAR(shiftX, std::round(shiftX), 0.01f);
+            CHECK_NEAR(shiftY, std::round(shiftY), 0.01f);
+
+            camera.world = dx::XMMatrixMultiply(camera.world, dx::XMMatrixTranslation(step(random), step(random), step(random)));
+        }
+    }
+}
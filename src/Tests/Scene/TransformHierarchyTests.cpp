@@ -0,0 +1,241 @@
+#include <TestFramework.h>
+
+#include <MathUtils.h>
+#include <Scene/Components/AABBComponent.h>
+#include <Scene/Components/LocalTransformComponent.h>
+#include <Scene/Components/RelationshipComponent.h>
+#include <Scene/Components/WorldTransformComponent.h>
+#include <Scene/TransformHierarchy.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace Engine;
+using namespace Engine::Scene;
+
+namespace
+{
+    constexpr float32 Epsilon = 1e-4f;
+
+    struct Node
+    {
+        entt::entity entity = entt::null;
+        // Index of the parent node, nodes only point at earlier ones.
+        int32 parent = -1;
+    };
+
+    dx::XMMATRIX CreateLocalTransform(std::mt19937 &random)
+    {
+        std::uniform_real_distribution<float32> angle(-Math::PI, Math::PI);
+        std::uniform_real_distribution<float32> scale(0.5f, 1.5f);
+        std::uniform_real_distribution<float32> offset(-10.0f, 10.0f);
+
+        return dx::XMMatrixMultiply(
+            dx::XMMatrixMultiply(
+                dx::XMMatrixScaling(scale(random), scale(random), scale(random)),
+                dx::XMMatrixRotationRollPitchYaw(angle(random), angle(random), angle(random))),
+            dx::XMMatrixTranslation(offset(random), offset(random), offset(random)));
+    }
+
+    // A random forest whose entities are created in a shuffled order, so the registry is not sorted by depth.
+    std::vector<Node> CreateForest(std::mt19937 &random, entt::registry &registry, Size nodesCount)
+    {
+        std::vector<Node> nodes(nodesCount);
+        std::vector<Size> depths(nodesCount, 0);
+        for (Size i = 1; i < nodesCount; ++i)
+        {
+            // A few roots, uniform parents give about ln(n) levels and the middle ones span several update tasks.
+            if (std::uniform_int_distribution<Size>(0, 99)(random) >= 2)
+            {
+                nodes[i].parent = static_cast<int32>(std::uniform_int_distribution<Size>(0, i - 1)(random));
+                depths[i] = depths[nodes[i].parent] + 1;
+            }
+        }
+
+        std::vector<Size> order(nodesCount);
+        for (Size i = 0; i < nodesCount; ++i)
+        {
+            order[i] = i;
+        }
+        std::shuffle(order.begin(), order.end(), random);
+
+        for (auto i : order)
+        {
+            nodes[i].entity = registry.create();
+        }
+
+        std::uniform_real_distribution<float32> extent(0.1f, 2.0f);
+        for (auto i : order)
+        {
+            Components::RelationshipComponent relationship;
+            relationship.depth = depths[i];
+            relationship.parent = nodes[i].parent < 0 ? entt::entity(entt::null) : nodes[nodes[i].parent].entity;
+
+            registry.emplace<Components::RelationshipComponent>(nodes[i].entity, relationship);
+            registry.emplace<Components::LocalTransformComponent>(nodes[i].entity, CreateLocalTransform(random));
+
+            if (i % 3 != 0)
+            {
+                const dx::BoundingBox bounds({extent(random), -extent(random), extent(random)}, {extent(random), extent(random), extent(random)});
+                registry.emplace<Components::AABBComponent>(nodes[i].entity, bounds, dx::BoundingBox());
+            }
+        }
+
+        return nodes;
+    }
+
+    // World transforms of a walk up the parent chain of every node.
+    std::vector<dx::XMMATRIX> GetNaiveWorldTransforms(entt::registry &registry, const std::vector<Node> &nodes)
+    {
+        std::vector<dx::XMMATRIX> worlds(nodes.size());
+        for (Size i = 0; i < nodes.size(); ++i)
+        {
+            worlds[i] = registry.get<Components::LocalTransformComponent>(nodes[i].entity).transform;
+            for (int32 parent = nodes[i].parent; parent >= 0; parent = nodes[parent].parent)
+            {
+                worlds[i] = dx::XMMatrixMultiply(worlds[i], registry.get<Components::LocalTransformComponent>(nodes[parent].entity).transform);
+            }
+        }
+        return worlds;
+    }
+
+    bool IsNear(const dx::XMMATRIX &left, const dx::XMMATRIX &right)
+    {
+        for (Size row = 0; row < 4; ++row)
+        {
+            // Deep chains of large translations accumulate rounding relative to the magnitude of the values.
+            const float32 tolerance = Epsilon * (1.0f + dx::XMVectorGetX(dx::XMVector4Length(right.r[row])));
+            if (!dx::XMVector4NearEqual(left.r[row], right.r[row], dx::XMVectorReplicate(tolerance)))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Bounds of the eight transformed corners of the original box.
+    dx::BoundingBox GetNaiveBoundingBox(const dx::BoundingBox &bounds, const dx::XMMATRIX &world)
+    {
+        dx::XMFLOAT3 corners[dx::BoundingBox::CORNER_COUNT];
+        bounds.GetCorners(corners);
+        for (auto &corner : corners)
+        {
+            dx::XMStoreFloat3(&corner, dx::XMVector3Transform(dx::XMLoadFloat3(&corner), world));
+        }
+
+        dx::BoundingBox result;
+        dx::BoundingBox::CreateFromPoints(result, dx::BoundingBox::CORNER_COUNT, corners, sizeof(dx::XMFLOAT3));
+        return result;
+    }
+
+    Size CountMismatches(entt::registry &registry, const std::vector<Node> &nodes)
+    {
+        const auto worlds = GetNaiveWorldTransforms(registry, nodes);
+
+        Size mismatchesCount = 0;
+        for (Size i = 0; i < nodes.size(); ++i)
+        {
+            const auto &world = registry.get<Components::WorldTransformComponent>(nodes[i].entity).transform;
+            mismatchesCount += IsNear(world, worlds[i]) ? 0 : 1;
+
+            if (registry.has<Components::AABBComponent>(nodes[i].entity))
+            {
+                const auto &bounds = registry.get<Components::AABBComponent>(nodes[i].entity);
+                const auto expected = GetNaiveBoundingBox(bounds.originalBoundingBox, worlds[i]);
+
+                const float32 tolerance = Epsilon * (1.0f + dx::XMVectorGetX(dx::XMVector3Length(dx::XMLoadFloat3(&expected.Center))));
+                const auto vectorTolerance = dx::XMVectorReplicate(tolerance);
+                mismatchesCount += dx::XMVector3NearEqual(dx::XMLoadFloat3(&bounds.boundingBox.Center), dx::XMLoadFloat3(&expected.Center), vectorTolerance) &&
+                        dx::XMVector3NearEqual(dx::XMLoadFloat3(&bounds.boundingBox.Extents), dx::XMLoadFloat3(&expected.Extents), vectorTolerance) ? 0 : 1;
+            }
+        }
+        return mismatchesCount;
+    }
+
+    bool IsDescendant(const std::vector<Node> &nodes, Size node, const std::vector<bool> &isDirty)
+    {
+        for (int32 i = static_cast<int32>(node); i >= 0; i = nodes[i].parent)
+        {
+            if (isDirty[i])
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+TEST_CASE("Level order updates match a walk up the parent chain")
+{
+    std::mt19937 random(12);
+
+    entt::registry registry;
+    const auto nodes = CreateForest(random, registry, 6000);
+
+    TransformHierarchy hierarchy;
+    hierarchy.Rebuild(registry);
+    CHECK_EQUAL(hierarchy.GetNodesCount(), nodes.size());
+
+    CHECK(hierarchy.Update(registry));
+    CHECK_EQUAL(CountMismatches(registry, nodes), 0);
+
+    // Nothing is dirty after an update.
+    CHECK(!hierarchy.Update(registry));
+}
+
+TEST_CASE("Only dirty nodes and their descendants are recomputed")
+{
+    std::mt19937 random(13);
+
+    entt::registry registry;
+    const auto nodes = CreateForest(random, registry, 6000);
+
+    TransformHierarchy hierarchy;
+    hierarchy.Rebuild(registry);
+    hierarchy.Update(registry);
+
+    const auto poison = dx::XMMatrixScaling(0.0f, 0.0f, 0.0f);
+    for (uint32 round = 0; round < 4; ++round)
+    {
+        std::vector<bool> isDirty(nodes.size(), false);
+        for (Size i = 0; i < 40; ++i)
+        {
+            const Size node = std::uniform_int_distribution<Size>(0, nodes.size() - 1)(random);
+            isDirty[node] = true;
+            registry.get<Components::LocalTransformComponent>(nodes[node].entity).transform = CreateLocalTransform(random);
+            hierarchy.MarkDirty(nodes[node].entity);
+        }
+
+        // Clean nodes keep whatever their world transform holds, a poisoned value shows any needless write.
+        Size cleanCount = 0;
+        std::vector<dx::XMMATRIX> cleanWorlds(nodes.size());
+        for (Size i = 0; i < nodes.size(); ++i)
+        {
+            if (!IsDescendant(nodes, i, isDirty))
+            {
+                auto &world = registry.get<Components::WorldTransformComponent>(nodes[i].entity).transform;
+                cleanWorlds[i] = world;
+                world = poison;
+                ++cleanCount;
+            }
+        }
+        CHECK(cleanCount > 0 && cleanCount < nodes.size());
+
+        hierarchy.Update(registry);
+
+        Size writtenCount = 0;
+        for (Size i = 0; i < nodes.size(); ++i)
+        {
+            if (!IsDescendant(nodes, i, isDirty))
+            {
+                auto &world = registry.get<Components::WorldTransformComponent>(nodes[i].entity).transform;
+                writtenCount += IsNear(world, poison) ? 0 : 1;
+                world = cleanWorlds[i];
+            }
+        }
+
+        CHECK_EQUAL(writtenCount, 0);
+        CHECK_EQUAL(CountMismatches(registry, nodes), 0);
+    }
+}
@@ -0,0 +1,159 @@
+#include <TestFramework.h>
+
+#include <Scene/VertexCompression.h>
+
+#include <algorithm>
+#include <random>
+
+using namespace Engine::Scene;
+
+namespace
+{
+    // Largest angle between two unit vectors the octahedral snorm16 encoding may introduce.
+    constexpr float32 MaxDirectionError = 1e-4f;
+
+    DirectX::XMFLOAT3 RandomDirection(std::mt19937& random)
+    {
+        std::normal_distribution<float32> distribution;
+
+        DirectX::XMFLOAT3 direction;
+        do
+        {
+            direction = {distribution(random), distribution(random), distribution(random)};
+        } while (direction.x * direction.x + direction.y * direction.y + direction.z * direction.z < 1e-4f);
+
+        DirectX::XMStoreFloat3(&direction, DirectX::XMVector3Normalize(DirectX::XMLoadFloat3(&direction)));
+        return direction;
+    }
+
+    float32 GetDistance(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b)
+    {
+        return std::sqrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y) + (a.z - b.z) * (a.z - b.z));
+    }
+
+    float32 Dot(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b)
+    {
+        return a.x * b.x + a.y * b.y + a.z * b.z;
+    }
+
+    // Half floats keep 11 significant bits, rounding loses at most half of the last one.
+    bool IsWithinHalfPrecision(float32 decoded, float32 source)
+    {
+        const float32 magnitude = std::max(std::abs(source), 6.1e-5f);
+        return std::abs(decoded - source) <= magnitude * (1.0f / 2048.0f);
+    }
+
+    std::vector<Vertex> GetRandomVertices(std::mt19937& random, Size count)
+    {
+        std::uniform_real_distribution<float32> position(-250.0f, 250.0f);
+        std::uniform_real_distribution<float32> textureCoord(-4.0f, 4.0f);
+        std::bernoulli_distribution sign;
+
+        std::vector<Vertex> vertices(count);
+        for (auto& vertex : vertices)
+        {
+            vertex.Vertex = {position(random), position(random) * 0.1f, position(random) * 3.0f};
+            vertex.Normal = RandomDirection(random);
+            vertex.TextureCoord = {textureCoord(random), textureCoord(random)};
+
+            const auto tangent = RandomDirection(random);
+            vertex.Tangent = {tangent.x, tangent.y, tangent.z, sign(random) ? 1.0f : -1.0f};
+        }
+        return vertices;
+    }
+}
+
+static_assert(sizeof(CompactVertex) == 20);
+
+TEST_CASE("Octahedral encoding round trips the axes and both hemispheres")
+{
+    const DirectX::XMFLOAT3 axes[] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+    for (const auto& axis : axes)
+    {
+        CHECK(GetDistance(VertexCompression::DecodeOctahedron(VertexCompression::EncodeOctahedron(axis)), axis) < 1e-6f);
+    }
+
+    std::mt19937 random(6);
+    for (int i = 0; i < 10000; ++i)
+    {
+        const auto direction = RandomDirection(random);
+        const auto encoded = VertexCompression::EncodeOctahedron(direction);
+        CHECK(std::abs(encoded.x) <= 1.0f && std::abs(encoded.y) <= 1.0f);
+        CHECK(GetDistance(VertexCompression::DecodeOctahedron(encoded), direction) < 1e-5f);
+    }
+}
+
+TEST_CASE("Compact vertices decode within the quantization error bounds")
+{
+    std::mt19937 random(42);
+    const auto vertices = GetRandomVertices(random, 20000);
+    const auto quantization = VertexCompression::GetPositionQuantization(vertices);
+    const auto encoded = VertexCompression::Encode(vertices, quantization);
+    CHECK_EQUAL(encoded.size(), vertices.size());
+
+    // Half of a unorm16 step of the mesh bounds, with a little room for the float math around it.
+    const DirectX::XMFLOAT3 positionError = {
+        quantization.scale.x / 65535.0f * 0.5f + 1e-4f,
+        quantization.scale.y / 65535.0f * 0.5f + 1e-4f,
+        quantization.scale.z / 65535.0f * 0.5f + 1e-4f};
+
+    for (Size i = 0; i < vertices.size(); ++i)
+    {
+        const auto& source = vertices[i];
+        const auto decoded = VertexCompression::Decode(encoded[i], quantization);
+
+        CHECK_NEAR(decoded.Vertex.x, source.Vertex.x, positionError.x);
+        CHECK_NEAR(decoded.Vertex.y, source.Vertex.y, positionError.y);
+        CHECK_NEAR(decoded.Vertex.z, source.Vertex.z, positionError.z);
+
+        CHECK(GetDistance(decoded.Normal, source.Normal) < MaxDirectionError);
+
+        CHECK(IsWithinHalfPrecision(decoded.TextureCoord.x, source.TextureCoord.x));
+        CHECK(IsWithinHalfPrecision(decoded.TextureCoord.y, source.TextureCoord.y));
+
+        const DirectX::XMFLOAT3 sourceTangent = {source.Tangent.x, source.Tangent.y, source.Tangent.z};
+        const DirectX::XMFLOAT3 decodedTangent = {decoded.Tangent.x, decoded.Tangent.y, decoded.Tangent.z};
+        CHECK(GetDistance(decodedTangent, sourceTangent) < MaxDirectionError);
+        CHECK_EQUAL(decoded.Tangent.w, source.Tangent.w);
+    }
+}
+
+TEST_CASE("Positions on the bounds decode exactly and flat axes keep their offset")
+{
+    std::vector<Vertex> vertices(3);
+    vertices[0].Vertex = {-2.0f, 5.0f, 1.0f};
+    vertices[1].Vertex = {6.0f, 5.0f, 3.0f};
+    vertices[2].Vertex = {2.0f, 5.0f, 2.0f};
+    for (auto& vertex : vertices)
+    {
+        vertex.Normal = {0.0f, 1.0f, 0.0f};
+        vertex.Tangent = {1.0f, 0.0f, 0.0f, 1.0f};
+    }
+
+    const auto quantization = VertexCompression::GetPositionQuantization(vertices);
+    CHECK_EQUAL(quantization.scale.y, 0.0f);
+
+    const auto minimum = VertexCompression::Decode(VertexCompression::Encode(vertices[0], quantization), quantization);
+    const auto maximum = VertexCompression::Decode(VertexCompression::Encode(vertices[1], quantization), quantization);
+    CHECK_EQUAL(minimum.Vertex.x, -2.0f);
+    CHECK_EQUAL(minimum.Vertex.z, 1.0f);
+    CHECK_NEAR(maximum.Vertex.x, 6.0f, 1e-6f);
+    CHECK_NEAR(maximum.Vertex.z, 3.0f, 1e-6f);
+    CHECK_EQUAL(minimum.Vertex.y, 5.0f);
+    CHECK_EQUAL(maximum.Vertex.y, 5.0f);
+}
+
+TEST_CASE("Missing tangents decode perpendicular to the normal")
+{
+    std::mt19937 random(7);
+    for (int i = 0; i < 1000; ++i)
+    {
+        Vertex vertex = {};
+        vertex.Normal = RandomDirection(random);
+
+        const auto decoded = VertexCompression::Decode(VertexCompression::Encode(vertex, {}), {});
+        const DirectX::XMFLOAT3 tangent = {decoded.Tangent.x, decoded.Tangent.y, decoded.Tangent.z};
+        CHECK(std::abs(Dot(tangent, decoded.Normal)) < MaxDirectionError);
+        CHECK_NEAR(Dot(tangent, tangent), 1.0f, 1e-5f);
+    }
+}
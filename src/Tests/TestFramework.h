@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+// Minimal headless test runner: every TEST_CASE registers itself, TestMain.cpp runs them all
+// and fails the process when any check fails so ctest reports the executable as failed.
+namespace Engine::Tests
+{
+    struct TestCase
+    {
+        const char* name;
+        std::function<void()> function;
+    };
+
+    struct TestState
+    {
+        int checksCount = 0;
+        int failuresCount = 0;
+    };
+
+    inline std::vector<TestCase>& GetTestCases()
+    {
+        static std::vector<TestCase> testCases;
+        return testCases;
+    }
+
+    inline TestState& GetTestState()
+    {
+        static TestState state;
+        return state;
+    }
+
+    struct TestRegistrar
+    {
+        TestRegistrar(const char* name, std::function<void()> function)
+        {
+            GetTestCases().push_back({name, std::move(function)});
+        }
+    };
+
+    inline bool Check(bool condition, const char* expression, const char* file, int line)
+    {
+        auto& state = GetTestState();
+        ++state.checksCount;
+        if (!condition)
+        {
+            ++state.failuresCount;
+            std::printf("%s(%d): check failed: %s\n", file, line, expression);
+        }
+        return condition;
+    }
+} // namespace Engine::Tests
+
+#define TEST_CONCATENATE_IMPL(a, b) a##b
+#define TEST_CONCATENATE(a, b) TEST_CONCATENATE_IMPL(a, b)
+
+#define TEST_CASE(name)                                                       \
+    static void TEST_CONCATENATE(TestFunction, __LINE__)();                   \
+    static Engine::Tests::TestRegistrar TEST_CONCATENATE(TestRegistrar, __LINE__)( \
+        name, &TEST_CONCATENATE(TestFunction, __LINE__));                      \
+    static void TEST_CONCATENATE(TestFunction, __LINE__)()
+
+#define CHECK(expression) Engine::Tests::Check(static_cast<bool>(expression), #expression, __FILE__, __LINE__)
+
+#define CHECK_EQUAL(actual, expected) Engine::Tests::Check((actual) == (expected), #actual " == " #expected, __FILE__, __LINE__)
+
+#define CHECK_NEAR(actual, expected, tolerance) \
+    Engine::Tests::Check(std::abs((actual) - (expected)) <= (tolerance), #actual " ~= " #expected, __FILE__, __LINE__)
@@ -0,0 +1,21 @@
+#include "TestFramework.h"
+
+int main()
+{
+    using namespace Engine::Tests;
+
+    auto& state = GetTestState();
+    int failedCasesCount = 0;
+    for (const auto& testCase : GetTestCases())
+    {
+        const int failuresCount = state.failuresCount;
+        testCase.function();
+
+        const bool isPassed = state.failuresCount == failuresCount;
+        failedCasesCount += isPassed ? 0 : 1;
+        std::printf("[%s] %s\n", isPassed ? "PASS" : "FAIL", testCase.name);
+    }
+
+    std::printf("%zu test cases, %d checks, %d failed checks\n", GetTestCases().size(), state.checksCount, state.failuresCount);
+    return failedCasesCount == 0 ? 0 : 1;
+}